@@ -0,0 +1,460 @@
+/*******************************************************************************
+ * File Name: captive_portal.c
+ *
+ * Description: This file contains the captive portal of the SoftAP: a DNS
+ *              responder that answers every query with the IP address of the
+ *              SoftAP and the precomputed redirects of the connectivity-check
+ *              URLs.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Secure Sockets header file */
+#include "cy_secure_sockets.h"
+
+/* HTTP server task header file. */
+#include "web_server.h"
+#include "captive_portal.h"
+
+/* Standard C header file */
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* UDP socket of the DNS responder. Valid while captive_dns_running is set. */
+static cy_socket_t captive_dns_socket;
+static volatile bool captive_dns_running = false;
+
+/* IP address given in the answers, in network byte order. */
+static uint32_t captive_dns_ip_address;
+
+/* Serializes the use of the socket by the DNS task with its creation and
+ * deletion when the responder is started and stopped.
+ */
+static cy_mutex_t captive_dns_mutex;
+
+/* Buffers of the query and of the response. */
+static uint8_t captive_dns_rx_buffer[CAPTIVE_DNS_MAX_MESSAGE_LEN];
+static uint8_t captive_dns_tx_buffer[CAPTIVE_DNS_MAX_MESSAGE_LEN];
+
+/* Statistics of the DNS responder. */
+static volatile uint32_t captive_dns_queries = 0;
+static volatile uint32_t captive_dns_answers = 0;
+static volatile uint32_t captive_dns_empty_answers = 0;
+static volatile uint32_t captive_dns_dropped = 0;
+
+/* Task that serves the DNS queries. */
+static uint64_t captive_dns_task_stack[CAPTIVE_DNS_TASK_STACK_SIZE / 8];
+static cy_thread_t captive_dns_task_handle;
+static bool captive_dns_task_created = false;
+
+/* Redirect sent in answer to the connectivity-check URLs, formatted once
+ * with the IP address of the SoftAP.
+ */
+static char captive_portal_redirect[CAPTIVE_PORTAL_REDIRECT_LENGTH];
+static cy_resource_static_data_t captive_portal_redirect_resource;
+
+/*******************************************************************************
+ * Function Name: captive_dns_build_response
+ *******************************************************************************
+ * Summary:
+ *  Builds the response to a DNS query. A query of an A record is answered
+ *  with the given IP address; a query of any other type gets a response
+ *  without answer, so that the client does not wait for a timeout. Queries
+ *  other than a standard query of one question are answered with "not
+ *  implemented". The additional records of the query, such as EDNS, are not
+ *  copied to the response.
+ *
+ * Parameters:
+ *  query - Pointer to the DNS query.
+ *  query_len - Length of the DNS query.
+ *  ip_address - IPv4 address of the answer, in network byte order.
+ *  response - Buffer to store the response.
+ *  response_len - Size of the buffer.
+ *
+ * Return:
+ *  uint32_t - Length of the response, or 0 if the query is dropped.
+ *
+ *******************************************************************************/
+uint32_t captive_dns_build_response(const uint8_t *query, uint32_t query_len, uint32_t ip_address,
+                                    uint8_t *response, uint32_t response_len)
+{
+    uint32_t offset = CAPTIVE_DNS_HEADER_LEN;
+    uint16_t question_count;
+    uint16_t type;
+    uint16_t class;
+    bool answer;
+
+    if ((query_len < CAPTIVE_DNS_HEADER_LEN) || (response_len < CAPTIVE_DNS_HEADER_LEN) ||
+        (0 != (query[2] & CAPTIVE_DNS_FLAG_QR)))
+    {
+        return 0;
+    }
+
+    question_count = (uint16_t)((query[4] << 8) | query[5]);
+    if ((0 != (query[2] & CAPTIVE_DNS_FLAG_OPCODE_MASK)) || (1u != question_count))
+    {
+        memcpy(response, query, CAPTIVE_DNS_HEADER_LEN);
+        response[2] = (uint8_t)(CAPTIVE_DNS_FLAG_QR | (query[2] & (CAPTIVE_DNS_FLAG_OPCODE_MASK | CAPTIVE_DNS_FLAG_RD)));
+        response[3] = CAPTIVE_DNS_RCODE_NOT_IMPLEMENTED;
+        memset(&response[4], 0, CAPTIVE_DNS_HEADER_LEN - 4u);
+        return CAPTIVE_DNS_HEADER_LEN;
+    }
+
+    /* Skip the name of the question. Names in a question are not compressed. */
+    while ((offset < query_len) && (0 != query[offset]))
+    {
+        if (query[offset] > CAPTIVE_DNS_MAX_LABEL_LEN)
+        {
+            return 0;
+        }
+        offset += query[offset] + 1u;
+    }
+
+    /* The root label, the type and the class. */
+    offset += 5u;
+    if (offset > query_len)
+    {
+        return 0;
+    }
+
+    type = (uint16_t)((query[offset - 4u] << 8) | query[offset - 3u]);
+    class = (uint16_t)((query[offset - 2u] << 8) | query[offset - 1u]);
+    answer = (CAPTIVE_DNS_TYPE_A == type) && (CAPTIVE_DNS_CLASS_IN == class);
+
+    if (offset + (answer ? CAPTIVE_DNS_ANSWER_LEN : 0u) > response_len)
+    {
+        return 0;
+    }
+
+    /* Header and question of the query, with the counts of the response. */
+    memcpy(response, query, offset);
+    response[2] = (uint8_t)(CAPTIVE_DNS_FLAG_QR | CAPTIVE_DNS_FLAG_AA | (query[2] & CAPTIVE_DNS_FLAG_RD));
+    response[3] = CAPTIVE_DNS_FLAG_RA;
+    response[6] = 0;
+    response[7] = answer ? 1u : 0u;
+    memset(&response[8], 0, 4u);
+
+    if (!answer)
+    {
+        return offset;
+    }
+
+    response[offset++] = (uint8_t)(CAPTIVE_DNS_NAME_POINTER >> 8);
+    response[offset++] = (uint8_t)(CAPTIVE_DNS_NAME_POINTER & 0xFFu);
+    response[offset++] = 0;
+    response[offset++] = CAPTIVE_DNS_TYPE_A;
+    response[offset++] = 0;
+    response[offset++] = CAPTIVE_DNS_CLASS_IN;
+    response[offset++] = (uint8_t)(CAPTIVE_DNS_TTL_SEC >> 24);
+    response[offset++] = (uint8_t)((CAPTIVE_DNS_TTL_SEC >> 16) & 0xFFu);
+    response[offset++] = (uint8_t)((CAPTIVE_DNS_TTL_SEC >> 8) & 0xFFu);
+    response[offset++] = (uint8_t)(CAPTIVE_DNS_TTL_SEC & 0xFFu);
+    response[offset++] = 0;
+    response[offset++] = 4u;
+    memcpy(&response[offset], &ip_address, 4u);
+    offset += 4u;
+
+    return offset;
+}
+
+/*******************************************************************************
+ * Function Name: captive_dns_serve
+ *******************************************************************************
+ * Summary:
+ *  Receives one DNS query, if any arrives before the receive timeout, and
+ *  sends its response. Called with captive_dns_mutex held.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void captive_dns_serve(void)
+{
+    cy_rslt_t result;
+    cy_socket_sockaddr_t peer_address;
+    uint32_t peer_address_length = sizeof(peer_address);
+    uint32_t received = 0;
+    uint32_t sent = 0;
+    uint32_t length;
+
+    result = cy_socket_recvfrom(captive_dns_socket, captive_dns_rx_buffer, sizeof(captive_dns_rx_buffer),
+                                CY_SOCKET_FLAGS_NONE, &peer_address, &peer_address_length, &received);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return;
+    }
+
+    captive_dns_queries++;
+    length = captive_dns_build_response(captive_dns_rx_buffer, received, captive_dns_ip_address,
+                                        captive_dns_tx_buffer, sizeof(captive_dns_tx_buffer));
+    if (0 == length)
+    {
+        captive_dns_dropped++;
+        return;
+    }
+
+    if (0 != captive_dns_tx_buffer[7])
+    {
+        captive_dns_answers++;
+    }
+    else
+    {
+        captive_dns_empty_answers++;
+    }
+
+    (void)cy_socket_sendto(captive_dns_socket, captive_dns_tx_buffer, length, CY_SOCKET_FLAGS_NONE,
+                           &peer_address, peer_address_length, &sent);
+}
+
+/*******************************************************************************
+ * Function Name: captive_dns_task
+ *******************************************************************************
+ * Summary:
+ *  Task that answers the DNS queries of the SoftAP clients while the
+ *  responder is started.
+ *
+ * Parameters:
+ *  arg - Unused.
+ *
+ * Return:
+ *  None.
+ *
+ *******************************************************************************/
+static void captive_dns_task(cy_thread_arg_t arg)
+{
+    (void)arg;
+
+    while (true)
+    {
+        cy_rtos_get_mutex(&captive_dns_mutex, CY_RTOS_NEVER_TIMEOUT);
+        if (captive_dns_running)
+        {
+            captive_dns_serve();
+        }
+        cy_rtos_set_mutex(&captive_dns_mutex);
+
+        if (!captive_dns_running)
+        {
+            cy_rtos_delay_milliseconds(CAPTIVE_DNS_RECEIVE_TIMEOUT_MSEC);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: captive_dns_start
+ *******************************************************************************
+ * Summary:
+ *  Starts answering the DNS queries on CAPTIVE_DNS_PORT of the given IP
+ *  address with that address.
+ *
+ * Parameters:
+ *  address - IP address of the SoftAP.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the DNS responder is started
+ *  successfully, otherwise, it returns the secure sockets or RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t captive_dns_start(const cy_socket_sockaddr_t *address)
+{
+    cy_rslt_t result;
+    cy_socket_sockaddr_t bind_address = *address;
+    uint32_t receive_timeout = CAPTIVE_DNS_RECEIVE_TIMEOUT_MSEC;
+
+    if (!captive_dns_task_created)
+    {
+        result = cy_rtos_init_mutex(&captive_dns_mutex);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            return result;
+        }
+
+        result = cy_rtos_thread_create(&captive_dns_task_handle,
+                                       &captive_dns_task,
+                                       "Captive DNS task",
+                                       &captive_dns_task_stack,
+                                       CAPTIVE_DNS_TASK_STACK_SIZE,
+                                       CAPTIVE_DNS_TASK_PRIORITY,
+                                       0);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            return result;
+        }
+        captive_dns_task_created = true;
+    }
+
+    cy_rtos_get_mutex(&captive_dns_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    if (!captive_dns_running)
+    {
+        result = cy_socket_create(CY_SOCKET_DOMAIN_AF_INET, CY_SOCKET_TYPE_DGRAM, CY_SOCKET_IPPROTO_UDP,
+                                  &captive_dns_socket);
+        if (CY_RSLT_SUCCESS == result)
+        {
+            /* The receive timeout lets the task release the socket when the
+             * responder is stopped.
+             */
+            cy_socket_setsockopt(captive_dns_socket, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                                 &receive_timeout, sizeof(receive_timeout));
+
+            bind_address.port = CAPTIVE_DNS_PORT;
+            result = cy_socket_bind(captive_dns_socket, &bind_address, sizeof(bind_address));
+            if (CY_RSLT_SUCCESS == result)
+            {
+                captive_dns_ip_address = address->ip_address.ip.v4;
+                captive_dns_running = true;
+            }
+            else
+            {
+                cy_socket_delete(captive_dns_socket);
+            }
+        }
+    }
+    else
+    {
+        result = CY_RSLT_SUCCESS;
+    }
+
+    cy_rtos_set_mutex(&captive_dns_mutex);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: captive_dns_stop
+ *******************************************************************************
+ * Summary:
+ *  Stops the DNS responder and deletes its socket. Waits for the query being
+ *  received, at most CAPTIVE_DNS_RECEIVE_TIMEOUT_MSEC.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void captive_dns_stop(void)
+{
+    if (!captive_dns_task_created)
+    {
+        return;
+    }
+
+    cy_rtos_get_mutex(&captive_dns_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if (captive_dns_running)
+    {
+        captive_dns_running = false;
+        cy_socket_delete(captive_dns_socket);
+    }
+    cy_rtos_set_mutex(&captive_dns_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: captive_dns_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the statistics of the DNS responder.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void captive_dns_get_stats(captive_dns_stats_t *stats)
+{
+    stats->queries = captive_dns_queries;
+    stats->answers = captive_dns_answers;
+    stats->empty_answers = captive_dns_empty_answers;
+    stats->dropped = captive_dns_dropped;
+}
+
+/*******************************************************************************
+ * Function Name: captive_portal_register
+ *******************************************************************************
+ * Summary:
+ *  Registers the connectivity-check URLs of the client operating systems with
+ *  the HTTP server. They are answered with a redirect to the configuration
+ *  page, formatted once here and sent as is by the HTTP server.
+ *
+ * Parameters:
+ *  server - HTTP server of the SoftAP.
+ *  ip_address - IPv4 address of the SoftAP, in network byte order.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the URLs are registered, otherwise,
+ *  it returns the HTTP server error code.
+ *
+ *******************************************************************************/
+cy_rslt_t captive_portal_register(cy_http_server_t server, uint32_t ip_address)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    static const char *const check_urls[CAPTIVE_PORTAL_CHECK_URL_COUNT] = CAPTIVE_PORTAL_CHECK_URLS;
+    uint32_t index;
+    int length;
+
+    length = snprintf(captive_portal_redirect, sizeof(captive_portal_redirect), CAPTIVE_PORTAL_REDIRECT,
+                      (unsigned int)(ip_address & 0xFFu), (unsigned int)((ip_address >> 8) & 0xFFu),
+                      (unsigned int)((ip_address >> 16) & 0xFFu), (unsigned int)(ip_address >> 24));
+    if ((length < 0) || ((uint32_t)length >= sizeof(captive_portal_redirect)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    captive_portal_redirect_resource.data = captive_portal_redirect;
+    captive_portal_redirect_resource.length = (uint32_t)length;
+
+    for (index = 0; (index < CAPTIVE_PORTAL_CHECK_URL_COUNT) && (CY_RSLT_SUCCESS == result); index++)
+    {
+        result = cy_http_server_register_resource(server,
+                                                  (uint8_t *)check_urls[index],
+                                                  (uint8_t *)"text/html",
+                                                  CY_RAW_STATIC_URL_CONTENT,
+                                                  &captive_portal_redirect_resource);
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,125 @@
+/******************************************************************************
+* File Name: captive_portal.h
+*
+* Description: This file contains the configuration parameters and function
+*              prototypes of the captive portal of the SoftAP: a DNS
+*              responder that resolves every name to the SoftAP and the
+*              redirects of the connectivity-check URLs of the client
+*              operating systems.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CAPTIVE_PORTAL_H_
+#define CAPTIVE_PORTAL_H_
+
+#include "cy_http_server.h"
+#include "cy_secure_sockets.h"
+
+/* UDP port of the DNS responder. */
+#define CAPTIVE_DNS_PORT                             (53u)
+
+/* Time to live of the answers. It is kept short so that a client re-resolves
+ * the names with its next DNS server soon after it leaves the SoftAP.
+ */
+#define CAPTIVE_DNS_TTL_SEC                          (60u)
+
+/* Largest DNS message over UDP without EDNS. */
+#define CAPTIVE_DNS_MAX_MESSAGE_LEN                  (512u)
+
+/* The DNS task wakes up at this interval to check whether the responder is
+ * stopped.
+ */
+#define CAPTIVE_DNS_RECEIVE_TIMEOUT_MSEC             (1000u)
+
+/* DNS task configuration. */
+#define CAPTIVE_DNS_TASK_STACK_SIZE                  (2 * 1024)
+#define CAPTIVE_DNS_TASK_PRIORITY                    (CY_RTOS_PRIORITY_NORMAL)
+
+/* Fields of the DNS header and of the question. */
+#define CAPTIVE_DNS_HEADER_LEN                       (12u)
+#define CAPTIVE_DNS_FLAG_QR                          (0x80u)
+#define CAPTIVE_DNS_FLAG_OPCODE_MASK                 (0x78u)
+#define CAPTIVE_DNS_FLAG_AA                          (0x04u)
+#define CAPTIVE_DNS_FLAG_RD                          (0x01u)
+#define CAPTIVE_DNS_FLAG_RA                          (0x80u)
+#define CAPTIVE_DNS_RCODE_NOT_IMPLEMENTED            (0x04u)
+#define CAPTIVE_DNS_MAX_LABEL_LEN                    (63u)
+#define CAPTIVE_DNS_TYPE_A                           (1u)
+#define CAPTIVE_DNS_CLASS_IN                         (1u)
+
+/* Answer record: pointer to the name of the question, type, class, TTL,
+ * data length and the IPv4 address.
+ */
+#define CAPTIVE_DNS_NAME_POINTER                     (0xC00Cu)
+#define CAPTIVE_DNS_ANSWER_LEN                       (16u)
+
+/* Precomputed redirect to the configuration page, sent as is in answer to
+ * the connectivity-check URLs. The client operating system finds that the
+ * network has no Internet access and opens the page by itself.
+ */
+#define CAPTIVE_PORTAL_REDIRECT \
+    "HTTP/1.1 302 Found\r\n" \
+    "Location: http://%u.%u.%u.%u/\r\n" \
+    "Content-Length: 0\r\n" \
+    "Connection: close\r\n" \
+    "\r\n"
+#define CAPTIVE_PORTAL_REDIRECT_LENGTH               (sizeof(CAPTIVE_PORTAL_REDIRECT) + 8u)
+
+/* Connectivity-check URLs of Android, iOS and macOS, Windows and Firefox. */
+#define CAPTIVE_PORTAL_CHECK_URLS \
+    { "/generate_204", "/gen_204", "/hotspot-detect.html", "/library/test/success.html", \
+      "/connecttest.txt", "/ncsi.txt", "/redirect", "/canonical.html", "/success.txt" }
+#define CAPTIVE_PORTAL_CHECK_URL_COUNT               (9u)
+
+/* Statistics of the DNS responder reported in the metrics. */
+typedef struct
+{
+    uint32_t queries;
+    uint32_t answers;
+    uint32_t empty_answers;
+    uint32_t dropped;
+} captive_dns_stats_t;
+
+
+uint32_t captive_dns_build_response(const uint8_t *query, uint32_t query_len, uint32_t ip_address,
+                                    uint8_t *response, uint32_t response_len);
+cy_rslt_t captive_dns_start(const cy_socket_sockaddr_t *address);
+void captive_dns_stop(void);
+void captive_dns_get_stats(captive_dns_stats_t *stats);
+cy_rslt_t captive_portal_register(cy_http_server_t server, uint32_t ip_address);
+
+
+#endif /* CAPTIVE_PORTAL_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * File Name: channel_select.c
+ *
+ * Description: This file contains the selection of the SoftAP channel: the
+ *              non-overlapping 2.4 GHz channels are scored by the number and
+ *              the signal strength of the APs found on and next to them.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "channel_select.h"
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Channels the SoftAP can be started on. */
+static const uint8_t channel_select_candidates[CHANNEL_SELECT_CANDIDATE_COUNT] = CHANNEL_SELECT_CANDIDATES;
+
+/* Result of the last selection. */
+static volatile uint8_t channel_select_channel = 0;
+static volatile uint32_t channel_select_ap_count = 0;
+static volatile uint32_t channel_select_scores[CHANNEL_SELECT_CANDIDATE_COUNT];
+
+/*******************************************************************************
+ * Function Name: channel_select_score
+ *******************************************************************************
+ * Summary:
+ *  Scores the congestion of a 2.4 GHz channel from the APs found by a scan.
+ *  The function uses no RTOS or Wi-Fi calls so that it can be built and
+ *  timed on the host.
+ *
+ * Parameters:
+ *  aps - Array of the APs found by the scan.
+ *  ap_count - Number of APs.
+ *  channel - Channel to score.
+ *
+ * Return:
+ *  uint32_t - Score of the channel; the lower, the less congested.
+ *
+ *******************************************************************************/
+uint32_t channel_select_score(const scan_cache_entry_t *aps, uint32_t ap_count, uint8_t channel)
+{
+    uint32_t score = 0;
+    uint32_t distance;
+    int32_t level;
+    uint32_t index;
+
+    for (index = 0; index < ap_count; index++)
+    {
+        /* APs on the 5 GHz band do not share the air with the SoftAP. */
+        if ((0 == aps[index].channel) || (aps[index].channel > 14u))
+        {
+            continue;
+        }
+
+        distance = (aps[index].channel > channel) ? (aps[index].channel - channel) : (channel - aps[index].channel);
+        if (distance > CHANNEL_SELECT_OVERLAP)
+        {
+            continue;
+        }
+
+        level = (int32_t)aps[index].rssi - CHANNEL_SELECT_RSSI_FLOOR_DBM;
+        if (level < 1)
+        {
+            level = 1;
+        }
+
+        score += (uint32_t)level * ((CHANNEL_SELECT_OVERLAP + 1u) - distance);
+    }
+
+    return score;
+}
+
+/*******************************************************************************
+ * Function Name: channel_select_pick
+ *******************************************************************************
+ * Summary:
+ *  Picks the least congested of the non-overlapping candidate channels. On
+ *  a tie, the first candidate is kept.
+ *
+ * Parameters:
+ *  aps - Array of the APs found by the scan.
+ *  ap_count - Number of APs.
+ *  score - Pointer to store the score of the channel picked.
+ *
+ * Return:
+ *  uint8_t - Channel picked.
+ *
+ *******************************************************************************/
+uint8_t channel_select_pick(const scan_cache_entry_t *aps, uint32_t ap_count, uint32_t *score)
+{
+    uint8_t channel = CHANNEL_SELECT_DEFAULT_CHANNEL;
+    uint32_t best = UINT32_MAX;
+    uint32_t index;
+
+    for (index = 0; index < CHANNEL_SELECT_CANDIDATE_COUNT; index++)
+    {
+        channel_select_scores[index] = channel_select_score(aps, ap_count, channel_select_candidates[index]);
+        if (channel_select_scores[index] < best)
+        {
+            best = channel_select_scores[index];
+            channel = channel_select_candidates[index];
+        }
+    }
+
+    channel_select_channel = channel;
+    channel_select_ap_count = ap_count;
+    *score = best;
+    return channel;
+}
+
+/*******************************************************************************
+ * Function Name: channel_select_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the channel picked last and the scores of the candidates.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void channel_select_get_stats(channel_select_stats_t *stats)
+{
+    uint32_t index;
+
+    stats->channel = channel_select_channel;
+    stats->ap_count = channel_select_ap_count;
+    for (index = 0; index < CHANNEL_SELECT_CANDIDATE_COUNT; index++)
+    {
+        stats->channels[index] = channel_select_candidates[index];
+        stats->scores[index] = channel_select_scores[index];
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/******************************************************************************
+* File Name: channel_select.h
+*
+* Description: This file contains the configuration parameters, structures
+*              and function prototypes used to pick the least congested
+*              channel for the SoftAP.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CHANNEL_SELECT_H_
+#define CHANNEL_SELECT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "scan_cache.h"
+
+/* Non-overlapping 2.4 GHz channels the SoftAP can be started on. */
+#define CHANNEL_SELECT_CANDIDATES                    {1u, 6u, 11u}
+#define CHANNEL_SELECT_CANDIDATE_COUNT               (3u)
+
+/* Channel used when no AP was found by the scan. */
+#define CHANNEL_SELECT_DEFAULT_CHANNEL               (1u)
+
+/* A 20 MHz channel overlaps the channels up to CHANNEL_SELECT_OVERLAP away.
+ * An AP adds to the score of a channel its RSSI above
+ * CHANNEL_SELECT_RSSI_FLOOR_DBM, weighted by how much its channel overlaps:
+ * fully on the same channel, down to 1/5 four channels away.
+ */
+#define CHANNEL_SELECT_OVERLAP                       (4u)
+#define CHANNEL_SELECT_RSSI_FLOOR_DBM                (-96)
+
+/* Congestion of the candidate channels measured before the SoftAP was
+ * started, reported in the metrics.
+ */
+typedef struct
+{
+    uint8_t channel;
+    uint32_t ap_count;
+    uint8_t channels[CHANNEL_SELECT_CANDIDATE_COUNT];
+    uint32_t scores[CHANNEL_SELECT_CANDIDATE_COUNT];
+} channel_select_stats_t;
+
+
+uint32_t channel_select_score(const scan_cache_entry_t *aps, uint32_t ap_count, uint8_t channel);
+uint8_t channel_select_pick(const scan_cache_entry_t *aps, uint32_t ap_count, uint32_t *score);
+void channel_select_get_stats(channel_select_stats_t *stats);
+
+
+#endif /* CHANNEL_SELECT_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,210 @@
+/*******************************************************************************
+ * File Name: conn_quota.c
+ *
+ * Description: This file contains the per-client connection quota applied
+ *              when a connection is accepted, with the counters of the
+ *              accepted and rejected connections of each client.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "conn_quota.h"
+
+/* Standard C header file */
+#include <string.h>
+
+/*******************************************************************************
+ * Function Name: conn_quota_find
+ *******************************************************************************
+ * Summary:
+ *  Finds the entry of a client. If the client is not tracked, an unused entry,
+ *  or else the entry of a client without open connections, is given to it.
+ *
+ * Parameters:
+ *  quota - Pointer to the quota.
+ *  key - Key of the client.
+ *  add - true to give an entry to a client that is not tracked.
+ *
+ * Return:
+ *  conn_quota_client_t* - Entry of the client, or NULL if it is not tracked
+ *  and no entry can be given to it.
+ *
+ *******************************************************************************/
+static conn_quota_client_t *conn_quota_find(conn_quota_t *quota, uint32_t key, bool add)
+{
+    conn_quota_client_t *free_entry = NULL;
+    conn_quota_client_t *client;
+
+    for (uint32_t index = 0; index < CONN_QUOTA_MAX_CLIENTS; index++)
+    {
+        client = &quota->clients[index];
+        if ((0 != client->key) && (key == client->key))
+        {
+            return client;
+        }
+
+        if (0 == client->connections)
+        {
+            if ((NULL == free_entry) || ((0 != free_entry->key) && (0 == client->key)))
+            {
+                free_entry = client;
+            }
+        }
+    }
+
+    if (!add || (NULL == free_entry))
+    {
+        return NULL;
+    }
+
+    memset(free_entry, 0, sizeof(*free_entry));
+    free_entry->key = key;
+    return free_entry;
+}
+
+/*******************************************************************************
+ * Function Name: conn_quota_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes a quota with no open connections.
+ *
+ * Parameters:
+ *  quota - Pointer to the quota.
+ *  max_connections - Connections the listener can serve at the same time.
+ *  max_per_client - Connections a single client may hold.
+ *  reserved - Connections kept for the clients that hold none.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void conn_quota_init(conn_quota_t *quota, uint32_t max_connections, uint32_t max_per_client, uint32_t reserved)
+{
+    memset(quota, 0, sizeof(*quota));
+    quota->max_connections = max_connections;
+    quota->max_per_client = max_per_client;
+    quota->reserved = reserved;
+}
+
+/*******************************************************************************
+ * Function Name: conn_quota_reject
+ *******************************************************************************
+ * Summary:
+ *  Counts a rejected connection of a client, for a connection that the
+ *  listener cannot serve before its quota is checked.
+ *
+ * Parameters:
+ *  quota - Pointer to the quota.
+ *  key - Key of the client.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void conn_quota_reject(conn_quota_t *quota, uint32_t key)
+{
+    conn_quota_client_t *client = conn_quota_find(quota, key, true);
+
+    quota->rejected++;
+    if (NULL != client)
+    {
+        client->rejected++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: conn_quota_acquire
+ *******************************************************************************
+ * Summary:
+ *  Decides whether a new connection of a client is accepted. It is rejected
+ *  when the listener is full, when the client already holds max_per_client
+ *  connections, or when the client already holds a connection and only the
+ *  reserved connections are left. The decision is counted for the client.
+ *
+ * Parameters:
+ *  quota - Pointer to the quota.
+ *  key - Key of the client.
+ *
+ * Return:
+ *  bool - true if the connection is accepted and must be released with
+ *  conn_quota_release() when it is closed.
+ *
+ *******************************************************************************/
+bool conn_quota_acquire(conn_quota_t *quota, uint32_t key)
+{
+    conn_quota_client_t *client = conn_quota_find(quota, key, true);
+    uint32_t free_connections = quota->max_connections - quota->connections;
+
+    if ((NULL == client) || (0 == free_connections) || (client->connections >= quota->max_per_client) ||
+        ((0 != client->connections) && (free_connections <= quota->reserved)))
+    {
+        conn_quota_reject(quota, key);
+        return false;
+    }
+
+    quota->connections++;
+    quota->accepted++;
+    client->connections++;
+    client->accepted++;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: conn_quota_release
+ *******************************************************************************
+ * Summary:
+ *  Releases a connection accepted by conn_quota_acquire().
+ *
+ * Parameters:
+ *  quota - Pointer to the quota.
+ *  key - Key of the client.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void conn_quota_release(conn_quota_t *quota, uint32_t key)
+{
+    conn_quota_client_t *client = conn_quota_find(quota, key, false);
+
+    if ((NULL == client) || (0 == client->connections) || (0 == quota->connections))
+    {
+        return;
+    }
+
+    client->connections--;
+    quota->connections--;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/******************************************************************************
+* File Name: conn_quota.h
+*
+* Description: This file contains the structures and function prototypes of
+*              the per-client connection quota applied when a connection is
+*              accepted.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CONN_QUOTA_H_
+#define CONN_QUOTA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Number of clients whose connections and rejections are tracked. A client
+ * without open connections is forgotten when the entry is needed for a new
+ * client.
+ */
+#define CONN_QUOTA_MAX_CLIENTS                       (8u)
+
+/* Connections and counters of one client, identified by a non-zero key: its
+ * IPv4 address, or a hash of an ID when the address is not known.
+ */
+typedef struct
+{
+    uint32_t key;
+    uint32_t connections;
+    uint32_t accepted;
+    uint32_t rejected;
+} conn_quota_client_t;
+
+/* Quota of a listener. A client may hold at most max_per_client of the
+ * max_connections connections, and the last reserved connections are kept for
+ * clients that hold none, so that one client cannot lock the others out.
+ * The caller serializes the calls.
+ */
+typedef struct
+{
+    uint32_t max_connections;
+    uint32_t max_per_client;
+    uint32_t reserved;
+    uint32_t connections;
+    uint32_t accepted;
+    uint32_t rejected;
+    conn_quota_client_t clients[CONN_QUOTA_MAX_CLIENTS];
+} conn_quota_t;
+
+
+void conn_quota_init(conn_quota_t *quota, uint32_t max_connections, uint32_t max_per_client, uint32_t reserved);
+bool conn_quota_acquire(conn_quota_t *quota, uint32_t key);
+void conn_quota_reject(conn_quota_t *quota, uint32_t key);
+void conn_quota_release(conn_quota_t *quota, uint32_t key);
+
+
+#endif /* CONN_QUOTA_H_ */
+
+/* [] END OF FILE */
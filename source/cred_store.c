@@ -0,0 +1,768 @@
+/*******************************************************************************
+ * File Name: cred_store.c
+ *
+ * Description: This file contains the persistent store of the Wi-Fi
+ *              profiles: the credentials, BSSID and channel of the APs the
+ *              device can connect to, used to reconnect at boot without the
+ *              SoftAP. The record is protected by a magic number, a version
+ *              and a CRC, and is kept in the last flash sector or, on the
+ *              host, in a file.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "cred_store.h"
+
+/* Standard C header file */
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(CRED_STORE_HOST_FILE)
+#include <stdio.h>
+#else
+#include "cyhal.h"
+#include "cyabs_rtos.h"
+#endif
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+#if !defined(CRED_STORE_HOST_FILE)
+/* Flash instance and location of the record. */
+static cyhal_flash_t cred_store_flash;
+static uint32_t cred_store_address = 0;
+static uint32_t cred_store_page_size = 0;
+static uint8_t cred_store_erase_value = 0xFFu;
+
+/* Buffer used to program the record one page at a time. */
+static uint32_t cred_store_page[CRED_STORE_MAX_PAGE_SIZE / sizeof(uint32_t)];
+
+/* Serializes the access to the record between the server task and the HTTP
+ * server threads serving the profiles API.
+ */
+static cy_mutex_t cred_store_mutex;
+#endif
+
+/* Copy of the record being read or updated; kept out of the thread stacks. */
+static cred_store_record_t cred_store_record;
+
+/* Set once the storage is initialized. */
+static bool cred_store_ready = false;
+
+/*******************************************************************************
+ * Function Name: cred_store_crc32
+ *******************************************************************************
+ * Summary:
+ *  Computes the CRC-32 (IEEE 802.3) of a buffer.
+ *
+ * Parameters:
+ *  data - Pointer to the buffer.
+ *  length - Length of the buffer.
+ *
+ * Return:
+ *  uint32_t - CRC of the buffer.
+ *
+ *******************************************************************************/
+static uint32_t cred_store_crc32(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    uint32_t bit;
+
+    while (length-- > 0)
+    {
+        crc ^= *data++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+
+    return ~crc;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_lock
+ *******************************************************************************
+ * Summary:
+ *  Takes the record for the calling thread. Nothing to do on the host.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void cred_store_lock(void)
+{
+#if !defined(CRED_STORE_HOST_FILE)
+    cy_rtos_get_mutex(&cred_store_mutex, CY_RTOS_NEVER_TIMEOUT);
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_unlock
+ *******************************************************************************
+ * Summary:
+ *  Releases the record taken by cred_store_lock.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void cred_store_unlock(void)
+{
+#if !defined(CRED_STORE_HOST_FILE)
+    cy_rtos_set_mutex(&cred_store_mutex);
+#endif
+}
+
+#if defined(CRED_STORE_HOST_FILE)
+/*******************************************************************************
+ * Function Name: cred_store_backend_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the file that emulates the flash on the host.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Always CY_RSLT_SUCCESS; the file is created on the first save.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_backend_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_backend_read
+ *******************************************************************************
+ * Summary:
+ *  Reads the record from the file that emulates the flash.
+ *
+ * Parameters:
+ *  data - Buffer to store the record.
+ *  size - Size of the record.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the record is read, otherwise,
+ *  it returns CY_RSLT_TYPE_ERROR.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_backend_read(uint8_t *data, uint32_t size)
+{
+    FILE *file = fopen(CRED_STORE_HOST_FILE, "rb");
+    size_t length;
+
+    if (NULL == file)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    length = fread(data, 1, size, file);
+    fclose(file);
+
+    return (length == size) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_backend_write
+ *******************************************************************************
+ * Summary:
+ *  Replaces the record in the file that emulates the flash.
+ *
+ * Parameters:
+ *  data - Pointer to the record.
+ *  size - Size of the record.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the record is written, otherwise,
+ *  it returns CY_RSLT_TYPE_ERROR.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_backend_write(const uint8_t *data, uint32_t size)
+{
+    FILE *file = fopen(CRED_STORE_HOST_FILE, "wb");
+    size_t length;
+
+    if (NULL == file)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    length = fwrite(data, 1, size, file);
+    if (0 != fclose(file))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return (length == size) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_backend_erase
+ *******************************************************************************
+ * Summary:
+ *  Removes the file that emulates the flash.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Always CY_RSLT_SUCCESS.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_backend_erase(void)
+{
+    (void)remove(CRED_STORE_HOST_FILE);
+    return CY_RSLT_SUCCESS;
+}
+#else
+/*******************************************************************************
+ * Function Name: cred_store_backend_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the flash and selects its last sector for the record.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the flash is initialized, otherwise,
+ *  it returns the HAL error code or CY_RSLT_TYPE_ERROR.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_backend_init(void)
+{
+    cy_rslt_t result;
+    cyhal_flash_info_t info;
+    const cyhal_flash_block_info_t *block;
+
+    result = cyhal_flash_init(&cred_store_flash);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    cyhal_flash_get_info(&cred_store_flash, &info);
+    if (0 == info.block_count)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    block = &info.blocks[info.block_count - 1];
+    if ((block->page_size > CRED_STORE_MAX_PAGE_SIZE) || (block->sector_size < sizeof(cred_store_record_t)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    cred_store_address = block->start_address + block->size - block->sector_size;
+    cred_store_page_size = block->page_size;
+    cred_store_erase_value = block->erase_value;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_backend_read
+ *******************************************************************************
+ * Summary:
+ *  Reads the record from the flash.
+ *
+ * Parameters:
+ *  data - Buffer to store the record.
+ *  size - Size of the record.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the record is read, otherwise,
+ *  it returns the HAL error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_backend_read(uint8_t *data, uint32_t size)
+{
+    return cyhal_flash_read(&cred_store_flash, cred_store_address, data, size);
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_backend_write
+ *******************************************************************************
+ * Summary:
+ *  Erases the sector of the record and programs the new record one page at
+ *  a time.
+ *
+ * Parameters:
+ *  data - Pointer to the record.
+ *  size - Size of the record.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the record is written, otherwise,
+ *  it returns the HAL error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_backend_write(const uint8_t *data, uint32_t size)
+{
+    cy_rslt_t result;
+    uint32_t offset;
+    uint32_t length;
+
+    result = cyhal_flash_erase(&cred_store_flash, cred_store_address);
+
+    for (offset = 0; (CY_RSLT_SUCCESS == result) && (offset < size); offset += cred_store_page_size)
+    {
+        length = ((size - offset) < cred_store_page_size) ? (size - offset) : cred_store_page_size;
+
+        memset(cred_store_page, cred_store_erase_value, cred_store_page_size);
+        memcpy(cred_store_page, &data[offset], length);
+
+        result = cyhal_flash_write(&cred_store_flash, cred_store_address + offset, cred_store_page);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_backend_erase
+ *******************************************************************************
+ * Summary:
+ *  Erases the sector of the record.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the sector is erased, otherwise,
+ *  it returns the HAL error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_backend_erase(void)
+{
+    return cyhal_flash_erase(&cred_store_flash, cred_store_address);
+}
+#endif /* CRED_STORE_HOST_FILE */
+
+/*******************************************************************************
+ * Function Name: cred_store_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the storage of the credentials.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the storage is initialized,
+ *  otherwise, it returns the error code of the storage.
+ *
+ *******************************************************************************/
+cy_rslt_t cred_store_init(void)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if (!cred_store_ready)
+    {
+#if !defined(CRED_STORE_HOST_FILE)
+        result = cy_rtos_init_mutex(&cred_store_mutex);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            return result;
+        }
+#endif
+        result = cred_store_backend_init();
+        cred_store_ready = (CY_RSLT_SUCCESS == result);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_read
+ *******************************************************************************
+ * Summary:
+ *  Reads the record. A record that is erased, corrupted or of another
+ *  version is reported as missing. Called with the record taken.
+ *
+ * Parameters:
+ *  record - Pointer to store the record.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the record is valid, otherwise, it
+ *  returns CY_RSLT_TYPE_ERROR or the error code of the storage.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_read(cred_store_record_t *record)
+{
+    cy_rslt_t result;
+    uint32_t index;
+
+    if (!cred_store_ready)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    result = cred_store_backend_read((uint8_t *)record, sizeof(*record));
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    if ((CRED_STORE_MAGIC != record->magic) ||
+        (CRED_STORE_VERSION != record->version) ||
+        (sizeof(*record) != record->length) ||
+        (cred_store_crc32((const uint8_t *)record, offsetof(cred_store_record_t, crc)) != record->crc))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    /* Never hand out an SSID or a password that is not terminated. */
+    for (index = 0; index < CRED_STORE_MAX_PROFILES; index++)
+    {
+        record->profiles[index].ssid[sizeof(record->profiles[index].ssid) - 1] = '\0';
+        record->profiles[index].password[sizeof(record->profiles[index].password) - 1] = '\0';
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_write
+ *******************************************************************************
+ * Summary:
+ *  Seals the record with the magic number, the version and the CRC, and
+ *  writes it. Called with the record taken.
+ *
+ * Parameters:
+ *  record - Pointer to the record.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the record is written, otherwise,
+ *  it returns the error code of the storage.
+ *
+ *******************************************************************************/
+static cy_rslt_t cred_store_write(cred_store_record_t *record)
+{
+    record->magic = CRED_STORE_MAGIC;
+    record->version = CRED_STORE_VERSION;
+    record->length = sizeof(*record);
+    record->crc = cred_store_crc32((const uint8_t *)record, offsetof(cred_store_record_t, crc));
+
+    return cred_store_backend_write((const uint8_t *)record, sizeof(*record));
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_slot
+ *******************************************************************************
+ * Summary:
+ *  Returns the slot of the profile of an SSID.
+ *
+ * Parameters:
+ *  record - Pointer to the record.
+ *  ssid - Pointer to the SSID.
+ *
+ * Return:
+ *  uint32_t - Index of the profile, or CRED_STORE_MAX_PROFILES if the SSID
+ *  has no profile.
+ *
+ *******************************************************************************/
+static uint32_t cred_store_slot(const cred_store_record_t *record, const uint8_t *ssid)
+{
+    uint32_t index;
+
+    for (index = 0; index < CRED_STORE_MAX_PROFILES; index++)
+    {
+        if (record->profiles[index].valid &&
+            (0 == strncmp((const char *)record->profiles[index].ssid, (const char *)ssid, CY_WCM_MAX_SSID_LEN)))
+        {
+            break;
+        }
+    }
+
+    return index;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_load
+ *******************************************************************************
+ * Summary:
+ *  Reads the stored profiles.
+ *
+ * Parameters:
+ *  profiles - Array to store the profiles.
+ *  count - Pointer to store the number of profiles.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if at least one profile is stored,
+ *  otherwise, it returns CY_RSLT_TYPE_ERROR or the error code of the storage.
+ *
+ *******************************************************************************/
+cy_rslt_t cred_store_load(cred_store_entry_t profiles[CRED_STORE_MAX_PROFILES], uint32_t *count)
+{
+    cy_rslt_t result;
+    uint32_t index;
+
+    *count = 0;
+
+    cred_store_lock();
+    result = cred_store_read(&cred_store_record);
+    for (index = 0; (CY_RSLT_SUCCESS == result) && (index < CRED_STORE_MAX_PROFILES); index++)
+    {
+        if (cred_store_record.profiles[index].valid)
+        {
+            memcpy(&profiles[(*count)++], &cred_store_record.profiles[index], sizeof(cred_store_entry_t));
+        }
+    }
+    cred_store_unlock();
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    return (0 != *count) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_find
+ *******************************************************************************
+ * Summary:
+ *  Reads the stored profile of an SSID.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *  entry - Pointer to store the profile.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the SSID has a profile, otherwise,
+ *  it returns CY_RSLT_TYPE_ERROR or the error code of the storage.
+ *
+ *******************************************************************************/
+cy_rslt_t cred_store_find(const uint8_t *ssid, cred_store_entry_t *entry)
+{
+    cy_rslt_t result;
+    uint32_t slot;
+
+    cred_store_lock();
+    result = cred_store_read(&cred_store_record);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        slot = cred_store_slot(&cred_store_record, ssid);
+        if (CRED_STORE_MAX_PROFILES != slot)
+        {
+            memcpy(entry, &cred_store_record.profiles[slot], sizeof(*entry));
+        }
+        else
+        {
+            result = CY_RSLT_TYPE_ERROR;
+        }
+    }
+    cred_store_unlock();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_save
+ *******************************************************************************
+ * Summary:
+ *  Adds or replaces the profile of an SSID. When the record is full, a new
+ *  profile replaces the one with the oldest successful connection, and then
+ *  the lowest priority. The storage is not written when the same profile is
+ *  already stored, to save flash wear on every reconnect.
+ *
+ * Parameters:
+ *  entry - Pointer to the profile. Unused bytes must be zeroed so that
+ *  identical profiles compare equal. valid and last_success are set here.
+ *  connected - true when the device just connected with the profile: the
+ *  profile becomes the most recent success and keeps its stored priority.
+ *  Otherwise, the profile keeps its stored last_success.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the profile is stored, otherwise,
+ *  it returns CY_RSLT_TYPE_ERROR or the error code of the storage.
+ *
+ *******************************************************************************/
+cy_rslt_t cred_store_save(const cred_store_entry_t *entry, bool connected)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    cred_store_record_t *record = &cred_store_record;
+    cred_store_entry_t profile;
+    uint32_t slot;
+    uint32_t index;
+    bool changed = false;
+
+    if (!cred_store_ready)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memcpy(&profile, entry, sizeof(profile));
+    profile.valid = true;
+    profile.last_success = 0;
+
+    cred_store_lock();
+
+    if (CY_RSLT_SUCCESS != cred_store_read(record))
+    {
+        memset(record, 0, sizeof(*record));
+    }
+
+    slot = cred_store_slot(record, entry->ssid);
+    if (CRED_STORE_MAX_PROFILES != slot)
+    {
+        profile.last_success = record->profiles[slot].last_success;
+        if (connected)
+        {
+            profile.priority = record->profiles[slot].priority;
+        }
+    }
+    else
+    {
+        /* Take a free slot, or else the lowest ranked profile. */
+        slot = 0;
+        for (index = 0; index < CRED_STORE_MAX_PROFILES; index++)
+        {
+            if (!record->profiles[index].valid)
+            {
+                slot = index;
+                break;
+            }
+
+            if ((record->profiles[index].last_success < record->profiles[slot].last_success) ||
+                ((record->profiles[index].last_success == record->profiles[slot].last_success) &&
+                 (record->profiles[index].priority < record->profiles[slot].priority)))
+            {
+                slot = index;
+            }
+        }
+    }
+
+    /* A reconnection to the most recent AP changes nothing. */
+    if (connected && ((0 == profile.last_success) || (profile.last_success != record->sequence)))
+    {
+        profile.last_success = ++record->sequence;
+        changed = true;
+    }
+
+    if (0 != memcmp(&record->profiles[slot], &profile, sizeof(profile)))
+    {
+        memcpy(&record->profiles[slot], &profile, sizeof(profile));
+        changed = true;
+    }
+
+    if (changed)
+    {
+        result = cred_store_write(record);
+    }
+
+    cred_store_unlock();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_remove
+ *******************************************************************************
+ * Summary:
+ *  Removes the profile of an SSID.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the profile is removed, otherwise,
+ *  it returns CY_RSLT_TYPE_ERROR if the SSID has no profile, or the error
+ *  code of the storage.
+ *
+ *******************************************************************************/
+cy_rslt_t cred_store_remove(const uint8_t *ssid)
+{
+    cy_rslt_t result;
+    uint32_t slot;
+
+    cred_store_lock();
+    result = cred_store_read(&cred_store_record);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        slot = cred_store_slot(&cred_store_record, ssid);
+        if (CRED_STORE_MAX_PROFILES != slot)
+        {
+            memset(&cred_store_record.profiles[slot], 0, sizeof(cred_store_record.profiles[slot]));
+            result = cred_store_write(&cred_store_record);
+        }
+        else
+        {
+            result = CY_RSLT_TYPE_ERROR;
+        }
+    }
+    cred_store_unlock();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: cred_store_erase
+ *******************************************************************************
+ * Summary:
+ *  Removes all the stored profiles.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the profiles are removed,
+ *  otherwise, it returns CY_RSLT_TYPE_ERROR or the error code of the storage.
+ *
+ *******************************************************************************/
+cy_rslt_t cred_store_erase(void)
+{
+    cy_rslt_t result;
+
+    if (!cred_store_ready)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    cred_store_lock();
+    result = cred_store_backend_erase();
+    cred_store_unlock();
+
+    return result;
+}
+
+/* [] END OF FILE */
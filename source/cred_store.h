@@ -0,0 +1,114 @@
+/******************************************************************************
+* File Name: cred_store.h
+*
+* Description: This file contains the configuration parameters, structures
+*              and function prototypes of the persistent store of the Wi-Fi
+*              profiles the device can connect to.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef CRED_STORE_H_
+#define CRED_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+#include "cy_wcm.h"
+#include "pmk_cache.h"
+
+/* Identifies a valid record. The version is increased whenever the layout of
+ * cred_store_record_t changes; a record of another version is ignored.
+ */
+#define CRED_STORE_MAGIC                             (0x43524544u)
+#define CRED_STORE_VERSION                           (4u)
+
+/* The record is kept in the last sector of the flash. On the host, it is kept
+ * in the file named by CRED_STORE_HOST_FILE when that macro is defined.
+ */
+#define CRED_STORE_MAX_PAGE_SIZE                     (512u)
+
+/* Number of Wi-Fi profiles kept in the record. When the record is full, a
+ * new profile replaces the one with the oldest successful connection, and
+ * then the lowest priority.
+ */
+#define CRED_STORE_MAX_PROFILES                      (4u)
+
+/* A Wi-Fi profile: the credentials and location of an AP, the PMK derived
+ * from the SSID and password when pmk_valid is set, and the static IP
+ * settings provisioned for the STA interface when static_ip_valid is set.
+ * last_success orders the profiles by their last successful connection; it
+ * is 0 for a profile that never connected. A higher priority is tried first
+ * between profiles that are otherwise equal.
+ */
+typedef struct
+{
+    bool valid;
+    uint8_t priority;
+    uint32_t last_success;
+    cy_wcm_ssid_t ssid;
+    cy_wcm_passphrase_t password;
+    cy_wcm_security_t security;
+    cy_wcm_mac_t bssid;
+    uint8_t channel;
+    bool pmk_valid;
+    uint8_t pmk[PMK_LENGTH];
+    bool static_ip_valid;
+    cy_wcm_ip_setting_t static_ip;
+} cred_store_entry_t;
+
+/* Layout of the record in the storage. sequence is the last_success of the
+ * most recent successful connection. The CRC covers all the fields before it.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;
+    uint32_t sequence;
+    cred_store_entry_t profiles[CRED_STORE_MAX_PROFILES];
+    uint32_t crc;
+} cred_store_record_t;
+
+
+cy_rslt_t cred_store_init(void);
+cy_rslt_t cred_store_load(cred_store_entry_t profiles[CRED_STORE_MAX_PROFILES], uint32_t *count);
+cy_rslt_t cred_store_find(const uint8_t *ssid, cred_store_entry_t *entry);
+cy_rslt_t cred_store_save(const cred_store_entry_t *entry, bool connected);
+cy_rslt_t cred_store_remove(const uint8_t *ssid);
+cy_rslt_t cred_store_erase(void);
+
+
+#endif /* CRED_STORE_H_ */
+
+/* [] END OF FILE */
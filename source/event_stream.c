@@ -0,0 +1,747 @@
+/*******************************************************************************
+ * File Name: event_stream.c
+ *
+ * Description: This file contains the HTTP server-sent event (SSE) stream used
+ *              to send device data to the clients. Every event is assigned a
+ *              monotonic ID and kept in a fixed-size history ring so that a
+ *              client reconnecting after a link drop receives the events it
+ *              missed before the live stream resumes.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cy_http_server.h"
+
+/* HTTP server task header file. */
+#include "web_server.h"
+#include "event_stream.h"
+
+/* Standard C header file */
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Macros
+ ********************************************************************************/
+/* Response to a stream over the quota. The HTTP server library has no status
+ * type for 503, so the response is written as the payload, like the 204
+ * response of the connectivity checks.
+ */
+#define EVENT_STREAM_BUSY_RESPONSE \
+    "HTTP/1.1 503 Service Unavailable\r\n" \
+    "Retry-After: 5\r\n" \
+    "Content-Length: 0\r\n" \
+    "Connection: close\r\n" \
+    "\r\n"
+
+/*******************************************************************************
+ * Structures
+ ********************************************************************************/
+/* An event kept in the history ring. */
+typedef struct
+{
+    uint32_t id;
+    const char *name;
+    uint32_t data_len;
+    char data[EVENT_STREAM_MAX_DATA_LEN];
+} event_stream_record_t;
+
+/* A client receiving the event stream. */
+typedef struct
+{
+    cy_http_response_stream_t *stream;
+    uint32_t interface;
+    uint32_t client_id;
+    bool active;
+    cy_time_t last_write_time;
+    uint32_t stalled_writes;
+} event_stream_subscriber_t;
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* History ring; the event with ID n is stored at index n % EVENT_STREAM_HISTORY_DEPTH. */
+static event_stream_record_t event_history[EVENT_STREAM_HISTORY_DEPTH];
+
+/* ID assigned to the next event. IDs start at 1 so that 0 means no event. */
+static uint32_t next_event_id = 1;
+
+/* Clients receiving the event stream. */
+static event_stream_subscriber_t event_subscribers[EVENT_STREAM_MAX_SUBSCRIBERS];
+
+/* Serializes the history ring and the subscriber table between the HTTP
+ * server thread and the publishing thread.
+ */
+static cy_mutex_t event_stream_mutex;
+
+/* Buffer used to format a live event once for all subscribers. */
+static char event_tx_buffer[EVENT_STREAM_MAX_EVENT_LEN];
+
+/* Buffer used to replay a batch of missed events to a reconnecting client. */
+static char event_replay_buffer[EVENT_STREAM_REPLAY_BUFFER_LENGTH];
+
+/* Quota of the streams of each client, checked when a stream is opened. */
+static conn_quota_t event_stream_quota;
+
+/* Streams accepted in the current window, whatever their client ID. */
+static cy_time_t event_stream_window_start = 0;
+static uint32_t event_stream_window_accepts = 0;
+static uint32_t event_stream_rate_limited = 0;
+
+/* Statistics reported in the metrics. */
+static uint32_t reaped_subscriber_count = 0;
+static uint32_t stalled_write_count = 0;
+static uint32_t heartbeat_count = 0;
+
+/*******************************************************************************
+ * Function Name: event_stream_reap
+ *******************************************************************************
+ * Summary:
+ *  Closes the connection of a dead subscriber so that its socket is returned
+ *  to the HTTP server without waiting for TCP to time out. Must be called with
+ *  event_stream_mutex held.
+ *
+ * Parameters:
+ *  subscriber - Subscriber to close.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void event_stream_reap(event_stream_subscriber_t *subscriber)
+{
+    cy_http_server_response_stream_disconnect(subscriber->stream);
+    conn_quota_release(&event_stream_quota, subscriber->client_id);
+
+    subscriber->stream = NULL;
+    subscriber->active = false;
+    subscriber->stalled_writes = 0;
+    reaped_subscriber_count++;
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_write
+ *******************************************************************************
+ * Summary:
+ *  Writes to a subscriber and checks that the write made progress. The
+ *  subscriber is reaped if the write fails or if
+ *  EVENT_STREAM_MAX_STALLED_WRITES writes in a row take longer than
+ *  EVENT_STREAM_STALLED_WRITE_MSEC. Must be called with event_stream_mutex held.
+ *
+ * Parameters:
+ *  subscriber - Subscriber to write to.
+ *  data - Data to write.
+ *  data_len - Length of the data.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void event_stream_write(event_stream_subscriber_t *subscriber, const char *data, uint32_t data_len)
+{
+    cy_rslt_t result;
+    cy_time_t start_time;
+    cy_time_t end_time;
+
+    cy_rtos_get_time(&start_time);
+    result = cy_http_server_response_stream_write_payload(subscriber->stream, data, data_len);
+    cy_rtos_get_time(&end_time);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Event stream write failed, closing the subscriber.\n"));
+        event_stream_reap(subscriber);
+        return;
+    }
+
+    subscriber->last_write_time = end_time;
+
+    if ((end_time - start_time) >= EVENT_STREAM_STALLED_WRITE_MSEC)
+    {
+        stalled_write_count++;
+        if (++subscriber->stalled_writes >= EVENT_STREAM_MAX_STALLED_WRITES)
+        {
+            ERR_INFO(("Event stream subscriber is not reading, closing it.\n"));
+            event_stream_reap(subscriber);
+        }
+    }
+    else
+    {
+        subscriber->stalled_writes = 0;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_format
+ *******************************************************************************
+ * Summary:
+ *  Formats an event in the SSE wire format.
+ *
+ * Parameters:
+ *  buf - Buffer to which the event is written.
+ *  buf_len - Size of the buffer.
+ *  id - ID of the event.
+ *  name - Name of the event, or NULL for the default "message" event.
+ *  data - Data of the event.
+ *  data_len - Length of the data.
+ *
+ * Return:
+ *  uint32_t - Number of bytes written, or 0 if the event does not fit.
+ *
+ *******************************************************************************/
+static uint32_t event_stream_format(char *buf, uint32_t buf_len, uint32_t id,
+                                    const char *name, const char *data, uint32_t data_len)
+{
+    int length;
+
+    if (NULL != name)
+    {
+        length = snprintf(buf, buf_len, EVENT_STREAM_ID "%lu\n" EVENT_STREAM_EVENT "%s\n" EVENT_STREAM_DATA "%.*s" LFLF,
+                          (unsigned long)id, name, (int)data_len, data);
+    }
+    else
+    {
+        length = snprintf(buf, buf_len, EVENT_STREAM_ID "%lu\n" EVENT_STREAM_DATA "%.*s" LFLF,
+                          (unsigned long)id, (int)data_len, data);
+    }
+
+    if ((length < 0) || ((uint32_t)length >= buf_len))
+    {
+        return 0;
+    }
+
+    return (uint32_t)length;
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_get_last_event_id
+ *******************************************************************************
+ * Summary:
+ *  Extracts the ID of the last event received by the client from the query
+ *  string of the event stream request.
+ *
+ * Parameters:
+ *  url_parameters - Pointer to the HTTP URL query string.
+ *  last_event_id - Pointer to store the ID of the last event.
+ *
+ * Return:
+ *  bool - true if the client requested to resume from an event ID.
+ *
+ *******************************************************************************/
+static bool event_stream_get_last_event_id(const char *url_parameters, uint32_t *last_event_id)
+{
+    char *value = NULL;
+    uint32_t value_len = 0;
+    uint32_t id = 0;
+
+    if ((NULL == url_parameters) || (NULL_CHARACTER_ASCII_VALUE == url_parameters[0]))
+    {
+        return false;
+    }
+
+    if (CY_RSLT_SUCCESS != cy_http_server_get_query_parameter_value(url_parameters, EVENT_STREAM_LAST_ID_PARAM,
+                                                                    &value, &value_len))
+    {
+        return false;
+    }
+
+    if ((NULL == value) || (0 == value_len))
+    {
+        return false;
+    }
+
+    for (uint32_t index = 0; index < value_len; index++)
+    {
+        if ((value[index] < '0') || (value[index] > '9'))
+        {
+            return false;
+        }
+        id = (id * 10u) + (uint32_t)(value[index] - '0');
+    }
+
+    *last_event_id = id;
+    return (id > 0);
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_get_client_id
+ *******************************************************************************
+ * Summary:
+ *  Hashes the ID of the client passed by the page as a query parameter into
+ *  the 32-bit key of the quota (FNV-1a).
+ *
+ * Parameters:
+ *  url_parameters - Pointer to the HTTP URL query string.
+ *
+ * Return:
+ *  uint32_t - Key of the client; never 0, which marks an unused quota entry.
+ *
+ *******************************************************************************/
+static uint32_t event_stream_get_client_id(const char *url_parameters)
+{
+    char *value = NULL;
+    uint32_t value_len = 0;
+    uint32_t hash = 2166136261u;
+
+    if ((NULL != url_parameters) && (NULL_CHARACTER_ASCII_VALUE != url_parameters[0]) &&
+        (CY_RSLT_SUCCESS == cy_http_server_get_query_parameter_value(url_parameters, EVENT_STREAM_CLIENT_PARAM,
+                                                                     &value, &value_len)) &&
+        (NULL != value))
+    {
+        for (uint32_t index = 0; index < value_len; index++)
+        {
+            hash = (hash ^ (uint8_t)value[index]) * 16777619u;
+        }
+    }
+
+    return (0 != hash) ? hash : 1u;
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_replay
+ *******************************************************************************
+ * Summary:
+ *  Writes the events published after last_event_id to the stream, in writes of
+ *  up to EVENT_STREAM_REPLAY_BATCH events. If those events are no longer in the
+ *  history ring, a single reset event is written instead. Must be called with
+ *  event_stream_mutex held.
+ *
+ * Parameters:
+ *  stream - Pointer to the HTTP response stream.
+ *  last_event_id - ID of the last event received by the client.
+ *  replay_len - Pointer to store the number of bytes written.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the missed events are written
+ *  successfully, otherwise, it returns the HTTP server error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t event_stream_replay(cy_http_response_stream_t *stream, uint32_t last_event_id, uint32_t *replay_len)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t latest_id = next_event_id - 1;
+    uint32_t oldest_id = (next_event_id > EVENT_STREAM_HISTORY_DEPTH) ?
+                         (next_event_id - EVENT_STREAM_HISTORY_DEPTH) : 1;
+    uint32_t batch_len = 0;
+    uint32_t length;
+    char reset_data[12];
+    event_stream_record_t *record;
+
+    *replay_len = 0;
+
+    if (last_event_id == latest_id)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    /* The gap has fallen out of the history ring, or the ID is from before a
+     * reboot of the device. Tell the client that it missed events.
+     */
+    if ((last_event_id + 1 < oldest_id) || (last_event_id > latest_id))
+    {
+        length = (uint32_t)snprintf(reset_data, sizeof(reset_data), "%lu", (unsigned long)latest_id);
+        batch_len = event_stream_format(event_replay_buffer, sizeof(event_replay_buffer), latest_id,
+                                        EVENT_STREAM_RESET_EVENT, reset_data, length);
+        *replay_len = batch_len;
+        return cy_http_server_response_stream_write_payload(stream, event_replay_buffer, batch_len);
+    }
+
+    for (uint32_t id = last_event_id + 1; (id <= latest_id) && (CY_RSLT_SUCCESS == result); id++)
+    {
+        record = &event_history[id % EVENT_STREAM_HISTORY_DEPTH];
+        length = event_stream_format(&event_replay_buffer[batch_len], sizeof(event_replay_buffer) - batch_len,
+                                     record->id, record->name, record->data, record->data_len);
+        batch_len += length;
+
+        /* Write the batch when it is full or holds the latest event. */
+        if ((id == latest_id) || ((sizeof(event_replay_buffer) - batch_len) < EVENT_STREAM_MAX_EVENT_LEN))
+        {
+            result = cy_http_server_response_stream_write_payload(stream, event_replay_buffer, batch_len);
+            *replay_len += batch_len;
+            batch_len = 0;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the event stream.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the event stream is initialized
+ *  successfully, otherwise, it returns the RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t event_stream_init(void)
+{
+    memset(event_subscribers, 0, sizeof(event_subscribers));
+    next_event_id = 1;
+    conn_quota_init(&event_stream_quota, EVENT_STREAM_MAX_SUBSCRIBERS, EVENT_STREAM_MAX_STREAMS_PER_CLIENT,
+                    EVENT_STREAM_RESERVED_STREAMS);
+
+    return cy_rtos_init_mutex(&event_stream_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_resource_handler
+ *******************************************************************************
+ * Summary:
+ *  Handles the HTTP GET request for the event stream. The response is sent with
+ *  chunked transfer encoding and is kept open to send the events. If the client
+ *  passes the ID of the last event it received, the missed events are replayed
+ *  in one write before the client receives the live events. A stream over the
+ *  quota of its client, or over EVENT_STREAM_MAX_ACCEPTS in the current
+ *  window, is answered with 503 Service Unavailable.
+ *
+ * Parameters:
+ *  url_path - Pointer to the HTTP URL path.
+ *  url_parameters - Pointer to the HTTP URL query string.
+ *  stream - Pointer to the HTTP response stream.
+ *  arg - Pointer to the binding of the route to the interface of the server.
+ *  http_message_body - Pointer to the HTTP data from the client.
+ *
+ * Return:
+ *  int32_t - Returns HTTP_REQUEST_HANDLE_SUCCESS if the request from the client
+ *  was handled successfully. Otherwise, it returns HTTP_REQUEST_HANDLE_ERROR.
+ *
+ *******************************************************************************/
+int32_t event_stream_resource_handler(const char *url_path,
+                                      const char *url_parameters,
+                                      cy_http_response_stream_t *stream,
+                                      void *arg,
+                                      cy_http_message_body_t *http_message_body)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    event_stream_subscriber_t *subscriber = NULL;
+    uint32_t last_event_id = 0;
+    uint32_t replay_len = 0;
+    uint32_t client_id;
+    bool resume_requested;
+    cy_time_t now;
+
+    resume_requested = event_stream_get_last_event_id(url_parameters, &last_event_id);
+    client_id = event_stream_get_client_id(url_parameters);
+
+    /* Reserve a subscriber slot within the quota of the client and the
+     * streams accepted in the window.
+     */
+    cy_rtos_get_mutex(&event_stream_mutex, CY_RTOS_NEVER_TIMEOUT);
+    cy_rtos_get_time(&now);
+    if ((now - event_stream_window_start) >= EVENT_STREAM_ACCEPT_WINDOW_MSEC)
+    {
+        event_stream_window_start = now;
+        event_stream_window_accepts = 0;
+    }
+
+    for (uint32_t index = 0; index < EVENT_STREAM_MAX_SUBSCRIBERS; index++)
+    {
+        if (NULL == event_subscribers[index].stream)
+        {
+            subscriber = &event_subscribers[index];
+            break;
+        }
+    }
+
+    if ((NULL == subscriber) || (event_stream_window_accepts >= EVENT_STREAM_MAX_ACCEPTS))
+    {
+        event_stream_rate_limited += (NULL != subscriber) ? 1u : 0u;
+        subscriber = NULL;
+        conn_quota_reject(&event_stream_quota, client_id);
+    }
+    else if (!conn_quota_acquire(&event_stream_quota, client_id))
+    {
+        subscriber = NULL;
+    }
+    else
+    {
+        event_stream_window_accepts++;
+        subscriber->stream = stream;
+        subscriber->client_id = client_id;
+        subscriber->interface = (NULL != arg) ? (uint32_t)((const http_route_binding_t *)arg)->interface :
+                                (uint32_t)HTTP_INTERFACE_AP;
+        subscriber->active = false;
+    }
+    cy_rtos_set_mutex(&event_stream_mutex);
+
+    if (NULL == subscriber)
+    {
+        ERR_INFO(("Event stream rejected by the quota.\n"));
+        cy_http_server_response_stream_write_payload(stream, EVENT_STREAM_BUSY_RESPONSE,
+                                                     sizeof(EVENT_STREAM_BUSY_RESPONSE) - 1);
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+
+    /* Enable chunked transfer encoding on the HTTP stream. */
+    result = cy_http_server_response_stream_enable_chunked_transfer(stream);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_http_server_response_stream_write_header(stream, CY_HTTP_200_TYPE, CHUNKED_CONTENT_LENGTH,
+                                                             CY_HTTP_CACHE_DISABLED, CY_HTTP_MIME_TYPE_TEXT_EVENT_STREAM);
+    }
+
+    cy_rtos_get_mutex(&event_stream_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    /* The slot was released if the server drained in the meantime. */
+    if (stream != subscriber->stream)
+    {
+        cy_rtos_set_mutex(&event_stream_mutex);
+        ERR_INFO(("Event stream closed while it was starting.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+
+    /* Replay under the lock so that no event is published between the replayed
+     * events and the first live event.
+     */
+    if ((CY_RSLT_SUCCESS == result) && resume_requested)
+    {
+        result = event_stream_replay(stream, last_event_id, &replay_len);
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        subscriber->active = true;
+        subscriber->stalled_writes = 0;
+        cy_rtos_get_time(&subscriber->last_write_time);
+    }
+    else
+    {
+        conn_quota_release(&event_stream_quota, subscriber->client_id);
+        subscriber->stream = NULL;
+    }
+
+    cy_rtos_set_mutex(&event_stream_mutex);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to start the HTTP event stream.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+
+    if (resume_requested)
+    {
+        APP_INFO(("Event stream resumed after ID %lu, replayed %lu bytes.\n", (unsigned long)last_event_id, (unsigned long)replay_len));
+    }
+
+    return HTTP_REQUEST_HANDLE_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_publish
+ *******************************************************************************
+ * Summary:
+ *  Assigns the next ID to an event, stores it in the history ring, and sends it
+ *  to all the clients receiving the event stream. A client whose write fails or
+ *  stalls is reaped; it resumes from its last event ID when it reconnects.
+ *
+ * Parameters:
+ *  event_name - Name of the event, or NULL for the default "message" event. The
+ *               string must remain valid while the event is in the history.
+ *  data - Data of the event.
+ *  data_len - Length of the data, at most EVENT_STREAM_MAX_DATA_LEN.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the event is published successfully,
+ *  otherwise, it returns CY_RSLT_TYPE_ERROR.
+ *
+ *******************************************************************************/
+cy_rslt_t event_stream_publish(const char *event_name, const char *data, uint32_t data_len)
+{
+    event_stream_record_t *record;
+    uint32_t tx_len = 0;
+
+    if ((NULL == data) || (data_len > EVENT_STREAM_MAX_DATA_LEN))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    cy_rtos_get_mutex(&event_stream_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    record = &event_history[next_event_id % EVENT_STREAM_HISTORY_DEPTH];
+    record->id = next_event_id++;
+    record->name = event_name;
+    record->data_len = data_len;
+    memcpy(record->data, data, data_len);
+
+    for (uint32_t index = 0; index < EVENT_STREAM_MAX_SUBSCRIBERS; index++)
+    {
+        if (!event_subscribers[index].active)
+        {
+            continue;
+        }
+
+        /* Format the event once for all the subscribers. */
+        if (0 == tx_len)
+        {
+            tx_len = event_stream_format(event_tx_buffer, sizeof(event_tx_buffer), record->id,
+                                         record->name, record->data, record->data_len);
+            if (0 == tx_len)
+            {
+                break;
+            }
+        }
+
+        event_stream_write(&event_subscribers[index], event_tx_buffer, tx_len);
+    }
+
+    cy_rtos_set_mutex(&event_stream_mutex);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_send_heartbeat
+ *******************************************************************************
+ * Summary:
+ *  Sends a comment to every subscriber that has not been written to for
+ *  EVENT_STREAM_HEARTBEAT_INTERVAL_MSEC, so that a peer that went away is
+ *  detected and reaped even when no events are published.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void event_stream_send_heartbeat(void)
+{
+    cy_time_t now;
+
+    cy_rtos_get_mutex(&event_stream_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    cy_rtos_get_time(&now);
+    for (uint32_t index = 0; index < EVENT_STREAM_MAX_SUBSCRIBERS; index++)
+    {
+        if ((event_subscribers[index].active) &&
+            ((now - event_subscribers[index].last_write_time) >= EVENT_STREAM_HEARTBEAT_INTERVAL_MSEC))
+        {
+            heartbeat_count++;
+            event_stream_write(&event_subscribers[index], EVENT_STREAM_HEARTBEAT, sizeof(EVENT_STREAM_HEARTBEAT) - 1);
+        }
+    }
+
+    cy_rtos_set_mutex(&event_stream_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_close_interface
+ *******************************************************************************
+ * Summary:
+ *  Closes the connections of the subscribers served by the HTTP server of an
+ *  interface, so that no subscriber refers to a response stream of the
+ *  server once it is stopped and deleted. The clients resume from their last
+ *  event ID when they reconnect. A slot reserved by a handler that has not
+ *  started its stream yet is released too, and the handler then fails; its
+ *  connection is closed with the server.
+ *
+ * Parameters:
+ *  interface - Interface of the HTTP server (http_interface_t).
+ *
+ * Return:
+ *  uint32_t - Number of subscribers closed.
+ *
+ *******************************************************************************/
+uint32_t event_stream_close_interface(uint32_t interface)
+{
+    uint32_t closed = 0;
+
+    cy_rtos_get_mutex(&event_stream_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    for (uint32_t index = 0; index < EVENT_STREAM_MAX_SUBSCRIBERS; index++)
+    {
+        if ((NULL != event_subscribers[index].stream) && (interface == event_subscribers[index].interface))
+        {
+            if (event_subscribers[index].active)
+            {
+                cy_http_server_response_stream_disconnect(event_subscribers[index].stream);
+            }
+            conn_quota_release(&event_stream_quota, event_subscribers[index].client_id);
+            event_subscribers[index].stream = NULL;
+            event_subscribers[index].active = false;
+            event_subscribers[index].stalled_writes = 0;
+            closed++;
+        }
+    }
+
+    cy_rtos_set_mutex(&event_stream_mutex);
+
+    return closed;
+}
+
+/*******************************************************************************
+ * Function Name: event_stream_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the statistics of the event stream.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void event_stream_get_stats(event_stream_stats_t *stats)
+{
+    cy_rtos_get_mutex(&event_stream_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    stats->active_subscribers = 0;
+    for (uint32_t index = 0; index < EVENT_STREAM_MAX_SUBSCRIBERS; index++)
+    {
+        if (event_subscribers[index].active)
+        {
+            stats->active_subscribers++;
+        }
+    }
+    stats->reaped_subscribers = reaped_subscriber_count;
+    stats->stalled_writes = stalled_write_count;
+    stats->heartbeats_sent = heartbeat_count;
+    stats->last_event_id = next_event_id - 1;
+    stats->accepted = event_stream_quota.accepted;
+    stats->rejected = event_stream_quota.rejected;
+    stats->rate_limited = event_stream_rate_limited;
+    memcpy(stats->clients, event_stream_quota.clients, sizeof(stats->clients));
+
+    cy_rtos_set_mutex(&event_stream_mutex);
+}
+
+/* [] END OF FILE */
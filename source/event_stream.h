@@ -0,0 +1,160 @@
+/******************************************************************************
+* File Name: event_stream.h
+*
+* Description: This file contains the configuration parameters and function
+*              prototypes of the HTTP server-sent event (SSE) stream used to
+*              send device data to the clients.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef EVENT_STREAM_H_
+#define EVENT_STREAM_H_
+
+#include "cy_http_server.h"
+#include "conn_quota.h"
+
+/* URL of the HTTP event stream resource. */
+#define EVENT_STREAM_URL                             "/events"
+
+/* Query parameter carrying the ID of the last event received by the client.
+ * The HTTP server library does not pass request headers to the resource
+ * handler, so the page sends the Last-Event-ID value as a query parameter
+ * when it reconnects.
+ */
+#define EVENT_STREAM_LAST_ID_PARAM                   "last_event_id"
+
+/* While a WebSocket client is connected, the device data is published to the
+ * event stream at most once per EVENT_STREAM_DATA_INTERVAL_MSEC, and the
+ * WebSocket carries it at the full upload rate. The history ring then keeps
+ * the device data of the last EVENT_STREAM_HISTORY_SEC seconds plus
+ * EVENT_STREAM_HISTORY_SPARE Wi-Fi state and SoftAP events published in that
+ * time. Otherwise the event stream carries the device data at the upload
+ * rate, and the ring covers a shorter time.
+ */
+#define EVENT_STREAM_DATA_INTERVAL_MSEC              (1000u)
+#define EVENT_STREAM_HISTORY_SEC                     (30u)
+#define EVENT_STREAM_HISTORY_SPARE                   (6u)
+#define EVENT_STREAM_HISTORY_DEPTH                   ((EVENT_STREAM_HISTORY_SEC * 1000u / EVENT_STREAM_DATA_INTERVAL_MSEC) + \
+                                                      EVENT_STREAM_HISTORY_SPARE)
+
+/* Maximum length of the data field of a single event; fits the device data
+ * in text format (TELEMETRY_MAX_TEXT_LEN).
+ */
+#define EVENT_STREAM_MAX_DATA_LEN                    (56u)
+
+/* Maximum number of clients receiving the event stream at the same time.
+ * Each of them holds one of the MAX_SOCKETS connections of the HTTP server.
+ */
+#define EVENT_STREAM_MAX_SUBSCRIBERS                 (2u)
+
+/* Query parameter carrying the ID that the page keeps in the local storage of
+ * the browser. The HTTP server library does not expose the address of the
+ * client, so the quota of the event stream is applied to this ID: a client
+ * may hold EVENT_STREAM_MAX_STREAMS_PER_CLIENT streams, and the last
+ * EVENT_STREAM_RESERVED_STREAMS are kept for clients that hold none. The
+ * requests without an ID share one quota.
+ */
+#define EVENT_STREAM_CLIENT_PARAM                    "client"
+#define EVENT_STREAM_MAX_STREAMS_PER_CLIENT          (1u)
+#define EVENT_STREAM_RESERVED_STREAMS                (1u)
+
+/* The ID is chosen by the client, so a client that changes it passes the
+ * quota of each ID. Whatever the ID, at most EVENT_STREAM_MAX_SUBSCRIBERS
+ * streams are open, and at most EVENT_STREAM_MAX_ACCEPTS streams are
+ * accepted per EVENT_STREAM_ACCEPT_WINDOW_MSEC, so that such a client cannot
+ * take each stream as soon as it is closed.
+ */
+#define EVENT_STREAM_MAX_ACCEPTS                     (4u)
+#define EVENT_STREAM_ACCEPT_WINDOW_MSEC              (10000u)
+
+/* Size of a formatted event: "id: <10 digits>\nevent: <name>\ndata: <data>\n\n" */
+#define EVENT_STREAM_MAX_NAME_LEN                    (16u)
+#define EVENT_STREAM_MAX_EVENT_LEN                   (EVENT_STREAM_MAX_DATA_LEN + EVENT_STREAM_MAX_NAME_LEN + 32u)
+
+/* The missed events are replayed to a reconnecting client in writes of up to
+ * EVENT_STREAM_REPLAY_BATCH events.
+ */
+#define EVENT_STREAM_REPLAY_BATCH                    (4u)
+#define EVENT_STREAM_REPLAY_BUFFER_LENGTH            (EVENT_STREAM_REPLAY_BATCH * EVENT_STREAM_MAX_EVENT_LEN)
+
+/* Macros used to format the fields of an event. */
+#define EVENT_STREAM_ID                              "id: "
+#define EVENT_STREAM_EVENT                           "event: "
+
+/* Name of the event sent when the missed events are no longer in the history. */
+#define EVENT_STREAM_RESET_EVENT                     "reset"
+
+/* Comment sent to an idle subscriber so that a dead peer is detected even
+ * when no events are published.
+ */
+#define EVENT_STREAM_HEARTBEAT                       ":" LFLF
+#define EVENT_STREAM_HEARTBEAT_INTERVAL_MSEC         (5000u)
+
+/* A write that takes longer than this made no progress because the peer is
+ * not reading. A subscriber is closed after EVENT_STREAM_MAX_STALLED_WRITES
+ * such writes in a row, or on the first write that fails.
+ */
+#define EVENT_STREAM_STALLED_WRITE_MSEC              (500u)
+#define EVENT_STREAM_MAX_STALLED_WRITES              (3u)
+
+/* Statistics of the event stream reported in the metrics. */
+typedef struct
+{
+    uint32_t active_subscribers;
+    uint32_t reaped_subscribers;
+    uint32_t stalled_writes;
+    uint32_t heartbeats_sent;
+    uint32_t last_event_id;
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t rate_limited;
+    conn_quota_client_t clients[CONN_QUOTA_MAX_CLIENTS];
+} event_stream_stats_t;
+
+
+cy_rslt_t event_stream_init(void);
+int32_t event_stream_resource_handler(const char *url_path,
+                                      const char *url_parameters,
+                                      cy_http_response_stream_t *stream,
+                                      void *arg,
+                                      cy_http_message_body_t *http_message_body);
+cy_rslt_t event_stream_publish(const char *event_name, const char *data, uint32_t data_len);
+void event_stream_send_heartbeat(void);
+uint32_t event_stream_close_interface(uint32_t interface);
+void event_stream_get_stats(event_stream_stats_t *stats);
+
+
+#endif /* EVENT_STREAM_H_ */
+
+/* [] END OF FILE */
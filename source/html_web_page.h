@@ -91,6 +91,31 @@
            "<div class=\"topleft\"></div> " \
     "</div>"
 
+/* Optional static IP configuration of the STA interface. Leave the IP address
+ * empty to use DHCP.
+ */
+#define WIFI_STATIC_IP_FIELDS \
+    "<details>" \
+        "<summary>Static IP (optional)</summary>" \
+        "<label><b>IP address</b></label></br>" \
+        "<input type=\"text\" placeholder=\"192.168.1.50\" name=\"IP\" size=\"30\" /></br>" \
+        "<label><b>Netmask</b></label></br>" \
+        "<input type=\"text\" placeholder=\"255.255.255.0\" name=\"Netmask\" size=\"30\" /></br>" \
+        "<label><b>Gateway</b></label></br>" \
+        "<input type=\"text\" placeholder=\"192.168.1.1\" name=\"Gateway\" size=\"30\" /></br>" \
+    "</details></br>"
+
+/* Keeps an ID of the browser in its local storage. The pages pass it to the
+ * event stream, whose quota is applied per client ID.
+ */
+#define EVENT_STREAM_CLIENT_SCRIPT \
+    "var client_id = \"\";" \
+    "try { client_id = localStorage.getItem(\"client_id\") || \"\"; } catch (e) {}" \
+    "if (!client_id) {" \
+        "client_id = Math.random().toString(36).slice(2, 10);" \
+        "try { localStorage.setItem(\"client_id\", client_id); } catch (e) {}" \
+    "}"
+
 /* Landing page, user input Wi-Fi network and credentials */
 #define HTTP_SOFTAP_STARTUP_WEBPAGE \
               "<!DOCTYPE html>" \
@@ -104,13 +129,15 @@
                     "<fieldset>" \
                         "<legend>Enter Credentials</legend>" \
                         "<label><b>SSID </b></label></br>"\
-                        "<input type=\"text\" placeholder=\"Enter SSID\" name=\"SSID\" size=\"30\" /></br></br>" \
+                        "<input type=\"text\" placeholder=\"Enter SSID\" name=\"SSID\" size=\"30\" maxlength=\"32\" /></br></br>" \
                         "<label><b> Password</b></label></br>"\
-                        "<input type=\"password\" placeholder=\"Enter Password\" name=\"Password\" size=\"30\" minlength=\"8\" /></br></br>" \
+                        "<input type=\"password\" placeholder=\"Enter Password\" name=\"Password\" size=\"30\" minlength=\"8\" maxlength=\"63\" /></br></br>" \
+                        WIFI_STATIC_IP_FIELDS \
                         "<input type=\"submit\" name=\"submit\" value=\"Connect to Wi-Fi\"/></br></br>" \
                     "</fieldset>" \
                     "</br>" \
                 "</form>" \
+                "<a href=\"/wifi_scan\">Show the available APs</a>" \
               "</body>" \
               "</html>"
 
@@ -128,7 +155,7 @@
     "<script>" \
     "function wifi_scan(){ " \
     "var wifi_obj = document.getElementById(\"wifi_scan_stat\");" \
-    "wifi_obj.remove();" \
+    "if (wifi_obj) { wifi_obj.remove(); }" \
     "}" \
     "wifi_scan();" \
     "</script>" \
@@ -144,7 +171,10 @@
       "width: 450px; height: 180px;\">"
 
 
-#define SOFTAP_SCAN_INTERMEDIATE_RESPONSE    "</textarea></body>"
+/* Text of the AP list when no AP is found. */
+#define WIFI_SCAN_NO_AP                      "No APs found yet. Reload the page in a few seconds."
+
+#define SOFTAP_SCAN_INTERMEDIATE_RESPONSE    "</textarea></br><a href=\"/wifi_scan?fresh=1\">Scan again</a></body>"
 
 #define SOFTAP_SCAN_END_RESPONSE \
     "<body>" \
@@ -153,9 +183,10 @@
        "<fieldset>" \
             "<legend>Enter Credentials</legend>" \
             "<label><b>SSID </b></label></br>"\
-            "<input type=\"text\" placeholder=\"Enter SSID\" name=\"SSID\" size=\"30\" /></br></br>" \
+            "<input type=\"text\" placeholder=\"Enter SSID\" name=\"SSID\" size=\"30\" maxlength=\"32\" /></br></br>" \
             "<label><b> Password</b></label></br>"\
-            "<input type=\"password\" placeholder=\"Enter Password\" name=\"Password\" size=\"30\" minlength=\"8\" /></br></br>" \
+            "<input type=\"password\" placeholder=\"Enter Password\" name=\"Password\" size=\"30\" minlength=\"8\" maxlength=\"63\" /></br></br>" \
+            WIFI_STATIC_IP_FIELDS \
             "<input type=\"submit\" name=\"submit\" value=\"Connect to Wi-Fi\"/></br></br>" \
         "</fieldset>" \
     "</form>" \
@@ -197,6 +228,17 @@
 
 #define WIFI_CONNECT_SUCCESS_RESPONSE_END \
     "<h1>Successfully connected to Wi-Fi</h1>" \
+    "<p id=\"softap_notice\"></p>" \
+    "<script>" \
+    EVENT_STREAM_CLIENT_SCRIPT \
+    "if (typeof(EventSource) !== \"undefined\") {" \
+        "var softap_events = new EventSource(\"/events?client=\" + client_id);" \
+        "softap_events.addEventListener(\"softap\", function(event) {" \
+            "document.getElementById(\"softap_notice\").innerHTML = \"The SoftAP is moving to \" + event.data + \". Reconnect to it if this page stops responding.\";" \
+            "softap_events.close();" \
+        "});" \
+    "}" \
+    "</script>" \
     "<form action=\"/\" method=\"get\">" \
         "<fieldset>" \
             "<p>Click the button to redirect to homepage...</p>" \
@@ -204,7 +246,7 @@
         "</fieldset>" \
         "</br>" \
     "</form>" \
-    "<form action=\"/wifi_scan_form\" method=\"post\">" \
+    "<form action=\"" DEVICE_DATA_REDIRECT_URL "\" method=\"post\">" \
         "<fieldset>" \
             "<input type=\"submit\" name=\"submit\" value=\"Display Device Data\"/></br></br>" \
         "</fieldset>" \
@@ -223,8 +265,8 @@
             "<p>" \
                 "To view the device data please connect your PC to the same Wi-Fi network to which " \
                  "you have connected the device. Open the web browser of your choice and enter " \
-                 "the URL http://<i><b>IP address</i></b>:80, where <i><b>IP address</i></b> is " \
-                 "the one that is displayed on the UART terminal." \
+                 "the URL http://" MDNS_HOSTNAME "." MDNS_DOMAIN "/ or http://<i><b>IP address</i></b>:80, " \
+                 "where <i><b>IP address</i></b> is the one that is displayed on the UART terminal." \
             "</p>" \
         "</body>" \
     "</html>"
@@ -243,6 +285,9 @@
             "<br><br>" \
             "<br><br>" \
             "<div id=\"device_data\" value=\"100\"></div>" \
+            "<p id=\"round_trip\"></p>" \
+            "<p id=\"wifi_state\"></p>" \
+            "<p id=\"softap_notice\"></p>" \
             "<script>" \
                 " function btn_disable_function() {" \
                 " var increase_btn_id = document.getElementById(\"increase_btn\");" \
@@ -259,35 +304,139 @@
                     " decrease_btn_id.disabled = false;" \
                     " },1000);" \
                 " }" \
-            "function increase() { " \
+            "var ws = null;" \
+            "var ws_seq = 0;" \
+            "var ws_sent_time = {};" \
+            "var event_source = null;" \
+            "var last_event_id = 0;" \
+            "var event_retry_msec = 1000;" \
+            "var event_retry_timer = null;" \
+            EVENT_STREAM_CLIENT_SCRIPT \
+            "function show_round_trip(transport, start) {" \
+                "document.getElementById(\"round_trip\").innerHTML = \"Last command round trip: \" +" \
+                    "(performance.now() - start).toFixed(1) + \" ms (\" + transport + \")\";" \
+            "} " \
+            "function send_command(ws_command, command) { " \
+                "if (ws && ws.readyState === 1) { " \
+                    "ws_seq = (ws_seq + 1) & 0xFFFF; " \
+                    "ws_sent_time[ws_seq] = performance.now(); " \
+                    "ws.send(new Uint8Array([ws_command, ws_seq >> 8, ws_seq & 0xFF])); " \
+                    "return; " \
+                "} " \
                 " btn_disable_function();" \
+                " var start = performance.now(); " \
                 " var xhttp = new XMLHttpRequest(); "\
                 " xhttp.onreadystatechange = function() { "\
-                    "   if (this.readyState === 4 && this.status == 200) { " \
+                    "   if (this.readyState === 4) { " \
+                        "   show_round_trip(\"HTTP\", start); " \
                         "   } "\
                     "}; "\
                     "xhttp.open(\"POST\", \"/\", true); "\
                     "xhttp.setRequestHeader(\"Content-type\", \"application/x-www-form-urlencoded\"); "\
-                    "xhttp.send(\"Increase\");"\
-            "} "\
-            "function decrease() { " \
-                "  btn_disable_function();" \
-                "  var xhttp = new XMLHttpRequest(); " \
-                "  xhttp.onreadystatechange = function() { " \
-                    "    if (this.readyState === 4 && this.status == 200) { " \
-                    "    } " \
-                    "  }; " \
-                    "xhttp.open(\"POST\", \"/\", true); " \
-                    "xhttp.setRequestHeader(\"Content-type\", \"application/x-www-form-urlencoded\"); "\
-                    "xhttp.send(\"Decrease\"); " \
+                    "xhttp.send(command);"\
             "} "\
-        "if(typeof(EventSource) !== \"undefined\") {" \
-            "var source = new EventSource(\"/events\");" \
-            "source.onmessage = function(event) {" \
+            "function increase() { send_command(1, \"Increase\"); } " \
+            "function decrease() { send_command(2, \"Decrease\"); } " \
+            "function decode_telemetry(view, offset) {" \
+                "if (view.byteLength < offset + 2 || view.getUint8(offset) !== 1) { return null; }" \
+                "var present = view.getUint8(offset + 1);" \
+                "var sample = {};" \
+                "offset += 2;" \
+                "try {" \
+                    "if (present & 1) { sample.duty_cycle = view.getUint16(offset, true) / 10; offset += 2; }" \
+                    "if (present & 2) { sample.uptime = view.getUint32(offset, true) / 100; offset += 4; }" \
+                    "if (present & 4) { sample.rssi = view.getInt8(offset); offset += 1; }" \
+                "} catch (e) { return null; }" \
+                "return sample;" \
+            "} " \
+            "function format_telemetry(sample) {" \
+                "var fields = [];" \
+                "if (\"duty_cycle\" in sample) { fields.push(\"Duty cycle: \" + Math.floor(sample.duty_cycle) + \"%\"); }" \
+                "if (\"rssi\" in sample) { fields.push(\"RSSI: \" + sample.rssi + \" dBm\"); }" \
+                "if (\"uptime\" in sample) { fields.push(\"Uptime: \" + sample.uptime.toFixed(2) + \" s\"); }" \
+                "return fields.join(\", \");" \
+            "} " \
+        "function show_event(name, data) {" \
+            "if (name === \"wifi\") {" \
+                "document.getElementById(\"wifi_state\").innerHTML = \"Wi-Fi: \" + data;" \
+            "} else if (name === \"softap\") {" \
+                "document.getElementById(\"softap_notice\").innerHTML = \"The SoftAP is moving to \" + data + \". Clients connected to it may briefly disconnect.\";" \
+            "}" \
+        "} " \
+        "function close_event_stream() {" \
+            "clearTimeout(event_retry_timer);" \
+            "event_retry_timer = null;" \
+            "if (event_source) { event_source.close(); event_source = null; }" \
+        "} " \
+        "function connect_event_stream() {" \
+            "var url = \"/events?client=\" + client_id;" \
+            "event_retry_timer = null;" \
+            "if (last_event_id > 0) { url += \"&last_event_id=\" + last_event_id; }" \
+            "event_source = new EventSource(url);" \
+            "event_source.onopen = function() { event_retry_msec = 1000; };" \
+            "event_source.onmessage = function(event) {" \
+                "last_event_id = event.lastEventId;" \
                 "document.getElementById(\"device_data\").innerHTML = event.data;" \
                 "  };" \
+            "event_source.addEventListener(\"reset\", function(event) {" \
+                "last_event_id = event.lastEventId;" \
+                "document.getElementById(\"device_data\").innerHTML = \"Some device data was missed while disconnected.\";" \
+                "  });" \
+            "[\"wifi\", \"softap\"].forEach(function(name) {" \
+                "event_source.addEventListener(name, function(event) {" \
+                    "last_event_id = event.lastEventId;" \
+                    "show_event(name, event.data);" \
+                    "  });" \
+                "});" \
+            "event_source.onerror = function() {" \
+                "close_event_stream();" \
+                "event_retry_timer = setTimeout(connect_event_stream, event_retry_msec);" \
+                "event_retry_msec = Math.min(event_retry_msec * 2, 30000);" \
+                "  };" \
+        "}" \
+        "function fall_back_to_event_stream() {" \
+            "if (typeof(EventSource) === \"undefined\") {" \
+                "document.getElementById(\"device_data\").innerHTML = \"Sorry, your browser does not support server-sent events...\";" \
+            "} else if (!event_source && !event_retry_timer) {" \
+                "connect_event_stream();" \
+            "}" \
+        "}" \
+        "function connect_websocket() {" \
+            "ws = new WebSocket(\"ws://\" + location.hostname + \":81/ws\");" \
+            "ws.binaryType = \"arraybuffer\";" \
+            "ws.onopen = function() {" \
+                "close_event_stream();" \
+                "last_event_id = 0;" \
+                "  };" \
+            "ws.onmessage = function(event) {" \
+                "if (typeof(event.data) === \"string\") {" \
+                    "document.getElementById(\"device_data\").innerHTML = event.data;" \
+                    "return;" \
+                "}" \
+                "var data = new Uint8Array(event.data);" \
+                "if (data[0] === 0x80) {" \
+                    "var sample = decode_telemetry(new DataView(event.data), 1);" \
+                    "if (sample) { document.getElementById(\"device_data\").innerHTML = format_telemetry(sample); }" \
+                "} else if (data[0] === 0x81) {" \
+                    "var seq = (data[1] << 8) | data[2];" \
+                    "if (seq in ws_sent_time) { show_round_trip(\"WebSocket\", ws_sent_time[seq]); delete ws_sent_time[seq]; }" \
+                    "document.getElementById(\"device_data\").innerHTML = \"Duty cycle: \" + data[3] + \"%\";" \
+                "} else if (data[0] === 0x82 && data.length >= 2 + data[1]) {" \
+                    "var text = new TextDecoder().decode(data.subarray(2));" \
+                    "show_event(text.substring(0, data[1]), text.substring(data[1]));" \
+                "}" \
+                "  };" \
+            "ws.onclose = function() {" \
+                "ws = null;" \
+                "ws_sent_time = {};" \
+                "fall_back_to_event_stream();" \
+                "setTimeout(connect_websocket, 5000);" \
+                "  };" \
+        "}" \
+        "if(typeof(WebSocket) !== \"undefined\") {" \
+            "connect_websocket();" \
         "} else {" \
-            "document.getElementById(\"device_data\").innerHTML = \"Sorry, your browser does not support server-sent events...\";" \
+            "fall_back_to_event_stream();" \
         "}" \
         "</script>" \
         "</body>" \
@@ -0,0 +1,220 @@
+/*******************************************************************************
+ * File Name: ip_config.c
+ *
+ * Description: This file contains the selection of the IP settings of the STA
+ *              interface: a provisioned static configuration, or DHCP.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "ip_config.h"
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Static configuration provisioned through the connect form. */
+static bool ip_static_valid = false;
+static cy_wcm_ip_setting_t ip_static;
+
+/* IP settings passed to the current connection and their source. */
+static cy_wcm_ip_setting_t ip_selected;
+static volatile ip_config_source_t ip_source = IP_CONFIG_SOURCE_DHCP;
+
+/* Names of the IP settings sources used in the metrics. */
+static const char *ip_source_names[] =
+{
+    "dhcp",
+    "static"
+};
+
+/*******************************************************************************
+ * Function Name: ip_config_set_static
+ *******************************************************************************
+ * Summary:
+ *  Sets or clears the static IP configuration of the STA interface.
+ *
+ * Parameters:
+ *  settings - Pointer to the static IP settings, or NULL to use DHCP.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void ip_config_set_static(const cy_wcm_ip_setting_t *settings)
+{
+    if (NULL == settings)
+    {
+        ip_static_valid = false;
+        return;
+    }
+
+    ip_static = *settings;
+    ip_static_valid = true;
+}
+
+/*******************************************************************************
+ * Function Name: ip_config_get_static
+ *******************************************************************************
+ * Summary:
+ *  Returns the static IP configuration of the STA interface, if any.
+ *
+ * Parameters:
+ *  settings - Pointer to store the static IP settings.
+ *
+ * Return:
+ *  bool - true if a static IP configuration is set.
+ *
+ *******************************************************************************/
+bool ip_config_get_static(cy_wcm_ip_setting_t *settings)
+{
+    if (ip_static_valid)
+    {
+        *settings = ip_static;
+    }
+
+    return ip_static_valid;
+}
+
+/*******************************************************************************
+ * Function Name: ip_config_select
+ *******************************************************************************
+ * Summary:
+ *  Selects the IP settings of a connection: the static configuration if
+ *  set, or DHCP.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_wcm_ip_setting_t * - IP settings to pass as the static_ip_settings of
+ *  the connect parameters, or NULL to use DHCP.
+ *
+ *******************************************************************************/
+cy_wcm_ip_setting_t *ip_config_select(void)
+{
+    if (ip_static_valid)
+    {
+        ip_selected = ip_static;
+        ip_source = IP_CONFIG_SOURCE_STATIC;
+        return &ip_selected;
+    }
+
+    ip_source = IP_CONFIG_SOURCE_DHCP;
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: ip_config_parse_ipv4
+ *******************************************************************************
+ * Summary:
+ *  Parses a dotted-decimal IPv4 address.
+ *
+ * Parameters:
+ *  text - Pointer to the terminated address.
+ *  address - Pointer to store the address.
+ *
+ * Return:
+ *  bool - true if the text is a valid IPv4 address.
+ *
+ *******************************************************************************/
+bool ip_config_parse_ipv4(const char *text, cy_wcm_ip_address_t *address)
+{
+    uint32_t value = 0;
+    uint32_t octet;
+    uint32_t digits;
+    uint32_t index;
+
+    for (index = 0; index < 4u; index++)
+    {
+        octet = 0;
+        for (digits = 0; (*text >= '0') && (*text <= '9'); digits++)
+        {
+            octet = (octet * 10u) + (uint32_t)(*text++ - '0');
+            if ((digits >= 3u) || (octet > 255u))
+            {
+                return false;
+            }
+        }
+
+        if ((0 == digits) || (*text != ((index < 3u) ? '.' : '\0')))
+        {
+            return false;
+        }
+        text++;
+
+        value |= octet << (8u * index);
+    }
+
+    address->version = CY_WCM_IP_VER_V4;
+    address->ip.v4 = value;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: ip_config_source_name
+ *******************************************************************************
+ * Summary:
+ *  Returns the name of an IP settings source.
+ *
+ * Parameters:
+ *  source - Source of the IP settings.
+ *
+ * Return:
+ *  const char * - Name of the source.
+ *
+ *******************************************************************************/
+const char *ip_config_source_name(ip_config_source_t source)
+{
+    return (source <= IP_CONFIG_SOURCE_STATIC) ? ip_source_names[source] : "unknown";
+}
+
+/*******************************************************************************
+ * Function Name: ip_config_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the source of the IP settings of the last connection.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void ip_config_get_stats(ip_config_stats_t *stats)
+{
+    stats->source = ip_source;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,81 @@
+/******************************************************************************
+* File Name: ip_config.h
+*
+* Description: This file contains the configuration parameters, structures
+*              and function prototypes used to select the IP settings of the
+*              STA interface: a provisioned static configuration, or DHCP.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef IP_CONFIG_H_
+#define IP_CONFIG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_wcm.h"
+
+/* Only a static configuration provisioned by the user is passed to WCM as
+ * static IP settings. A DHCP lease is never reused that way: WCM would not
+ * renew it, and the DHCP server could give the address to another client
+ * once the lease expires.
+ */
+
+/* Maximum length of a dotted-decimal IPv4 address. */
+#define IP_CONFIG_IPV4_TEXT_LEN                      (15u)
+
+/* Source of the IP settings of the last connection. */
+typedef enum
+{
+    IP_CONFIG_SOURCE_DHCP = 0,
+    IP_CONFIG_SOURCE_STATIC
+} ip_config_source_t;
+
+/* Statistics of the IP settings reported in the metrics. */
+typedef struct
+{
+    ip_config_source_t source;
+} ip_config_stats_t;
+
+
+void ip_config_set_static(const cy_wcm_ip_setting_t *settings);
+bool ip_config_get_static(cy_wcm_ip_setting_t *settings);
+cy_wcm_ip_setting_t *ip_config_select(void);
+bool ip_config_parse_ipv4(const char *text, cy_wcm_ip_address_t *address);
+const char *ip_config_source_name(ip_config_source_t source);
+void ip_config_get_stats(ip_config_stats_t *stats);
+
+
+#endif /* IP_CONFIG_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,772 @@
+/*******************************************************************************
+ * File Name: mdns.c
+ *
+ * Description: This file contains the mDNS responder that advertises the host
+ *              name of the device and its HTTP service (DNS-SD) on the
+ *              network of the STA.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Secure Sockets header file */
+#include "cy_secure_sockets.h"
+
+/* HTTP server task header file. */
+#include "web_server.h"
+#include "mdns.h"
+
+/* Standard C header file */
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Full names of the records. */
+static const char mdns_host_name[] = MDNS_HOSTNAME "." MDNS_DOMAIN;
+static const char mdns_instance_name[] = MDNS_SERVICE_INSTANCE "." MDNS_SERVICE_TYPE;
+
+/* UDP socket of the responder. Valid while mdns_running is set. */
+static cy_socket_t mdns_socket;
+static volatile bool mdns_running = false;
+
+/* IP address advertised, in network byte order. */
+static uint32_t mdns_ip_address;
+
+/* Serializes the use of the socket by the mDNS task with its creation and
+ * deletion when the responder is started and stopped.
+ */
+static cy_mutex_t mdns_mutex;
+
+/* Response built when the responder starts, multicast as is. */
+static uint8_t mdns_response[MDNS_MAX_MESSAGE_LEN];
+static uint32_t mdns_response_len = 0;
+
+/* Buffer of the queries. */
+static uint8_t mdns_rx_buffer[MDNS_MAX_MESSAGE_LEN];
+
+/* Schedule of the responses. */
+static bool mdns_response_pending = false;
+static uint32_t mdns_announcements_left = 0;
+static cy_time_t mdns_last_response_time = 0;
+
+/* Statistics of the responder. */
+static volatile uint32_t mdns_queries = 0;
+static volatile uint32_t mdns_matched_queries = 0;
+static volatile uint32_t mdns_deferred_queries = 0;
+static volatile uint32_t mdns_responses = 0;
+static volatile uint32_t mdns_announcements = 0;
+
+/* Task that serves the mDNS queries. */
+static uint64_t mdns_task_stack[MDNS_TASK_STACK_SIZE / 8];
+static cy_thread_t mdns_task_handle;
+static bool mdns_task_created = false;
+
+/*******************************************************************************
+ * Function Name: mdns_put_name
+ *******************************************************************************
+ * Summary:
+ *  Writes a name in the DNS label format: an optional first label that may
+ *  contain dots, such as a service instance, followed by a dotted domain.
+ *
+ * Parameters:
+ *  buf - Buffer of the message.
+ *  offset - Offset of the name in the buffer.
+ *  buf_len - Size of the buffer.
+ *  label - First label, or NULL.
+ *  domain - Dotted domain.
+ *
+ * Return:
+ *  uint32_t - Offset after the name, or 0 if it does not fit in the buffer.
+ *
+ *******************************************************************************/
+static uint32_t mdns_put_name(uint8_t *buf, uint32_t offset, uint32_t buf_len, const char *label, const char *domain)
+{
+    const char *end;
+    uint32_t length;
+
+    if (NULL != label)
+    {
+        length = strlen(label);
+        if ((length > MDNS_MAX_LABEL_LEN) || (offset + 1u + length > buf_len))
+        {
+            return 0;
+        }
+        buf[offset++] = (uint8_t)length;
+        memcpy(&buf[offset], label, length);
+        offset += length;
+    }
+
+    while ('\0' != *domain)
+    {
+        end = strchr(domain, '.');
+        length = (NULL != end) ? (uint32_t)(end - domain) : strlen(domain);
+        if ((0 == length) || (length > MDNS_MAX_LABEL_LEN) || (offset + 1u + length > buf_len))
+        {
+            return 0;
+        }
+        buf[offset++] = (uint8_t)length;
+        memcpy(&buf[offset], domain, length);
+        offset += length;
+        domain += length + ((NULL != end) ? 1u : 0u);
+    }
+
+    if (offset >= buf_len)
+    {
+        return 0;
+    }
+    buf[offset++] = 0;
+
+    return offset;
+}
+
+/*******************************************************************************
+ * Function Name: mdns_put_record
+ *******************************************************************************
+ * Summary:
+ *  Writes the name, type, class and TTL of a record, and reserves its data
+ *  length, written by mdns_end_record.
+ *
+ * Parameters:
+ *  buf - Buffer of the message.
+ *  offset - Offset of the record in the buffer.
+ *  buf_len - Size of the buffer.
+ *  label - First label of the name, or NULL.
+ *  domain - Dotted domain of the name.
+ *  type - Type of the record.
+ *  class - Class of the record, with MDNS_CACHE_FLUSH for unique records.
+ *  ttl - Time to live, in seconds.
+ *
+ * Return:
+ *  uint32_t - Offset of the data of the record, or 0 if it does not fit.
+ *
+ *******************************************************************************/
+static uint32_t mdns_put_record(uint8_t *buf, uint32_t offset, uint32_t buf_len, const char *label,
+                                const char *domain, uint16_t type, uint16_t class, uint32_t ttl)
+{
+    offset = mdns_put_name(buf, offset, buf_len, label, domain);
+    if ((0 == offset) || (offset + 10u > buf_len))
+    {
+        return 0;
+    }
+
+    buf[offset++] = (uint8_t)(type >> 8);
+    buf[offset++] = (uint8_t)(type & 0xFFu);
+    buf[offset++] = (uint8_t)(class >> 8);
+    buf[offset++] = (uint8_t)(class & 0xFFu);
+    buf[offset++] = (uint8_t)(ttl >> 24);
+    buf[offset++] = (uint8_t)((ttl >> 16) & 0xFFu);
+    buf[offset++] = (uint8_t)((ttl >> 8) & 0xFFu);
+    buf[offset++] = (uint8_t)(ttl & 0xFFu);
+
+    /* Data length, written by mdns_end_record. */
+    return offset + 2u;
+}
+
+/*******************************************************************************
+ * Function Name: mdns_end_record
+ *******************************************************************************
+ * Summary:
+ *  Writes the data length of a record.
+ *
+ * Parameters:
+ *  buf - Buffer of the message.
+ *  data - Offset of the data of the record.
+ *  end - Offset after the data of the record.
+ *
+ * Return:
+ *  uint32_t - Offset after the record.
+ *
+ *******************************************************************************/
+static uint32_t mdns_end_record(uint8_t *buf, uint32_t data, uint32_t end)
+{
+    buf[data - 2u] = (uint8_t)((end - data) >> 8);
+    buf[data - 1u] = (uint8_t)((end - data) & 0xFFu);
+
+    return end;
+}
+
+/*******************************************************************************
+ * Function Name: mdns_build_response
+ *******************************************************************************
+ * Summary:
+ *  Builds the response advertising the device: the PTR records of the
+ *  service type and of the service enumeration, the SRV and TXT records of
+ *  the service instance, and the A record of the host. A goodbye response
+ *  has the same records with a TTL of 0.
+ *
+ * Parameters:
+ *  ip_address - IPv4 address of the host, in network byte order.
+ *  goodbye - true to build the goodbye response.
+ *  buf - Buffer to store the response.
+ *  buf_len - Size of the buffer.
+ *
+ * Return:
+ *  uint32_t - Length of the response, or 0 if it does not fit in the buffer.
+ *
+ *******************************************************************************/
+uint32_t mdns_build_response(uint32_t ip_address, bool goodbye, uint8_t *buf, uint32_t buf_len)
+{
+    uint32_t offset = MDNS_HEADER_LEN;
+    uint32_t data;
+    uint32_t host_ttl = goodbye ? 0u : MDNS_HOST_TTL_SEC;
+    uint32_t other_ttl = goodbye ? 0u : MDNS_OTHER_TTL_SEC;
+    uint32_t length;
+
+    if (buf_len < MDNS_HEADER_LEN)
+    {
+        return 0;
+    }
+
+    /* Response header with five answers and no question. */
+    memset(buf, 0, MDNS_HEADER_LEN);
+    buf[2] = MDNS_FLAG_QR | MDNS_FLAG_AA;
+    buf[7] = 5u;
+
+    /* Service type -> service instance. */
+    data = mdns_put_record(buf, offset, buf_len, NULL, MDNS_SERVICE_TYPE, MDNS_TYPE_PTR, MDNS_CLASS_IN, other_ttl);
+    offset = (0 != data) ? mdns_put_name(buf, data, buf_len, MDNS_SERVICE_INSTANCE, MDNS_SERVICE_TYPE) : 0;
+    if (0 == offset)
+    {
+        return 0;
+    }
+    offset = mdns_end_record(buf, data, offset);
+
+    /* Service instance -> priority, weight, port and host. */
+    data = mdns_put_record(buf, offset, buf_len, MDNS_SERVICE_INSTANCE, MDNS_SERVICE_TYPE, MDNS_TYPE_SRV,
+                           MDNS_CLASS_IN | MDNS_CACHE_FLUSH, host_ttl);
+    if ((0 == data) || (data + 6u > buf_len))
+    {
+        return 0;
+    }
+    memset(&buf[data], 0, 4u);
+    buf[data + 4u] = (uint8_t)(HTTP_PORT >> 8);
+    buf[data + 5u] = (uint8_t)(HTTP_PORT & 0xFFu);
+    offset = mdns_put_name(buf, data + 6u, buf_len, MDNS_HOSTNAME, MDNS_DOMAIN);
+    if (0 == offset)
+    {
+        return 0;
+    }
+    offset = mdns_end_record(buf, data, offset);
+
+    /* Service instance -> path of the home page. */
+    length = sizeof(MDNS_TXT_PATH) - 1u;
+    data = mdns_put_record(buf, offset, buf_len, MDNS_SERVICE_INSTANCE, MDNS_SERVICE_TYPE, MDNS_TYPE_TXT,
+                           MDNS_CLASS_IN | MDNS_CACHE_FLUSH, other_ttl);
+    if ((0 == data) || (data + 1u + length > buf_len))
+    {
+        return 0;
+    }
+    buf[data] = (uint8_t)length;
+    memcpy(&buf[data + 1u], MDNS_TXT_PATH, length);
+    offset = mdns_end_record(buf, data, data + 1u + length);
+
+    /* Host -> IP address. */
+    data = mdns_put_record(buf, offset, buf_len, MDNS_HOSTNAME, MDNS_DOMAIN, MDNS_TYPE_A,
+                           MDNS_CLASS_IN | MDNS_CACHE_FLUSH, host_ttl);
+    if ((0 == data) || (data + 4u > buf_len))
+    {
+        return 0;
+    }
+    memcpy(&buf[data], &ip_address, 4u);
+    offset = mdns_end_record(buf, data, data + 4u);
+
+    /* Service enumeration -> service type. */
+    data = mdns_put_record(buf, offset, buf_len, NULL, MDNS_SERVICE_ENUMERATION, MDNS_TYPE_PTR, MDNS_CLASS_IN,
+                           other_ttl);
+    offset = (0 != data) ? mdns_put_name(buf, data, buf_len, NULL, MDNS_SERVICE_TYPE) : 0;
+    if (0 == offset)
+    {
+        return 0;
+    }
+
+    return mdns_end_record(buf, data, offset);
+}
+
+/*******************************************************************************
+ * Function Name: mdns_read_name
+ *******************************************************************************
+ * Summary:
+ *  Reads a possibly compressed name of a message as a dotted string.
+ *
+ * Parameters:
+ *  msg - Pointer to the message.
+ *  msg_len - Length of the message.
+ *  offset - Offset of the name; updated to the offset after the name.
+ *  name - Buffer of MDNS_MAX_NAME_LEN bytes to store the name.
+ *
+ * Return:
+ *  bool - true if the name is valid.
+ *
+ *******************************************************************************/
+static bool mdns_read_name(const uint8_t *msg, uint32_t msg_len, uint32_t *offset, char *name)
+{
+    uint32_t position = *offset;
+    uint32_t length = 0;
+    uint32_t pointers = 0;
+    uint32_t label;
+
+    while (true)
+    {
+        if (position >= msg_len)
+        {
+            return false;
+        }
+
+        label = msg[position];
+        if (0 == label)
+        {
+            if (0 == pointers)
+            {
+                *offset = position + 1u;
+            }
+            name[length] = '\0';
+            return true;
+        }
+
+        if (MDNS_NAME_POINTER == (label & MDNS_NAME_POINTER))
+        {
+            if ((position + 1u >= msg_len) || (++pointers > MDNS_MAX_POINTERS))
+            {
+                return false;
+            }
+            if (1u == pointers)
+            {
+                *offset = position + 2u;
+            }
+            position = ((label & ~MDNS_NAME_POINTER) << 8) | msg[position + 1u];
+            continue;
+        }
+
+        if ((label > MDNS_MAX_LABEL_LEN) || (position + 1u + label > msg_len) ||
+            (length + label + 2u > MDNS_MAX_NAME_LEN))
+        {
+            return false;
+        }
+
+        if (0 != length)
+        {
+            name[length++] = '.';
+        }
+        memcpy(&name[length], &msg[position + 1u], label);
+        length += label;
+        position += 1u + label;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: mdns_query_matches
+ *******************************************************************************
+ * Summary:
+ *  Checks whether a query asks for one of the records of the device.
+ *
+ * Parameters:
+ *  query - Pointer to the message.
+ *  query_len - Length of the message.
+ *
+ * Return:
+ *  bool - true if a question of the query is answered by the response.
+ *
+ *******************************************************************************/
+bool mdns_query_matches(const uint8_t *query, uint32_t query_len)
+{
+    char name[MDNS_MAX_NAME_LEN];
+    uint32_t offset = MDNS_HEADER_LEN;
+    uint32_t questions;
+    uint16_t type;
+    uint16_t class;
+    bool any;
+
+    if ((query_len < MDNS_HEADER_LEN) || (0 != (query[2] & MDNS_FLAG_QR)))
+    {
+        return false;
+    }
+
+    questions = ((uint32_t)query[4] << 8) | query[5];
+    while (questions-- > 0)
+    {
+        if (!mdns_read_name(query, query_len, &offset, name) || (offset + 4u > query_len))
+        {
+            return false;
+        }
+
+        type = (uint16_t)((query[offset] << 8) | query[offset + 1u]);
+        class = (uint16_t)((query[offset + 2u] << 8) | query[offset + 3u]);
+        offset += 4u;
+        if (MDNS_CLASS_IN != (class & MDNS_CLASS_MASK))
+        {
+            continue;
+        }
+
+        any = (MDNS_TYPE_ANY == type);
+        if (((any || (MDNS_TYPE_A == type)) && (0 == strcasecmp(name, mdns_host_name))) ||
+            ((any || (MDNS_TYPE_PTR == type)) && (0 == strcasecmp(name, MDNS_SERVICE_TYPE))) ||
+            ((any || (MDNS_TYPE_PTR == type)) && (0 == strcasecmp(name, MDNS_SERVICE_ENUMERATION))) ||
+            ((any || (MDNS_TYPE_SRV == type) || (MDNS_TYPE_TXT == type)) &&
+             (0 == strcasecmp(name, mdns_instance_name))))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: mdns_send
+ *******************************************************************************
+ * Summary:
+ *  Multicasts a response. Called with mdns_mutex held.
+ *
+ * Parameters:
+ *  response - Pointer to the response.
+ *  length - Length of the response.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void mdns_send(const uint8_t *response, uint32_t length)
+{
+    cy_socket_sockaddr_t group;
+    uint32_t sent = 0;
+
+    memset(&group, 0, sizeof(group));
+    group.port = MDNS_PORT;
+    group.ip_address.version = CY_SOCKET_IP_VER_V4;
+    group.ip_address.ip.v4 = MDNS_MULTICAST_ADDRESS;
+
+    (void)cy_socket_sendto(mdns_socket, response, length, CY_SOCKET_FLAGS_NONE, &group, sizeof(group), &sent);
+    cy_rtos_get_time(&mdns_last_response_time);
+}
+
+/*******************************************************************************
+ * Function Name: mdns_serve
+ *******************************************************************************
+ * Summary:
+ *  Receives one query, if any arrives before the receive timeout, and sends
+ *  the announcements and the responses that are due. Called with mdns_mutex
+ *  held.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void mdns_serve(void)
+{
+    cy_rslt_t result;
+    cy_socket_sockaddr_t peer_address;
+    uint32_t peer_address_length = sizeof(peer_address);
+    uint32_t received = 0;
+    cy_time_t now;
+
+    result = cy_socket_recvfrom(mdns_socket, mdns_rx_buffer, sizeof(mdns_rx_buffer), CY_SOCKET_FLAGS_NONE,
+                                &peer_address, &peer_address_length, &received);
+    cy_rtos_get_time(&now);
+    if ((CY_RSLT_SUCCESS == result) && (0 != received))
+    {
+        mdns_queries++;
+        if (mdns_query_matches(mdns_rx_buffer, received))
+        {
+            mdns_matched_queries++;
+            if (mdns_response_pending || (0 != mdns_announcements_left) ||
+                ((now - mdns_last_response_time) < MDNS_MIN_RESPONSE_INTERVAL_MSEC))
+            {
+                mdns_deferred_queries++;
+            }
+            mdns_response_pending = true;
+        }
+    }
+
+    if ((now - mdns_last_response_time) < MDNS_MIN_RESPONSE_INTERVAL_MSEC)
+    {
+        return;
+    }
+
+    /* An announcement also answers the pending queries. */
+    if (0 != mdns_announcements_left)
+    {
+        mdns_announcements_left--;
+        mdns_announcements++;
+        mdns_response_pending = false;
+        mdns_send(mdns_response, mdns_response_len);
+    }
+    else if (mdns_response_pending)
+    {
+        mdns_responses++;
+        mdns_response_pending = false;
+        mdns_send(mdns_response, mdns_response_len);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: mdns_task
+ *******************************************************************************
+ * Summary:
+ *  Task that answers the mDNS queries while the responder is started.
+ *
+ * Parameters:
+ *  arg - Unused.
+ *
+ * Return:
+ *  None.
+ *
+ *******************************************************************************/
+static void mdns_task(cy_thread_arg_t arg)
+{
+    (void)arg;
+
+    while (true)
+    {
+        cy_rtos_get_mutex(&mdns_mutex, CY_RTOS_NEVER_TIMEOUT);
+        if (mdns_running)
+        {
+            mdns_serve();
+        }
+        cy_rtos_set_mutex(&mdns_mutex);
+
+        if (!mdns_running)
+        {
+            cy_rtos_delay_milliseconds(MDNS_RECEIVE_TIMEOUT_MSEC);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: mdns_close
+ *******************************************************************************
+ * Summary:
+ *  Sends the goodbye response and deletes the socket. Called with mdns_mutex
+ *  held while the responder is running.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void mdns_close(void)
+{
+    uint32_t length;
+
+    length = mdns_build_response(mdns_ip_address, true, mdns_rx_buffer, sizeof(mdns_rx_buffer));
+    if (0 != length)
+    {
+        mdns_send(mdns_rx_buffer, length);
+    }
+
+    mdns_running = false;
+    cy_socket_delete(mdns_socket);
+}
+
+/*******************************************************************************
+ * Function Name: mdns_start
+ *******************************************************************************
+ * Summary:
+ *  Starts advertising the device at the given IP address of the STA. Does
+ *  nothing if the responder already advertises this address; restarts it if
+ *  the address changed.
+ *
+ * Parameters:
+ *  ip_address - IPv4 address of the STA, in network byte order.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the responder is started
+ *  successfully, otherwise, it returns CY_RSLT_TYPE_ERROR or the secure
+ *  sockets or RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t mdns_start(uint32_t ip_address)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    cy_socket_sockaddr_t bind_address;
+    cy_socket_ip_mreq_t membership;
+    uint32_t receive_timeout = MDNS_RECEIVE_TIMEOUT_MSEC;
+    uint8_t multicast_ttl = MDNS_MULTICAST_TTL;
+
+    if (mdns_running && (ip_address == mdns_ip_address))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    if (!mdns_task_created)
+    {
+        result = cy_rtos_init_mutex(&mdns_mutex);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            return result;
+        }
+
+        result = cy_rtos_thread_create(&mdns_task_handle,
+                                       &mdns_task,
+                                       "mDNS task",
+                                       &mdns_task_stack,
+                                       MDNS_TASK_STACK_SIZE,
+                                       MDNS_TASK_PRIORITY,
+                                       0);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            return result;
+        }
+        mdns_task_created = true;
+    }
+
+    cy_rtos_get_mutex(&mdns_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    if (mdns_running)
+    {
+        mdns_close();
+    }
+
+    mdns_response_len = mdns_build_response(ip_address, false, mdns_response, sizeof(mdns_response));
+    if (0 == mdns_response_len)
+    {
+        result = CY_RSLT_TYPE_ERROR;
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_socket_create(CY_SOCKET_DOMAIN_AF_INET, CY_SOCKET_TYPE_DGRAM, CY_SOCKET_IPPROTO_UDP,
+                                  &mdns_socket);
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        cy_socket_setsockopt(mdns_socket, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                             &receive_timeout, sizeof(receive_timeout));
+        cy_socket_setsockopt(mdns_socket, CY_SOCKET_SOL_IP, CY_SOCKET_SO_IP_MULTICAST_TTL,
+                             &multicast_ttl, sizeof(multicast_ttl));
+
+        memset(&bind_address, 0, sizeof(bind_address));
+        bind_address.port = MDNS_PORT;
+        bind_address.ip_address.version = CY_SOCKET_IP_VER_V4;
+        bind_address.ip_address.ip.v4 = ip_address;
+        result = cy_socket_bind(mdns_socket, &bind_address, sizeof(bind_address));
+
+        if (CY_RSLT_SUCCESS == result)
+        {
+            memset(&membership, 0, sizeof(membership));
+            membership.multi_addr.version = CY_SOCKET_IP_VER_V4;
+            membership.multi_addr.ip.v4 = MDNS_MULTICAST_ADDRESS;
+            membership.if_addr.version = CY_SOCKET_IP_VER_V4;
+            membership.if_addr.ip.v4 = ip_address;
+            result = cy_socket_setsockopt(mdns_socket, CY_SOCKET_SOL_IP, CY_SOCKET_SO_JOIN_MULTICAST_GROUP,
+                                          &membership, sizeof(membership));
+        }
+
+        if (CY_RSLT_SUCCESS == result)
+        {
+            mdns_ip_address = ip_address;
+            mdns_response_pending = false;
+            mdns_announcements_left = MDNS_ANNOUNCE_COUNT;
+            cy_rtos_get_time(&mdns_last_response_time);
+            mdns_last_response_time -= MDNS_MIN_RESPONSE_INTERVAL_MSEC;
+            mdns_running = true;
+        }
+        else
+        {
+            cy_socket_delete(mdns_socket);
+        }
+    }
+
+    cy_rtos_set_mutex(&mdns_mutex);
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        APP_INFO(("Advertising http://%s/ on the Wi-Fi network.\n", mdns_host_name));
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: mdns_stop
+ *******************************************************************************
+ * Summary:
+ *  Stops advertising the device. Waits for the query being received, at most
+ *  MDNS_RECEIVE_TIMEOUT_MSEC.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void mdns_stop(void)
+{
+    if (!mdns_running)
+    {
+        return;
+    }
+
+    cy_rtos_get_mutex(&mdns_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if (mdns_running)
+    {
+        mdns_close();
+    }
+    cy_rtos_set_mutex(&mdns_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: mdns_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the statistics of the mDNS responder.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void mdns_get_stats(mdns_stats_t *stats)
+{
+    stats->running = mdns_running;
+    stats->queries = mdns_queries;
+    stats->matched_queries = mdns_matched_queries;
+    stats->deferred_queries = mdns_deferred_queries;
+    stats->responses = mdns_responses;
+    stats->announcements = mdns_announcements;
+}
+
+/* [] END OF FILE */
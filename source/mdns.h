@@ -0,0 +1,131 @@
+/******************************************************************************
+* File Name: mdns.h
+*
+* Description: This file contains the configuration parameters and function
+*              prototypes of the mDNS responder that advertises the device
+*              and its HTTP server on the network of the STA.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef MDNS_H_
+#define MDNS_H_
+
+#include "cy_result.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Host name of the device, resolved as <MDNS_HOSTNAME>.local, and the
+ * instance name of its HTTP service. Give each device on the network its own
+ * names: the responder does not probe for conflicts.
+ */
+#define MDNS_HOSTNAME                                "cy-web-server"
+#define MDNS_SERVICE_INSTANCE                        "CY Wi-Fi Web Server"
+#define MDNS_SERVICE_TYPE                            "_http._tcp.local"
+#define MDNS_SERVICE_ENUMERATION                     "_services._dns-sd._udp.local"
+#define MDNS_DOMAIN                                  "local"
+#define MDNS_TXT_PATH                                "path=/"
+
+/* Multicast group and port of mDNS: 224.0.0.251:5353. */
+#define MDNS_MULTICAST_ADDRESS                       (0xFB0000E0u)
+#define MDNS_PORT                                    (5353u)
+#define MDNS_MULTICAST_TTL                           (255u)
+
+/* Time to live of the records: the host and SRV records, which change with
+ * the IP address, and the other records (RFC 6762, section 10).
+ */
+#define MDNS_HOST_TTL_SEC                            (120u)
+#define MDNS_OTHER_TTL_SEC                           (4500u)
+
+/* The response is built once when the responder starts and multicast at most
+ * once per MDNS_MIN_RESPONSE_INTERVAL_MSEC: the queries received in between
+ * are answered together at the end of the interval. The responder announces
+ * itself MDNS_ANNOUNCE_COUNT times, MDNS_ANNOUNCE_INTERVAL_MSEC apart, when
+ * it starts.
+ */
+#define MDNS_MIN_RESPONSE_INTERVAL_MSEC              (1000u)
+#define MDNS_ANNOUNCE_COUNT                          (2u)
+#define MDNS_ANNOUNCE_INTERVAL_MSEC                  (1000u)
+
+/* Largest mDNS message handled, and longest name of a question. */
+#define MDNS_MAX_MESSAGE_LEN                         (512u)
+#define MDNS_MAX_NAME_LEN                            (256u)
+
+/* The mDNS task checks for due responses and for a stopped responder at
+ * this interval.
+ */
+#define MDNS_RECEIVE_TIMEOUT_MSEC                    (250u)
+
+/* mDNS task configuration. */
+#define MDNS_TASK_STACK_SIZE                         (2 * 1024)
+#define MDNS_TASK_PRIORITY                           (CY_RTOS_PRIORITY_NORMAL)
+
+/* Fields of the messages. */
+#define MDNS_HEADER_LEN                              (12u)
+#define MDNS_FLAG_QR                                 (0x80u)
+#define MDNS_FLAG_AA                                 (0x04u)
+#define MDNS_TYPE_A                                  (1u)
+#define MDNS_TYPE_PTR                                (12u)
+#define MDNS_TYPE_TXT                                (16u)
+#define MDNS_TYPE_SRV                                (33u)
+#define MDNS_TYPE_ANY                                (255u)
+#define MDNS_CLASS_IN                                (1u)
+#define MDNS_CLASS_MASK                              (0x7FFFu)
+#define MDNS_CACHE_FLUSH                             (0x8000u)
+#define MDNS_NAME_POINTER                            (0xC0u)
+#define MDNS_MAX_LABEL_LEN                           (63u)
+#define MDNS_MAX_POINTERS                            (8u)
+
+/* Statistics of the mDNS responder reported in the metrics. */
+typedef struct
+{
+    bool running;
+    uint32_t queries;
+    uint32_t matched_queries;
+    uint32_t deferred_queries;
+    uint32_t responses;
+    uint32_t announcements;
+} mdns_stats_t;
+
+
+uint32_t mdns_build_response(uint32_t ip_address, bool goodbye, uint8_t *buf, uint32_t buf_len);
+bool mdns_query_matches(const uint8_t *query, uint32_t query_len);
+cy_rslt_t mdns_start(uint32_t ip_address);
+void mdns_stop(void);
+void mdns_get_stats(mdns_stats_t *stats);
+
+
+#endif /* MDNS_H_ */
+
+/* [] END OF FILE */
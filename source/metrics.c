@@ -0,0 +1,371 @@
+/*******************************************************************************
+ * File Name: metrics.c
+ *
+ * Description: This file contains the HTTP resource that reports the runtime
+ *              metrics of the application as plain text, one "name value"
+ *              pair per line.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cy_http_server.h"
+
+/* HTTP server task header file. */
+#include "web_server.h"
+#include "metrics.h"
+
+/* Standard C header file */
+#include <stdio.h>
+#include <stdarg.h>
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Buffer used to format the metrics response. */
+static char metrics_response[METRICS_RESPONSE_LENGTH];
+
+/* Serializes the use of metrics_response between HTTP server threads. */
+static cy_mutex_t metrics_mutex;
+
+/*******************************************************************************
+ * Function Name: metrics_append
+ *******************************************************************************
+ * Summary:
+ *  Appends a formatted line to the metrics response.
+ *
+ * Parameters:
+ *  offset - Current length of the metrics response.
+ *  format - printf style format of the line.
+ *
+ * Return:
+ *  uint32_t - New length of the metrics response.
+ *
+ *******************************************************************************/
+static uint32_t metrics_append(uint32_t offset, const char *format, ...)
+{
+    va_list args;
+    int length;
+
+    if (offset >= sizeof(metrics_response))
+    {
+        return offset;
+    }
+
+    va_start(args, format);
+    length = vsnprintf(&metrics_response[offset], sizeof(metrics_response) - offset, format, args);
+    va_end(args);
+
+    if (length < 0)
+    {
+        return offset;
+    }
+
+    offset += (uint32_t)length;
+    return (offset < sizeof(metrics_response)) ? offset : (sizeof(metrics_response) - 1);
+}
+
+/*******************************************************************************
+ * Function Name: metrics_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the metrics resource.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the metrics resource is initialized
+ *  successfully, otherwise, it returns the RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t metrics_init(void)
+{
+    return cy_rtos_init_mutex(&metrics_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: metrics_resource_handler
+ *******************************************************************************
+ * Summary:
+ *  Handles the HTTP GET request for the metrics and sends the current values
+ *  as plain text.
+ *
+ * Parameters:
+ *  url_path - Pointer to the HTTP URL path.
+ *  url_parameters - Pointer to the HTTP URL query string.
+ *  stream - Pointer to the HTTP response stream.
+ *  arg - Pointer to the argument passed during HTTP resource registration.
+ *  http_message_body - Pointer to the HTTP data from the client.
+ *
+ * Return:
+ *  int32_t - Returns HTTP_REQUEST_HANDLE_SUCCESS if the request from the client
+ *  was handled successfully. Otherwise, it returns HTTP_REQUEST_HANDLE_ERROR.
+ *
+ *******************************************************************************/
+int32_t metrics_resource_handler(const char *url_path,
+                                 const char *url_parameters,
+                                 cy_http_response_stream_t *stream,
+                                 void *arg,
+                                 cy_http_message_body_t *http_message_body)
+{
+    cy_rslt_t result;
+    uint32_t length = 0;
+    event_stream_stats_t event_stats;
+    telemetry_stats_t telemetry_stats;
+    rate_control_stats_t rate_stats;
+    boot_stats_t boot_stats;
+    pmk_cache_stats_t pmk_stats;
+    ip_config_stats_t ip_stats;
+    retry_policy_stats_t retry_stats;
+    scan_cache_stats_t scan_stats;
+    scan_page_stats_t scan_page_stats;
+    wifi_state_stats_t wifi_stats;
+    roam_stats_t roam_stats;
+    channel_select_stats_t channel_stats;
+    captive_dns_stats_t dns_stats;
+    mdns_stats_t mdns_stats;
+    http_interface_stats_t http_stats;
+    softap_stats_t softap_stats;
+    websocket_stats_t websocket_stats;
+    static const char *const http_interface_names[HTTP_INTERFACE_COUNT] = {"ap", "sta"};
+    uint32_t reason;
+    uint32_t ip_address;
+    uint32_t index;
+
+    if (CY_HTTP_REQUEST_GET != http_message_body->request_type)
+    {
+        ERR_INFO(("Received invalid HTTP request method for the metrics. Supported HTTP method is GET.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+
+    event_stream_get_stats(&event_stats);
+    telemetry_get_stats(&telemetry_stats);
+    rate_control_get_stats(&rate_stats);
+    get_boot_stats(&boot_stats);
+    pmk_cache_get_stats(&pmk_stats);
+    ip_config_get_stats(&ip_stats);
+    retry_policy_get_stats(&retry_stats);
+    scan_cache_get_stats(&scan_stats);
+    get_scan_page_stats(&scan_page_stats);
+    wifi_state_get_stats(&wifi_stats);
+    roam_get_stats(&roam_stats);
+    channel_select_get_stats(&channel_stats);
+    captive_dns_get_stats(&dns_stats);
+    mdns_get_stats(&mdns_stats);
+    get_softap_stats(&softap_stats);
+    websocket_get_stats(&websocket_stats);
+
+    cy_rtos_get_mutex(&metrics_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    length = metrics_append(length, "wifi_state{state=\"%s\"} 1\n", wifi_state_name(wifi_stats.state));
+    length = metrics_append(length, "wifi_state_transitions %lu\n", (unsigned long)wifi_stats.transitions);
+    length = metrics_append(length, "wifi_link_losses %lu\n", (unsigned long)wifi_stats.link_losses);
+    length = metrics_append(length, "wifi_reconnects %lu\n", (unsigned long)wifi_stats.reconnects);
+    length = metrics_append(length, "wifi_last_outage_msec %lu\n", (unsigned long)wifi_stats.last_outage_msec);
+    length = metrics_append(length, "wifi_dropped_events %lu\n", (unsigned long)wifi_stats.dropped_events);
+    length = metrics_append(length, "roam_rssi_dbm %d\n", (int)roam_stats.rssi_dbm);
+    length = metrics_append(length, "roam_tx_failed_percent %lu\n", (unsigned long)roam_stats.tx_failed_percent);
+    length = metrics_append(length, "roam_samples %lu\n", (unsigned long)roam_stats.samples);
+    length = metrics_append(length, "roam_degraded_samples %lu\n", (unsigned long)roam_stats.degraded_samples);
+    length = metrics_append(length, "roam_searches %lu\n", (unsigned long)roam_stats.searches);
+    length = metrics_append(length, "roams %lu\n", (unsigned long)roam_stats.roams);
+    length = metrics_append(length, "roam_failures %lu\n", (unsigned long)roam_stats.failed_roams);
+    length = metrics_append(length, "roam_last_msec %lu\n", (unsigned long)roam_stats.last_roam_msec);
+    length = metrics_append(length, "roam_last_gain_db %ld\n", (long)roam_stats.last_roam_gain_db);
+    if (0 != channel_stats.channel)
+    {
+        length = metrics_append(length, "softap_channel %u\n", (unsigned int)boot_stats.softap_channel);
+        length = metrics_append(length, "softap_moves %lu\n", (unsigned long)boot_stats.softap_moves);
+        length = metrics_append(length, "softap_move_msec %lu\n", (unsigned long)boot_stats.softap_move_msec);
+        length = metrics_append(length, "softap_channel_scan_aps %lu\n", (unsigned long)channel_stats.ap_count);
+        for (index = 0; index < CHANNEL_SELECT_CANDIDATE_COUNT; index++)
+        {
+            length = metrics_append(length, "softap_channel_score{channel=\"%u\"} %lu\n",
+                                    (unsigned int)channel_stats.channels[index], (unsigned long)channel_stats.scores[index]);
+        }
+    }
+    if (BOOT_PATH_NONE != boot_stats.path)
+    {
+        length = metrics_append(length, "boot_to_connected_msec{path=\"%s\"} %lu\n",
+                                (BOOT_PATH_STORED_CREDENTIALS == boot_stats.path) ? "stored_credentials" : "softap",
+                                (unsigned long)boot_stats.connected_msec);
+        length = metrics_append(length, "wifi_association_msec %lu\n", (unsigned long)boot_stats.association_msec);
+        length = metrics_append(length, "wifi_addressing_msec{source=\"%s\"} %lu\n",
+                                ip_config_source_name(ip_stats.source), (unsigned long)boot_stats.addressing_msec);
+    }
+    if (0 != boot_stats.connect_msec)
+    {
+        length = metrics_append(length, "wifi_connect_msec{target=\"%s\"} %lu\n",
+                                boot_stats.connect_directed ? "directed" : "scan", (unsigned long)boot_stats.connect_msec);
+    }
+    length = metrics_append(length, "wifi_directed_connects %lu\n", (unsigned long)boot_stats.directed_connects);
+    length = metrics_append(length, "wifi_directed_fallbacks %lu\n", (unsigned long)boot_stats.directed_fallbacks);
+    length = metrics_append(length, "wifi_profiles %lu\n", (unsigned long)boot_stats.profiles);
+    length = metrics_append(length, "wifi_profile_rank %lu\n", (unsigned long)boot_stats.profile_rank);
+    length = metrics_append(length, "wifi_profile_attempts %lu\n", (unsigned long)boot_stats.profile_attempts);
+    length = metrics_append(length, "device_data_redirects %lu\n", (unsigned long)boot_stats.device_data_redirects);
+    length = metrics_append(length, "wifi_connect_attempts %lu\n", (unsigned long)retry_stats.attempts);
+    length = metrics_append(length, "wifi_connect_retries %lu\n", (unsigned long)retry_stats.retries);
+    length = metrics_append(length, "wifi_connect_last_attempts{outcome=\"%s\"} %lu\n",
+                            retry_policy_outcome_name(retry_stats.last_outcome), (unsigned long)retry_stats.last_attempts);
+    length = metrics_append(length, "scan_cache_entries %lu\n", (unsigned long)scan_stats.entries);
+    length = metrics_append(length, "scan_cache_hits %lu\n", (unsigned long)scan_stats.hits);
+    length = metrics_append(length, "scan_cache_misses %lu\n", (unsigned long)scan_stats.misses);
+    length = metrics_append(length, "scan_targeted_scans %lu\n", (unsigned long)scan_stats.targeted_scans);
+    length = metrics_append(length, "scan_full_scans %lu\n", (unsigned long)scan_stats.full_scans);
+    length = metrics_append(length, "scan_background_scans %lu\n", (unsigned long)scan_stats.background_scans);
+    length = metrics_append(length, "scan_cache_aged_out %lu\n", (unsigned long)scan_stats.aged_out);
+    length = metrics_append(length, "scan_cache_dropped %lu\n", (unsigned long)scan_stats.dropped);
+    length = metrics_append(length, "scan_stream_overflows %lu\n", (unsigned long)scan_stats.stream_overflows);
+    length = metrics_append(length, "scan_page_fresh_scans %lu\n", (unsigned long)scan_page_stats.fresh_scans);
+    length = metrics_append(length, "scan_page_ttfb_msec %lu\n", (unsigned long)scan_page_stats.ttfb_msec);
+    length = metrics_append(length, "scan_page_first_ap_msec %lu\n", (unsigned long)scan_page_stats.first_ap_msec);
+    length = metrics_append(length, "scan_page_total_msec %lu\n", (unsigned long)scan_page_stats.total_msec);
+    length = metrics_append(length, "scan_page_aps %lu\n", (unsigned long)scan_page_stats.ap_count);
+    length = metrics_append(length, "captive_dns_queries %lu\n", (unsigned long)dns_stats.queries);
+    length = metrics_append(length, "captive_dns_answers %lu\n", (unsigned long)dns_stats.answers);
+    length = metrics_append(length, "captive_dns_empty_answers %lu\n", (unsigned long)dns_stats.empty_answers);
+    length = metrics_append(length, "captive_dns_dropped %lu\n", (unsigned long)dns_stats.dropped);
+    for (index = 0; index < HTTP_INTERFACE_COUNT; index++)
+    {
+        get_http_interface_stats((http_interface_t)index, &http_stats);
+        length = metrics_append(length, "http_server_running{interface=\"%s\"} %u\n",
+                                http_interface_names[index], http_stats.running ? 1u : 0u);
+        length = metrics_append(length, "http_requests{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.requests);
+        length = metrics_append(length, "http_request_errors{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.errors);
+        length = metrics_append(length, "http_request_msec_total{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.total_msec);
+        length = metrics_append(length, "http_request_msec_max{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.max_msec);
+        length = metrics_append(length, "http_reconfigurations{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.reconfigurations);
+        length = metrics_append(length, "http_drain_rejected{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.drain_rejected);
+        length = metrics_append(length, "http_aborted_responses{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.aborted);
+        length = metrics_append(length, "http_drain_closed_event_streams{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.closed_event_streams);
+        length = metrics_append(length, "http_drain_closed_websockets{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.closed_websockets);
+        length = metrics_append(length, "http_last_drain_msec{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.last_drain_msec);
+        length = metrics_append(length, "http_last_reconfigure_msec{interface=\"%s\"} %lu\n",
+                                http_interface_names[index], (unsigned long)http_stats.last_reconfigure_msec);
+    }
+    length = metrics_append(length, "softap_running %u\n", softap_stats.running ? 1u : 0u);
+    length = metrics_append(length, "softap_clients %lu\n", (unsigned long)softap_stats.clients);
+    length = metrics_append(length, "softap_idle_teardowns %lu\n", (unsigned long)softap_stats.teardowns);
+    length = metrics_append(length, "softap_restarts %lu\n", (unsigned long)softap_stats.restarts);
+    if (0 != softap_stats.teardowns)
+    {
+        length = metrics_append(length, "softap_teardown_byte_pool_used_bytes{when=\"before\"} %lu\n",
+                                (unsigned long)softap_stats.byte_pool_used_before);
+        length = metrics_append(length, "softap_teardown_byte_pool_used_bytes{when=\"after\"} %lu\n",
+                                (unsigned long)softap_stats.byte_pool_used_after);
+        length = metrics_append(length, "softap_teardown_free_packets{when=\"before\"} %lu\n",
+                                (unsigned long)softap_stats.pool_free_before);
+        length = metrics_append(length, "softap_teardown_free_packets{when=\"after\"} %lu\n",
+                                (unsigned long)softap_stats.pool_free_after);
+    }
+    length = metrics_append(length, "websocket_clients %lu\n", (unsigned long)websocket_stats.connected_clients);
+    length = metrics_append(length, "websocket_accepted %lu\n", (unsigned long)websocket_stats.accepted);
+    length = metrics_append(length, "websocket_rejected %lu\n", (unsigned long)websocket_stats.rejected);
+    for (index = 0; index < CONN_QUOTA_MAX_CLIENTS; index++)
+    {
+        if (0 != websocket_stats.clients[index].rejected)
+        {
+            ip_address = websocket_stats.clients[index].key;
+            length = metrics_append(length, "websocket_rejected{client=\"%u.%u.%u.%u\"} %lu\n",
+                                    (unsigned int)(ip_address & 0xFFu), (unsigned int)((ip_address >> 8) & 0xFFu),
+                                    (unsigned int)((ip_address >> 16) & 0xFFu), (unsigned int)(ip_address >> 24),
+                                    (unsigned long)websocket_stats.clients[index].rejected);
+        }
+    }
+    length = metrics_append(length, "mdns_running %u\n", mdns_stats.running ? 1u : 0u);
+    length = metrics_append(length, "mdns_queries %lu\n", (unsigned long)mdns_stats.queries);
+    length = metrics_append(length, "mdns_matched_queries %lu\n", (unsigned long)mdns_stats.matched_queries);
+    length = metrics_append(length, "mdns_deferred_queries %lu\n", (unsigned long)mdns_stats.deferred_queries);
+    length = metrics_append(length, "mdns_responses %lu\n", (unsigned long)mdns_stats.responses);
+    length = metrics_append(length, "mdns_announcements %lu\n", (unsigned long)mdns_stats.announcements);
+    length = metrics_append(length, "pmk_cache_hits %lu\n", (unsigned long)pmk_stats.hits);
+    length = metrics_append(length, "pmk_cache_misses %lu\n", (unsigned long)pmk_stats.misses);
+    length = metrics_append(length, "pmk_derivations %lu\n", (unsigned long)pmk_stats.derivations);
+    length = metrics_append(length, "pmk_last_derive_msec %lu\n", (unsigned long)pmk_stats.last_derive_msec);
+    length = metrics_append(length, "event_stream_subscribers_active %lu\n", (unsigned long)event_stats.active_subscribers);
+    length = metrics_append(length, "event_stream_subscribers_reaped %lu\n", (unsigned long)event_stats.reaped_subscribers);
+    length = metrics_append(length, "event_stream_stalled_writes %lu\n", (unsigned long)event_stats.stalled_writes);
+    length = metrics_append(length, "event_stream_heartbeats_sent %lu\n", (unsigned long)event_stats.heartbeats_sent);
+    length = metrics_append(length, "event_stream_last_event_id %lu\n", (unsigned long)event_stats.last_event_id);
+    length = metrics_append(length, "event_stream_accepted %lu\n", (unsigned long)event_stats.accepted);
+    length = metrics_append(length, "event_stream_rejected %lu\n", (unsigned long)event_stats.rejected);
+    length = metrics_append(length, "event_stream_rate_limited %lu\n", (unsigned long)event_stats.rate_limited);
+    for (index = 0; index < CONN_QUOTA_MAX_CLIENTS; index++)
+    {
+        if (0 != event_stats.clients[index].rejected)
+        {
+            length = metrics_append(length, "event_stream_rejected{client=\"%08lx\"} %lu\n",
+                                    (unsigned long)event_stats.clients[index].key,
+                                    (unsigned long)event_stats.clients[index].rejected);
+        }
+    }
+    length = metrics_append(length, "telemetry_text_bytes %lu\n", (unsigned long)telemetry_stats.text_len);
+    length = metrics_append(length, "telemetry_binary_bytes %lu\n", (unsigned long)telemetry_stats.binary_len);
+    length = metrics_append(length, "rate_control_interval_msec %lu\n", (unsigned long)rate_stats.interval_msec);
+    length = metrics_append(length, "rate_control_tx_pool_free %lu\n", (unsigned long)rate_stats.tx_pool_free);
+    length = metrics_append(length, "rate_control_tx_pool_free_min %lu\n", (unsigned long)rate_stats.tx_pool_free_min);
+    length = metrics_append(length, "rate_control_write_time_msec %lu\n", (unsigned long)rate_stats.write_time_msec);
+    for (reason = 0; reason < RATE_CONTROL_REASON_COUNT; reason++)
+    {
+        length = metrics_append(length, "rate_control_decisions{reason=\"%s\"} %lu\n",
+                                rate_control_reason_name((rate_control_reason_t)reason),
+                                (unsigned long)rate_stats.decisions[reason]);
+    }
+
+    result = cy_http_server_response_stream_write_payload(stream, metrics_response, length);
+
+    cy_rtos_set_mutex(&metrics_mutex);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to send the metrics response.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+
+    return HTTP_REQUEST_HANDLE_SUCCESS;
+}
+
+/* [] END OF FILE */
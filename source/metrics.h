@@ -0,0 +1,63 @@
+/******************************************************************************
+* File Name: metrics.h
+*
+* Description: This file contains the configuration parameters and function
+*              prototypes of the HTTP resource that reports the runtime
+*              metrics of the application.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include "cy_http_server.h"
+
+/* URL of the metrics resource. */
+#define METRICS_URL                                  "/metrics"
+
+/* Buffer used to format the metrics response. */
+#define METRICS_RESPONSE_LENGTH                      (6144u)
+
+
+cy_rslt_t metrics_init(void);
+int32_t metrics_resource_handler(const char *url_path,
+                                 const char *url_parameters,
+                                 cy_http_response_stream_t *stream,
+                                 void *arg,
+                                 cy_http_message_body_t *http_message_body);
+
+
+#endif /* METRICS_H_ */
+
+/* [] END OF FILE */
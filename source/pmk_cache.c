@@ -0,0 +1,394 @@
+/*******************************************************************************
+ * File Name: pmk_cache.c
+ *
+ * Description: This file contains the PBKDF2-HMAC-SHA1 derivation of the WPA2
+ *              PMK and a cache of the last derived PMK in RAM, backed by the
+ *              credential store, so that reconnects do not derive the PMK
+ *              again.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "pmk_cache.h"
+#include "cred_store.h"
+#include "sha1.h"
+
+/* Standard C header file */
+#include <string.h>
+
+/*******************************************************************************
+ * Macros
+ ********************************************************************************/
+#define HMAC_IPAD                                    (0x36u)
+#define HMAC_OPAD                                    (0x5Cu)
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* PMK of the last SSID and passphrase pair derived or loaded from the store. */
+static bool pmk_cache_valid = false;
+static cy_wcm_ssid_t pmk_cache_ssid;
+static cy_wcm_passphrase_t pmk_cache_passphrase;
+static uint8_t pmk_cache_pmk[PMK_LENGTH];
+
+/* Statistics of the cache. */
+static volatile uint32_t pmk_cache_hits = 0;
+static volatile uint32_t pmk_cache_misses = 0;
+static volatile uint32_t pmk_cache_derivations = 0;
+static volatile uint32_t pmk_cache_last_derive_msec = 0;
+
+/*******************************************************************************
+ * Function Name: pmk_hmac_init
+ *******************************************************************************
+ * Summary:
+ *  Computes the SHA-1 states after the inner and outer padded HMAC keys. They
+ *  are the same for every HMAC of a PBKDF2 derivation, so they are computed
+ *  once and copied for each iteration, which halves the number of SHA-1
+ *  blocks processed.
+ *
+ * Parameters:
+ *  key - Pointer to the HMAC key.
+ *  key_len - Length of the HMAC key.
+ *  inner - Pointer to store the state after the inner padded key.
+ *  outer - Pointer to store the state after the outer padded key.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void pmk_hmac_init(const uint8_t *key, uint32_t key_len, sha1_context_t *inner, sha1_context_t *outer)
+{
+    uint8_t block[SHA1_BLOCK_LENGTH];
+    uint8_t key_digest[SHA1_DIGEST_LENGTH];
+    uint32_t index;
+
+    if (key_len > SHA1_BLOCK_LENGTH)
+    {
+        sha1_init(inner);
+        sha1_update(inner, key, key_len);
+        sha1_final(inner, key_digest);
+        key = key_digest;
+        key_len = SHA1_DIGEST_LENGTH;
+    }
+
+    memset(block, 0, sizeof(block));
+    memcpy(block, key, key_len);
+
+    for (index = 0; index < SHA1_BLOCK_LENGTH; index++)
+    {
+        block[index] ^= HMAC_IPAD;
+    }
+    sha1_init(inner);
+    sha1_update(inner, block, SHA1_BLOCK_LENGTH);
+
+    for (index = 0; index < SHA1_BLOCK_LENGTH; index++)
+    {
+        block[index] ^= (HMAC_IPAD ^ HMAC_OPAD);
+    }
+    sha1_init(outer);
+    sha1_update(outer, block, SHA1_BLOCK_LENGTH);
+}
+
+/*******************************************************************************
+ * Function Name: pmk_hmac
+ *******************************************************************************
+ * Summary:
+ *  Computes an HMAC-SHA1 from the precomputed padded key states.
+ *
+ * Parameters:
+ *  inner - Pointer to the state after the inner padded key.
+ *  outer - Pointer to the state after the outer padded key.
+ *  data - Pointer to the message.
+ *  data_len - Length of the message.
+ *  mac - Buffer to store the HMAC.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void pmk_hmac(const sha1_context_t *inner, const sha1_context_t *outer,
+                     const uint8_t *data, uint32_t data_len, uint8_t mac[SHA1_DIGEST_LENGTH])
+{
+    sha1_context_t ctx;
+
+    ctx = *inner;
+    sha1_update(&ctx, data, data_len);
+    sha1_final(&ctx, mac);
+
+    ctx = *outer;
+    sha1_update(&ctx, mac, SHA1_DIGEST_LENGTH);
+    sha1_final(&ctx, mac);
+}
+
+/*******************************************************************************
+ * Function Name: pmk_pbkdf2
+ *******************************************************************************
+ * Summary:
+ *  Derives the PMK with PBKDF2-HMAC-SHA1 as defined by IEEE 802.11i.
+ *
+ * Parameters:
+ *  passphrase - Pointer to the passphrase.
+ *  passphrase_len - Length of the passphrase.
+ *  ssid - Pointer to the SSID, used as the salt.
+ *  ssid_len - Length of the SSID.
+ *  pmk - Buffer to store the PMK.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void pmk_pbkdf2(const uint8_t *passphrase, uint32_t passphrase_len,
+                       const uint8_t *ssid, uint32_t ssid_len, uint8_t pmk[PMK_LENGTH])
+{
+    sha1_context_t inner;
+    sha1_context_t outer;
+    uint8_t salt[CY_WCM_MAX_SSID_LEN + 4];
+    uint8_t u[SHA1_DIGEST_LENGTH];
+    uint8_t t[SHA1_DIGEST_LENGTH];
+    uint32_t block_index;
+    uint32_t iteration;
+    uint32_t index;
+    uint32_t offset = 0;
+    uint32_t length;
+
+    pmk_hmac_init(passphrase, passphrase_len, &inner, &outer);
+    memcpy(salt, ssid, ssid_len);
+
+    for (block_index = 1; offset < PMK_LENGTH; block_index++)
+    {
+        salt[ssid_len] = (uint8_t)(block_index >> 24);
+        salt[ssid_len + 1] = (uint8_t)(block_index >> 16);
+        salt[ssid_len + 2] = (uint8_t)(block_index >> 8);
+        salt[ssid_len + 3] = (uint8_t)block_index;
+
+        pmk_hmac(&inner, &outer, salt, ssid_len + 4, u);
+        memcpy(t, u, SHA1_DIGEST_LENGTH);
+
+        for (iteration = 1; iteration < PMK_PBKDF2_ITERATIONS; iteration++)
+        {
+            pmk_hmac(&inner, &outer, u, SHA1_DIGEST_LENGTH, u);
+            for (index = 0; index < SHA1_DIGEST_LENGTH; index++)
+            {
+                t[index] ^= u[index];
+            }
+        }
+
+        length = ((PMK_LENGTH - offset) < SHA1_DIGEST_LENGTH) ? (PMK_LENGTH - offset) : SHA1_DIGEST_LENGTH;
+        memcpy(&pmk[offset], t, length);
+        offset += length;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pmk_cache_matches
+ *******************************************************************************
+ * Summary:
+ *  Checks whether a cached PMK was derived from the given SSID and passphrase.
+ *
+ * Parameters:
+ *  cached_ssid - Pointer to the SSID of the cached PMK.
+ *  cached_passphrase - Pointer to the passphrase of the cached PMK.
+ *  ssid - Pointer to the SSID.
+ *  passphrase - Pointer to the passphrase.
+ *
+ * Return:
+ *  bool - true if the SSID and the passphrase match.
+ *
+ *******************************************************************************/
+static bool pmk_cache_matches(const uint8_t *cached_ssid, const uint8_t *cached_passphrase,
+                              const uint8_t *ssid, const uint8_t *passphrase)
+{
+    return ((0 == strncmp((const char *)cached_ssid, (const char *)ssid, CY_WCM_MAX_SSID_LEN)) &&
+            (0 == strncmp((const char *)cached_passphrase, (const char *)passphrase, CY_WCM_MAX_PASSPHRASE_LEN)));
+}
+
+/*******************************************************************************
+ * Function Name: pmk_cache_security_supported
+ *******************************************************************************
+ * Summary:
+ *  Checks whether a PMK can be used instead of the passphrase. WPA3-SAE
+ *  derives its PMK from a handshake and needs the passphrase.
+ *
+ * Parameters:
+ *  security - Security type of the AP.
+ *
+ * Return:
+ *  bool - true for the WPA and WPA2 personal security types.
+ *
+ *******************************************************************************/
+bool pmk_cache_security_supported(cy_wcm_security_t security)
+{
+    return ((CY_WCM_SECURITY_WPA_AES_PSK == security) ||
+            (CY_WCM_SECURITY_WPA_TKIP_PSK == security) ||
+            (CY_WCM_SECURITY_WPA_MIXED_PSK == security) ||
+            (CY_WCM_SECURITY_WPA2_AES_PSK == security) ||
+            (CY_WCM_SECURITY_WPA2_TKIP_PSK == security) ||
+            (CY_WCM_SECURITY_WPA2_MIXED_PSK == security));
+}
+
+/*******************************************************************************
+ * Function Name: pmk_cache_lookup
+ *******************************************************************************
+ * Summary:
+ *  Looks up the PMK of an SSID and passphrase pair in RAM and then in the
+ *  credential store.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *  passphrase - Pointer to the passphrase.
+ *  pmk - Buffer to store the PMK.
+ *
+ * Return:
+ *  bool - true if the PMK is cached.
+ *
+ *******************************************************************************/
+bool pmk_cache_lookup(const uint8_t *ssid, const uint8_t *passphrase, uint8_t pmk[PMK_LENGTH])
+{
+    cred_store_entry_t entry;
+
+    if (!pmk_cache_valid || !pmk_cache_matches(pmk_cache_ssid, pmk_cache_passphrase, ssid, passphrase))
+    {
+        if ((CY_RSLT_SUCCESS != cred_store_find(ssid, &entry)) || !entry.pmk_valid ||
+            !pmk_cache_matches(entry.ssid, entry.password, ssid, passphrase))
+        {
+            pmk_cache_misses++;
+            return false;
+        }
+
+        memcpy(pmk_cache_ssid, entry.ssid, sizeof(pmk_cache_ssid));
+        memcpy(pmk_cache_passphrase, entry.password, sizeof(pmk_cache_passphrase));
+        memcpy(pmk_cache_pmk, entry.pmk, PMK_LENGTH);
+        pmk_cache_valid = true;
+    }
+
+    memcpy(pmk, pmk_cache_pmk, PMK_LENGTH);
+    pmk_cache_hits++;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pmk_cache_derive
+ *******************************************************************************
+ * Summary:
+ *  Derives the PMK of an SSID and passphrase pair and keeps it in RAM. The
+ *  caller stores it in the credential store along with the credentials.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *  passphrase - Pointer to the passphrase.
+ *  pmk - Buffer to store the PMK.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void pmk_cache_derive(const uint8_t *ssid, const uint8_t *passphrase, uint8_t pmk[PMK_LENGTH])
+{
+    cy_time_t start;
+    cy_time_t end;
+    uint32_t ssid_len = strnlen((const char *)ssid, CY_WCM_MAX_SSID_LEN);
+    uint32_t passphrase_len = strnlen((const char *)passphrase, CY_WCM_MAX_PASSPHRASE_LEN);
+
+    cy_rtos_get_time(&start);
+    pmk_pbkdf2(passphrase, passphrase_len, ssid, ssid_len, pmk);
+    cy_rtos_get_time(&end);
+
+    pmk_cache_last_derive_msec = end - start;
+    pmk_cache_derivations++;
+
+    memset(pmk_cache_ssid, 0, sizeof(pmk_cache_ssid));
+    memset(pmk_cache_passphrase, 0, sizeof(pmk_cache_passphrase));
+    memcpy(pmk_cache_ssid, ssid, ssid_len);
+    memcpy(pmk_cache_passphrase, passphrase, passphrase_len);
+    memcpy(pmk_cache_pmk, pmk, PMK_LENGTH);
+    pmk_cache_valid = true;
+}
+
+/*******************************************************************************
+ * Function Name: pmk_to_hex
+ *******************************************************************************
+ * Summary:
+ *  Formats a PMK as the 64 hexadecimal characters accepted as the password of
+ *  the connect parameters.
+ *
+ * Parameters:
+ *  pmk - Pointer to the PMK.
+ *  hex - Buffer to store the terminated string.
+ *  hex_len - Size of the buffer, at least PMK_HEX_LENGTH + 1.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void pmk_to_hex(const uint8_t pmk[PMK_LENGTH], char *hex, uint32_t hex_len)
+{
+    static const char digits[] = "0123456789abcdef";
+    uint32_t index;
+
+    if (hex_len <= PMK_HEX_LENGTH)
+    {
+        return;
+    }
+
+    for (index = 0; index < PMK_LENGTH; index++)
+    {
+        hex[index * 2u] = digits[pmk[index] >> 4];
+        hex[index * 2u + 1u] = digits[pmk[index] & 0x0Fu];
+    }
+    hex[PMK_HEX_LENGTH] = '\0';
+}
+
+/*******************************************************************************
+ * Function Name: pmk_cache_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the statistics of the PMK cache.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void pmk_cache_get_stats(pmk_cache_stats_t *stats)
+{
+    stats->hits = pmk_cache_hits;
+    stats->misses = pmk_cache_misses;
+    stats->derivations = pmk_cache_derivations;
+    stats->last_derive_msec = pmk_cache_last_derive_msec;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,75 @@
+/******************************************************************************
+* File Name: pmk_cache.h
+*
+* Description: This file contains the configuration parameters and function
+*              prototypes of the cache of the WPA2 pairwise master keys (PMK)
+*              derived from the SSID and passphrase of the APs.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PMK_CACHE_H_
+#define PMK_CACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_wcm.h"
+
+/* A WPA/WPA2 PMK is PBKDF2-HMAC-SHA1(passphrase, SSID, 4096 iterations, 256 bits).
+ * It is passed to the connect path as 64 hexadecimal characters, which the
+ * Wi-Fi host driver installs as the PMK instead of deriving it again.
+ */
+#define PMK_LENGTH                                   (32u)
+#define PMK_HEX_LENGTH                               (PMK_LENGTH * 2u)
+#define PMK_PBKDF2_ITERATIONS                        (4096u)
+
+/* Statistics of the PMK cache reported in the metrics. */
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t derivations;
+    uint32_t last_derive_msec;
+} pmk_cache_stats_t;
+
+
+bool pmk_cache_security_supported(cy_wcm_security_t security);
+bool pmk_cache_lookup(const uint8_t *ssid, const uint8_t *passphrase, uint8_t pmk[PMK_LENGTH]);
+void pmk_cache_derive(const uint8_t *ssid, const uint8_t *passphrase, uint8_t pmk[PMK_LENGTH]);
+void pmk_to_hex(const uint8_t pmk[PMK_LENGTH], char *hex, uint32_t hex_len);
+void pmk_cache_get_stats(pmk_cache_stats_t *stats);
+
+
+#endif /* PMK_CACHE_H_ */
+
+/* [] END OF FILE */
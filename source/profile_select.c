@@ -0,0 +1,168 @@
+/*******************************************************************************
+ * File Name: profile_select.c
+ *
+ * Description: This file contains the selection of the Wi-Fi profile to
+ *              connect to: the stored profiles are ranked by their last
+ *              successful connection, the signal strength of their AP in the
+ *              scan cache and their priority.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "profile_select.h"
+
+/* Standard C header file */
+#include <string.h>
+
+/*******************************************************************************
+ * Function Name: profile_select_before
+ *******************************************************************************
+ * Summary:
+ *  Compares two candidates: a profile whose SSID was found by the scan comes
+ *  first, then the most recent successful connection, then the strongest
+ *  signal, then the highest priority, then the order of the store.
+ *
+ * Parameters:
+ *  a - Pointer to the first candidate.
+ *  b - Pointer to the second candidate.
+ *  profiles - Array of the profiles of the candidates.
+ *
+ * Return:
+ *  bool - true if a is tried before b.
+ *
+ *******************************************************************************/
+static bool profile_select_before(const profile_candidate_t *a, const profile_candidate_t *b,
+                                  const cred_store_entry_t *profiles)
+{
+    const cred_store_entry_t *pa = &profiles[a->profile];
+    const cred_store_entry_t *pb = &profiles[b->profile];
+
+    if (a->visible != b->visible)
+    {
+        return a->visible;
+    }
+
+    if (pa->last_success != pb->last_success)
+    {
+        return (pa->last_success > pb->last_success);
+    }
+
+    if (a->visible && (a->ap.rssi != b->ap.rssi))
+    {
+        return (a->ap.rssi > b->ap.rssi);
+    }
+
+    if (pa->priority != pb->priority)
+    {
+        return (pa->priority > pb->priority);
+    }
+
+    return (a->profile < b->profile);
+}
+
+/*******************************************************************************
+ * Function Name: profile_select_rank
+ *******************************************************************************
+ * Summary:
+ *  Ranks the profiles in the order they are tried. Each profile is matched
+ *  with the strongest AP of its SSID among the APs found by the scans; a
+ *  profile whose SSID was not found is kept after them, with the AP stored
+ *  in the profile, as the AP may be hidden or may not have answered the
+ *  scan. The function uses no RTOS or Wi-Fi calls so that it can be built
+ *  and timed on the host.
+ *
+ * Parameters:
+ *  profiles - Array of the profiles.
+ *  profile_count - Number of profiles.
+ *  aps - Array of the APs found by the scans.
+ *  ap_count - Number of APs.
+ *  candidates - Array of at least profile_count entries to store the ranked
+ *  candidates.
+ *
+ * Return:
+ *  uint32_t - Number of candidates.
+ *
+ *******************************************************************************/
+uint32_t profile_select_rank(const cred_store_entry_t *profiles, uint32_t profile_count,
+                             const scan_cache_entry_t *aps, uint32_t ap_count,
+                             profile_candidate_t *candidates)
+{
+    profile_candidate_t candidate;
+    uint32_t count = 0;
+    uint32_t index;
+    uint32_t ap;
+    uint32_t slot;
+
+    for (index = 0; index < profile_count; index++)
+    {
+        if (!profiles[index].valid)
+        {
+            continue;
+        }
+
+        memset(&candidate, 0, sizeof(candidate));
+        candidate.profile = index;
+
+        for (ap = 0; ap < ap_count; ap++)
+        {
+            if ((0 == strncmp((const char *)aps[ap].ssid, (const char *)profiles[index].ssid, CY_WCM_MAX_SSID_LEN)) &&
+                (!candidate.visible || (aps[ap].rssi > candidate.ap.rssi)))
+            {
+                memcpy(&candidate.ap, &aps[ap], sizeof(candidate.ap));
+                candidate.visible = true;
+            }
+        }
+
+        if (!candidate.visible)
+        {
+            memcpy(candidate.ap.ssid, profiles[index].ssid, sizeof(candidate.ap.ssid));
+            memcpy(candidate.ap.bssid, profiles[index].bssid, sizeof(candidate.ap.bssid));
+            candidate.ap.security = profiles[index].security;
+            candidate.ap.channel = profiles[index].channel;
+            candidate.ap.band = (profiles[index].channel > 14u) ? CY_WCM_WIFI_BAND_5GHZ : CY_WCM_WIFI_BAND_2_4GHZ;
+        }
+
+        /* Insertion sort; there are only a few profiles. */
+        for (slot = count; (slot > 0) && profile_select_before(&candidate, &candidates[slot - 1], profiles); slot--)
+        {
+            candidates[slot] = candidates[slot - 1];
+        }
+        candidates[slot] = candidate;
+        count++;
+    }
+
+    return count;
+}
+
+/* [] END OF FILE */
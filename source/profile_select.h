@@ -0,0 +1,68 @@
+/******************************************************************************
+* File Name: profile_select.h
+*
+* Description: This file contains the structures and function prototypes
+*              used to rank the stored Wi-Fi profiles against the APs found
+*              by the scans.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PROFILE_SELECT_H_
+#define PROFILE_SELECT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cred_store.h"
+#include "scan_cache.h"
+
+/* A profile to try, with the AP to join. When the SSID of the profile was
+ * found by a scan, ap is its strongest AP; otherwise, ap is built from the
+ * BSSID, channel and security type stored in the profile.
+ */
+typedef struct
+{
+    uint32_t profile;
+    bool visible;
+    scan_cache_entry_t ap;
+} profile_candidate_t;
+
+
+uint32_t profile_select_rank(const cred_store_entry_t *profiles, uint32_t profile_count,
+                             const scan_cache_entry_t *aps, uint32_t ap_count,
+                             profile_candidate_t *candidates);
+
+
+#endif /* PROFILE_SELECT_H_ */
+
+/* [] END OF FILE */
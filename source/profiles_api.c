@@ -0,0 +1,588 @@
+/*******************************************************************************
+ * File Name: profiles_api.c
+ *
+ * Description: This file contains the JSON API used to list, add, update
+ *              and remove the stored Wi-Fi profiles.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cy_http_server.h"
+
+/* HTTP server task header file. */
+#include "web_server.h"
+#include "profiles_api.h"
+
+/* Standard C header file */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Buffer used to format the profiles response. */
+static char profiles_response[PROFILES_RESPONSE_LENGTH];
+
+/* Profiles read or updated by the request being handled; kept out of the
+ * stacks of the HTTP server threads.
+ */
+static cred_store_entry_t profiles_api_profiles[CRED_STORE_MAX_PROFILES];
+static cred_store_entry_t profiles_api_entry;
+
+/* Serializes the requests between HTTP server threads. */
+static cy_mutex_t profiles_mutex;
+
+/*******************************************************************************
+ * Function Name: profiles_api_append
+ *******************************************************************************
+ * Summary:
+ *  Appends formatted text to the profiles response.
+ *
+ * Parameters:
+ *  offset - Current length of the profiles response.
+ *  format - printf style format of the text.
+ *
+ * Return:
+ *  uint32_t - New length of the profiles response.
+ *
+ *******************************************************************************/
+static uint32_t profiles_api_append(uint32_t offset, const char *format, ...)
+{
+    va_list args;
+    int length;
+
+    if (offset >= sizeof(profiles_response))
+    {
+        return offset;
+    }
+
+    va_start(args, format);
+    length = vsnprintf(&profiles_response[offset], sizeof(profiles_response) - offset, format, args);
+    va_end(args);
+
+    if (length < 0)
+    {
+        return offset;
+    }
+
+    offset += (uint32_t)length;
+    return (offset < sizeof(profiles_response)) ? offset : (sizeof(profiles_response) - 1);
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_append_string
+ *******************************************************************************
+ * Summary:
+ *  Appends a string to the profiles response as a quoted JSON string.
+ *
+ * Parameters:
+ *  offset - Current length of the profiles response.
+ *  text - Pointer to the string.
+ *
+ * Return:
+ *  uint32_t - New length of the profiles response.
+ *
+ *******************************************************************************/
+static uint32_t profiles_api_append_string(uint32_t offset, const char *text)
+{
+    offset = profiles_api_append(offset, "\"");
+
+    for (; '\0' != *text; text++)
+    {
+        if (('"' == *text) || ('\\' == *text))
+        {
+            offset = profiles_api_append(offset, "\\%c", *text);
+        }
+        else if ((uint8_t)*text < 0x20u)
+        {
+            offset = profiles_api_append(offset, "\\u%04x", (unsigned int)(uint8_t)*text);
+        }
+        else
+        {
+            offset = profiles_api_append(offset, "%c", *text);
+        }
+    }
+
+    return profiles_api_append(offset, "\"");
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_skip_space
+ *******************************************************************************
+ * Summary:
+ *  Skips the JSON whitespace.
+ *
+ * Parameters:
+ *  text - Pointer to the text.
+ *  end - Pointer to the end of the JSON object.
+ *
+ * Return:
+ *  const char * - Pointer to the first character that is not whitespace.
+ *
+ *******************************************************************************/
+static const char *profiles_api_skip_space(const char *text, const char *end)
+{
+    while ((text < end) && ((' ' == *text) || ('\t' == *text) || ('\r' == *text) || ('\n' == *text)))
+    {
+        text++;
+    }
+
+    return text;
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_skip_value
+ *******************************************************************************
+ * Summary:
+ *  Skips a JSON string, or a number or literal, of a flat JSON object.
+ *
+ * Parameters:
+ *  value - Pointer to the value.
+ *  end - Pointer to the end of the JSON object.
+ *
+ * Return:
+ *  const char * - Pointer to the character after the value, or NULL if the
+ *  value is an unterminated string, an object or an array.
+ *
+ *******************************************************************************/
+static const char *profiles_api_skip_value(const char *value, const char *end)
+{
+    if ((value < end) && ('"' == *value))
+    {
+        for (value++; value < end; value++)
+        {
+            if ('\\' == *value)
+            {
+                value++;
+            }
+            else if ('"' == *value)
+            {
+                return value + 1;
+            }
+        }
+        return NULL;
+    }
+
+    if ((value >= end) || ('{' == *value) || ('[' == *value))
+    {
+        return NULL;
+    }
+
+    while ((value < end) && (',' != *value) && ('}' != *value) && (' ' != *value) &&
+           ('\t' != *value) && ('\r' != *value) && ('\n' != *value))
+    {
+        value++;
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_field
+ *******************************************************************************
+ * Summary:
+ *  Finds the value of a field in a flat JSON object. The object is walked
+ *  key by key, so a string value that contains the name of a field is not
+ *  taken for that field.
+ *
+ * Parameters:
+ *  body - Pointer to the JSON object, not NUL-terminated.
+ *  end - Pointer to the end of the JSON object.
+ *  name - Name of the field.
+ *
+ * Return:
+ *  const char * - Pointer to the first character of the value, or NULL if
+ *  the field is not found or the object is malformed.
+ *
+ *******************************************************************************/
+static const char *profiles_api_field(const char *body, const char *end, const char *name)
+{
+    uint32_t name_len = strlen(name);
+    const char *key;
+    const char *key_end;
+    const char *value;
+
+    body = profiles_api_skip_space(body, end);
+    if ((body >= end) || ('{' != *body))
+    {
+        return NULL;
+    }
+
+    for (body = profiles_api_skip_space(body + 1, end); (body < end) && ('}' != *body);)
+    {
+        key = body;
+        key_end = profiles_api_skip_value(key, end);
+        if ((NULL == key_end) || ('"' != *key))
+        {
+            return NULL;
+        }
+
+        value = profiles_api_skip_space(key_end, end);
+        if ((value >= end) || (':' != *value))
+        {
+            return NULL;
+        }
+        value = profiles_api_skip_space(value + 1, end);
+
+        if (((uint32_t)(key_end - key) == (name_len + 2)) && (0 == memcmp(&key[1], name, name_len)))
+        {
+            return (value < end) ? value : NULL;
+        }
+
+        body = profiles_api_skip_value(value, end);
+        if (NULL == body)
+        {
+            return NULL;
+        }
+
+        body = profiles_api_skip_space(body, end);
+        if ((body < end) && (',' == *body))
+        {
+            body = profiles_api_skip_space(body + 1, end);
+        }
+        else if ((body >= end) || ('}' != *body))
+        {
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_string
+ *******************************************************************************
+ * Summary:
+ *  Parses a JSON string value. Only the \" \\ and \/ escapes are accepted.
+ *
+ * Parameters:
+ *  value - Pointer to the value.
+ *  end - Pointer to the end of the JSON object.
+ *  buf - Buffer to store the NUL-terminated string.
+ *  buf_len - Size of the buffer.
+ *
+ * Return:
+ *  bool - true if the value is a string that fits in the buffer.
+ *
+ *******************************************************************************/
+static bool profiles_api_string(const char *value, const char *end, char *buf, uint32_t buf_len)
+{
+    uint32_t length = 0;
+
+    if ((NULL == value) || ('"' != *value))
+    {
+        return false;
+    }
+
+    for (value++; value < end; value++)
+    {
+        if ('"' == *value)
+        {
+            buf[length] = '\0';
+            return true;
+        }
+
+        if ('\\' == *value)
+        {
+            value++;
+            if ((value >= end) || (('"' != *value) && ('\\' != *value) && ('/' != *value)))
+            {
+                return false;
+            }
+        }
+
+        if (length >= (buf_len - 1))
+        {
+            return false;
+        }
+        buf[length++] = *value;
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_number
+ *******************************************************************************
+ * Summary:
+ *  Parses a JSON number value as an unsigned integer.
+ *
+ * Parameters:
+ *  value - Pointer to the value.
+ *  end - Pointer to the end of the JSON object.
+ *  max - Largest value accepted.
+ *  number - Pointer to store the number.
+ *
+ * Return:
+ *  bool - true if the value is an integer not greater than max.
+ *
+ *******************************************************************************/
+static bool profiles_api_number(const char *value, const char *end, uint32_t max, uint32_t *number)
+{
+    *number = 0;
+
+    if ((NULL == value) || (value >= end) || (*value < '0') || (*value > '9'))
+    {
+        return false;
+    }
+
+    for (; (value < end) && (*value >= '0') && (*value <= '9'); value++)
+    {
+        *number = (*number * 10u) + (uint32_t)(*value - '0');
+        if (*number > max)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_list
+ *******************************************************************************
+ * Summary:
+ *  Formats the stored profiles, without their passwords.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t - Length of the profiles response.
+ *
+ *******************************************************************************/
+static uint32_t profiles_api_list(void)
+{
+    uint32_t length = 0;
+    uint32_t count = 0;
+    uint32_t index;
+
+    (void)cred_store_load(profiles_api_profiles, &count);
+
+    length = profiles_api_append(length, "{\"profiles\":[");
+    for (index = 0; index < count; index++)
+    {
+        length = profiles_api_append(length, "%s{\"ssid\":", (0 == index) ? "" : ",");
+        length = profiles_api_append_string(length, (const char *)profiles_api_profiles[index].ssid);
+        length = profiles_api_append(length, ",\"priority\":%u,\"last_success\":%lu,\"channel\":%u}",
+                                     (unsigned int)profiles_api_profiles[index].priority,
+                                     (unsigned long)profiles_api_profiles[index].last_success,
+                                     (unsigned int)profiles_api_profiles[index].channel);
+    }
+
+    return profiles_api_append(length, "]}");
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_update
+ *******************************************************************************
+ * Summary:
+ *  Adds, updates or removes the profile described by a JSON object. A new
+ *  profile has no known BSSID or channel until it connects; its security
+ *  type is taken from the scan, or assumed from whether it has a password.
+ *
+ * Parameters:
+ *  body - Pointer to the JSON object, not NUL-terminated.
+ *  body_len - Length of the JSON object.
+ *
+ * Return:
+ *  const char * - NULL if the request succeeded, otherwise, the reason of
+ *  the error.
+ *
+ *******************************************************************************/
+static const char *profiles_api_update(const char *body, uint32_t body_len)
+{
+    const char *end = body + body_len;
+    const char *value;
+    cy_wcm_ssid_t ssid;
+    cy_wcm_passphrase_t password;
+    bool has_password;
+    bool has_priority;
+    uint32_t priority = 0;
+    size_t length;
+
+    memset(ssid, 0, sizeof(ssid));
+    if (!profiles_api_string(profiles_api_field(body, end, "ssid"), end, (char *)ssid, sizeof(ssid)) || ('\0' == ssid[0]))
+    {
+        return "invalid ssid";
+    }
+
+    value = profiles_api_field(body, end, "delete");
+    if ((NULL != value) && ((end - value) >= 4) && (0 == memcmp(value, "true", 4)))
+    {
+        return (CY_RSLT_SUCCESS == cred_store_remove(ssid)) ? NULL : "unknown ssid";
+    }
+
+    memset(password, 0, sizeof(password));
+    value = profiles_api_field(body, end, "password");
+    has_password = (NULL != value);
+    if (has_password && !profiles_api_string(value, end, (char *)password, sizeof(password)))
+    {
+        return "invalid password";
+    }
+
+    /* An empty password is an open network; a WPA passphrase is 8 to 63
+     * characters.
+     */
+    length = strlen((const char *)password);
+    if ((0 != length) && ((length < PROFILES_PASSWORD_MIN_LEN) || (length > PROFILES_PASSWORD_MAX_LEN)))
+    {
+        return "invalid password";
+    }
+
+    value = profiles_api_field(body, end, "priority");
+    has_priority = (NULL != value);
+    if (has_priority && !profiles_api_number(value, end, UINT8_MAX, &priority))
+    {
+        return "invalid priority";
+    }
+
+    if (CY_RSLT_SUCCESS != cred_store_find(ssid, &profiles_api_entry))
+    {
+        memset(&profiles_api_entry, 0, sizeof(profiles_api_entry));
+        memcpy(profiles_api_entry.ssid, ssid, sizeof(profiles_api_entry.ssid));
+        profiles_api_entry.security = ('\0' == password[0]) ? CY_WCM_SECURITY_OPEN : CY_WCM_SECURITY_WPA2_AES_PSK;
+    }
+
+    if (has_password && (0 != strncmp((const char *)profiles_api_entry.password, (const char *)password, sizeof(password))))
+    {
+        memcpy(profiles_api_entry.password, password, sizeof(profiles_api_entry.password));
+        profiles_api_entry.pmk_valid = false;
+        memset(profiles_api_entry.pmk, 0, sizeof(profiles_api_entry.pmk));
+    }
+
+    if (has_priority)
+    {
+        profiles_api_entry.priority = (uint8_t)priority;
+    }
+
+    return (CY_RSLT_SUCCESS == cred_store_save(&profiles_api_entry, false)) ? NULL : "store failed";
+}
+
+/*******************************************************************************
+ * Function Name: profiles_api_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the profiles resource.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the profiles resource is initialized
+ *  successfully, otherwise, it returns the RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t profiles_api_init(void)
+{
+    return cy_rtos_init_mutex(&profiles_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: profiles_resource_handler
+ *******************************************************************************
+ * Summary:
+ *  Handles the HTTP GET request listing the stored Wi-Fi profiles and the
+ *  HTTP POST request adding, updating or removing one, as described in
+ *  profiles_api.h. A POST request that cannot be applied is answered with
+ *  400 Bad Request and the reason of the error.
+ *
+ * Parameters:
+ *  url_path - Pointer to the HTTP URL path.
+ *  url_parameters - Pointer to the HTTP URL query string.
+ *  stream - Pointer to the HTTP response stream.
+ *  arg - Pointer to the argument passed during HTTP resource registration.
+ *  http_message_body - Pointer to the HTTP data from the client.
+ *
+ * Return:
+ *  int32_t - Returns HTTP_REQUEST_HANDLE_SUCCESS if the request from the client
+ *  was handled successfully. Otherwise, it returns HTTP_REQUEST_HANDLE_ERROR.
+ *
+ *******************************************************************************/
+int32_t profiles_resource_handler(const char *url_path,
+                                  const char *url_parameters,
+                                  cy_http_response_stream_t *stream,
+                                  void *arg,
+                                  cy_http_message_body_t *http_message_body)
+{
+    cy_rslt_t result;
+    uint32_t length;
+    const char *error = NULL;
+
+    if ((CY_HTTP_REQUEST_GET != http_message_body->request_type) &&
+        (CY_HTTP_REQUEST_POST != http_message_body->request_type))
+    {
+        ERR_INFO(("Received invalid HTTP request method for the profiles. Supported HTTP methods are GET and POST.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+
+    cy_rtos_get_mutex(&profiles_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    if (CY_HTTP_REQUEST_GET == http_message_body->request_type)
+    {
+        length = profiles_api_list();
+    }
+    else
+    {
+        error = profiles_api_update((const char *)http_message_body->data, http_message_body->data_length);
+        length = (NULL == error) ? profiles_api_append(0, "{\"result\":\"ok\"}")
+                                 : profiles_api_append(0, "{\"error\":\"%s\"}", error);
+    }
+
+    result = CY_RSLT_SUCCESS;
+    if (NULL != error)
+    {
+        result = cy_http_server_response_stream_write_header(stream, CY_HTTP_400_TYPE, length,
+                                                             CY_HTTP_CACHE_DISABLED, CY_HTTP_MIME_TYPE_JSON);
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_http_server_response_stream_write_payload(stream, profiles_response, length);
+    }
+
+    cy_rtos_set_mutex(&profiles_mutex);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to send the profiles response.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+
+    return HTTP_REQUEST_HANDLE_SUCCESS;
+}
+
+/* [] END OF FILE */
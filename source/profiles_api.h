@@ -0,0 +1,76 @@
+/******************************************************************************
+* File Name: profiles_api.h
+*
+* Description: This file contains the configuration parameters and function
+*              prototypes of the JSON API used to manage the stored Wi-Fi
+*              profiles.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef PROFILES_API_H_
+#define PROFILES_API_H_
+
+#include "cy_http_server.h"
+
+/* URL of the Wi-Fi profiles resource.
+ *
+ * GET returns the stored profiles, without their passwords:
+ *  {"profiles":[{"ssid":"...","priority":0,"last_success":0,"channel":0}]}
+ * POST adds a profile, or updates the password and priority of a stored one:
+ *  {"ssid":"...","password":"...","priority":0}
+ * or removes it:
+ *  {"ssid":"...","delete":true}
+ * and returns {"result":"ok"}, or 400 Bad Request with {"error":"<reason>"}.
+ * The password is empty for an open network, or a WPA passphrase of
+ * PROFILES_PASSWORD_MIN_LEN to PROFILES_PASSWORD_MAX_LEN characters.
+ */
+#define PROFILES_URL                                 "/profiles"
+#define PROFILES_PASSWORD_MIN_LEN                    (8u)
+#define PROFILES_PASSWORD_MAX_LEN                    (63u)
+
+/* Buffer used to format the profiles response. */
+#define PROFILES_RESPONSE_LENGTH                     (1536u)
+
+
+cy_rslt_t profiles_api_init(void);
+int32_t profiles_resource_handler(const char *url_path,
+                                  const char *url_parameters,
+                                  cy_http_response_stream_t *stream,
+                                  void *arg,
+                                  cy_http_message_body_t *http_message_body);
+
+
+#endif /* PROFILES_API_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,276 @@
+/*******************************************************************************
+ * File Name: rate_control.c
+ *
+ * Description: This file contains the controller that widens the device data
+ *              upload interval when the TX packet pool is nearly exhausted,
+ *              the writes are slow or the link is weak, and narrows it again
+ *              when there is headroom.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "rate_control.h"
+
+/* NetX Duo and network interface header files */
+#include "nx_api.h"
+#include "cy_network_mw_core.h"
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Shortest and current upload interval, and number of uploads in a row with
+ * headroom.
+ */
+static uint32_t rate_min_interval_msec = RATE_CONTROL_MAX_INTERVAL_MSEC;
+static uint32_t rate_interval_msec = RATE_CONTROL_MAX_INTERVAL_MSEC;
+static uint32_t rate_headroom_count = 0;
+
+/* Last measurements and decisions, reported in the metrics. */
+static volatile uint32_t rate_tx_pool_free = 0;
+static volatile uint32_t rate_tx_pool_free_min = UINT32_MAX;
+static volatile uint32_t rate_write_time_msec = 0;
+static volatile uint32_t rate_decisions[RATE_CONTROL_REASON_COUNT];
+
+/* Names of the decision reasons used in the metrics. */
+static const char *rate_reason_names[RATE_CONTROL_REASON_COUNT] =
+{
+    "tx_pool",
+    "slow_write",
+    "weak_link",
+    "headroom"
+};
+
+/*******************************************************************************
+ * Function Name: rate_control_init
+ *******************************************************************************
+ * Summary:
+ *  Sets the shortest upload interval and starts from it.
+ *
+ * Parameters:
+ *  min_interval_msec - Shortest upload interval in milliseconds.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void rate_control_init(uint32_t min_interval_msec)
+{
+    uint32_t index;
+
+    rate_min_interval_msec = min_interval_msec;
+    rate_interval_msec = min_interval_msec;
+    rate_headroom_count = 0;
+    rate_tx_pool_free_min = UINT32_MAX;
+
+    for (index = 0; index < RATE_CONTROL_REASON_COUNT; index++)
+    {
+        rate_decisions[index] = 0;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: rate_control_update
+ *******************************************************************************
+ * Summary:
+ *  Decides the interval before the next upload from the measurements of the
+ *  last one. The interval is doubled on pressure, up to
+ *  RATE_CONTROL_MAX_INTERVAL_MSEC, and narrowed by
+ *  RATE_CONTROL_NARROW_STEP_MSEC after RATE_CONTROL_HEADROOM_SAMPLES uploads
+ *  in a row without pressure. A weak link raises the lower bound.
+ *
+ * Parameters:
+ *  input - Pointer to the measurements of the last upload.
+ *
+ * Return:
+ *  uint32_t - Interval in milliseconds before the next upload.
+ *
+ *******************************************************************************/
+uint32_t rate_control_update(const rate_control_input_t *input)
+{
+    uint32_t floor_msec = rate_min_interval_msec;
+    uint32_t interval_msec = rate_interval_msec;
+    rate_control_reason_t reason = RATE_CONTROL_REASON_COUNT;
+    bool tx_pool_low = false;
+    bool tx_pool_headroom = true;
+
+    if (input->tx_pool_total > 0)
+    {
+        tx_pool_low = (input->tx_pool_free <= RATE_CONTROL_TX_POOL_LOW_WATER);
+        tx_pool_headroom = (input->tx_pool_free >= (input->tx_pool_total / 2u));
+
+        rate_tx_pool_free = input->tx_pool_free;
+        if (input->tx_pool_free < rate_tx_pool_free_min)
+        {
+            rate_tx_pool_free_min = input->tx_pool_free;
+        }
+    }
+    rate_write_time_msec = input->write_time_msec;
+
+    if (input->rssi_valid && (input->rssi_dbm < RATE_CONTROL_WEAK_LINK_RSSI_DBM))
+    {
+        floor_msec = RATE_CONTROL_WEAK_LINK_MIN_INTERVAL_MSEC;
+    }
+
+    if (tx_pool_low || (input->write_time_msec >= RATE_CONTROL_SLOW_WRITE_MSEC))
+    {
+        rate_headroom_count = 0;
+        interval_msec = (interval_msec * 2u < RATE_CONTROL_MAX_INTERVAL_MSEC) ?
+                        (interval_msec * 2u) : RATE_CONTROL_MAX_INTERVAL_MSEC;
+        reason = tx_pool_low ? RATE_CONTROL_REASON_TX_POOL : RATE_CONTROL_REASON_SLOW_WRITE;
+    }
+    else if (tx_pool_headroom && (input->write_time_msec < (RATE_CONTROL_SLOW_WRITE_MSEC / 2u)))
+    {
+        if (++rate_headroom_count >= RATE_CONTROL_HEADROOM_SAMPLES)
+        {
+            rate_headroom_count = 0;
+            interval_msec = (interval_msec > floor_msec + RATE_CONTROL_NARROW_STEP_MSEC) ?
+                            (interval_msec - RATE_CONTROL_NARROW_STEP_MSEC) : floor_msec;
+            reason = RATE_CONTROL_REASON_HEADROOM;
+        }
+    }
+    else
+    {
+        rate_headroom_count = 0;
+    }
+
+    if (interval_msec < floor_msec)
+    {
+        interval_msec = floor_msec;
+        reason = RATE_CONTROL_REASON_WEAK_LINK;
+    }
+
+    if ((interval_msec != rate_interval_msec) && (reason < RATE_CONTROL_REASON_COUNT))
+    {
+        rate_decisions[reason]++;
+    }
+
+    rate_interval_msec = interval_msec;
+    return interval_msec;
+}
+
+/*******************************************************************************
+ * Function Name: rate_control_get_tx_pool
+ *******************************************************************************
+ * Summary:
+ *  Reads the occupancy of the packet pool used to transmit, which has
+ *  TX_PACKET_POOL_SIZE packets. The pool is shared by the interfaces, so it
+ *  is read through the STA interface, or through the SoftAP interface when
+ *  the STA interface does not exist, for example before the first
+ *  connection. The SoftAP interface is gone after an idle teardown, and
+ *  never exists after a boot with the stored credentials.
+ *
+ * Parameters:
+ *  tx_pool_free - Pointer to store the number of free packets.
+ *  tx_pool_total - Pointer to store the number of packets in the pool.
+ *
+ * Return:
+ *  bool - true if the occupancy was read, false otherwise.
+ *
+ *******************************************************************************/
+bool rate_control_get_tx_pool(uint32_t *tx_pool_free, uint32_t *tx_pool_total)
+{
+    NX_IP *ip;
+    ULONG total_packets = 0;
+    ULONG free_packets = 0;
+
+    ip = (NX_IP *)cy_network_get_nw_interface(CY_NETWORK_WIFI_STA_INTERFACE, 0);
+    if ((NX_NULL == ip) || (NX_NULL == ip->nx_ip_default_packet_pool))
+    {
+        ip = (NX_IP *)cy_network_get_nw_interface(CY_NETWORK_WIFI_AP_INTERFACE, 0);
+    }
+
+    if ((NX_NULL == ip) || (NX_NULL == ip->nx_ip_default_packet_pool))
+    {
+        return false;
+    }
+
+    if (NX_SUCCESS != nx_packet_pool_info_get(ip->nx_ip_default_packet_pool, &total_packets,
+                                              &free_packets, NX_NULL, NX_NULL, NX_NULL))
+    {
+        return false;
+    }
+
+    *tx_pool_free = (uint32_t)free_packets;
+    *tx_pool_total = (uint32_t)total_packets;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: rate_control_reason_name
+ *******************************************************************************
+ * Summary:
+ *  Returns the name of a decision reason.
+ *
+ * Parameters:
+ *  reason - Decision reason.
+ *
+ * Return:
+ *  const char * - Name of the reason.
+ *
+ *******************************************************************************/
+const char *rate_control_reason_name(rate_control_reason_t reason)
+{
+    return (reason < RATE_CONTROL_REASON_COUNT) ? rate_reason_names[reason] : "unknown";
+}
+
+/*******************************************************************************
+ * Function Name: rate_control_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the current interval, the last measurements and the number of
+ *  decisions taken for each reason.
+ *
+ * Parameters:
+ *  stats - Pointer to store the state of the controller.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void rate_control_get_stats(rate_control_stats_t *stats)
+{
+    uint32_t index;
+
+    stats->interval_msec = rate_interval_msec;
+    stats->tx_pool_free = rate_tx_pool_free;
+    stats->tx_pool_free_min = (UINT32_MAX == rate_tx_pool_free_min) ? 0 : rate_tx_pool_free_min;
+    stats->write_time_msec = rate_write_time_msec;
+
+    for (index = 0; index < RATE_CONTROL_REASON_COUNT; index++)
+    {
+        stats->decisions[index] = rate_decisions[index];
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,116 @@
+/******************************************************************************
+* File Name: rate_control.h
+*
+* Description: This file contains the configuration parameters, structures
+*              and function prototypes of the controller that adapts the
+*              device data upload interval to the TX packet pool occupancy,
+*              the write latency and the link quality.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RATE_CONTROL_H_
+#define RATE_CONTROL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Longest device data upload interval. The shortest one is passed to
+ * rate_control_init() and is also the initial interval.
+ */
+#define RATE_CONTROL_MAX_INTERVAL_MSEC               (1000u)
+
+/* The interval is doubled on pressure and narrowed by the step only after
+ * RATE_CONTROL_HEADROOM_SAMPLES uploads in a row had headroom, so that the
+ * rate backs off quickly and recovers slowly.
+ */
+#define RATE_CONTROL_NARROW_STEP_MSEC                (50u)
+#define RATE_CONTROL_HEADROOM_SAMPLES                (10u)
+
+/* Pressure: the free TX packets are at or below the low watermark, or writing
+ * one upload took at least RATE_CONTROL_SLOW_WRITE_MSEC. Each upload can use
+ * a TX packet per event stream subscriber and one for the WebSocket client.
+ */
+#define RATE_CONTROL_TX_POOL_LOW_WATER               (3u)
+#define RATE_CONTROL_SLOW_WRITE_MSEC                 (100u)
+
+/* Below this RSSI, the interval is kept at or above
+ * RATE_CONTROL_WEAK_LINK_MIN_INTERVAL_MSEC because every frame takes longer
+ * on air at the lower rates used on a weak link.
+ */
+#define RATE_CONTROL_WEAK_LINK_RSSI_DBM              (-75)
+#define RATE_CONTROL_WEAK_LINK_MIN_INTERVAL_MSEC     (200u)
+
+/* Reason of an interval decision. */
+typedef enum
+{
+    RATE_CONTROL_REASON_TX_POOL = 0,
+    RATE_CONTROL_REASON_SLOW_WRITE,
+    RATE_CONTROL_REASON_WEAK_LINK,
+    RATE_CONTROL_REASON_HEADROOM,
+    RATE_CONTROL_REASON_COUNT
+} rate_control_reason_t;
+
+/* Measurements of the last upload. tx_pool_total is 0 when the occupancy of
+ * the TX packet pool is not known.
+ */
+typedef struct
+{
+    uint32_t tx_pool_free;
+    uint32_t tx_pool_total;
+    uint32_t write_time_msec;
+    bool rssi_valid;
+    int8_t rssi_dbm;
+} rate_control_input_t;
+
+/* State of the controller reported in the metrics. */
+typedef struct
+{
+    uint32_t interval_msec;
+    uint32_t tx_pool_free;
+    uint32_t tx_pool_free_min;
+    uint32_t write_time_msec;
+    uint32_t decisions[RATE_CONTROL_REASON_COUNT];
+} rate_control_stats_t;
+
+
+void rate_control_init(uint32_t min_interval_msec);
+uint32_t rate_control_update(const rate_control_input_t *input);
+bool rate_control_get_tx_pool(uint32_t *tx_pool_free, uint32_t *tx_pool_total);
+const char *rate_control_reason_name(rate_control_reason_t reason);
+void rate_control_get_stats(rate_control_stats_t *stats);
+
+
+#endif /* RATE_CONTROL_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,291 @@
+/*******************************************************************************
+ * File Name: retry_policy.c
+ *
+ * Description: This file contains the retry policy used for the Wi-Fi
+ *              connection attempts and the classification of the WCM and WHD
+ *              error codes.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "retry_policy.h"
+
+/* Wi-Fi connection manager header files */
+#include "cy_wcm.h"
+#include "cy_wcm_error.h"
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Statistics of all the sequences of attempts. */
+static volatile uint32_t retry_attempts = 0;
+static volatile uint32_t retry_retries = 0;
+static volatile retry_outcome_t retry_last_outcome = RETRY_OUTCOME_NONE;
+static volatile uint32_t retry_last_attempts = 0;
+
+/* Names of the outcomes used in the metrics. */
+static const char *retry_outcome_names[] =
+{
+    "none",
+    "success",
+    "fatal",
+    "max_attempts",
+    "deadline",
+    "rejected"
+};
+
+/*******************************************************************************
+ * Function Name: retry_policy_random
+ *******************************************************************************
+ * Summary:
+ *  Returns the next value of the xorshift32 generator used for the jitter.
+ *
+ * Parameters:
+ *  policy - Pointer to the retry policy.
+ *
+ * Return:
+ *  uint32_t - Pseudo-random value.
+ *
+ *******************************************************************************/
+static uint32_t retry_policy_random(retry_policy_t *policy)
+{
+    uint32_t x = policy->random_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    policy->random_state = x;
+
+    return x;
+}
+
+/*******************************************************************************
+ * Function Name: retry_policy_finish
+ *******************************************************************************
+ * Summary:
+ *  Records the outcome of a sequence of attempts.
+ *
+ * Parameters:
+ *  policy - Pointer to the retry policy.
+ *  outcome - Outcome of the sequence.
+ *
+ * Return:
+ *  bool - Always false, so that it can be returned by retry_policy_next.
+ *
+ *******************************************************************************/
+static bool retry_policy_finish(retry_policy_t *policy, retry_outcome_t outcome)
+{
+    retry_last_outcome = outcome;
+    retry_last_attempts = policy->attempts;
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: retry_policy_start
+ *******************************************************************************
+ * Summary:
+ *  Starts a sequence of attempts.
+ *
+ * Parameters:
+ *  policy - Pointer to the retry policy.
+ *  config - Pointer to the parameters of the policy, which must stay valid
+ *  during the sequence.
+ *  seed - Seed of the jitter, which should differ between devices, for
+ *  example derived from the MAC address.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void retry_policy_start(retry_policy_t *policy, const retry_policy_config_t *config, uint32_t seed)
+{
+    cy_rtos_get_time(&policy->start_time);
+    policy->config = config;
+    policy->attempts = 0;
+    policy->rejections = 0;
+    policy->delay_msec = config->initial_delay_msec;
+    policy->random_state = (0 == seed) ? 0x9E3779B9u : seed;
+}
+
+/*******************************************************************************
+ * Function Name: retry_policy_next
+ *******************************************************************************
+ * Summary:
+ *  Decides whether to retry after an attempt and how long to wait first.
+ *
+ * Parameters:
+ *  policy - Pointer to the retry policy.
+ *  result - Result of the attempt.
+ *  delay_msec - Pointer to store the delay before the next attempt.
+ *
+ * Return:
+ *  bool - true to retry after the delay, false if the attempt succeeded or
+ *  the sequence is over.
+ *
+ *******************************************************************************/
+bool retry_policy_next(retry_policy_t *policy, cy_rslt_t result, uint32_t *delay_msec)
+{
+    const retry_policy_config_t *config = policy->config;
+    retry_class_t retry_class = RETRY_CLASS_RETRYABLE;
+    cy_time_t now;
+    uint32_t delay;
+    uint32_t jitter;
+
+    policy->attempts++;
+    retry_attempts++;
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        return retry_policy_finish(policy, RETRY_OUTCOME_SUCCESS);
+    }
+
+    if (NULL != config->classify)
+    {
+        retry_class = config->classify(result);
+    }
+
+    if (RETRY_CLASS_FATAL == retry_class)
+    {
+        return retry_policy_finish(policy, RETRY_OUTCOME_FATAL);
+    }
+
+    if ((RETRY_CLASS_REJECTED == retry_class) && (++policy->rejections > config->max_rejections))
+    {
+        return retry_policy_finish(policy, RETRY_OUTCOME_REJECTED);
+    }
+
+    if (policy->attempts >= config->max_attempts)
+    {
+        return retry_policy_finish(policy, RETRY_OUTCOME_MAX_ATTEMPTS);
+    }
+
+    delay = policy->delay_msec;
+    jitter = (delay * config->jitter_percent) / 100u;
+    if (jitter > 0)
+    {
+        delay = delay - jitter + (retry_policy_random(policy) % (2u * jitter + 1u));
+    }
+
+    cy_rtos_get_time(&now);
+    if ((now - policy->start_time) + delay >= config->deadline_msec)
+    {
+        return retry_policy_finish(policy, RETRY_OUTCOME_DEADLINE);
+    }
+
+    policy->delay_msec = (policy->delay_msec < (config->max_delay_msec / 2u)) ?
+                         (policy->delay_msec * 2u) : config->max_delay_msec;
+
+    retry_retries++;
+    *delay_msec = delay;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: retry_policy_classify_wcm
+ *******************************************************************************
+ * Summary:
+ *  Classifies the result of cy_wcm_connect_ap(). Invalid parameters and
+ *  unsupported security types are fatal. The WCM of the CYW955913 has no WHD
+ *  and reports a join the AP refused, such as with a wrong password, as
+ *  CY_RSLT_WCM_STA_CONNECT_ERROR, which is classified as rejected. A timeout
+ *  or a DHCP failure may be transient, for example while the AP reboots.
+ *
+ * Parameters:
+ *  result - Result of the connection attempt.
+ *
+ * Return:
+ *  retry_class_t - Classification of the result.
+ *
+ *******************************************************************************/
+retry_class_t retry_policy_classify_wcm(cy_rslt_t result)
+{
+    switch (result)
+    {
+    case CY_RSLT_WCM_BAD_NETWORK_PARAM:
+    case CY_RSLT_WCM_BAD_SSID_LEN:
+    case CY_RSLT_WCM_BAD_PASSPHRASE_LEN:
+    case CY_RSLT_WCM_SECURITY_NOT_SUPPORTED:
+    case CY_RSLT_WCM_BAD_ARG:
+    case CY_RSLT_WCM_INTERFACE_NOT_SUPPORTED:
+    case CY_RSLT_WCM_NOT_INITIALIZED:
+        return RETRY_CLASS_FATAL;
+
+    case CY_RSLT_WCM_STA_CONNECT_ERROR:
+        return RETRY_CLASS_REJECTED;
+
+    default:
+        return RETRY_CLASS_RETRYABLE;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: retry_policy_outcome_name
+ *******************************************************************************
+ * Summary:
+ *  Returns the name of an outcome.
+ *
+ * Parameters:
+ *  outcome - Outcome of a sequence of attempts.
+ *
+ * Return:
+ *  const char * - Name of the outcome.
+ *
+ *******************************************************************************/
+const char *retry_policy_outcome_name(retry_outcome_t outcome)
+{
+    return (outcome <= RETRY_OUTCOME_REJECTED) ? retry_outcome_names[outcome] : "unknown";
+}
+
+/*******************************************************************************
+ * Function Name: retry_policy_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the statistics of the retry policies.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void retry_policy_get_stats(retry_policy_stats_t *stats)
+{
+    stats->attempts = retry_attempts;
+    stats->retries = retry_retries;
+    stats->last_outcome = retry_last_outcome;
+    stats->last_attempts = retry_last_attempts;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,120 @@
+/******************************************************************************
+* File Name: retry_policy.h
+*
+* Description: This file contains the structures and function prototypes of
+*              the retry policy used for the Wi-Fi connection attempts:
+*              capped exponential backoff with jitter, a total deadline and
+*              the classification of the errors as retryable or not.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef RETRY_POLICY_H_
+#define RETRY_POLICY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+#include "cyabs_rtos.h"
+
+/* Classification of the result of an attempt. */
+typedef enum
+{
+    RETRY_CLASS_RETRYABLE = 0,    /* Transient, for example the AP was not found. */
+    RETRY_CLASS_FATAL,            /* Retrying cannot help, for example an invalid parameter. */
+    RETRY_CLASS_REJECTED          /* The AP refused the join, for example a bad password. */
+} retry_class_t;
+
+/* Function that classifies the result of a failed attempt. */
+typedef retry_class_t (*retry_classify_t)(cy_rslt_t result);
+
+/* Parameters of a retry policy. The delay before retry n is
+ * min(initial_delay_msec * 2^(n-1), max_delay_msec), randomized by
+ * +/- jitter_percent so that devices that lost the same AP do not retry in
+ * lockstep. No retry is scheduled past deadline_msec from the first attempt.
+ * A join refused by the AP is retried at most max_rejections times, because
+ * it is most often a wrong password.
+ */
+typedef struct
+{
+    uint32_t max_attempts;
+    uint32_t max_rejections;
+    uint32_t initial_delay_msec;
+    uint32_t max_delay_msec;
+    uint32_t deadline_msec;
+    uint32_t jitter_percent;
+    retry_classify_t classify;
+} retry_policy_config_t;
+
+/* State of a sequence of attempts. */
+typedef struct
+{
+    const retry_policy_config_t *config;
+    cy_time_t start_time;
+    uint32_t attempts;
+    uint32_t rejections;
+    uint32_t delay_msec;
+    uint32_t random_state;
+} retry_policy_t;
+
+/* Outcome of a sequence of attempts, reported in the metrics. */
+typedef enum
+{
+    RETRY_OUTCOME_NONE = 0,
+    RETRY_OUTCOME_SUCCESS,
+    RETRY_OUTCOME_FATAL,
+    RETRY_OUTCOME_MAX_ATTEMPTS,
+    RETRY_OUTCOME_DEADLINE,
+    RETRY_OUTCOME_REJECTED
+} retry_outcome_t;
+
+/* Statistics of the retry policies reported in the metrics. */
+typedef struct
+{
+    uint32_t attempts;
+    uint32_t retries;
+    retry_outcome_t last_outcome;
+    uint32_t last_attempts;
+} retry_policy_stats_t;
+
+
+void retry_policy_start(retry_policy_t *policy, const retry_policy_config_t *config, uint32_t seed);
+bool retry_policy_next(retry_policy_t *policy, cy_rslt_t result, uint32_t *delay_msec);
+retry_class_t retry_policy_classify_wcm(cy_rslt_t result);
+const char *retry_policy_outcome_name(retry_outcome_t outcome);
+void retry_policy_get_stats(retry_policy_stats_t *stats);
+
+
+#endif /* RETRY_POLICY_H_ */
+
+/* [] END OF FILE */
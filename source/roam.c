@@ -0,0 +1,251 @@
+/*******************************************************************************
+ * File Name: roam.c
+ *
+ * Description: This file contains the link monitor used for roaming: it
+ *              tracks the RSSI and the transmit failures of the link to the
+ *              AP and, with hysteresis, decides when to look for a stronger
+ *              AP of the same SSID and whether to roam to it.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "roam.h"
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Degraded samples in a row, and the time before which no AP is searched. */
+static uint32_t roam_degraded_count = 0;
+static uint32_t roam_holdoff_until = 0;
+
+/* The last sample was degraded or close to the trigger. */
+static bool roam_near_trigger = false;
+
+/* TX counters of the previous sample. */
+static bool roam_tx_baseline = false;
+static uint32_t roam_tx_packets = 0;
+static uint32_t roam_tx_failed = 0;
+
+/* Statistics of the link monitor. */
+static volatile int8_t roam_rssi_dbm = 0;
+static volatile uint32_t roam_tx_failed_percent = 0;
+static volatile uint32_t roam_samples = 0;
+static volatile uint32_t roam_degraded_samples = 0;
+static volatile uint32_t roam_searches = 0;
+static volatile uint32_t roam_roams = 0;
+static volatile uint32_t roam_failed_roams = 0;
+static volatile uint32_t roam_last_roam_msec = 0;
+static volatile int32_t roam_last_roam_gain_db = 0;
+
+/*******************************************************************************
+ * Function Name: roam_reset
+ *******************************************************************************
+ * Summary:
+ *  Restarts the monitor on a new connection. No AP is searched during the
+ *  first ROAM_HOLDOFF_MSEC of the connection.
+ *
+ * Parameters:
+ *  now_msec - Current time in milliseconds.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void roam_reset(uint32_t now_msec)
+{
+    roam_degraded_count = 0;
+    roam_holdoff_until = now_msec + ROAM_HOLDOFF_MSEC;
+    roam_tx_baseline = false;
+    roam_near_trigger = false;
+}
+
+/*******************************************************************************
+ * Function Name: roam_update
+ *******************************************************************************
+ * Summary:
+ *  Adds a sample of the link and decides whether to search for a stronger AP.
+ *  The search is requested after ROAM_TRIGGER_SAMPLES degraded samples in a
+ *  row, at most once per ROAM_HOLDOFF_MSEC.
+ *
+ * Parameters:
+ *  input - Pointer to the sample.
+ *  now_msec - Current time in milliseconds.
+ *
+ * Return:
+ *  bool - true if the caller should search for a stronger AP.
+ *
+ *******************************************************************************/
+bool roam_update(const roam_input_t *input, uint32_t now_msec)
+{
+    uint32_t tx_packets;
+    uint32_t tx_failed;
+    bool degraded = (input->rssi_dbm < ROAM_TRIGGER_RSSI_DBM);
+
+    roam_rssi_dbm = input->rssi_dbm;
+    roam_samples++;
+
+    if (input->tx_valid)
+    {
+        if (roam_tx_baseline)
+        {
+            tx_packets = input->tx_packets - roam_tx_packets;
+            tx_failed = input->tx_failed - roam_tx_failed;
+            if ((tx_packets >= ROAM_MIN_TX_PACKETS) && (tx_failed <= tx_packets))
+            {
+                roam_tx_failed_percent = (tx_failed * 100u) / tx_packets;
+                degraded = degraded || (roam_tx_failed_percent >= ROAM_TX_FAILED_PERCENT);
+            }
+        }
+
+        roam_tx_baseline = true;
+        roam_tx_packets = input->tx_packets;
+        roam_tx_failed = input->tx_failed;
+    }
+
+    roam_near_trigger = degraded || (input->rssi_dbm < (ROAM_TRIGGER_RSSI_DBM + ROAM_NEAR_MARGIN_DB));
+
+    if (!degraded)
+    {
+        roam_degraded_count = 0;
+        return false;
+    }
+
+    roam_degraded_samples++;
+    if ((++roam_degraded_count < ROAM_TRIGGER_SAMPLES) || ((int32_t)(roam_holdoff_until - now_msec) > 0))
+    {
+        return false;
+    }
+
+    roam_degraded_count = 0;
+    roam_holdoff_until = now_msec + ROAM_HOLDOFF_MSEC;
+    roam_searches++;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: roam_sample_interval
+ *******************************************************************************
+ * Summary:
+ *  Returns the time until the next sample of the link, based on the last
+ *  sample.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t - ROAM_SAMPLE_INTERVAL_MSEC if the last sample was degraded or
+ *  close to the trigger, otherwise ROAM_IDLE_SAMPLE_INTERVAL_MSEC.
+ *
+ *******************************************************************************/
+uint32_t roam_sample_interval(void)
+{
+    return roam_near_trigger ? ROAM_SAMPLE_INTERVAL_MSEC : ROAM_IDLE_SAMPLE_INTERVAL_MSEC;
+}
+
+/*******************************************************************************
+ * Function Name: roam_is_better
+ *******************************************************************************
+ * Summary:
+ *  Decides whether an AP is strong enough to roam to.
+ *
+ * Parameters:
+ *  current_rssi_dbm - RSSI of the current AP.
+ *  candidate_rssi_dbm - RSSI of the other AP.
+ *
+ * Return:
+ *  bool - true if the other AP is at least ROAM_MIN_RSSI_GAIN_DB stronger.
+ *
+ *******************************************************************************/
+bool roam_is_better(int8_t current_rssi_dbm, int16_t candidate_rssi_dbm)
+{
+    return ((int32_t)candidate_rssi_dbm - (int32_t)current_rssi_dbm) >= ROAM_MIN_RSSI_GAIN_DB;
+}
+
+/*******************************************************************************
+ * Function Name: roam_record
+ *******************************************************************************
+ * Summary:
+ *  Records the outcome of a roam.
+ *
+ * Parameters:
+ *  success - true if the device connected to the new AP.
+ *  duration_msec - Time from leaving the old AP to having an IP address on
+ *  the new one.
+ *  gain_db - RSSI of the new AP minus the RSSI of the old one.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void roam_record(bool success, uint32_t duration_msec, int32_t gain_db)
+{
+    if (success)
+    {
+        roam_roams++;
+        roam_last_roam_msec = duration_msec;
+        roam_last_roam_gain_db = gain_db;
+    }
+    else
+    {
+        roam_failed_roams++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: roam_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the last sample of the link and the roams made.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void roam_get_stats(roam_stats_t *stats)
+{
+    stats->rssi_dbm = roam_rssi_dbm;
+    stats->tx_failed_percent = roam_tx_failed_percent;
+    stats->samples = roam_samples;
+    stats->degraded_samples = roam_degraded_samples;
+    stats->searches = roam_searches;
+    stats->roams = roam_roams;
+    stats->failed_roams = roam_failed_roams;
+    stats->last_roam_msec = roam_last_roam_msec;
+    stats->last_roam_gain_db = roam_last_roam_gain_db;
+}
+
+/* [] END OF FILE */
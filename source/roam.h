@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name: roam.h
+*
+* Description: This file contains the configuration parameters, structures
+*              and function prototypes of the link monitor that decides when
+*              to roam to a stronger AP of the same SSID.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef ROAM_H_
+#define ROAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Interval between two samples of the link to the AP. While the last sample
+ * was degraded or its RSSI was within ROAM_NEAR_MARGIN_DB of
+ * ROAM_TRIGGER_RSSI_DBM, the link is sampled every ROAM_SAMPLE_INTERVAL_MSEC;
+ * otherwise only every ROAM_IDLE_SAMPLE_INTERVAL_MSEC, so that the server task
+ * stays asleep on a good link.
+ */
+#define ROAM_SAMPLE_INTERVAL_MSEC                    (1000u)
+#define ROAM_IDLE_SAMPLE_INTERVAL_MSEC               (10000u)
+#define ROAM_NEAR_MARGIN_DB                          (6)
+
+/* A sample is degraded when the RSSI is below ROAM_TRIGGER_RSSI_DBM, or
+ * when at least ROAM_TX_FAILED_PERCENT of the frames transmitted since the
+ * previous sample failed, out of at least ROAM_MIN_TX_PACKETS frames.
+ */
+#define ROAM_TRIGGER_RSSI_DBM                        (-75)
+#define ROAM_TX_FAILED_PERCENT                       (20u)
+#define ROAM_MIN_TX_PACKETS                          (10u)
+
+/* Hysteresis: the device looks for another AP only after
+ * ROAM_TRIGGER_SAMPLES degraded samples in a row, and roams only to an AP
+ * at least ROAM_MIN_RSSI_GAIN_DB stronger. After a connection, a roam or a
+ * search that found no better AP, it waits ROAM_HOLDOFF_MSEC before
+ * searching again, so that it does not scan or roam back and forth.
+ */
+#define ROAM_TRIGGER_SAMPLES                         (5u)
+#define ROAM_MIN_RSSI_GAIN_DB                        (8)
+#define ROAM_HOLDOFF_MSEC                            (30000u)
+
+/* A sample of the link. The TX counters are cumulative; tx_valid is false
+ * when they could not be read.
+ */
+typedef struct
+{
+    int8_t rssi_dbm;
+    bool tx_valid;
+    uint32_t tx_packets;
+    uint32_t tx_failed;
+} roam_input_t;
+
+/* State of the link monitor reported in the metrics. */
+typedef struct
+{
+    int8_t rssi_dbm;
+    uint32_t tx_failed_percent;
+    uint32_t samples;
+    uint32_t degraded_samples;
+    uint32_t searches;
+    uint32_t roams;
+    uint32_t failed_roams;
+    uint32_t last_roam_msec;
+    int32_t last_roam_gain_db;
+} roam_stats_t;
+
+
+void roam_reset(uint32_t now_msec);
+bool roam_update(const roam_input_t *input, uint32_t now_msec);
+uint32_t roam_sample_interval(void);
+bool roam_is_better(int8_t current_rssi_dbm, int16_t candidate_rssi_dbm);
+void roam_record(bool success, uint32_t duration_msec, int32_t gain_db);
+void roam_get_stats(roam_stats_t *stats);
+
+
+#endif /* ROAM_H_ */
+
+/* [] END OF FILE */
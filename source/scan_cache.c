@@ -0,0 +1,873 @@
+/*******************************************************************************
+ * File Name: scan_cache.c
+ *
+ * Description: This file contains the cache of the APs found by the Wi-Fi
+ *              scans: a fixed-size table, one entry per BSSID, sorted by
+ *              signal strength and aged out. A background task refreshes it
+ *              while the SoftAP is being used for configuration, and a scan
+ *              targeted at one SSID fills it when the AP to connect to is not
+ *              in it.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "scan_cache.h"
+
+/* Standard C header file */
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* APs found by the scans. The first scan_cache_count entries are in use and
+ * are kept sorted by signal strength, strongest first.
+ */
+static scan_cache_entry_t scan_cache_entries[SCAN_CACHE_MAX_ENTRIES];
+static uint32_t scan_cache_count = 0;
+
+/* Serializes the access to the table between the scan callback, which runs
+ * in the WCM worker thread, the connect path and the scan page.
+ */
+static cy_mutex_t scan_cache_mutex;
+
+/* Serializes the scans: WCM runs one scan at a time. */
+static cy_mutex_t scan_cache_scan_mutex;
+
+/* Signaled by the scan callback when a scan completes. */
+static cy_semaphore_t scan_cache_complete;
+
+/* APs reported by a streamed scan, waiting to be sent to the client. */
+typedef struct
+{
+    bool complete;
+    scan_cache_entry_t entry;
+} scan_cache_stream_item_t;
+
+static cy_queue_t scan_cache_stream_queue;
+static volatile bool scan_cache_streaming = false;
+static bool scan_cache_stream_complete = false;
+
+/* Task that refreshes the table in the background while enabled. */
+static uint64_t scan_cache_task_stack[SCAN_CACHE_TASK_STACK_SIZE / 8];
+static cy_thread_t scan_cache_task_handle;
+static bool scan_cache_task_started = false;
+static volatile bool scan_cache_background = false;
+static uint32_t scan_cache_interval_msec = 0;
+
+/* Statistics of the cache. */
+static volatile uint32_t scan_cache_hits = 0;
+static volatile uint32_t scan_cache_misses = 0;
+static volatile uint32_t scan_cache_targeted_scans = 0;
+static volatile uint32_t scan_cache_full_scans = 0;
+static volatile uint32_t scan_cache_background_scans = 0;
+static volatile uint32_t scan_cache_aged_out = 0;
+static volatile uint32_t scan_cache_dropped = 0;
+static volatile uint32_t scan_cache_stream_overflows = 0;
+
+/*******************************************************************************
+ * Function Name: scan_cache_expire
+ *******************************************************************************
+ * Summary:
+ *  Removes the entries not seen for SCAN_CACHE_MAX_AGE_MSEC, keeping the
+ *  order of the others. Must be called with scan_cache_mutex held.
+ *
+ * Parameters:
+ *  now - Current time.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void scan_cache_expire(cy_time_t now)
+{
+    uint32_t index;
+    uint32_t kept = 0;
+
+    for (index = 0; index < scan_cache_count; index++)
+    {
+        if ((now - scan_cache_entries[index].last_seen) >= SCAN_CACHE_MAX_AGE_MSEC)
+        {
+            scan_cache_aged_out++;
+            continue;
+        }
+
+        if (kept != index)
+        {
+            scan_cache_entries[kept] = scan_cache_entries[index];
+        }
+        kept++;
+    }
+
+    scan_cache_count = kept;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_reorder
+ *******************************************************************************
+ * Summary:
+ *  Moves an entry whose signal strength changed to its place in the table.
+ *  Must be called with scan_cache_mutex held.
+ *
+ * Parameters:
+ *  index - Index of the entry.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void scan_cache_reorder(uint32_t index)
+{
+    scan_cache_entry_t entry = scan_cache_entries[index];
+
+    while ((index > 0) && (scan_cache_entries[index - 1].rssi < entry.rssi))
+    {
+        scan_cache_entries[index] = scan_cache_entries[index - 1];
+        index--;
+    }
+
+    while ((index + 1 < scan_cache_count) && (scan_cache_entries[index + 1].rssi > entry.rssi))
+    {
+        scan_cache_entries[index] = scan_cache_entries[index + 1];
+        index++;
+    }
+
+    scan_cache_entries[index] = entry;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_security_name
+ *******************************************************************************
+ * Summary:
+ *  Returns a short name of a security type for the scan page.
+ *
+ * Parameters:
+ *  security - Security type.
+ *
+ * Return:
+ *  const char * - Name of the security type.
+ *
+ *******************************************************************************/
+static const char *scan_cache_security_name(cy_wcm_security_t security)
+{
+    switch (security)
+    {
+    case CY_WCM_SECURITY_OPEN:
+        return "Open";
+    case CY_WCM_SECURITY_WEP_PSK:
+        return "WEP";
+    case CY_WCM_SECURITY_WPA_AES_PSK:
+    case CY_WCM_SECURITY_WPA_TKIP_PSK:
+    case CY_WCM_SECURITY_WPA_MIXED_PSK:
+        return "WPA";
+    case CY_WCM_SECURITY_WPA2_AES_PSK:
+    case CY_WCM_SECURITY_WPA2_TKIP_PSK:
+    case CY_WCM_SECURITY_WPA2_MIXED_PSK:
+        return "WPA2";
+    case CY_WCM_SECURITY_WPA3_SAE:
+        return "WPA3";
+    case CY_WCM_SECURITY_WPA3_WPA2_PSK:
+        return "WPA3/WPA2";
+    default:
+        return "Other";
+    }
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_callback
+ *******************************************************************************
+ * Summary:
+ *  Adds each AP found by a scan to the cache and signals the end of the scan.
+ *
+ * Parameters:
+ *  result_ptr - Pointer to the AP found, NULL when the scan is complete.
+ *  user_data - Unused.
+ *  status - Status of the scan.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void scan_cache_callback(cy_wcm_scan_result_t *result_ptr, void *user_data, cy_wcm_scan_status_t status)
+{
+    scan_cache_stream_item_t item;
+
+    (void)user_data;
+
+    memset(&item, 0, sizeof(item));
+
+    if ((CY_WCM_SCAN_INCOMPLETE == status) && (NULL != result_ptr))
+    {
+        scan_cache_add(result_ptr);
+
+        if (scan_cache_streaming && ('\0' != result_ptr->SSID[0]))
+        {
+            memcpy(item.entry.ssid, result_ptr->SSID, sizeof(cy_wcm_ssid_t));
+            memcpy(item.entry.bssid, result_ptr->BSSID, sizeof(cy_wcm_mac_t));
+            item.entry.rssi = result_ptr->signal_strength;
+            item.entry.security = result_ptr->security;
+            item.entry.channel = result_ptr->channel;
+            item.entry.band = result_ptr->band;
+
+            /* Never block the WCM worker thread on a slow client. */
+            if (CY_RSLT_SUCCESS != cy_rtos_put_queue(&scan_cache_stream_queue, &item, 0, false))
+            {
+                scan_cache_stream_overflows++;
+            }
+        }
+    }
+    else if (CY_WCM_SCAN_COMPLETE == status)
+    {
+        if (scan_cache_streaming)
+        {
+            item.complete = true;
+            (void)cy_rtos_put_queue(&scan_cache_stream_queue, &item, 0, false);
+        }
+
+        cy_rtos_set_semaphore(&scan_cache_complete, false);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_run_scan
+ *******************************************************************************
+ * Summary:
+ *  Runs a scan and waits up to SCAN_CACHE_SCAN_TIMEOUT_MSEC for it to
+ *  complete. The APs found are added to the cache.
+ *
+ * Parameters:
+ *  scan_filter - Pointer to the scan filter, or NULL to scan for all APs.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the scan completed, otherwise, it
+ *  returns the WCM or RTOS error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t scan_cache_run_scan(cy_wcm_scan_filter_t *scan_filter)
+{
+    cy_rslt_t result;
+
+    cy_rtos_get_mutex(&scan_cache_scan_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    /* Drop a completion left over by a scan that timed out. */
+    (void)cy_rtos_get_semaphore(&scan_cache_complete, 0, false);
+
+    result = cy_wcm_start_scan(scan_cache_callback, NULL, scan_filter);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_rtos_get_semaphore(&scan_cache_complete, SCAN_CACHE_SCAN_TIMEOUT_MSEC, false);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            cy_wcm_stop_scan();
+        }
+    }
+
+    cy_rtos_set_mutex(&scan_cache_scan_mutex);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_task
+ *******************************************************************************
+ * Summary:
+ *  Refreshes the table with a scan for all APs every scan interval while the
+ *  background scans are enabled.
+ *
+ * Parameters:
+ *  arg - Unused.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void scan_cache_task(cy_thread_arg_t arg)
+{
+    (void)arg;
+
+    while (true)
+    {
+        if (scan_cache_background && (CY_RSLT_SUCCESS == scan_cache_run_scan(NULL)))
+        {
+            scan_cache_background_scans++;
+        }
+
+        cy_rtos_delay_milliseconds(scan_cache_interval_msec);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the scan cache.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the scan cache is initialized
+ *  successfully, otherwise, it returns the RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t scan_cache_init(void)
+{
+    cy_rslt_t result;
+
+    scan_cache_count = 0;
+
+    result = cy_rtos_init_mutex(&scan_cache_mutex);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    result = cy_rtos_init_mutex(&scan_cache_scan_mutex);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    result = cy_rtos_init_semaphore(&scan_cache_complete, 1, 0);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    return cy_rtos_init_queue(&scan_cache_stream_queue, SCAN_CACHE_STREAM_QUEUE_LENGTH, sizeof(scan_cache_stream_item_t));
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_add
+ *******************************************************************************
+ * Summary:
+ *  Adds or refreshes the entry of the BSSID of a scan result and moves it to
+ *  its place in the table. When the table is full, a new AP replaces the
+ *  weakest one if its signal is stronger, and is dropped otherwise. Hidden
+ *  SSIDs are not cached, as they cannot be looked up.
+ *
+ * Parameters:
+ *  result - Pointer to the scan result.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void scan_cache_add(const cy_wcm_scan_result_t *result)
+{
+    cy_time_t now;
+    uint32_t index;
+
+    if ('\0' == result->SSID[0])
+    {
+        return;
+    }
+
+    cy_rtos_get_time(&now);
+    cy_rtos_get_mutex(&scan_cache_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    scan_cache_expire(now);
+
+    for (index = 0; index < scan_cache_count; index++)
+    {
+        if (0 == memcmp(scan_cache_entries[index].bssid, result->BSSID, sizeof(cy_wcm_mac_t)))
+        {
+            break;
+        }
+    }
+
+    if (index == scan_cache_count)
+    {
+        if (scan_cache_count < SCAN_CACHE_MAX_ENTRIES)
+        {
+            scan_cache_count++;
+        }
+        else if (result->signal_strength > scan_cache_entries[scan_cache_count - 1].rssi)
+        {
+            index = scan_cache_count - 1;
+        }
+        else
+        {
+            scan_cache_dropped++;
+            cy_rtos_set_mutex(&scan_cache_mutex);
+            return;
+        }
+    }
+
+    memcpy(scan_cache_entries[index].ssid, result->SSID, sizeof(cy_wcm_ssid_t));
+    memcpy(scan_cache_entries[index].bssid, result->BSSID, sizeof(cy_wcm_mac_t));
+    scan_cache_entries[index].rssi = result->signal_strength;
+    scan_cache_entries[index].security = result->security;
+    scan_cache_entries[index].channel = result->channel;
+    scan_cache_entries[index].band = result->band;
+    scan_cache_entries[index].last_seen = now;
+    scan_cache_reorder(index);
+
+    cy_rtos_set_mutex(&scan_cache_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_lookup
+ *******************************************************************************
+ * Summary:
+ *  Looks up the AP with the strongest signal among the entries of an SSID.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *  entry - Pointer to store the entry found.
+ *
+ * Return:
+ *  bool - true if the SSID is in the cache.
+ *
+ *******************************************************************************/
+bool scan_cache_lookup(const uint8_t *ssid, scan_cache_entry_t *entry)
+{
+    bool found = false;
+    cy_time_t now;
+    uint32_t index;
+
+    cy_rtos_get_time(&now);
+    cy_rtos_get_mutex(&scan_cache_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    scan_cache_expire(now);
+
+    /* The table is sorted, so the first match is the strongest. */
+    for (index = 0; index < scan_cache_count; index++)
+    {
+        if (0 == strncmp((const char *)scan_cache_entries[index].ssid, (const char *)ssid, CY_WCM_MAX_SSID_LEN))
+        {
+            *entry = scan_cache_entries[index];
+            found = true;
+            break;
+        }
+    }
+
+    cy_rtos_set_mutex(&scan_cache_mutex);
+
+    if (found)
+    {
+        scan_cache_hits++;
+    }
+    else
+    {
+        scan_cache_misses++;
+    }
+
+    return found;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_snapshot
+ *******************************************************************************
+ * Summary:
+ *  Copies the entries of the cache, strongest signal first.
+ *
+ * Parameters:
+ *  entries - Array to store the entries.
+ *  max_entries - Size of the array.
+ *
+ * Return:
+ *  uint32_t - Number of entries copied.
+ *
+ *******************************************************************************/
+uint32_t scan_cache_snapshot(scan_cache_entry_t *entries, uint32_t max_entries)
+{
+    cy_time_t now;
+    uint32_t count;
+
+    cy_rtos_get_time(&now);
+    cy_rtos_get_mutex(&scan_cache_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    scan_cache_expire(now);
+
+    count = (scan_cache_count < max_entries) ? scan_cache_count : max_entries;
+    memcpy(entries, scan_cache_entries, count * sizeof(scan_cache_entry_t));
+
+    cy_rtos_set_mutex(&scan_cache_mutex);
+
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_scan_ssid
+ *******************************************************************************
+ * Summary:
+ *  Runs a scan filtered on one SSID. The APs found are added to the cache.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the scan completed, otherwise, it
+ *  returns the WCM or RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t scan_cache_scan_ssid(const uint8_t *ssid)
+{
+    cy_wcm_scan_filter_t scan_filter;
+
+    memset(&scan_filter, 0, sizeof(scan_filter));
+    scan_filter.mode = CY_WCM_SCAN_FILTER_TYPE_SSID;
+    memcpy(scan_filter.param.SSID, ssid, strnlen((const char *)ssid, CY_WCM_MAX_SSID_LEN));
+
+    scan_cache_targeted_scans++;
+
+    return scan_cache_run_scan(&scan_filter);
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_scan_all
+ *******************************************************************************
+ * Summary:
+ *  Runs an unfiltered scan in the foreground. The APs found are added to the
+ *  cache.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the scan completed, otherwise, it
+ *  returns the WCM or RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t scan_cache_scan_all(void)
+{
+    scan_cache_full_scans++;
+
+    return scan_cache_run_scan(NULL);
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_start_scanner
+ *******************************************************************************
+ * Summary:
+ *  Enables the background scans and starts the task that runs them, unless
+ *  it already runs.
+ *
+ * Parameters:
+ *  interval_msec - Delay between two background scans.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the task is created successfully,
+ *  otherwise, it returns the RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t scan_cache_start_scanner(uint32_t interval_msec)
+{
+    cy_rslt_t result;
+
+    scan_cache_interval_msec = interval_msec;
+    scan_cache_background = true;
+
+    if (scan_cache_task_started)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    result = cy_rtos_thread_create(&scan_cache_task_handle,
+                                   &scan_cache_task,
+                                   "Scan cache task",
+                                   &scan_cache_task_stack,
+                                   SCAN_CACHE_TASK_STACK_SIZE,
+                                   SCAN_CACHE_TASK_PRIORITY,
+                                   0);
+    scan_cache_task_started = (CY_RSLT_SUCCESS == result);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_set_background
+ *******************************************************************************
+ * Summary:
+ *  Enables or disables the background scans. When disabling, waits for the
+ *  scan in progress, if any, to complete so that it does not overlap with a
+ *  connection attempt.
+ *
+ * Parameters:
+ *  enable - true to enable the background scans.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void scan_cache_set_background(bool enable)
+{
+    scan_cache_background = enable;
+
+    if (!enable)
+    {
+        cy_rtos_get_mutex(&scan_cache_scan_mutex, CY_RTOS_NEVER_TIMEOUT);
+        cy_rtos_set_mutex(&scan_cache_scan_mutex);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_stream_start
+ *******************************************************************************
+ * Summary:
+ *  Starts a scan for all APs whose results are reported one by one through
+ *  scan_cache_stream_next, as WCM finds them. The results are also added to
+ *  the table. scan_cache_stream_end must be called once the caller is done,
+ *  even when the scan fails to start.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the scan is started, otherwise, it
+ *  returns the WCM error code.
+ *
+ *******************************************************************************/
+cy_rslt_t scan_cache_stream_start(void)
+{
+    scan_cache_stream_item_t item;
+    cy_rslt_t result;
+
+    cy_rtos_get_mutex(&scan_cache_scan_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    /* Drop what is left over by a previous scan. */
+    (void)cy_rtos_get_semaphore(&scan_cache_complete, 0, false);
+    while (CY_RSLT_SUCCESS == cy_rtos_get_queue(&scan_cache_stream_queue, &item, 0, false))
+    {
+    }
+
+    scan_cache_stream_complete = false;
+    scan_cache_streaming = true;
+
+    result = cy_wcm_start_scan(scan_cache_callback, NULL, NULL);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        scan_cache_streaming = false;
+        scan_cache_stream_complete = true;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_stream_next
+ *******************************************************************************
+ * Summary:
+ *  Waits for the next AP reported by the streamed scan. The same BSSID may be
+ *  reported more than once.
+ *
+ * Parameters:
+ *  entry - Pointer to store the AP.
+ *  complete - Set to true when the scan is complete and no AP is returned.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if an AP is returned or the scan is
+ *  complete, otherwise, the RTOS error code when no AP is reported within
+ *  SCAN_CACHE_SCAN_TIMEOUT_MSEC.
+ *
+ *******************************************************************************/
+cy_rslt_t scan_cache_stream_next(scan_cache_entry_t *entry, bool *complete)
+{
+    scan_cache_stream_item_t item;
+    cy_rslt_t result;
+
+    *complete = scan_cache_stream_complete;
+    if (*complete)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    result = cy_rtos_get_queue(&scan_cache_stream_queue, &item, SCAN_CACHE_SCAN_TIMEOUT_MSEC, false);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    if (item.complete)
+    {
+        scan_cache_stream_complete = true;
+        *complete = true;
+    }
+    else
+    {
+        *entry = item.entry;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_stream_end
+ *******************************************************************************
+ * Summary:
+ *  Ends the streamed scan, stopping it if it has not completed.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void scan_cache_stream_end(void)
+{
+    if (!scan_cache_stream_complete)
+    {
+        cy_wcm_stop_scan();
+    }
+
+    scan_cache_streaming = false;
+    cy_rtos_set_mutex(&scan_cache_scan_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_format_entry
+ *******************************************************************************
+ * Summary:
+ *  Formats an AP as one line of the scan page. The characters of the SSID
+ *  that are special in HTML are escaped.
+ *
+ * Parameters:
+ *  entry - Pointer to the AP.
+ *  buf - Buffer to store the text.
+ *  buf_len - Size of the buffer, SCAN_CACHE_MAX_ROW_LEN is always enough.
+ *
+ * Return:
+ *  uint32_t - Length of the text, or 0 if it does not fit in the buffer.
+ *
+ *******************************************************************************/
+uint32_t scan_cache_format_entry(const scan_cache_entry_t *entry, char *buf, uint32_t buf_len)
+{
+    uint32_t length = 0;
+    uint32_t ssid_index;
+    int written;
+
+    for (ssid_index = 0; (ssid_index < CY_WCM_MAX_SSID_LEN) && ('\0' != entry->ssid[ssid_index]); ssid_index++)
+    {
+        if (length + 5 >= buf_len)
+        {
+            return 0;
+        }
+
+        switch (entry->ssid[ssid_index])
+        {
+        case '<':
+            memcpy(&buf[length], "&lt;", 4);
+            length += 4;
+            break;
+        case '&':
+            memcpy(&buf[length], "&amp;", 5);
+            length += 5;
+            break;
+        default:
+            buf[length++] = (char)entry->ssid[ssid_index];
+            break;
+        }
+    }
+
+    written = snprintf(&buf[length], buf_len - length, "  %d dBm  ch %u  %s\n",
+                       (int)entry->rssi, (unsigned int)entry->channel,
+                       scan_cache_security_name(entry->security));
+    if ((written < 0) || ((uint32_t)written >= buf_len - length))
+    {
+        return 0;
+    }
+
+    return length + (uint32_t)written;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_format
+ *******************************************************************************
+ * Summary:
+ *  Formats the table for the scan page, one AP per line, strongest first.
+ *
+ * Parameters:
+ *  buf - Buffer to store the text.
+ *  buf_len - Size of the buffer.
+ *
+ * Return:
+ *  uint32_t - Length of the text. APs that do not fit are left out.
+ *
+ *******************************************************************************/
+uint32_t scan_cache_format(char *buf, uint32_t buf_len)
+{
+    uint32_t length = 0;
+    uint32_t row_len;
+    cy_time_t now;
+    uint32_t index;
+
+    cy_rtos_get_time(&now);
+    cy_rtos_get_mutex(&scan_cache_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    scan_cache_expire(now);
+
+    for (index = 0; index < scan_cache_count; index++)
+    {
+        row_len = scan_cache_format_entry(&scan_cache_entries[index], &buf[length], buf_len - length);
+        if (0 == row_len)
+        {
+            break;
+        }
+        length += row_len;
+    }
+
+    cy_rtos_set_mutex(&scan_cache_mutex);
+
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: scan_cache_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the statistics of the scan cache.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void scan_cache_get_stats(scan_cache_stats_t *stats)
+{
+    stats->entries = scan_cache_count;
+    stats->hits = scan_cache_hits;
+    stats->misses = scan_cache_misses;
+    stats->targeted_scans = scan_cache_targeted_scans;
+    stats->full_scans = scan_cache_full_scans;
+    stats->background_scans = scan_cache_background_scans;
+    stats->aged_out = scan_cache_aged_out;
+    stats->dropped = scan_cache_dropped;
+    stats->stream_overflows = scan_cache_stream_overflows;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,118 @@
+/******************************************************************************
+* File Name: scan_cache.h
+*
+* Description: This file contains the configuration parameters, structures
+*              and function prototypes of the cache of the APs found by the
+*              Wi-Fi scans, used to render the scan page and to pick the
+*              security type and band of the AP to connect to.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SCAN_CACHE_H_
+#define SCAN_CACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cyabs_rtos.h"
+#include "cy_wcm.h"
+
+/* Number of APs kept in the table, one entry per BSSID. When the table is
+ * full, a new AP replaces the weakest one if its signal is stronger.
+ */
+#define SCAN_CACHE_MAX_ENTRIES                       (16u)
+
+/* An AP not seen by a scan for this long is removed from the table. */
+#define SCAN_CACHE_MAX_AGE_MSEC                      (30000u)
+
+/* Time allowed for a scan to complete. */
+#define SCAN_CACHE_SCAN_TIMEOUT_MSEC                 (5000u)
+
+/* Task that refreshes the table in the background. */
+#define SCAN_CACHE_TASK_STACK_SIZE                   (2 * 1024)
+#define SCAN_CACHE_TASK_PRIORITY                     (CY_RTOS_PRIORITY_BELOWNORMAL)
+
+/* Number of APs reported by a streamed scan that can wait to be sent to the
+ * client. An AP reported while the queue is full is only added to the table.
+ */
+#define SCAN_CACHE_STREAM_QUEUE_LENGTH               (8u)
+
+/* Largest size of one AP in the scan page: "<SSID escaped>  -100 dBm  ch 165  WPA3/WPA2\n" */
+#define SCAN_CACHE_MAX_ROW_LEN                       ((CY_WCM_MAX_SSID_LEN * 5u) + 32u)
+
+/* An AP found by a scan. */
+typedef struct
+{
+    cy_wcm_ssid_t ssid;
+    cy_wcm_mac_t bssid;
+    int16_t rssi;
+    cy_wcm_security_t security;
+    uint8_t channel;
+    cy_wcm_wifi_band_t band;
+    cy_time_t last_seen;
+} scan_cache_entry_t;
+
+/* Statistics of the scan cache reported in the metrics. */
+typedef struct
+{
+    uint32_t entries;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t targeted_scans;
+    uint32_t full_scans;
+    uint32_t background_scans;
+    uint32_t aged_out;
+    uint32_t dropped;
+    uint32_t stream_overflows;
+} scan_cache_stats_t;
+
+
+cy_rslt_t scan_cache_init(void);
+void scan_cache_add(const cy_wcm_scan_result_t *result);
+bool scan_cache_lookup(const uint8_t *ssid, scan_cache_entry_t *entry);
+uint32_t scan_cache_snapshot(scan_cache_entry_t *entries, uint32_t max_entries);
+cy_rslt_t scan_cache_scan_ssid(const uint8_t *ssid);
+cy_rslt_t scan_cache_scan_all(void);
+cy_rslt_t scan_cache_start_scanner(uint32_t interval_msec);
+void scan_cache_set_background(bool enable);
+cy_rslt_t scan_cache_stream_start(void);
+cy_rslt_t scan_cache_stream_next(scan_cache_entry_t *entry, bool *complete);
+void scan_cache_stream_end(void);
+uint32_t scan_cache_format_entry(const scan_cache_entry_t *entry, char *buf, uint32_t buf_len);
+uint32_t scan_cache_format(char *buf, uint32_t buf_len);
+void scan_cache_get_stats(scan_cache_stats_t *stats);
+
+
+#endif /* SCAN_CACHE_H_ */
+
+/* [] END OF FILE */
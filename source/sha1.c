@@ -0,0 +1,237 @@
+/*******************************************************************************
+ * File Name: sha1.c
+ *
+ * Description: This file contains a compact implementation of the SHA-1 hash
+ *              (FIPS 180-4) used to compute the Sec-WebSocket-Accept value of
+ *              the WebSocket handshake.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "sha1.h"
+
+/* Standard C header file */
+#include <string.h>
+
+/*******************************************************************************
+ * Macros
+ ********************************************************************************/
+#define SHA1_ROTL(value, bits)                       (((value) << (bits)) | ((value) >> (32u - (bits))))
+
+/*******************************************************************************
+ * Function Name: sha1_process_block
+ *******************************************************************************
+ * Summary:
+ *  Processes one 64-byte block of the message.
+ *
+ * Parameters:
+ *  ctx - Pointer to the SHA-1 context.
+ *  block - Pointer to the block.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void sha1_process_block(sha1_context_t *ctx, const uint8_t *block)
+{
+    uint32_t w[16];
+    uint32_t a = ctx->state[0];
+    uint32_t b = ctx->state[1];
+    uint32_t c = ctx->state[2];
+    uint32_t d = ctx->state[3];
+    uint32_t e = ctx->state[4];
+    uint32_t f;
+    uint32_t k;
+    uint32_t temp;
+
+    for (uint32_t i = 0; i < 16u; i++)
+    {
+        w[i] = ((uint32_t)block[4u * i] << 24) | ((uint32_t)block[4u * i + 1u] << 16) |
+               ((uint32_t)block[4u * i + 2u] << 8) | (uint32_t)block[4u * i + 3u];
+    }
+
+    for (uint32_t i = 0; i < 80u; i++)
+    {
+        /* The message schedule is kept in a 16-word circular buffer. */
+        if (i >= 16u)
+        {
+            temp = w[(i + 13u) & 15u] ^ w[(i + 8u) & 15u] ^ w[(i + 2u) & 15u] ^ w[i & 15u];
+            w[i & 15u] = SHA1_ROTL(temp, 1u);
+        }
+
+        if (i < 20u)
+        {
+            f = (b & c) | ((~b) & d);
+            k = 0x5A827999u;
+        }
+        else if (i < 40u)
+        {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1u;
+        }
+        else if (i < 60u)
+        {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDCu;
+        }
+        else
+        {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6u;
+        }
+
+        temp = SHA1_ROTL(a, 5u) + f + e + k + w[i & 15u];
+        e = d;
+        d = c;
+        c = SHA1_ROTL(b, 30u);
+        b = a;
+        a = temp;
+    }
+
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+}
+
+/*******************************************************************************
+ * Function Name: sha1_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes a SHA-1 context.
+ *
+ * Parameters:
+ *  ctx - Pointer to the SHA-1 context.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void sha1_init(sha1_context_t *ctx)
+{
+    ctx->state[0] = 0x67452301u;
+    ctx->state[1] = 0xEFCDAB89u;
+    ctx->state[2] = 0x98BADCFEu;
+    ctx->state[3] = 0x10325476u;
+    ctx->state[4] = 0xC3D2E1F0u;
+    ctx->total_length = 0;
+    ctx->buffer_length = 0;
+}
+
+/*******************************************************************************
+ * Function Name: sha1_update
+ *******************************************************************************
+ * Summary:
+ *  Adds data to the message being hashed.
+ *
+ * Parameters:
+ *  ctx - Pointer to the SHA-1 context.
+ *  data - Pointer to the data.
+ *  length - Length of the data.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void sha1_update(sha1_context_t *ctx, const uint8_t *data, uint32_t length)
+{
+    uint32_t copy_length;
+
+    ctx->total_length += length;
+
+    while (length > 0)
+    {
+        copy_length = SHA1_BLOCK_LENGTH - ctx->buffer_length;
+        if (copy_length > length)
+        {
+            copy_length = length;
+        }
+
+        memcpy(&ctx->buffer[ctx->buffer_length], data, copy_length);
+        ctx->buffer_length += copy_length;
+        data += copy_length;
+        length -= copy_length;
+
+        if (SHA1_BLOCK_LENGTH == ctx->buffer_length)
+        {
+            sha1_process_block(ctx, ctx->buffer);
+            ctx->buffer_length = 0;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: sha1_final
+ *******************************************************************************
+ * Summary:
+ *  Pads the message and returns its digest.
+ *
+ * Parameters:
+ *  ctx - Pointer to the SHA-1 context.
+ *  digest - Buffer to store the 20-byte digest.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void sha1_final(sha1_context_t *ctx, uint8_t digest[SHA1_DIGEST_LENGTH])
+{
+    uint64_t total_bits = ctx->total_length * 8u;
+
+    ctx->buffer[ctx->buffer_length++] = 0x80u;
+    if (ctx->buffer_length > (SHA1_BLOCK_LENGTH - 8u))
+    {
+        memset(&ctx->buffer[ctx->buffer_length], 0, SHA1_BLOCK_LENGTH - ctx->buffer_length);
+        sha1_process_block(ctx, ctx->buffer);
+        ctx->buffer_length = 0;
+    }
+    memset(&ctx->buffer[ctx->buffer_length], 0, (SHA1_BLOCK_LENGTH - 8u) - ctx->buffer_length);
+
+    for (uint32_t i = 0; i < 8u; i++)
+    {
+        ctx->buffer[SHA1_BLOCK_LENGTH - 1u - i] = (uint8_t)(total_bits >> (8u * i));
+    }
+    sha1_process_block(ctx, ctx->buffer);
+
+    for (uint32_t i = 0; i < 5u; i++)
+    {
+        digest[4u * i] = (uint8_t)(ctx->state[i] >> 24);
+        digest[4u * i + 1u] = (uint8_t)(ctx->state[i] >> 16);
+        digest[4u * i + 2u] = (uint8_t)(ctx->state[i] >> 8);
+        digest[4u * i + 3u] = (uint8_t)(ctx->state[i]);
+    }
+}
+
+/* [] END OF FILE */
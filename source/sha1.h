@@ -0,0 +1,65 @@
+/******************************************************************************
+* File Name: sha1.h
+*
+* Description: This file contains the function prototypes of the SHA-1 hash
+*              used by the WebSocket handshake.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef SHA1_H_
+#define SHA1_H_
+
+#include <stdint.h>
+
+#define SHA1_DIGEST_LENGTH                           (20u)
+#define SHA1_BLOCK_LENGTH                            (64u)
+
+/* Context of an incremental SHA-1 computation. */
+typedef struct
+{
+    uint32_t state[5];
+    uint64_t total_length;
+    uint32_t buffer_length;
+    uint8_t buffer[SHA1_BLOCK_LENGTH];
+} sha1_context_t;
+
+
+void sha1_init(sha1_context_t *ctx);
+void sha1_update(sha1_context_t *ctx, const uint8_t *data, uint32_t length);
+void sha1_final(sha1_context_t *ctx, uint8_t digest[SHA1_DIGEST_LENGTH]);
+
+
+#endif /* SHA1_H_ */
+
+/* [] END OF FILE */
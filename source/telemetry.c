@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * File Name: telemetry.c
+ *
+ * Description: This file contains the encoders of the device data: a text
+ *              format for the HTTP event stream and a compact binary format
+ *              with a schema version, field presence bits and fixed-point
+ *              fields for the WebSocket connection.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "telemetry.h"
+
+/* Standard C header file */
+#include <stdio.h>
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Sizes of the last encoded sample. */
+static volatile uint32_t last_text_len = 0;
+static volatile uint32_t last_binary_len = 0;
+
+/*******************************************************************************
+ * Function Name: telemetry_encode_text
+ *******************************************************************************
+ * Summary:
+ *  Encodes a sample as human-readable text. The fixed-point fields are
+ *  formatted with integer arithmetic only.
+ *
+ * Parameters:
+ *  sample - Pointer to the sample.
+ *  buf - Buffer to store the text.
+ *  buf_len - Size of the buffer.
+ *
+ * Return:
+ *  uint32_t - Length of the text, or 0 if it does not fit in the buffer.
+ *
+ *******************************************************************************/
+uint32_t telemetry_encode_text(const telemetry_sample_t *sample, char *buf, uint32_t buf_len)
+{
+    uint32_t length = 0;
+    int written = 0;
+
+    if (0 != (sample->present & TELEMETRY_FIELD_DUTY_CYCLE))
+    {
+        written = snprintf(&buf[length], buf_len - length, "Duty cycle: %u%%",
+                           (unsigned int)(sample->duty_cycle_permille / 10u));
+        if ((written < 0) || ((uint32_t)written >= buf_len - length))
+        {
+            return 0;
+        }
+        length += (uint32_t)written;
+    }
+
+    if (0 != (sample->present & TELEMETRY_FIELD_RSSI))
+    {
+        written = snprintf(&buf[length], buf_len - length, "%sRSSI: %d dBm",
+                           (length > 0) ? ", " : "", (int)sample->rssi_dbm);
+        if ((written < 0) || ((uint32_t)written >= buf_len - length))
+        {
+            return 0;
+        }
+        length += (uint32_t)written;
+    }
+
+    if (0 != (sample->present & TELEMETRY_FIELD_UPTIME))
+    {
+        written = snprintf(&buf[length], buf_len - length, "%sUptime: %lu.%02lu s",
+                           (length > 0) ? ", " : "",
+                           (unsigned long)(sample->uptime_centisec / 100u),
+                           (unsigned long)(sample->uptime_centisec % 100u));
+        if ((written < 0) || ((uint32_t)written >= buf_len - length))
+        {
+            return 0;
+        }
+        length += (uint32_t)written;
+    }
+
+    last_text_len = length;
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_encode_binary
+ *******************************************************************************
+ * Summary:
+ *  Encodes a sample in the binary layout described in telemetry.h.
+ *
+ * Parameters:
+ *  sample - Pointer to the sample.
+ *  buf - Buffer to store the frame.
+ *  buf_len - Size of the buffer, at least TELEMETRY_MAX_BINARY_LEN.
+ *
+ * Return:
+ *  uint32_t - Length of the frame, or 0 if the buffer is too small.
+ *
+ *******************************************************************************/
+uint32_t telemetry_encode_binary(const telemetry_sample_t *sample, uint8_t *buf, uint32_t buf_len)
+{
+    uint32_t length = 0;
+
+    if (buf_len < TELEMETRY_MAX_BINARY_LEN)
+    {
+        return 0;
+    }
+
+    buf[length++] = TELEMETRY_SCHEMA_VERSION;
+    buf[length++] = sample->present;
+
+    if (0 != (sample->present & TELEMETRY_FIELD_DUTY_CYCLE))
+    {
+        buf[length++] = (uint8_t)(sample->duty_cycle_permille & 0xFFu);
+        buf[length++] = (uint8_t)(sample->duty_cycle_permille >> 8);
+    }
+
+    if (0 != (sample->present & TELEMETRY_FIELD_UPTIME))
+    {
+        buf[length++] = (uint8_t)(sample->uptime_centisec & 0xFFu);
+        buf[length++] = (uint8_t)((sample->uptime_centisec >> 8) & 0xFFu);
+        buf[length++] = (uint8_t)((sample->uptime_centisec >> 16) & 0xFFu);
+        buf[length++] = (uint8_t)(sample->uptime_centisec >> 24);
+    }
+
+    if (0 != (sample->present & TELEMETRY_FIELD_RSSI))
+    {
+        buf[length++] = (uint8_t)sample->rssi_dbm;
+    }
+
+    last_binary_len = length;
+    return length;
+}
+
+/*******************************************************************************
+ * Function Name: telemetry_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the sizes of the last sample encoded in each format.
+ *
+ * Parameters:
+ *  stats - Pointer to store the sizes.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void telemetry_get_stats(telemetry_stats_t *stats)
+{
+    stats->text_len = last_text_len;
+    stats->binary_len = last_binary_len;
+}
+
+/* [] END OF FILE */
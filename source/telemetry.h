@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: telemetry.h
+*
+* Description: This file contains the structures and function prototypes
+*              used to encode the device data as text or as a compact binary
+*              frame.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Version of the binary telemetry layout. Increase it whenever the layout
+ * changes so that the decoder in SOFTAP_DEVICE_DATA can reject frames it does
+ * not understand.
+ *
+ * Binary layout, multi-byte fields in little-endian order:
+ *  byte 0      schema version
+ *  byte 1      presence bits, TELEMETRY_FIELD_*
+ *  then, for each field present, in the order of its presence bit:
+ *  duty cycle  uint16, in 0.1 % units
+ *  uptime      uint32, in 10 ms units
+ *  RSSI        int8, in dBm
+ */
+#define TELEMETRY_SCHEMA_VERSION                     (1u)
+
+/* Presence bits of the telemetry fields. */
+#define TELEMETRY_FIELD_DUTY_CYCLE                   (1u << 0)
+#define TELEMETRY_FIELD_UPTIME                       (1u << 1)
+#define TELEMETRY_FIELD_RSSI                         (1u << 2)
+
+/* Largest encoded sizes of a sample. */
+#define TELEMETRY_MAX_BINARY_LEN                     (9u)
+#define TELEMETRY_MAX_TEXT_LEN                       (56u)
+
+/* A sample of the device data. Fields are kept in the fixed-point units of
+ * the binary layout so that encoding needs no floating-point arithmetic.
+ */
+typedef struct
+{
+    uint8_t present;
+    uint16_t duty_cycle_permille;
+    uint32_t uptime_centisec;
+    int8_t rssi_dbm;
+} telemetry_sample_t;
+
+/* Sizes of the last encoded sample, reported in the metrics. */
+typedef struct
+{
+    uint32_t text_len;
+    uint32_t binary_len;
+} telemetry_stats_t;
+
+
+uint32_t telemetry_encode_text(const telemetry_sample_t *sample, char *buf, uint32_t buf_len);
+uint32_t telemetry_encode_binary(const telemetry_sample_t *sample, uint8_t *buf, uint32_t buf_len);
+void telemetry_get_stats(telemetry_stats_t *stats);
+
+
+#endif /* TELEMETRY_H_ */
+
+/* [] END OF FILE */
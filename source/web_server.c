@@ -51,6 +51,11 @@
 #include "cy_wcm.h"
 #include "cy_wcm_error.h"
 
+/* NetX Duo header files, used to read the packet pool */
+#include "nx_api.h"
+#include "tx_byte_pool.h"
+#include "cy_network_mw_core.h"
+
 /* HTTP server task header file. */
 #include "web_server.h"
 #include "cy_http_server.h"
@@ -75,44 +80,208 @@ static const cy_wcm_ip_setting_t ap_sta_mode_ip_settings =
         INITIALISER_IPV4_ADDRESS(.gateway, SOFTAP_GATEWAY),
 };
 
-/* Holds the IP address and port number details of the socket for the HTTP server. */
-cy_socket_sockaddr_t http_server_ip_address;
-
-/* Pointer to HTTP event stream used to send device data to client. */
-cy_http_response_stream_t *http_event_stream;
+/* Holds the IP address and port number details of the socket for the HTTP
+ * server of each interface.
+ */
+static cy_socket_sockaddr_t http_server_addresses[HTTP_INTERFACE_COUNT];
 
-/* Wi-Fi network interface. */
-cy_network_interface_t nw_interface;
+/* Wi-Fi network interface of each HTTP server. */
+static cy_network_interface_t http_nw_interfaces[HTTP_INTERFACE_COUNT];
 
-/* HTTP server instance. */
+/* HTTP server instance of the SoftAP. */
 cy_http_server_t http_ap_server;
 
-/* HTTP server instance. */
+/* HTTP server instance of the STA. */
 cy_http_server_t http_sta_server;
 
-/*Buffer to store SSID*/
-uint8_t wifi_ssid[WIFI_SSID_LEN] = {0};
+/* Routes of the HTTP servers. The server of the STA serves the device data
+ * page, the event stream and the metrics only; the scan page, the profiles
+ * and the device data redirect are used to provision the device from the
+ * SoftAP.
+ */
+static const http_route_t http_routes[HTTP_ROUTE_COUNT] =
+{
+    {"/", "text/html", CY_DYNAMIC_URL_CONTENT, softap_resource_handler, true},
+    {WIFI_SCAN_URL, "text/html", CY_DYNAMIC_URL_CONTENT, wifi_scan_resource_handler, false},
+    {EVENT_STREAM_URL, "text/event-stream", CY_RAW_DYNAMIC_URL_CONTENT, event_stream_resource_handler, true},
+    {METRICS_URL, "text/plain", CY_DYNAMIC_URL_CONTENT, metrics_resource_handler, true},
+    {PROFILES_URL, "application/json", CY_DYNAMIC_URL_CONTENT, profiles_resource_handler, false},
+    {DEVICE_DATA_REDIRECT_URL, "text/html", CY_RAW_DYNAMIC_URL_CONTENT, device_data_redirect_handler, false}
+};
+
+/* Resources registered with each HTTP server, bound to the shared routes. */
+static http_route_binding_t http_route_bindings[HTTP_INTERFACE_COUNT][HTTP_ROUTE_COUNT];
+static cy_resource_dynamic_data_t http_route_resources[HTTP_INTERFACE_COUNT][HTTP_ROUTE_COUNT];
+
+/* Requests served by the HTTP server of each interface. */
+static http_interface_stats_t http_interface_stats[HTTP_INTERFACE_COUNT];
 
-/*Buffer to store Password*/
+/* Serializes the in-flight counts of the HTTP servers between the HTTP
+ * server threads and the server task that drains them, and the time each
+ * drain started.
+ */
+static cy_mutex_t http_route_mutex;
+static cy_time_t http_drain_start[HTTP_INTERFACE_COUNT];
+
+/* Address the HTTP server of the STA failed to start on; not tried again. */
+static uint32_t http_sta_server_failed_address = 0;
+
+/* Time the HTTP server of the SoftAP is shut down at, with
+ * HTTP_AP_SERVER_SHUTDOWN.
+ */
+static cy_time_t http_ap_server_shutdown_time = 0;
+
+/* Buffer to store the terminated SSID. */
+uint8_t wifi_ssid[WIFI_SSID_LEN + 1] = {0};
+
+/* Buffer to store the terminated password. */
 uint8_t wifi_pwd[WIFI_PWD_LEN] = {0};
 
 /*Buffer to store HTTP data*/
 char buffer[BUFFER_LENGTH] = {0};
 
-/* Holds the response handler for HTTP GET and POST request from the client
- * to implement Wi-Fi scan and Wi-Fi connect funtionality.
- */
-cy_resource_dynamic_data_t http_wifi_resource;
-
 /* Flag to indicate if device has been configured. */
 volatile bool device_configured = false;
 
-/*Variable to indicate re-configuration request*/
+/* Variable to indicate re-configuration request: SERVER_RECONFIGURE_REQUESTED
+ * while an HTTP server drains, SERVER_RECONFIGURED once its interface is
+ * reconfigured.
+ */
 volatile int8_t reconfiguration_request = 0;
 
 /* Array to store Wi-Fi connect response. */
 static char http_wifi_connect_response[WIFI_CONNECT_RESPONSE_LENGTH] = {0};
 
+/* Array to store the list of APs of the scan page. */
+static char http_wifi_scan_response[MAX_WIFI_SCAN_HTTP_RESPONSE_LENGTH] = {0};
+
+/* Serializes the use of http_wifi_scan_response between HTTP server threads.
+ * It is held only while a page is rendered from the AP table; a new scan
+ * formats each AP in a buffer of its own request.
+ */
+static cy_mutex_t wifi_scan_mutex;
+
+/* Latency of the last scan page streamed from a new scan. */
+static volatile uint32_t wifi_scan_fresh_scans = 0;
+static volatile uint32_t wifi_scan_ttfb_msec = 0;
+static volatile uint32_t wifi_scan_first_ap_msec = 0;
+static volatile uint32_t wifi_scan_total_msec = 0;
+static volatile uint32_t wifi_scan_ap_count = 0;
+
+/* How and when the device got connected to an AP after boot. */
+static volatile boot_path_t boot_path = BOOT_PATH_NONE;
+static volatile uint32_t boot_connected_msec = 0;
+
+/* Time of the last connect phases: the association is complete when WCM
+ * reports CY_WCM_EVENT_CONNECTED, and the addressing when the connect call
+ * returns with an IP address.
+ */
+static volatile cy_time_t wifi_associated_time = 0;
+static volatile uint32_t wifi_association_msec = 0;
+static volatile uint32_t wifi_addressing_msec = 0;
+
+/* Duration of the last connection to the AP entered in the SoftAP page, and
+ * whether it joined a known BSSID directly or needed a scan.
+ */
+static volatile uint32_t wifi_connect_msec = 0;
+static volatile bool wifi_connect_directed = false;
+static volatile uint32_t wifi_directed_connects = 0;
+static volatile uint32_t wifi_directed_fallbacks = 0;
+
+/* Serializes a connection from the SoftAP page and the reconnections of the
+ * server task after a link loss.
+ */
+static cy_mutex_t wifi_connect_mutex;
+
+/* Stored profiles, APs found by the scans and ranked candidates of the last
+ * connection with the stored profiles; used only by the server task, also to
+ * pick the SoftAP channel and the AP to roam to.
+ */
+static cred_store_entry_t wifi_profiles[CRED_STORE_MAX_PROFILES];
+static scan_cache_entry_t wifi_profile_aps[SCAN_CACHE_MAX_ENTRIES];
+static profile_candidate_t wifi_profile_candidates[CRED_STORE_MAX_PROFILES];
+static volatile uint32_t wifi_profile_count = 0;
+static volatile uint32_t wifi_profile_rank = 0;
+static volatile uint32_t wifi_profile_attempts = 0;
+
+/* Channel of the AP the STA is connected to. */
+static volatile uint8_t wifi_sta_channel = 0;
+
+/* IP address of the STA, in network byte order, and the redirect to the
+ * device data page on it. The redirect is formatted in the buffer not in use
+ * when the address changes, so that a request being answered is not
+ * affected.
+ */
+static volatile uint32_t wifi_sta_ip_address = 0;
+static char device_data_redirect[2][DEVICE_DATA_REDIRECT_LENGTH];
+static volatile uint32_t device_data_redirect_len[2] = {0, 0};
+static volatile uint32_t device_data_redirect_index = 0;
+static volatile uint32_t device_data_redirects = 0;
+
+/* Channel of the SoftAP, or 0 when it is not started, and its moves to the
+ * channel of the STA. A channel the SoftAP failed to move to is not tried
+ * again.
+ */
+static volatile uint8_t softap_channel = 0;
+static volatile uint8_t softap_failed_channel = 0;
+static volatile uint32_t softap_moves = 0;
+static volatile uint32_t softap_move_msec = 0;
+
+/* Clients associated with the SoftAP, and the idle teardown of the SoftAP:
+ * the channel it is started again on, the time it became idle, and the
+ * restart requested with the user button.
+ */
+static volatile uint32_t softap_clients = 0;
+static uint8_t softap_teardown_channel = 0;
+static cy_time_t softap_idle_since = 0;
+static volatile bool softap_restart_requested = false;
+static cyhal_gpio_callback_data_t softap_button_callback_data;
+static volatile uint32_t softap_teardowns = 0;
+static volatile uint32_t softap_restarts = 0;
+static volatile uint32_t softap_byte_pool_used_before = 0;
+static volatile uint32_t softap_byte_pool_used_after = 0;
+static volatile uint32_t softap_pool_free_before = 0;
+static volatile uint32_t softap_pool_free_after = 0;
+
+/* Whether the AP of the connection in progress was found by the scan. */
+static volatile bool wifi_connect_target_found = false;
+
+static retry_class_t wifi_classify_connect(cy_rslt_t result);
+
+/* Retry policy of the reconnection after a link loss. A stored AP that
+ * refuses the join may be rebooting, so rejections are retried as long as
+ * the other failures.
+ */
+static const retry_policy_config_t wifi_reconnect_config =
+{
+    .max_attempts = WIFI_RECONNECT_MAX_ATTEMPTS,
+    .max_rejections = WIFI_RECONNECT_MAX_ATTEMPTS,
+    .initial_delay_msec = WIFI_CONN_RETRY_INTERVAL_MSEC,
+    .max_delay_msec = WIFI_RECONNECT_MAX_INTERVAL_MSEC,
+    .deadline_msec = WIFI_RECONNECT_DEADLINE_MSEC,
+    .jitter_percent = WIFI_CONN_RETRY_JITTER_PERCENT,
+    .classify = retry_policy_classify_wcm
+};
+
+/* Retry policy of the connection to the AP entered in the SoftAP page. */
+static const retry_policy_config_t wifi_retry_config =
+{
+    .max_attempts = MAX_WIFI_RETRY_COUNT,
+    .max_rejections = WIFI_CONN_MAX_REJECTIONS,
+    .initial_delay_msec = WIFI_CONN_RETRY_INTERVAL_MSEC,
+    .max_delay_msec = WIFI_CONN_RETRY_MAX_INTERVAL_MSEC,
+    .deadline_msec = WIFI_CONN_RETRY_DEADLINE_MSEC,
+    .jitter_percent = WIFI_CONN_RETRY_JITTER_PERCENT,
+    .classify = wifi_classify_connect
+};
+
+/* Duty cycle reported in the device data. */
+static volatile uint32_t device_duty_cycle = DUTY_CYCLE_DEFAULT_PERCENT;
+
+/* Task that publishes the device data to the HTTP event stream. */
+static uint64_t device_data_task_stack[DEVICE_DATA_TASK_STACK_SIZE / 8];
+static cy_thread_t device_data_task_handle;
+
 /*******************************************************************************
  * Function Name: softap_resource_handler
  *******************************************************************************
@@ -120,7 +289,9 @@ static char http_wifi_connect_response[WIFI_CONNECT_RESPONSE_LENGTH] = {0};
  *  Handles HTTP GET, POST, and PUT requests from the client.
  *  HTTP GET sends the HTTP startup webpage as a response to the client.
  *  HTTP POST extracts the credentials from the HTTP data from the client
- *  and tries to connect to the AP.
+ *  and tries to connect to the AP. The server of the STA always serves the
+ *  device data page, since a client can only reach it once the device is
+ *  connected.
  *  HTTP PUT sends an error message as a response to the client if the resource
  *  registration is unsuccessful.
  *
@@ -128,7 +299,7 @@ static char http_wifi_connect_response[WIFI_CONNECT_RESPONSE_LENGTH] = {0};
  *  url_path - Pointer to the HTTP URL path.
  *  url_parameters - Pointer to the HTTP URL query string.
  *  stream - Pointer to the HTTP response stream.
- *  arg - Pointer to the argument passed during HTTP resource registration.
+ *  arg - Pointer to the binding of the route to the interface of the server.
  *  http_message_body - Pointer to the HTTP data from the client.
  *
  * Return:
@@ -144,13 +315,15 @@ int32_t softap_resource_handler(const char *url_path,
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
     int32_t status = HTTP_REQUEST_HANDLE_SUCCESS;
+    const http_route_binding_t *binding = (const http_route_binding_t *)arg;
+    bool provisioning = !device_configured && ((NULL == binding) || (HTTP_INTERFACE_AP == binding->interface));
 
     switch (http_message_body->request_type)
     {
     case CY_HTTP_REQUEST_GET:
 
         /* If device is not configured send the initial page */
-        if (!device_configured)
+        if (provisioning)
         {
             /* The start up page of the HTTP client will be sent as an initial response
              * to the GET request.
@@ -174,7 +347,7 @@ int32_t softap_resource_handler(const char *url_path,
 
     case CY_HTTP_REQUEST_POST:
 
-        if (!device_configured)
+        if (provisioning)
         {
             /* The device tries to connect to the AP using the credentials sent via HTTP
              * webpage.
@@ -183,6 +356,19 @@ int32_t softap_resource_handler(const char *url_path,
         }
         else
         {
+            /* Update the duty cycle on the Increase and Decrease buttons of the
+             * device data page.
+             */
+            if ((http_message_body->data_length >= sizeof(INCREASE) - 1) &&
+                (!strncmp(INCREASE, (const char *)http_message_body->data, sizeof(INCREASE) - 1)))
+            {
+                device_duty_cycle_step(true);
+            }
+            else if ((http_message_body->data_length >= sizeof(DECREASE) - 1) &&
+                     (!strncmp(DECREASE, (const char *)http_message_body->data, sizeof(DECREASE) - 1)))
+            {
+                device_duty_cycle_step(false);
+            }
 
             /* Send the HTTP response. */
             result = cy_http_server_response_stream_write_payload(stream, HTTP_HEADER_204, sizeof(HTTP_HEADER_204) - 1);
@@ -207,282 +393,2403 @@ int32_t softap_resource_handler(const char *url_path,
     return status;
 }
 
-/********************************************************************************
- * Function Name: wifi_extract_credentials
- ********************************************************************************
+/*******************************************************************************
+ * Function Name: wifi_scan_write
+ *******************************************************************************
  * Summary:
- *  The function extracts the credentials entered via HTTP webpage. Switches to STA
- *  mode then connects to the same credentials.
+ *  Sends a part of the scan page to the client at once. The page is sent with
+ *  chunked transfer encoding, so each part is flushed as one chunk.
  *
  * Parameters:
- *  const uint8_t* data : The HTTP data that contains ssid and password that is
- *  entered from the HTTP webpage.
- *   uint32_t data_len : The length of the HTTP response.
+ *  stream - Pointer to the HTTP response stream.
+ *  data - Pointer to the data.
+ *  length - Length of the data.
  *
  * Return:
- *  void
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the data is sent, otherwise, it
+ *  returns the HTTP server error code.
  *
  *******************************************************************************/
-cy_rslt_t wifi_extract_credentials(const uint8_t *data, uint32_t data_len, cy_http_response_stream_t *stream)
+static cy_rslt_t wifi_scan_write(cy_http_response_stream_t *stream, const char *data, uint32_t length)
 {
-    int8_t ssid_buff_index, buff_index = 0;
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-    char *response = http_wifi_connect_response;
-
-    /*decode the url encoded data using the function url_decode()*/
-    url_decode(buffer, data);
+    cy_rslt_t result;
 
-    if (!strncmp("SSID", buffer, 4))
+    result = cy_http_server_response_stream_write_payload(stream, data, length);
+    if (CY_RSLT_SUCCESS == result)
     {
-        /* Extract SSID and Password - skip to SSID*/
-        while ((buffer[buff_index++] != EQUALS_OPERATOR_ASCII_VALUE))
-            ;
+        result = cy_http_server_response_stream_flush(stream);
+    }
+
+    return result;
+}
 
-        ssid_buff_index = 0;
-        /*skip '&' */
-        while ((buffer[buff_index] != AMPERSAND_OPERATOR_ASCII_VALUE))
-            wifi_ssid[ssid_buff_index++] = buffer[buff_index++];
+/*******************************************************************************
+ * Function Name: wifi_scan_stream_results
+ *******************************************************************************
+ * Summary:
+ *  Runs a new scan and sends each AP to the client as soon as WCM reports it.
+ *  An AP reported more than once in the same scan is sent only once. Each AP
+ *  is formatted in a buffer on the stack, so the scan page rendered from the
+ *  AP table does not wait for the scan.
+ *
+ * Parameters:
+ *  stream - Pointer to the HTTP response stream.
+ *  start_time - Time the request was received.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the results are sent, otherwise, it
+ *  returns the HTTP server error code. A scan that fails or times out ends
+ *  the list without an error.
+ *
+ *******************************************************************************/
+static cy_rslt_t wifi_scan_stream_results(cy_http_response_stream_t *stream, cy_time_t start_time)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    cy_rslt_t scan_result;
+    scan_cache_entry_t entry;
+    cy_wcm_mac_t sent_bssid[SCAN_CACHE_MAX_ENTRIES];
+    char row[SCAN_CACHE_MAX_ROW_LEN];
+    uint32_t sent_count = 0;
+    uint32_t row_len;
+    uint32_t index;
+    bool complete = false;
+    cy_time_t now;
+
+    scan_result = scan_cache_stream_start();
+    if (CY_RSLT_SUCCESS != scan_result)
+    {
+        ERR_INFO(("Failed to start the scan with error code 0x%08lx.\n", (unsigned long)scan_result));
+    }
 
-        buff_index++;
-        /* skip to Password */
-        while ((buffer[buff_index++] != EQUALS_OPERATOR_ASCII_VALUE))
-            ;
+    while ((CY_RSLT_SUCCESS == scan_result) && (CY_RSLT_SUCCESS == result) && (sent_count < SCAN_CACHE_MAX_ENTRIES))
+    {
+        scan_result = scan_cache_stream_next(&entry, &complete);
+        if ((CY_RSLT_SUCCESS != scan_result) || complete)
+        {
+            break;
+        }
 
-        ssid_buff_index = 0;
-        while ((buff_index < data_len))
+        for (index = 0; index < sent_count; index++)
         {
-            if (buffer[buff_index] == AMPERSAND_OPERATOR_ASCII_VALUE)
+            if (0 == memcmp(sent_bssid[index], entry.bssid, sizeof(cy_wcm_mac_t)))
+            {
                 break;
+            }
+        }
 
-            wifi_pwd[ssid_buff_index++] = buffer[buff_index++];
+        row_len = scan_cache_format_entry(&entry, row, sizeof(row));
+        if ((index < sent_count) || (0 == row_len))
+        {
+            continue;
         }
-    }
-    result = cy_http_server_response_stream_write_payload(stream, WIFI_CONNECT_IN_PROGRESS, sizeof(WIFI_CONNECT_IN_PROGRESS));
-    if (CY_RSLT_SUCCESS != result)
-    {
-        ERR_INFO(("Failed to send the HTTP POST response.\n"));
-    }
 
-    result = start_sta_mode();
-    if (CY_RSLT_SUCCESS != result)
-    {
-        sprintf(response, WIFI_CONNECT_RESPONSE_START);
-        response += strlen(WIFI_CONNECT_RESPONSE_START);
-        sprintf(response, WIFI_CONNECT_FAIL_RESPONSE_END);
-        response += strlen(WIFI_CONNECT_FAIL_RESPONSE_END);
-        result = cy_http_server_response_stream_write_payload(stream, http_wifi_connect_response, sizeof(http_wifi_connect_response));
-        if (CY_RSLT_SUCCESS != result)
+        memcpy(sent_bssid[sent_count++], entry.bssid, sizeof(cy_wcm_mac_t));
+        result = wifi_scan_write(stream, row, row_len);
+
+        if (1 == sent_count)
         {
-            ERR_INFO(("Failed to send the HTTP POST response.\n"));
+            cy_rtos_get_time(&now);
+            wifi_scan_first_ap_msec = now - start_time;
         }
     }
-    else
+
+    scan_cache_stream_end();
+
+    wifi_scan_ap_count = sent_count;
+    if ((CY_RSLT_SUCCESS == result) && (0 == sent_count))
     {
-        sprintf(response, WIFI_CONNECT_RESPONSE_START);
-        response += strlen(WIFI_CONNECT_RESPONSE_START);
-        sprintf(response, WIFI_CONNECT_SUCCESS_RESPONSE_END);
-        response += strlen(WIFI_CONNECT_SUCCESS_RESPONSE_END);
-        result = cy_http_server_response_stream_write_payload(stream, http_wifi_connect_response, sizeof(http_wifi_connect_response));
-        if (CY_RSLT_SUCCESS != result)
-        {
-            ERR_INFO(("Failed to send the HTTP POST response.\n"));
-        }
+        result = wifi_scan_write(stream, WIFI_SCAN_NO_AP, sizeof(WIFI_SCAN_NO_AP) - 1);
     }
+
     return result;
 }
 
-/********************************************************************************
- * Function Name: start_ap_mode
- ********************************************************************************
+/*******************************************************************************
+ * Function Name: wifi_scan_resource_handler
+ *******************************************************************************
  * Summary:
- *  The function configures device in Concurrent AP + STA mode and initialises
- *  a SoftAP with the given credentials (SOFTAP_SSID, SOFTAP_PASSWORD and  security
- *  CY_WCM_SOFTAP_PASSWORD_WPA2_AES_PSK).
+ *  Handles HTTP GET requests for the scan page. By default, the page is
+ *  rendered from the table of APs refreshed by the background scans, so the
+ *  client does not wait for a scan. When the client asks for a new scan, the
+ *  start of the page is sent right away and each AP is sent as it is found.
  *
  * Parameters:
- *  void
+ *  url_path - Pointer to the HTTP URL path.
+ *  url_parameters - Pointer to the HTTP URL query string.
+ *  stream - Pointer to the HTTP response stream.
+ *  arg - Pointer to the argument passed during HTTP resource registration.
+ *  http_message_body - Pointer to the HTTP data from the client.
  *
  * Return:
- *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the SoftAP is started successfully,
- *  a WCM error code otherwise.
+ *  int32_t - Returns HTTP_REQUEST_HANDLE_SUCCESS if the request from the client
+ *  was handled successfully. Otherwise, it returns HTTP_REQUEST_HANDLE_ERROR.
  *
  *******************************************************************************/
-cy_rslt_t start_ap_mode()
+int32_t wifi_scan_resource_handler(const char *url_path,
+                                   const char *url_parameters,
+                                   cy_http_response_stream_t *stream,
+                                   void *arg,
+                                   cy_http_message_body_t *http_message_body)
 {
     cy_rslt_t result;
-    cy_wcm_ap_config_t ap_conf;
-    cy_wcm_ip_address_t ipv4_addr;
+    uint32_t length;
+    cy_time_t start_time;
+    cy_time_t now;
+    bool fresh_scan;
 
-    memset(&ap_conf, 0, sizeof(cy_wcm_ap_config_t));
-    memset(&ipv4_addr, 0, sizeof(cy_wcm_ip_address_t));
+    if (CY_HTTP_REQUEST_GET != http_message_body->request_type)
+    {
+        ERR_INFO(("Received invalid HTTP request method for the scan page. Supported HTTP method is GET.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
 
-    ap_conf.channel = 1;
-    memcpy(ap_conf.ap_credentials.SSID, SOFTAP_SSID, strlen(SOFTAP_SSID) + 1);
-    memcpy(ap_conf.ap_credentials.password, SOFTAP_PASSWORD, strlen(SOFTAP_PASSWORD) + 1);
-    ap_conf.ap_credentials.security = SOFTAP_SECURITY_TYPE;
-    ap_conf.ip_settings.ip_address = ap_sta_mode_ip_settings.ip_address;
-    ap_conf.ip_settings.netmask = ap_sta_mode_ip_settings.netmask;
-    ap_conf.ip_settings.gateway = ap_sta_mode_ip_settings.gateway;
+    cy_rtos_get_time(&start_time);
+    fresh_scan = ((NULL != url_parameters) && (NULL != strstr(url_parameters, WIFI_SCAN_FRESH_PARAM)));
 
-    result = cy_wcm_start_ap(&ap_conf);
-    PRINT_AND_ASSERT(result, "cy_wcm_start_ap failed...! \n");
+    result = wifi_scan_write(stream, SOFTAP_SCAN_START_RESPONSE, sizeof(SOFTAP_SCAN_START_RESPONSE) - 1);
 
-    /* Get IPV4 address for AP */
-    result = cy_wcm_get_ip_addr(CY_WCM_INTERFACE_TYPE_AP, &ipv4_addr);
-    PRINT_AND_ASSERT(result, "cy_wcm_get_ip_addr failed...! \n");
+    /* A new scan is serialized with the other scans by the scan cache. */
+    if ((CY_RSLT_SUCCESS == result) && fresh_scan)
+    {
+        cy_rtos_get_time(&now);
+        wifi_scan_fresh_scans++;
+        wifi_scan_ttfb_msec = now - start_time;
+        wifi_scan_first_ap_msec = 0;
 
-    return result;
+        result = wifi_scan_stream_results(stream, start_time);
+    }
+    else if (CY_RSLT_SUCCESS == result)
+    {
+        cy_rtos_get_mutex(&wifi_scan_mutex, CY_RTOS_NEVER_TIMEOUT);
+        length = scan_cache_format(http_wifi_scan_response, sizeof(http_wifi_scan_response));
+        if (0 == length)
+        {
+            result = wifi_scan_write(stream, WIFI_SCAN_NO_AP, sizeof(WIFI_SCAN_NO_AP) - 1);
+        }
+        else
+        {
+            result = wifi_scan_write(stream, http_wifi_scan_response, length);
+        }
+        cy_rtos_set_mutex(&wifi_scan_mutex);
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_http_server_response_stream_write_payload(stream, SOFTAP_SCAN_INTERMEDIATE_RESPONSE,
+                                                              sizeof(SOFTAP_SCAN_INTERMEDIATE_RESPONSE) - 1);
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_http_server_response_stream_write_payload(stream, SOFTAP_SCAN_END_RESPONSE,
+                                                              sizeof(SOFTAP_SCAN_END_RESPONSE) - 1);
+    }
+
+    if (fresh_scan)
+    {
+        cy_rtos_get_time(&now);
+        wifi_scan_total_msec = now - start_time;
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to send the scan page.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+
+    return HTTP_REQUEST_HANDLE_SUCCESS;
 }
 
 /*******************************************************************************
- * Function Name: start_sta_mode
+ * Function Name: device_data_redirect_update
  *******************************************************************************
  * Summary:
- *  The function attempts to connect to Wi-Fi until a connection is made or
- *  MAX_WIFI_RETRY_COUNT attempts have been made.
+ *  Caches the IP address of the STA and formats the redirect to the device
+ *  data page on it, unless it is already formatted for this address.
  *
  * Parameters:
- *  void
+ *  ip_address - IPv4 address of the STA, in network byte order.
  *
  * Return:
- *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the HTTP server is configured
- *  successfully, otherwise, it returns CY_RSLT_TYPE_ERROR.
+ *  void
  *
  *******************************************************************************/
-cy_rslt_t start_sta_mode()
+static void device_data_redirect_update(uint32_t ip_address)
 {
-    cy_rslt_t result;
-    cy_wcm_connect_params_t connect_param;
-    cy_wcm_ip_address_t ip_address;
-    bool wifi_conct_stat = false;
+    uint32_t index = device_data_redirect_index ^ 1u;
+    int length;
 
-    /*Disconnect from the currently connected AP if any*/
-    wifi_conct_stat = cy_wcm_is_connected_to_ap();
-    if (wifi_conct_stat)
+    if ((0 == ip_address) || (ip_address == wifi_sta_ip_address))
     {
-        cy_wcm_disconnect_ap();
+        return;
     }
 
-    memset(&connect_param, 0, sizeof(cy_wcm_connect_params_t));
-    memset(&ip_address, 0, sizeof(cy_wcm_ip_address_t));
-
-    memcpy(connect_param.ap_credentials.SSID, wifi_ssid, sizeof(wifi_ssid));
-    memcpy(connect_param.ap_credentials.password, wifi_pwd, sizeof(wifi_pwd));
-    connect_param.ap_credentials.security = CY_WCM_SECURITY_WPA2_AES_PSK;
-
-    /* Attempt to connect to Wi-Fi until a connection is made or
-     * MAX_WIFI_RETRY_COUNT attempts have been made.
-     */
-    for (uint32_t conn_retries = 0; conn_retries < MAX_WIFI_RETRY_COUNT; conn_retries++)
+    length = snprintf(device_data_redirect[index], sizeof(device_data_redirect[index]),
+                      DEVICE_DATA_REDIRECT_HEADER "%s",
+                      (unsigned int)(ip_address & 0xFFu), (unsigned int)((ip_address >> 8) & 0xFFu),
+                      (unsigned int)((ip_address >> 16) & 0xFFu), (unsigned int)(ip_address >> 24),
+                      (unsigned int)(sizeof(HTTP_DEVICE_DATA_REDIRECT_WEBPAGE) - 1),
+                      HTTP_DEVICE_DATA_REDIRECT_WEBPAGE);
+    if ((length < 0) || ((uint32_t)length >= sizeof(device_data_redirect[index])))
     {
-        result = cy_wcm_connect_ap(&connect_param, &ip_address);
-        if (result == CY_RSLT_SUCCESS)
-        {
-            APP_INFO(("Successfully connected to Wi-Fi network '%s'.\n", connect_param.ap_credentials.SSID));
-            break;
-        }
-        ERR_INFO(("Connection to Wi-Fi network failed with error code %d. Retrying in %d ms...\n", (int)result, WIFI_CONN_RETRY_INTERVAL_MSEC));
-
-        cy_rtos_delay_milliseconds(WIFI_CONN_RETRY_INTERVAL_MSEC);
+        return;
     }
 
-    return result;
+    device_data_redirect_len[index] = (uint32_t)length;
+    device_data_redirect_index = index;
+    wifi_sta_ip_address = ip_address;
 }
 
 /*******************************************************************************
- * Function Name: configure_http_server
+ * Function Name: device_data_redirect_handler
  *******************************************************************************
  * Summary:
- *  The function registers a softap_resource_handler to handle HTTP requests
- *  received by http_ap_server.
+ *  Handles the requests of the "Display Device Data" button. While the STA is
+ *  connected and its HTTP server is running, the client is redirected to the
+ *  device data page on the IP address of the STA with the redirect formatted
+ *  when the STA got its address. Otherwise, it is redirected to the home page.
  *
  * Parameters:
- *  void
+ *  url_path - Pointer to the HTTP URL path.
+ *  url_parameters - Pointer to the HTTP URL query string.
+ *  stream - Pointer to the HTTP response stream.
+ *  arg - Pointer to the argument passed during HTTP resource registration.
+ *  http_message_body - Pointer to the HTTP data from the client.
  *
  * Return:
- *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the HTTP server is configured
- *  successfully, otherwise, it returns CY_RSLT_TYPE_ERROR.
+ *  int32_t - Returns HTTP_REQUEST_HANDLE_SUCCESS if the request from the client
+ *  was handled successfully. Otherwise, it returns HTTP_REQUEST_HANDLE_ERROR.
  *
  *******************************************************************************/
-cy_rslt_t configure_http_server(void)
+int32_t device_data_redirect_handler(const char *url_path,
+                                     const char *url_parameters,
+                                     cy_http_response_stream_t *stream,
+                                     void *arg,
+                                     cy_http_message_body_t *http_message_body)
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-    cy_wcm_ip_address_t ip_addr;
-
-    /* Holds the response handler for HTTP GET and POST request from the client. */
-    cy_resource_dynamic_data_t http_get_post_resource;
-
-    /* IP address of SoftAp. */
-    result = cy_wcm_get_ip_addr(CY_WCM_INTERFACE_TYPE_AP, &ip_addr);
-    PRINT_AND_ASSERT(result, "cy_wcm_get_ip_addr failed for creating HTTP server...! \n");
-
-    http_server_ip_address.ip_address.ip.v4 = ip_addr.ip.v4;
-    http_server_ip_address.ip_address.version = CY_SOCKET_IP_VER_V4;
-
-    /* Add IP address information to network interface object. */
-    nw_interface.object = (void *)&http_server_ip_address;
-    nw_interface.type = CY_NW_INF_TYPE_WIFI;
-
-    /* Initialize secure socket library. */
-    result = cy_http_server_network_init();
-
-    /* Allocate memory needed for secure HTTP server. */
-    result = cy_http_server_create(&nw_interface, HTTP_PORT, MAX_SOCKETS, NULL, &http_ap_server);
-    PRINT_AND_ASSERT(result, "Failed to allocate memory for the HTTP server.\n");
+    cy_rslt_t result;
+    uint32_t index = device_data_redirect_index;
 
-    /* Configure dynamic resource handler. */
-    http_get_post_resource.resource_handler = softap_resource_handler;
-    http_get_post_resource.arg = NULL;
+    if ((WIFI_STATE_CONNECTED == wifi_state_get()) && http_interface_stats[HTTP_INTERFACE_STA].running &&
+        (0 != device_data_redirect_len[index]))
+    {
+        device_data_redirects++;
+        result = cy_http_server_response_stream_write_payload(stream, device_data_redirect[index],
+                                                              device_data_redirect_len[index]);
+    }
+    else
+    {
+        result = cy_http_server_response_stream_write_payload(stream, DEVICE_DATA_HOME_REDIRECT,
+                                                              sizeof(DEVICE_DATA_HOME_REDIRECT) - 1);
+    }
 
-    /* Register all the resources with the secure HTTP server. */
-    result = cy_http_server_register_resource(http_ap_server,
-                                              (uint8_t *)"/",
-                                              (uint8_t *)"text/html",
-                                              CY_DYNAMIC_URL_CONTENT,
-                                              &http_get_post_resource);
-    PRINT_AND_ASSERT(result, "Failed to register a resource.\n");
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to send the device data redirect.\n"));
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
 
-    return result;
+    return HTTP_REQUEST_HANDLE_SUCCESS;
 }
 
-/*******************************************************************************
- * Function Name: url_decode
+/********************************************************************************
+ * Function Name: wifi_form_field
  ********************************************************************************
- *
  * Summary:
- * This function is used to decode the url encoded HTTP data received.
+ *  Copies the value of a field of the URL-decoded connect form.
  *
  * Parameters:
- * char* dst: Pointer to to whch decoded data should be copied.
- * const uint8_t* src: Pointer to url encoded data .
+ *  form - Pointer to the URL-decoded form data.
+ *  name - Name of the field.
+ *  value - Buffer to store the terminated value.
+ *  value_len - Size of the buffer.
  *
  * Return:
- * void: Returns void .
+ *  bool - true if the field is present and its value fits in the buffer.
  *
  *******************************************************************************/
-void url_decode(char *dst, const uint8_t *src)
+static bool wifi_form_field(const char *form, const char *name, char *value, uint32_t value_len)
 {
-    char current_char, next_char;
-    /* Ensure that the received character is a valid character. */
-    while ((*src) && ((*src) < VALID_CHARACTER_ASCII_VALUE))
+    const char *field = form;
+    uint32_t name_len = strlen(name);
+    uint32_t length = 0;
+
+    while (NULL != field)
     {
-        /* URL encoding replaces unsafe ASCII characters with a "%" followed
-         * by two hexadecimal digits. Check for character "%" followed by
-         * two hexadecimal digits to decode unsafe ASCII characters.
-         */
-        if ((*src == MODUS_OPERATOR_ASCII_VALUE) && ((current_char = src[1]) && (next_char = src[2])) && (isxdigit(current_char) && isxdigit(next_char)))
+        if ((0 == strncmp(field, name, name_len)) && (EQUALS_OPERATOR_ASCII_VALUE == field[name_len]))
         {
-            if (current_char >= SMALL_LETTER_A_ASCII_VALUE)
-            {
-                current_char -= SMALL_LETTER_A_ASCII_VALUE - CAPITAL_LETTER_A_ASCII_VALUE;
-            }
-            if (current_char >= CAPITAL_LETTER_A_ASCII_VALUE)
-            {
-                current_char -= (CAPITAL_LETTER_A_ASCII_VALUE - LF_OPERATOR_ASCII_VALUE);
-            }
-            else
+            field += name_len + 1;
+            while ((field[length] != NULL_CHARACTER_ASCII_VALUE) && (field[length] != AMPERSAND_OPERATOR_ASCII_VALUE))
             {
-                current_char -= NUMBER_ZERO_ASCII_VALUE;
+                if (length + 1 >= value_len)
+                {
+                    return false;
+                }
+                value[length] = field[length];
+                length++;
+            }
+            value[length] = NULL_CHARACTER_ASCII_VALUE;
+            return true;
+        }
+
+        field = strchr(field, AMPERSAND_OPERATOR_ASCII_VALUE);
+        if (NULL != field)
+        {
+            field++;
+        }
+    }
+
+    return false;
+}
+
+/********************************************************************************
+ * Function Name: wifi_extract_static_ip
+ ********************************************************************************
+ * Summary:
+ *  Sets the static IP configuration of the STA interface from the optional
+ *  fields of the connect form. DHCP is used when the IP address is empty or
+ *  the configuration is not valid.
+ *
+ * Parameters:
+ *  form - Pointer to the URL-decoded form data.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void wifi_extract_static_ip(const char *form)
+{
+    char field[IP_CONFIG_IPV4_TEXT_LEN + 1];
+    cy_wcm_ip_setting_t settings;
+
+    if (!wifi_form_field(form, "IP", field, sizeof(field)) || (NULL_CHARACTER_ASCII_VALUE == field[0]))
+    {
+        ip_config_set_static(NULL);
+        return;
+    }
+
+    if (!ip_config_parse_ipv4(field, &settings.ip_address) ||
+        !wifi_form_field(form, "Netmask", field, sizeof(field)) ||
+        !ip_config_parse_ipv4(field, &settings.netmask) ||
+        !wifi_form_field(form, "Gateway", field, sizeof(field)) ||
+        !ip_config_parse_ipv4(field, &settings.gateway))
+    {
+        ERR_INFO(("Invalid static IP configuration, using DHCP.\n"));
+        ip_config_set_static(NULL);
+        return;
+    }
+
+    ip_config_set_static(&settings);
+}
+
+/********************************************************************************
+ * Function Name: wifi_extract_form_value
+ ********************************************************************************
+ * Summary:
+ *  Copies the URL-decoded value of a field of the connect form. The fields
+ *  are split before they are decoded, so that an encoded '&' or '=' in the
+ *  SSID or the password is kept.
+ *
+ * Parameters:
+ *  form - Pointer to the terminated, URL-encoded form data.
+ *  name - Name of the field.
+ *  value - Buffer to store the terminated value.
+ *  max_len - Longest value accepted, in bytes.
+ *
+ * Return:
+ *  bool - true if the field is present and its value is at most max_len
+ *  bytes long.
+ *
+ *******************************************************************************/
+static bool wifi_extract_form_value(const char *form, const char *name, uint8_t *value, uint32_t max_len)
+{
+    /* A URL-encoded byte takes at most three characters. */
+    char encoded[(3u * WIFI_PWD_LEN) + 1];
+    char decoded[sizeof(encoded)];
+
+    if (!wifi_form_field(form, name, encoded, sizeof(encoded)))
+    {
+        return false;
+    }
+
+    url_decode(decoded, (const uint8_t *)encoded);
+    if (strlen(decoded) > max_len)
+    {
+        return false;
+    }
+
+    memcpy(value, decoded, strlen(decoded) + 1);
+    return true;
+}
+
+/********************************************************************************
+ * Function Name: wifi_extract_credentials
+ ********************************************************************************
+ * Summary:
+ *  The function extracts the credentials entered via HTTP webpage. Switches to STA
+ *  mode then connects to the same credentials. A form without a valid SSID,
+ *  or with a value too long for its buffer, is answered with the failure
+ *  response and the device does not connect.
+ *
+ * Parameters:
+ *  const uint8_t* data : The HTTP data that contains ssid and password that is
+ *  entered from the HTTP webpage.
+ *   uint32_t data_len : The length of the HTTP response.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+cy_rslt_t wifi_extract_credentials(const uint8_t *data, uint32_t data_len, cy_http_response_stream_t *stream)
+{
+    cy_rslt_t result = CY_RSLT_TYPE_ERROR;
+    char *response = http_wifi_connect_response;
+    uint8_t ssid[WIFI_SSID_LEN + 1];
+    uint8_t password[WIFI_PWD_LEN];
+
+    /* The form is parsed into local buffers: wifi_ssid and wifi_pwd are only
+     * written by start_sta_mode, under wifi_connect_mutex.
+     */
+    memset(ssid, 0, sizeof(ssid));
+    memset(password, 0, sizeof(password));
+
+    /* The form is parsed from a terminated copy of the body. */
+    if (data_len < sizeof(buffer))
+    {
+        memcpy(buffer, data, data_len);
+        buffer[data_len] = NULL_CHARACTER_ASCII_VALUE;
+
+        if (wifi_extract_form_value(buffer, "SSID", ssid, WIFI_SSID_LEN) &&
+            (NULL_CHARACTER_ASCII_VALUE != ssid[0]) &&
+            wifi_extract_form_value(buffer, "Password", password, WIFI_PWD_LEN - 1))
+        {
+            wifi_extract_static_ip(buffer);
+            result = CY_RSLT_SUCCESS;
+        }
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Received an invalid Wi-Fi connect form.\n"));
+    }
+    else
+    {
+        result = cy_http_server_response_stream_write_payload(stream, WIFI_CONNECT_IN_PROGRESS, sizeof(WIFI_CONNECT_IN_PROGRESS));
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to send the HTTP POST response.\n"));
+        }
+
+        result = start_sta_mode(ssid, password);
+    }
+
+    memset(password, 0, sizeof(password));
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        sprintf(response, WIFI_CONNECT_RESPONSE_START);
+        response += strlen(WIFI_CONNECT_RESPONSE_START);
+        sprintf(response, WIFI_CONNECT_FAIL_RESPONSE_END);
+        response += strlen(WIFI_CONNECT_FAIL_RESPONSE_END);
+        result = cy_http_server_response_stream_write_payload(stream, http_wifi_connect_response, sizeof(http_wifi_connect_response));
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to send the HTTP POST response.\n"));
+        }
+    }
+    else
+    {
+        sprintf(response, WIFI_CONNECT_RESPONSE_START);
+        response += strlen(WIFI_CONNECT_RESPONSE_START);
+        sprintf(response, WIFI_CONNECT_SUCCESS_RESPONSE_END);
+        response += strlen(WIFI_CONNECT_SUCCESS_RESPONSE_END);
+        result = cy_http_server_response_stream_write_payload(stream, http_wifi_connect_response, sizeof(http_wifi_connect_response));
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Failed to send the HTTP POST response.\n"));
+        }
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: softap_start
+ *******************************************************************************
+ * Summary:
+ *  Starts the SoftAP with the given credentials (SOFTAP_SSID, SOFTAP_PASSWORD
+ *  and SOFTAP_SECURITY_TYPE) on a channel.
+ *
+ * Parameters:
+ *  channel - Channel of the SoftAP.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the SoftAP is started successfully,
+ *  a WCM error code otherwise.
+ *
+ *******************************************************************************/
+static cy_rslt_t softap_start(uint8_t channel)
+{
+    cy_rslt_t result;
+    cy_wcm_ap_config_t ap_conf;
+
+    memset(&ap_conf, 0, sizeof(cy_wcm_ap_config_t));
+
+    ap_conf.channel = channel;
+    memcpy(ap_conf.ap_credentials.SSID, SOFTAP_SSID, strlen(SOFTAP_SSID) + 1);
+    memcpy(ap_conf.ap_credentials.password, SOFTAP_PASSWORD, strlen(SOFTAP_PASSWORD) + 1);
+    ap_conf.ap_credentials.security = SOFTAP_SECURITY_TYPE;
+    ap_conf.ip_settings.ip_address = ap_sta_mode_ip_settings.ip_address;
+    ap_conf.ip_settings.netmask = ap_sta_mode_ip_settings.netmask;
+    ap_conf.ip_settings.gateway = ap_sta_mode_ip_settings.gateway;
+
+    result = cy_wcm_start_ap(&ap_conf);
+    softap_channel = (CY_RSLT_SUCCESS == result) ? channel : 0;
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: softap_pick_channel
+ *******************************************************************************
+ * Summary:
+ *  Scans for the APs around the device and returns the least congested of
+ *  the non-overlapping channels for the SoftAP.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint8_t - Channel of the SoftAP.
+ *
+ *******************************************************************************/
+static uint8_t softap_pick_channel(void)
+{
+    cy_rslt_t result;
+    uint32_t ap_count;
+    uint32_t score;
+    uint8_t channel;
+
+    result = scan_cache_scan_all();
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Scan for the SoftAP channel failed with error code 0x%08lx.\n", (unsigned long)result));
+    }
+
+    ap_count = scan_cache_snapshot(wifi_profile_aps, SCAN_CACHE_MAX_ENTRIES);
+    channel = channel_select_pick(wifi_profile_aps, ap_count, &score);
+    APP_INFO(("Starting the SoftAP on channel %u, score %lu from %lu APs found.\n",
+              (unsigned int)channel, (unsigned long)score, (unsigned long)ap_count));
+
+    return channel;
+}
+
+/********************************************************************************
+ * Function Name: start_ap_mode
+ ********************************************************************************
+ * Summary:
+ *  The function configures device in Concurrent AP + STA mode and initialises
+ *  a SoftAP with the given credentials (SOFTAP_SSID, SOFTAP_PASSWORD and  security
+ *  CY_WCM_SOFTAP_PASSWORD_WPA2_AES_PSK). The SoftAP is started on the least
+ *  congested of the non-overlapping channels, found by a scan of the APs
+ *  around the device.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the SoftAP is started successfully,
+ *  a WCM error code otherwise.
+ *
+ *******************************************************************************/
+cy_rslt_t start_ap_mode()
+{
+    cy_rslt_t result;
+    cy_wcm_ip_address_t ipv4_addr;
+
+    memset(&ipv4_addr, 0, sizeof(cy_wcm_ip_address_t));
+
+    result = softap_start(softap_pick_channel());
+    PRINT_AND_ASSERT(result, "cy_wcm_start_ap failed...! \n");
+
+    /* Get IPV4 address for AP */
+    result = cy_wcm_get_ip_addr(CY_WCM_INTERFACE_TYPE_AP, &ipv4_addr);
+    PRINT_AND_ASSERT(result, "cy_wcm_get_ip_addr failed...! \n");
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: softap_move_target
+ *******************************************************************************
+ * Summary:
+ *  Returns the channel the SoftAP should move to: the channel of the last
+ *  connection of the STA, when it differs from the channel of the SoftAP.
+ *  The SoftAP stays on its channel when the STA is on the 5 GHz band, where
+ *  the SoftAP is not started, or when it already failed to move there.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint8_t - Channel to move to, or 0 if the SoftAP stays on its channel.
+ *
+ *******************************************************************************/
+static uint8_t softap_move_target(void)
+{
+    uint8_t channel = wifi_sta_channel;
+
+    if (!SOFTAP_FOLLOW_STA_CHANNEL || (0 == softap_channel) || (channel == softap_channel) ||
+        (channel == softap_failed_channel) || (0 == channel) || (channel > 14u))
+    {
+        return 0;
+    }
+
+    return channel;
+}
+
+/*******************************************************************************
+ * Function Name: http_server_drain
+ *******************************************************************************
+ * Summary:
+ *  Puts the HTTP server of an interface in drain mode before its interface
+ *  is reconfigured: new requests are refused, the responses in flight are
+ *  given until HTTP_DRAIN_DEADLINE_MSEC to finish, and the event stream
+ *  subscribers of the server and the WebSocket listener and clients of the
+ *  interface are then closed and counted. The responses still in flight at
+ *  the deadline are counted as aborted. The server must be stopped or
+ *  started again, and http_server_reconfigured() called, after the
+ *  reconfiguration.
+ *
+ * Parameters:
+ *  interface - Interface of the HTTP server.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void http_server_drain(http_interface_t interface)
+{
+    http_interface_stats_t *stats = &http_interface_stats[interface];
+    cy_time_t now;
+    uint32_t inflight;
+    uint32_t closed_event_streams;
+    uint32_t closed_websockets;
+
+    reconfiguration_request = SERVER_RECONFIGURE_REQUESTED;
+
+    cy_rtos_get_mutex(&http_route_mutex, CY_RTOS_NEVER_TIMEOUT);
+    stats->draining = true;
+    inflight = stats->inflight;
+    cy_rtos_set_mutex(&http_route_mutex);
+
+    cy_rtos_get_time(&http_drain_start[interface]);
+    now = http_drain_start[interface];
+    while ((0 != inflight) && ((now - http_drain_start[interface]) < HTTP_DRAIN_DEADLINE_MSEC))
+    {
+        cy_rtos_delay_milliseconds(HTTP_DRAIN_POLL_INTERVAL_MSEC);
+        cy_rtos_get_time(&now);
+
+        cy_rtos_get_mutex(&http_route_mutex, CY_RTOS_NEVER_TIMEOUT);
+        inflight = stats->inflight;
+        cy_rtos_set_mutex(&http_route_mutex);
+    }
+
+    stats->last_drain_msec = now - http_drain_start[interface];
+    if (0 != inflight)
+    {
+        stats->aborted += inflight;
+        ERR_INFO(("%lu HTTP responses still in flight after %lu ms are aborted.\n",
+                  (unsigned long)inflight, (unsigned long)stats->last_drain_msec));
+    }
+
+    /* The event stream handler returns once its stream is started, but the
+     * subscriber holds the response stream of the server until it is closed.
+     * It is closed after the wait, so that a stream started by a request in
+     * flight is closed too.
+     */
+    closed_event_streams = event_stream_close_interface((uint32_t)interface);
+    closed_websockets = websocket_server_close((uint32_t)interface);
+    stats->closed_event_streams += closed_event_streams;
+    stats->closed_websockets += closed_websockets;
+    if ((0 != closed_event_streams) || (0 != closed_websockets))
+    {
+        APP_INFO(("Closed %lu event stream subscribers and %lu WebSocket clients to drain the HTTP server.\n",
+                  (unsigned long)closed_event_streams, (unsigned long)closed_websockets));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: http_server_reconfigured
+ *******************************************************************************
+ * Summary:
+ *  Ends the drain of the HTTP server of an interface once the interface is
+ *  reconfigured, and records the time from the start of the drain.
+ *
+ * Parameters:
+ *  interface - Interface of the HTTP server.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void http_server_reconfigured(http_interface_t interface)
+{
+    http_interface_stats_t *stats = &http_interface_stats[interface];
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+
+    cy_rtos_get_mutex(&http_route_mutex, CY_RTOS_NEVER_TIMEOUT);
+    stats->draining = false;
+    cy_rtos_set_mutex(&http_route_mutex);
+
+    stats->reconfigurations++;
+    stats->last_reconfigure_msec = now - http_drain_start[interface];
+    reconfiguration_request = SERVER_RECONFIGURED;
+}
+
+/*******************************************************************************
+ * Function Name: softap_move
+ *******************************************************************************
+ * Summary:
+ *  Restarts the SoftAP on another channel. The HTTP server, the WebSocket
+ *  listener and the DNS responder of the SoftAP, if they run, listen on the
+ *  SoftAP interface, so they are stopped while the interface is restarted,
+ *  after the HTTP server drains. If the SoftAP cannot be started on the new
+ *  channel, it is started again on its old channel. If that fails too, the
+ *  HTTP server of the SoftAP is deleted, and the SoftAP is left down like
+ *  after an idle teardown, to be restarted on its old channel on demand.
+ *
+ * Parameters:
+ *  channel - New channel of the SoftAP.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the SoftAP moved, otherwise, it
+ *  returns the WCM error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t softap_move(uint8_t channel)
+{
+    cy_rslt_t result;
+    cy_rslt_t fallback_result = CY_RSLT_SUCCESS;
+    uint8_t old_channel = softap_channel;
+    cy_time_t start;
+    cy_time_t end;
+
+    APP_INFO(("Moving the SoftAP from channel %u to the STA channel %u...\n",
+              (unsigned int)old_channel, (unsigned int)channel));
+
+    cy_rtos_get_time(&start);
+    if (http_interface_stats[HTTP_INTERFACE_AP].running)
+    {
+        http_server_drain(HTTP_INTERFACE_AP);
+        cy_http_server_stop(http_ap_server);
+        captive_dns_stop();
+    }
+    cy_wcm_stop_ap();
+
+    result = softap_start(channel);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to start the SoftAP on channel %u with error code 0x%08lx.\n",
+                  (unsigned int)channel, (unsigned long)result));
+        softap_failed_channel = channel;
+        fallback_result = softap_start(old_channel);
+    }
+
+    if (CY_RSLT_SUCCESS != fallback_result)
+    {
+        ERR_INFO(("Failed to start the SoftAP again on channel %u with error code 0x%08lx. The SoftAP is down.\n",
+                  (unsigned int)old_channel, (unsigned long)fallback_result));
+        softap_teardown_channel = old_channel;
+        if (http_interface_stats[HTTP_INTERFACE_AP].running)
+        {
+            http_interface_stats[HTTP_INTERFACE_AP].running = false;
+            cy_http_server_delete(http_ap_server);
+            http_server_reconfigured(HTTP_INTERFACE_AP);
+        }
+    }
+    else if (http_interface_stats[HTTP_INTERFACE_AP].running)
+    {
+        if (CY_RSLT_SUCCESS != captive_dns_start(&http_server_addresses[HTTP_INTERFACE_AP]))
+        {
+            ERR_INFO(("Failed to restart the DNS responder.\n"));
+        }
+
+        if (CY_RSLT_SUCCESS != cy_http_server_start(http_ap_server))
+        {
+            ERR_INFO(("Failed to restart the HTTP server.\n"));
+        }
+
+        /* The drain closed the WebSocket listener with its clients. */
+        if (CY_RSLT_SUCCESS != websocket_server_listen(HTTP_INTERFACE_AP, &http_server_addresses[HTTP_INTERFACE_AP]))
+        {
+            ERR_INFO(("Failed to restart the WebSocket listener.\n"));
+        }
+        http_server_reconfigured(HTTP_INTERFACE_AP);
+    }
+    cy_rtos_get_time(&end);
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        softap_moves++;
+        softap_move_msec = end - start;
+        APP_INFO(("SoftAP moved to channel %u in %lu ms.\n", (unsigned int)channel, (unsigned long)softap_move_msec));
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_classify_connect
+ *******************************************************************************
+ * Summary:
+ *  Classifies the result of a connection to the AP entered in the SoftAP
+ *  page. A join the WCM reports as refused is a rejection only when the
+ *  scan found the AP; otherwise the AP is missing, which may be transient.
+ *
+ * Parameters:
+ *  result - Result of the connection attempt.
+ *
+ * Return:
+ *  retry_class_t - Classification of the result.
+ *
+ *******************************************************************************/
+static retry_class_t wifi_classify_connect(cy_rslt_t result)
+{
+    retry_class_t retry_class = retry_policy_classify_wcm(result);
+
+    if ((RETRY_CLASS_REJECTED == retry_class) && !wifi_connect_target_found)
+    {
+        return RETRY_CLASS_RETRYABLE;
+    }
+
+    return retry_class;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_set_credentials
+ *******************************************************************************
+ * Summary:
+ *  Sets the SSID, security type and password of the connect parameters. For
+ *  WPA and WPA2 personal, the password is the PMK in hexadecimal, taken from
+ *  the PMK cache or derived once, so that the 4096 PBKDF2 iterations are not
+ *  repeated on every connect and retry.
+ *
+ * Parameters:
+ *  connect_param - Pointer to the connect parameters.
+ *  ssid - Pointer to the SSID.
+ *  passphrase - Pointer to the passphrase.
+ *  security - Security type of the AP.
+ *  pmk - Buffer to store the PMK.
+ *
+ * Return:
+ *  bool - true if the password is the PMK, false if it is the passphrase.
+ *
+ *******************************************************************************/
+static bool wifi_set_credentials(cy_wcm_connect_params_t *connect_param, const uint8_t *ssid,
+                                 const uint8_t *passphrase, cy_wcm_security_t security,
+                                 uint8_t pmk[PMK_LENGTH])
+{
+    memcpy(connect_param->ap_credentials.SSID, ssid, strnlen((const char *)ssid, CY_WCM_MAX_SSID_LEN));
+    connect_param->ap_credentials.security = security;
+
+    if (!pmk_cache_security_supported(security))
+    {
+        memcpy(connect_param->ap_credentials.password, passphrase,
+               strnlen((const char *)passphrase, CY_WCM_MAX_PASSPHRASE_LEN));
+        return false;
+    }
+
+    if (!pmk_cache_lookup(ssid, passphrase, pmk))
+    {
+        pmk_cache_derive(ssid, passphrase, pmk);
+    }
+
+    pmk_to_hex(pmk, (char *)connect_param->ap_credentials.password, sizeof(connect_param->ap_credentials.password));
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_event_callback
+ *******************************************************************************
+ * Summary:
+ *  Handles the WCM events. Records when the association of a connection
+ *  completes, to time it separately from the addressing, caches the new
+ *  IP address of the STA, and counts the clients of the SoftAP.
+ *
+ * Parameters:
+ *  event - WCM event.
+ *  event_data - Pointer to the data of the event.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void wifi_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t *event_data)
+{
+    cy_time_t now;
+
+    if (CY_WCM_EVENT_CONNECTED == event)
+    {
+        cy_rtos_get_time(&now);
+        wifi_associated_time = now;
+    }
+    else if (CY_WCM_EVENT_STA_JOINED_SOFTAP == event)
+    {
+        softap_clients++;
+    }
+    else if ((CY_WCM_EVENT_STA_LEFT_SOFTAP == event) && (0 != softap_clients))
+    {
+        softap_clients--;
+    }
+    else if ((CY_WCM_EVENT_IP_CHANGED == event) && (NULL != event_data))
+    {
+        device_data_redirect_update(event_data->ip_addr.ip.v4);
+    }
+
+    /* The state machine runs in the server task. */
+    wifi_state_post_event(event);
+}
+
+/*******************************************************************************
+ * Function Name: wifi_connect
+ *******************************************************************************
+ * Summary:
+ *  Connects to the AP with the IP settings selected by ip_config_select() and
+ *  times the association and addressing phases separately.
+ *
+ * Parameters:
+ *  connect_param - Pointer to the connect parameters.
+ *  ip_address - Pointer to store the IP address of the STA.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the device is connected, otherwise,
+ *  it returns the WCM error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t wifi_connect(cy_wcm_connect_params_t *connect_param, cy_wcm_ip_address_t *ip_address)
+{
+    cy_rslt_t result;
+    cy_time_t start;
+    cy_time_t end;
+    cy_time_t associated;
+    ip_config_stats_t ip_stats;
+
+    connect_param->static_ip_settings = ip_config_select();
+
+    cy_rtos_get_time(&start);
+    wifi_associated_time = 0;
+    wifi_state_enter(WIFI_STATE_CONNECTING);
+    result = cy_wcm_connect_ap(connect_param, ip_address);
+    cy_rtos_get_time(&end);
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    /* Without the event, the phases cannot be told apart. */
+    associated = wifi_associated_time;
+    if ((associated < start) || (associated > end))
+    {
+        associated = end;
+    }
+    wifi_association_msec = associated - start;
+    wifi_addressing_msec = end - associated;
+
+    ip_config_get_stats(&ip_stats);
+    APP_INFO(("Association took %lu ms and addressing (%s) took %lu ms.\n",
+              (unsigned long)wifi_association_msec, ip_config_source_name(ip_stats.source),
+              (unsigned long)wifi_addressing_msec));
+
+    device_data_redirect_update(ip_address->ip.v4);
+    wifi_state_enter(WIFI_STATE_CONNECTED);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_connected
+ *******************************************************************************
+ * Summary:
+ *  Records the boot-to-connected time of the first connection after boot,
+ *  restarts the link monitor, and stores the credentials, BSSID, channel and
+ *  PMK of the AP for the next boot.
+ *
+ * Parameters:
+ *  path - How the device got the credentials.
+ *  pmk - Pointer to the PMK used to connect, or NULL if the passphrase was used.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void wifi_connected(boot_path_t path, const uint8_t *pmk)
+{
+    cy_time_t now;
+    cy_wcm_associated_ap_info_t ap_info;
+    cred_store_entry_t entry;
+
+    cy_rtos_get_time(&now);
+    roam_reset(now);
+
+    if (BOOT_PATH_NONE == boot_path)
+    {
+        boot_connected_msec = now;
+        boot_path = path;
+        APP_INFO(("Connected %lu ms after boot using the %s.\n", (unsigned long)now,
+                  (BOOT_PATH_STORED_CREDENTIALS == path) ? "stored credentials" : "SoftAP"));
+    }
+
+    if (CY_RSLT_SUCCESS != cy_wcm_get_associated_ap_info(&ap_info))
+    {
+        return;
+    }
+
+    wifi_sta_channel = ap_info.channel;
+
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.ssid, wifi_ssid, (sizeof(wifi_ssid) < sizeof(entry.ssid)) ? sizeof(wifi_ssid) : (sizeof(entry.ssid) - 1));
+    memcpy(entry.password, wifi_pwd, (sizeof(wifi_pwd) < sizeof(entry.password)) ? sizeof(wifi_pwd) : (sizeof(entry.password) - 1));
+    entry.security = ap_info.security;
+    memcpy(entry.bssid, ap_info.BSSID, sizeof(entry.bssid));
+    entry.channel = ap_info.channel;
+    entry.static_ip_valid = ip_config_get_static(&entry.static_ip);
+    if (NULL != pmk)
+    {
+        entry.pmk_valid = true;
+        memcpy(entry.pmk, pmk, PMK_LENGTH);
+    }
+
+    if (CY_RSLT_SUCCESS != cred_store_save(&entry, true))
+    {
+        ERR_INFO(("Failed to store the Wi-Fi credentials.\n"));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: wifi_retry_seed
+ *******************************************************************************
+ * Summary:
+ *  Returns a seed for the jitter of the retry policies, taken from the MAC
+ *  address so that devices do not retry in lockstep.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  uint32_t - Seed.
+ *
+ *******************************************************************************/
+static uint32_t wifi_retry_seed(void)
+{
+    cy_wcm_mac_t mac_address;
+    uint32_t seed = 0;
+
+    if (CY_RSLT_SUCCESS == cy_wcm_get_mac_addr(CY_WCM_INTERFACE_TYPE_STA, &mac_address))
+    {
+        for (uint32_t index = 0; index < CY_WCM_MAC_ADDR_LEN; index++)
+        {
+            seed = (seed << 5) ^ (seed >> 27) ^ mac_address[index];
+        }
+    }
+
+    return seed;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_find_known_ap
+ *******************************************************************************
+ * Summary:
+ *  Looks up the BSSID, channel and security type of an AP without scanning:
+ *  in the scan cache, or else in the stored profile of the SSID.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *  entry - Pointer to store the AP found.
+ *
+ * Return:
+ *  bool - true if the AP is known.
+ *
+ *******************************************************************************/
+static bool wifi_find_known_ap(const uint8_t *ssid, scan_cache_entry_t *entry)
+{
+    cred_store_entry_t stored;
+    static const cy_wcm_mac_t no_bssid = {0};
+
+    if (scan_cache_lookup(ssid, entry))
+    {
+        return true;
+    }
+
+    if ((CY_RSLT_SUCCESS != cred_store_find(ssid, &stored)) ||
+        (0 == memcmp(stored.bssid, no_bssid, sizeof(cy_wcm_mac_t))))
+    {
+        return false;
+    }
+
+    memset(entry, 0, sizeof(*entry));
+    memcpy(entry->ssid, stored.ssid, sizeof(entry->ssid));
+    memcpy(entry->bssid, stored.bssid, sizeof(entry->bssid));
+    entry->security = stored.security;
+    entry->channel = stored.channel;
+    entry->band = (stored.channel > 14u) ? CY_WCM_WIFI_BAND_5GHZ : CY_WCM_WIFI_BAND_2_4GHZ;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_scan_for_ap
+ *******************************************************************************
+ * Summary:
+ *  Runs a scan on all channels targeted at an SSID and looks up the AP with
+ *  the strongest signal among the APs found.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *  entry - Pointer to store the AP found.
+ *
+ * Return:
+ *  bool - true if the AP is found.
+ *
+ *******************************************************************************/
+static bool wifi_scan_for_ap(const uint8_t *ssid, scan_cache_entry_t *entry)
+{
+    cy_rslt_t result;
+
+    wifi_state_enter(WIFI_STATE_SCANNING);
+    result = scan_cache_scan_ssid(ssid);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Scan for '%s' failed with error code 0x%08lx.\n", (char *)ssid, (unsigned long)result));
+    }
+
+    return scan_cache_lookup(ssid, entry);
+}
+
+/*******************************************************************************
+ * Function Name: wifi_set_target
+ *******************************************************************************
+ * Summary:
+ *  Sets the credentials, security type and band of the connect parameters
+ *  for the AP of wifi_ssid, entered in the SoftAP page or stored.
+ *
+ * Parameters:
+ *  connect_param - Pointer to the connect parameters.
+ *  entry - Pointer to the AP found, or NULL to try WPA2-AES-PSK on any band.
+ *  pmk - Buffer to store the PMK.
+ *
+ * Return:
+ *  bool - true if the password is the PMK, false if it is the passphrase.
+ *
+ *******************************************************************************/
+static bool wifi_set_target(cy_wcm_connect_params_t *connect_param, const scan_cache_entry_t *entry,
+                            uint8_t pmk[PMK_LENGTH])
+{
+    memset(&connect_param->ap_credentials, 0, sizeof(connect_param->ap_credentials));
+    connect_param->band = (NULL != entry) ? entry->band : CY_WCM_WIFI_BAND_ANY;
+
+    return wifi_set_credentials(connect_param, wifi_ssid, wifi_pwd,
+                                (NULL != entry) ? entry->security : CY_WCM_SECURITY_WPA2_AES_PSK, pmk);
+}
+
+/*******************************************************************************
+ * Function Name: start_sta_mode
+ *******************************************************************************
+ * Summary:
+ *  The function attempts to connect to Wi-Fi until a connection is made, the
+ *  error is not retryable, or the retry policy gives up. The credentials are
+ *  copied into wifi_ssid and wifi_pwd under wifi_connect_mutex, so that a
+ *  reconnection or a roam never sees a partly written pair.
+ *
+ * Parameters:
+ *  ssid - Terminated SSID entered in the SoftAP page.
+ *  password - Terminated password entered in the SoftAP page.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the HTTP server is configured
+ *  successfully, otherwise, it returns CY_RSLT_TYPE_ERROR.
+ *
+ *******************************************************************************/
+cy_rslt_t start_sta_mode(const uint8_t *ssid, const uint8_t *password)
+{
+    cy_rslt_t result;
+    cy_wcm_connect_params_t connect_param;
+    cy_wcm_ip_address_t ip_address;
+    bool wifi_conct_stat = false;
+    uint8_t pmk[PMK_LENGTH];
+    bool pmk_used;
+    retry_policy_t retry_policy;
+    uint32_t retry_delay_msec = 0;
+    scan_cache_entry_t ap_entry;
+    bool ap_found;
+    bool directed;
+    cy_time_t start_time;
+    cy_time_t now;
+
+    cy_rtos_get_time(&start_time);
+
+    /* Stop the background scans so that they do not delay the connection. */
+    scan_cache_set_background(false);
+
+    /* The server task does not reconnect while the new connection is made. */
+    cy_rtos_get_mutex(&wifi_connect_mutex, CY_RTOS_NEVER_TIMEOUT);
+    wifi_state_enter(WIFI_STATE_IDLE);
+
+    /* The previous credentials must not leak into a shorter SSID or password. */
+    memset(wifi_ssid, 0, sizeof(wifi_ssid));
+    memset(wifi_pwd, 0, sizeof(wifi_pwd));
+    memcpy(wifi_ssid, ssid, strnlen((const char *)ssid, WIFI_SSID_LEN));
+    memcpy(wifi_pwd, password, strnlen((const char *)password, WIFI_PWD_LEN - 1));
+
+    /*Disconnect from the currently connected AP if any*/
+    wifi_conct_stat = cy_wcm_is_connected_to_ap();
+    if (wifi_conct_stat)
+    {
+        cy_wcm_disconnect_ap();
+    }
+
+    memset(&connect_param, 0, sizeof(cy_wcm_connect_params_t));
+    memset(&ip_address, 0, sizeof(cy_wcm_ip_address_t));
+
+    /* When the AP is known from a recent scan or an earlier connection, the
+     * first attempt joins its BSSID on its band without scanning all the
+     * channels. Otherwise, or when that attempt fails, a scan targeted at the
+     * SSID finds the security type and band of the AP; if the AP is still not
+     * found, it may be hidden, so WPA2-AES-PSK on any band is tried.
+     */
+    directed = wifi_find_known_ap(wifi_ssid, &ap_entry);
+    ap_found = directed ? true : wifi_scan_for_ap(wifi_ssid, &ap_entry);
+    if (directed)
+    {
+        memcpy(connect_param.BSSID, ap_entry.bssid, sizeof(cy_wcm_mac_t));
+        APP_INFO(("Joining '%s' directly on channel %u.\n", (char *)wifi_ssid, (unsigned int)ap_entry.channel));
+    }
+    pmk_used = wifi_set_target(&connect_param, ap_found ? &ap_entry : NULL, pmk);
+    wifi_connect_target_found = ap_found;
+
+    retry_policy_start(&retry_policy, &wifi_retry_config, wifi_retry_seed());
+
+    /* Attempt to connect to Wi-Fi until a connection is made, the error is not
+     * retryable, or the retry policy gives up.
+     */
+    while (true)
+    {
+        result = wifi_connect(&connect_param, &ip_address);
+
+        /* Widen to a scan of all the channels when the directed join fails. */
+        if ((CY_RSLT_SUCCESS != result) && directed)
+        {
+            ERR_INFO(("Direct join failed with error code 0x%08lx. Scanning for '%s'...\n",
+                      (unsigned long)result, (char *)wifi_ssid));
+            directed = false;
+            wifi_directed_fallbacks++;
+            memset(connect_param.BSSID, 0, sizeof(cy_wcm_mac_t));
+            ap_found = wifi_scan_for_ap(wifi_ssid, &ap_entry);
+            pmk_used = wifi_set_target(&connect_param, ap_found ? &ap_entry : NULL, pmk);
+            wifi_connect_target_found = ap_found;
+        }
+
+        if (!retry_policy_next(&retry_policy, result, &retry_delay_msec))
+        {
+            break;
+        }
+
+        ERR_INFO(("Connection to Wi-Fi network failed with error code 0x%08lx. Retrying in %lu ms...\n",
+                  (unsigned long)result, (unsigned long)retry_delay_msec));
+        wifi_state_enter(WIFI_STATE_BACKOFF);
+        cy_rtos_delay_milliseconds(retry_delay_msec);
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        cy_rtos_get_time(&now);
+        wifi_connect_msec = now - start_time;
+        wifi_connect_directed = directed;
+        if (directed)
+        {
+            wifi_directed_connects++;
+        }
+
+        APP_INFO(("Successfully connected to Wi-Fi network '%s' in %lu ms.\n", connect_param.ap_credentials.SSID,
+                  (unsigned long)wifi_connect_msec));
+        wifi_connected(BOOT_PATH_SOFTAP, pmk_used ? pmk : NULL);
+    }
+    else
+    {
+        ERR_INFO(("Connection to Wi-Fi network failed with error code 0x%08lx. Giving up.\n", (unsigned long)result));
+        wifi_state_enter(WIFI_STATE_IDLE);
+        scan_cache_set_background(true);
+    }
+
+    cy_rtos_set_mutex(&wifi_connect_mutex);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_connect_profiles
+ *******************************************************************************
+ * Summary:
+ *  Tries the stored profiles in turn, each in one attempt, in the order
+ *  ranked by profile_select_rank. When more than one profile is stored, a
+ *  scan of all the channels first finds which of their APs are in range;
+ *  with a single profile, its stored BSSID is joined directly unless a scan
+ *  is requested.
+ *
+ * Parameters:
+ *  path - How the device got the credentials, reported once connected.
+ *  scan - true to scan for the AP of a single profile, as it may have moved
+ *  to another channel.
+ *  attempts - Pointer to store the number of profiles tried.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the device is connected, otherwise,
+ *  it returns CY_RSLT_TYPE_ERROR or the WCM error code of the last attempt.
+ *
+ *******************************************************************************/
+static cy_rslt_t wifi_connect_profiles(boot_path_t path, bool scan, uint32_t *attempts)
+{
+    cy_rslt_t result;
+    cy_wcm_connect_params_t connect_param;
+    cy_wcm_ip_address_t ip_address;
+    const cred_store_entry_t *profile;
+    uint8_t pmk[PMK_LENGTH];
+    bool pmk_used;
+    uint32_t profile_count;
+    uint32_t ap_count;
+    uint32_t count;
+    uint32_t index;
+
+    *attempts = 0;
+
+    result = cred_store_load(wifi_profiles, &profile_count);
+    wifi_profile_count = (CY_RSLT_SUCCESS == result) ? profile_count : 0;
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    if ((profile_count > 1) || scan)
+    {
+        wifi_state_enter(WIFI_STATE_SCANNING);
+        result = (profile_count > 1) ? scan_cache_scan_all() : scan_cache_scan_ssid(wifi_profiles[0].ssid);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            ERR_INFO(("Scan for the stored Wi-Fi networks failed with error code 0x%08lx.\n", (unsigned long)result));
+        }
+    }
+
+    ap_count = scan_cache_snapshot(wifi_profile_aps, SCAN_CACHE_MAX_ENTRIES);
+    count = profile_select_rank(wifi_profiles, profile_count, wifi_profile_aps, ap_count, wifi_profile_candidates);
+
+    result = CY_RSLT_TYPE_ERROR;
+    for (index = 0; index < count; index++)
+    {
+        profile = &wifi_profiles[wifi_profile_candidates[index].profile];
+
+        /* Keep the credentials in RAM as if they were entered in the SoftAP page. */
+        memset(wifi_ssid, 0, sizeof(wifi_ssid));
+        memset(wifi_pwd, 0, sizeof(wifi_pwd));
+        memcpy(wifi_ssid, profile->ssid, (sizeof(wifi_ssid) < sizeof(profile->ssid)) ? sizeof(wifi_ssid) : sizeof(profile->ssid));
+        memcpy(wifi_pwd, profile->password, (sizeof(wifi_pwd) < sizeof(profile->password)) ? sizeof(wifi_pwd) : sizeof(profile->password));
+        ip_config_set_static(profile->static_ip_valid ? &profile->static_ip : NULL);
+
+        memset(&connect_param, 0, sizeof(cy_wcm_connect_params_t));
+        memset(&ip_address, 0, sizeof(cy_wcm_ip_address_t));
+        memcpy(connect_param.BSSID, wifi_profile_candidates[index].ap.bssid, sizeof(cy_wcm_mac_t));
+        pmk_used = wifi_set_target(&connect_param, &wifi_profile_candidates[index].ap, pmk);
+
+        APP_INFO(("Connecting to the stored Wi-Fi network '%s' on channel %u...\n",
+                  (char *)wifi_ssid, (unsigned int)wifi_profile_candidates[index].ap.channel));
+
+        (*attempts)++;
+        wifi_profile_attempts++;
+
+        result = wifi_connect(&connect_param, &ip_address);
+        if (CY_RSLT_SUCCESS == result)
+        {
+            wifi_profile_rank = index;
+            wifi_connected(path, pmk_used ? pmk : NULL);
+            break;
+        }
+
+        ERR_INFO(("Connection to the stored Wi-Fi network '%s' failed with error code 0x%08lx.\n",
+                  (char *)wifi_ssid, (unsigned long)result));
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: connect_stored_credentials
+ *******************************************************************************
+ * Summary:
+ *  Connects to the AP of one of the stored profiles, trying each profile in
+ *  one directed attempt, using its stored security type, BSSID and band.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the device is connected, otherwise,
+ *  it returns CY_RSLT_TYPE_ERROR or the WCM error code.
+ *
+ *******************************************************************************/
+cy_rslt_t connect_stored_credentials(void)
+{
+    cy_rslt_t result;
+    uint32_t attempts;
+
+    result = wifi_connect_profiles(BOOT_PATH_STORED_CREDENTIALS, false, &attempts);
+    if (0 == attempts)
+    {
+        APP_INFO(("No stored Wi-Fi credentials.\n"));
+    }
+    else if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Connection to the stored Wi-Fi networks failed.\n"));
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ip_config_set_static(NULL);
+        wifi_state_enter(WIFI_STATE_IDLE);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_reconnect
+ *******************************************************************************
+ * Summary:
+ *  Makes one attempt to reconnect after a link loss. The first attempt
+ *  joins the known BSSID of the last AP directly; the next ones scan and try
+ *  the stored profiles, as the AP may have moved to another channel or
+ *  another known AP may be in range. Without stored profiles, they scan for
+ *  the SSID of the last AP.
+ *
+ * Parameters:
+ *  directed - true to join the known BSSID without scanning.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the device is connected, otherwise,
+ *  it returns the WCM error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t wifi_reconnect(bool directed)
+{
+    cy_rslt_t result;
+    cy_wcm_connect_params_t connect_param;
+    cy_wcm_ip_address_t ip_address;
+    scan_cache_entry_t ap_entry;
+    uint8_t pmk[PMK_LENGTH];
+    bool pmk_used;
+    bool ap_found;
+    uint32_t attempts;
+
+    /* WCM may have restored the link by itself. */
+    if (cy_wcm_is_connected_to_ap())
+    {
+        wifi_state_enter(WIFI_STATE_CONNECTED);
+        return CY_RSLT_SUCCESS;
+    }
+
+    if (!directed)
+    {
+        result = wifi_connect_profiles(boot_path, true, &attempts);
+        if (0 != attempts)
+        {
+            return result;
+        }
+    }
+
+    memset(&connect_param, 0, sizeof(cy_wcm_connect_params_t));
+    memset(&ip_address, 0, sizeof(cy_wcm_ip_address_t));
+
+    ap_found = directed ? wifi_find_known_ap(wifi_ssid, &ap_entry) : wifi_scan_for_ap(wifi_ssid, &ap_entry);
+    if (directed && ap_found)
+    {
+        memcpy(connect_param.BSSID, ap_entry.bssid, sizeof(cy_wcm_mac_t));
+    }
+    pmk_used = wifi_set_target(&connect_param, ap_found ? &ap_entry : NULL, pmk);
+
+    result = wifi_connect(&connect_param, &ip_address);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        wifi_connected(boot_path, pmk_used ? pmk : NULL);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_find_roam_target
+ *******************************************************************************
+ * Summary:
+ *  Looks up the AP with the strongest signal among the APs of an SSID in the
+ *  scan cache, other than the current one.
+ *
+ * Parameters:
+ *  ssid - Pointer to the SSID.
+ *  bssid - BSSID of the current AP.
+ *  entry - Pointer to store the AP found.
+ *
+ * Return:
+ *  bool - true if another AP of the SSID is in the cache.
+ *
+ *******************************************************************************/
+static bool wifi_find_roam_target(const uint8_t *ssid, const cy_wcm_mac_t bssid, scan_cache_entry_t *entry)
+{
+    uint32_t count;
+    uint32_t index;
+
+    /* The snapshot is sorted, so the first match is the strongest. */
+    count = scan_cache_snapshot(wifi_profile_aps, SCAN_CACHE_MAX_ENTRIES);
+    for (index = 0; index < count; index++)
+    {
+        if ((0 == strncmp((const char *)wifi_profile_aps[index].ssid, (const char *)ssid, CY_WCM_MAX_SSID_LEN)) &&
+            (0 != memcmp(wifi_profile_aps[index].bssid, bssid, sizeof(cy_wcm_mac_t))))
+        {
+            *entry = wifi_profile_aps[index];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_roam_check
+ *******************************************************************************
+ * Summary:
+ *  Samples the RSSI and the transmit failures of the link to the AP. When
+ *  the link monitor reports a sustained degradation, scans for the other APs
+ *  of the SSID and roams to the strongest one if it is enough stronger. The
+ *  roam leaves the current AP and joins the new BSSID directly, and gets its
+ *  address again from DHCP unless a static configuration is set.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the device is still connected,
+ *  otherwise, it returns the WCM error code of the failed roam.
+ *
+ *******************************************************************************/
+static cy_rslt_t wifi_roam_check(void)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    cy_wcm_associated_ap_info_t ap_info;
+    cy_wcm_wlan_statistics_t wlan_stats;
+    roam_input_t input;
+    scan_cache_entry_t target;
+    cy_wcm_connect_params_t connect_param;
+    cy_wcm_ip_address_t ip_address;
+    uint8_t pmk[PMK_LENGTH];
+    bool pmk_used;
+    cy_time_t start;
+    cy_time_t now;
+
+    if (CY_RSLT_SUCCESS != cy_wcm_get_associated_ap_info(&ap_info))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    input.rssi_dbm = (int8_t)ap_info.signal_strength;
+    input.tx_valid = (CY_RSLT_SUCCESS == cy_wcm_get_wlan_statistics(CY_WCM_INTERFACE_TYPE_STA, &wlan_stats));
+    input.tx_packets = input.tx_valid ? wlan_stats.tx_packets : 0;
+    input.tx_failed = input.tx_valid ? wlan_stats.tx_failed : 0;
+
+    cy_rtos_get_time(&now);
+    if (!roam_update(&input, now))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    /* A connection from the SoftAP page replaces the roam. */
+    cy_rtos_get_mutex(&wifi_connect_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if (WIFI_STATE_CONNECTED != wifi_state_get())
+    {
+        cy_rtos_set_mutex(&wifi_connect_mutex);
+        return CY_RSLT_SUCCESS;
+    }
+
+    (void)scan_cache_scan_ssid(wifi_ssid);
+    if (!wifi_find_roam_target(wifi_ssid, ap_info.BSSID, &target) || !roam_is_better(input.rssi_dbm, target.rssi))
+    {
+        cy_rtos_set_mutex(&wifi_connect_mutex);
+        return CY_RSLT_SUCCESS;
+    }
+
+    APP_INFO(("Link at %d dBm. Roaming to %02X:%02X:%02X:%02X:%02X:%02X at %d dBm on channel %u...\n",
+              (int)input.rssi_dbm, target.bssid[0], target.bssid[1], target.bssid[2],
+              target.bssid[3], target.bssid[4], target.bssid[5], (int)target.rssi, (unsigned int)target.channel));
+
+    memset(&connect_param, 0, sizeof(cy_wcm_connect_params_t));
+    memset(&ip_address, 0, sizeof(cy_wcm_ip_address_t));
+    memcpy(connect_param.BSSID, target.bssid, sizeof(cy_wcm_mac_t));
+    pmk_used = wifi_set_target(&connect_param, &target, pmk);
+
+    cy_rtos_get_time(&start);
+    cy_wcm_disconnect_ap();
+    result = wifi_connect(&connect_param, &ip_address);
+    cy_rtos_get_time(&now);
+
+    roam_record(CY_RSLT_SUCCESS == result, now - start, (int32_t)target.rssi - (int32_t)input.rssi_dbm);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        APP_INFO(("Roamed in %lu ms.\n", (unsigned long)(now - start)));
+        wifi_connected(boot_path, pmk_used ? pmk : NULL);
+    }
+    else
+    {
+        ERR_INFO(("Roam failed with error code 0x%08lx.\n", (unsigned long)result));
+        wifi_state_enter(WIFI_STATE_LOST);
+    }
+
+    cy_rtos_set_mutex(&wifi_connect_mutex);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: get_boot_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns how and when the device got connected to an AP after boot, the
+ *  duration of the phases of the last connection, how the connections from
+ *  the SoftAP page found the AP, and which stored profile connected.
+ *
+ * Parameters:
+ *  stats - Pointer to store the boot statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void get_boot_stats(boot_stats_t *stats)
+{
+    stats->path = boot_path;
+    stats->connected_msec = boot_connected_msec;
+    stats->association_msec = wifi_association_msec;
+    stats->addressing_msec = wifi_addressing_msec;
+    stats->connect_msec = wifi_connect_msec;
+    stats->connect_directed = wifi_connect_directed;
+    stats->directed_connects = wifi_directed_connects;
+    stats->directed_fallbacks = wifi_directed_fallbacks;
+    stats->profiles = wifi_profile_count;
+    stats->profile_rank = wifi_profile_rank;
+    stats->profile_attempts = wifi_profile_attempts;
+    stats->softap_channel = softap_channel;
+    stats->softap_moves = softap_moves;
+    stats->softap_move_msec = softap_move_msec;
+    stats->device_data_redirects = device_data_redirects;
+}
+
+/*******************************************************************************
+ * Function Name: get_scan_page_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the latency of the last scan page streamed from a new scan.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void get_scan_page_stats(scan_page_stats_t *stats)
+{
+    stats->fresh_scans = wifi_scan_fresh_scans;
+    stats->ttfb_msec = wifi_scan_ttfb_msec;
+    stats->first_ap_msec = wifi_scan_first_ap_msec;
+    stats->total_msec = wifi_scan_total_msec;
+    stats->ap_count = wifi_scan_ap_count;
+}
+
+/*******************************************************************************
+ * Function Name: http_route_handler
+ *******************************************************************************
+ * Summary:
+ *  Resource handler registered for every route of every HTTP server. Calls
+ *  the handler of the route and counts the request and the time spent in the
+ *  handler in the metrics of the interface of the server.
+ *
+ * Parameters:
+ *  url_path - Pointer to the HTTP URL path.
+ *  url_parameters - Pointer to the HTTP URL query string.
+ *  stream - Pointer to the HTTP response stream.
+ *  arg - Pointer to the binding of the route to the interface.
+ *  http_message_body - Pointer to the HTTP data from the client.
+ *
+ * Return:
+ *  int32_t - Status returned by the handler of the route.
+ *
+ *******************************************************************************/
+static int32_t http_route_handler(const char *url_path,
+                                  const char *url_parameters,
+                                  cy_http_response_stream_t *stream,
+                                  void *arg,
+                                  cy_http_message_body_t *http_message_body)
+{
+    const http_route_binding_t *binding = (const http_route_binding_t *)arg;
+    http_interface_stats_t *stats = &http_interface_stats[binding->interface];
+    int32_t status;
+    cy_time_t start;
+    cy_time_t end;
+
+    /* A draining server takes no new requests. */
+    cy_rtos_get_mutex(&http_route_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if (stats->draining)
+    {
+        stats->drain_rejected++;
+        cy_rtos_set_mutex(&http_route_mutex);
+        return HTTP_REQUEST_HANDLE_ERROR;
+    }
+    stats->inflight++;
+    cy_rtos_set_mutex(&http_route_mutex);
+
+    cy_rtos_get_time(&start);
+    status = http_routes[binding->route].handler(url_path, url_parameters, stream, arg, http_message_body);
+    cy_rtos_get_time(&end);
+
+    /* The server runs a handler for each connection, so the counters of the
+     * interface are updated under the mutex.
+     */
+    cy_rtos_get_mutex(&http_route_mutex, CY_RTOS_NEVER_TIMEOUT);
+    stats->inflight--;
+    stats->requests++;
+    if (HTTP_REQUEST_HANDLE_SUCCESS != status)
+    {
+        stats->errors++;
+    }
+    stats->total_msec += end - start;
+    if ((end - start) > stats->max_msec)
+    {
+        stats->max_msec = end - start;
+    }
+    cy_rtos_set_mutex(&http_route_mutex);
+
+    return status;
+}
+
+/*******************************************************************************
+ * Function Name: http_server_create
+ *******************************************************************************
+ * Summary:
+ *  Creates the HTTP server of an interface on the given IP address and
+ *  registers the routes of http_routes with it; the server of the STA only
+ *  registers the routes with on_sta set. Each server has its own bindings to
+ *  the routes, so that the requests are counted per interface.
+ *
+ * Parameters:
+ *  interface - Interface of the HTTP server.
+ *  ip_address - IPv4 address of the interface, in network byte order.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the HTTP server is created,
+ *  otherwise, it returns the HTTP server error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t http_server_create(http_interface_t interface, uint32_t ip_address)
+{
+    cy_rslt_t result;
+    cy_http_server_t *server = (HTTP_INTERFACE_AP == interface) ? &http_ap_server : &http_sta_server;
+    uint32_t route;
+
+    http_server_addresses[interface].ip_address.ip.v4 = ip_address;
+    http_server_addresses[interface].ip_address.version = CY_SOCKET_IP_VER_V4;
+
+    /* Add IP address information to network interface object. */
+    http_nw_interfaces[interface].object = (void *)&http_server_addresses[interface];
+    http_nw_interfaces[interface].type = CY_NW_INF_TYPE_WIFI;
+
+    /* Allocate memory needed for the HTTP server. */
+    result = cy_http_server_create(&http_nw_interfaces[interface], HTTP_PORT, MAX_SOCKETS, NULL, server);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    for (route = 0; (route < HTTP_ROUTE_COUNT) && (CY_RSLT_SUCCESS == result); route++)
+    {
+        if ((HTTP_INTERFACE_STA == interface) && !http_routes[route].on_sta)
+        {
+            continue;
+        }
+
+        http_route_bindings[interface][route].route = route;
+        http_route_bindings[interface][route].interface = interface;
+        http_route_resources[interface][route].resource_handler = http_route_handler;
+        http_route_resources[interface][route].arg = &http_route_bindings[interface][route];
+
+        result = cy_http_server_register_resource(*server,
+                                                  (uint8_t *)http_routes[route].url,
+                                                  (uint8_t *)http_routes[route].mime_type,
+                                                  http_routes[route].type,
+                                                  &http_route_resources[interface][route]);
+    }
+
+    /* On the SoftAP, answer the connectivity checks of the clients with a
+     * redirect to the configuration page.
+     */
+    if ((CY_RSLT_SUCCESS == result) && (HTTP_INTERFACE_AP == interface))
+    {
+        result = captive_portal_register(*server, ip_address);
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        cy_http_server_delete(*server);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: http_server_shutdown
+ *******************************************************************************
+ * Summary:
+ *  Drains the HTTP server of an interface, then stops it and frees its
+ *  sockets and memory.
+ *
+ * Parameters:
+ *  interface - Interface of the HTTP server.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void http_server_shutdown(http_interface_t interface)
+{
+    cy_http_server_t server = (HTTP_INTERFACE_AP == interface) ? http_ap_server : http_sta_server;
+
+    if (!http_interface_stats[interface].running)
+    {
+        return;
+    }
+
+    http_server_drain(interface);
+    http_interface_stats[interface].running = false;
+    cy_http_server_stop(server);
+    cy_http_server_delete(server);
+    http_server_reconfigured(interface);
+}
+
+/*******************************************************************************
+ * Function Name: http_sta_server_update
+ *******************************************************************************
+ * Summary:
+ *  Runs the HTTP server of the STA on its current IP address, with the
+ *  routes of the device data page and a WebSocket listener, so that the
+ *  clients on the network of the STA are served directly. The server is
+ *  created again when the IP address changes. With HTTP_AP_SERVER_SHUTDOWN,
+ *  the HTTP server and the DNS responder of the SoftAP are shut down
+ *  HTTP_AP_SERVER_SHUTDOWN_DELAY_MSEC after the server of the STA starts.
+ *
+ * Parameters:
+ *  ip_address - IPv4 address of the STA, in network byte order.
+ *  now - Current time.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void http_sta_server_update(uint32_t ip_address, cy_time_t now)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if ((!http_interface_stats[HTTP_INTERFACE_STA].running ||
+         (ip_address != http_server_addresses[HTTP_INTERFACE_STA].ip_address.ip.v4)) &&
+        (ip_address != http_sta_server_failed_address))
+    {
+        http_server_shutdown(HTTP_INTERFACE_STA);
+
+        result = http_server_create(HTTP_INTERFACE_STA, ip_address);
+        if (CY_RSLT_SUCCESS == result)
+        {
+            result = cy_http_server_start(http_sta_server);
+            if (CY_RSLT_SUCCESS != result)
+            {
+                cy_http_server_delete(http_sta_server);
+            }
+        }
+
+        if (CY_RSLT_SUCCESS == result)
+        {
+            http_interface_stats[HTTP_INTERFACE_STA].running = true;
+            http_sta_server_failed_address = 0;
+            if (CY_RSLT_SUCCESS != websocket_server_listen(HTTP_INTERFACE_STA, &http_server_addresses[HTTP_INTERFACE_STA]))
+            {
+                ERR_INFO(("Failed to start the WebSocket listener of the STA.\n"));
+            }
+            http_ap_server_shutdown_time = now + HTTP_AP_SERVER_SHUTDOWN_DELAY_MSEC;
+            APP_INFO(("HTTP server started on the STA at http://%u.%u.%u.%u:%u/\n",
+                      (unsigned int)(ip_address & 0xFFu), (unsigned int)((ip_address >> 8) & 0xFFu),
+                      (unsigned int)((ip_address >> 16) & 0xFFu), (unsigned int)(ip_address >> 24),
+                      (unsigned int)HTTP_PORT));
+        }
+        else
+        {
+            ERR_INFO(("Failed to start the HTTP server of the STA with error code 0x%08lx.\n",
+                      (unsigned long)result));
+            http_sta_server_failed_address = ip_address;
+        }
+    }
+
+    if (HTTP_AP_SERVER_SHUTDOWN && http_interface_stats[HTTP_INTERFACE_STA].running &&
+        http_interface_stats[HTTP_INTERFACE_AP].running && ((int32_t)(now - http_ap_server_shutdown_time) >= 0))
+    {
+        APP_INFO(("Shutting down the HTTP server of the SoftAP.\n"));
+        captive_dns_stop();
+        http_server_shutdown(HTTP_INTERFACE_AP);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: softap_get_headroom
+ *******************************************************************************
+ * Summary:
+ *  Reads the bytes in use in the ThreadX byte pools, which back the memory
+ *  allocated by the RTOS and the network stack, and the free packets of the
+ *  packet pool shared by the interfaces.
+ *
+ * Parameters:
+ *  byte_pool_used - Pointer to store the bytes in use in the byte pools.
+ *  pool_free - Pointer to store the number of free packets, or 0 if the pool
+ *  cannot be read.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void softap_get_headroom(volatile uint32_t *byte_pool_used, volatile uint32_t *pool_free)
+{
+    TX_BYTE_POOL *byte_pool = _tx_byte_pool_created_ptr;
+    ULONG byte_pool_count = _tx_byte_pool_created_count;
+    ULONG available_bytes;
+    uint32_t used_bytes = 0;
+    NX_IP *ip;
+    ULONG total_packets = 0;
+    ULONG free_packets = 0;
+
+    /* The created byte pools form a circular list. */
+    while ((0 != byte_pool_count--) && (TX_NULL != byte_pool))
+    {
+        if (TX_SUCCESS == tx_byte_pool_info_get(byte_pool, TX_NULL, &available_bytes, TX_NULL,
+                                                TX_NULL, TX_NULL, TX_NULL))
+        {
+            used_bytes += (uint32_t)(byte_pool->tx_byte_pool_size - available_bytes);
+        }
+        byte_pool = byte_pool->tx_byte_pool_created_next;
+    }
+
+    *byte_pool_used = used_bytes;
+    *pool_free = 0;
+
+    ip = (NX_IP *)cy_network_get_nw_interface(CY_NETWORK_WIFI_STA_INTERFACE, 0);
+    if ((NX_NULL != ip) && (NX_NULL != ip->nx_ip_default_packet_pool) &&
+        (NX_SUCCESS == nx_packet_pool_info_get(ip->nx_ip_default_packet_pool, &total_packets,
+                                               &free_packets, NX_NULL, NX_NULL, NX_NULL)))
+    {
+        *pool_free = (uint32_t)free_packets;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: softap_teardown
+ *******************************************************************************
+ * Summary:
+ *  Stops the DNS responder, the HTTP server, whose drain closes the event
+ *  streams and the WebSocket listener and clients of the SoftAP, and the
+ *  SoftAP, and records the bytes in use in the byte pools and the free packets
+ *  before and after.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void softap_teardown(void)
+{
+    softap_get_headroom(&softap_byte_pool_used_before, &softap_pool_free_before);
+
+    captive_dns_stop();
+    http_server_shutdown(HTTP_INTERFACE_AP);
+    softap_teardown_channel = softap_channel;
+    cy_wcm_stop_ap();
+    softap_channel = 0;
+    softap_clients = 0;
+    softap_teardowns++;
+
+    softap_get_headroom(&softap_byte_pool_used_after, &softap_pool_free_after);
+
+    APP_INFO(("SoftAP stopped after %lu ms without clients. Byte pools in use: %lu -> %lu bytes, free packets: %lu -> %lu.\n",
+              (unsigned long)SOFTAP_IDLE_TEARDOWN_MSEC,
+              (unsigned long)softap_byte_pool_used_before, (unsigned long)softap_byte_pool_used_after,
+              (unsigned long)softap_pool_free_before, (unsigned long)softap_pool_free_after));
+}
+
+/*******************************************************************************
+ * Function Name: softap_bring_up
+ *******************************************************************************
+ * Summary:
+ *  Starts the SoftAP on a channel with its HTTP server, WebSocket listener,
+ *  and DNS responder.
+ *
+ * Parameters:
+ *  channel - Channel of the SoftAP.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the SoftAP and its HTTP server are
+ *  started, otherwise, it returns the WCM or HTTP server error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t softap_bring_up(uint8_t channel)
+{
+    cy_rslt_t result;
+
+    result = softap_start(channel);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to start the SoftAP with error code 0x%08lx.\n", (unsigned long)result));
+        return result;
+    }
+
+    result = http_server_create(HTTP_INTERFACE_AP, ap_sta_mode_ip_settings.ip_address.ip.v4);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_http_server_start(http_ap_server);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            cy_http_server_delete(http_ap_server);
+        }
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to start the HTTP server of the SoftAP with error code 0x%08lx.\n",
+                  (unsigned long)result));
+        return result;
+    }
+    http_interface_stats[HTTP_INTERFACE_AP].running = true;
+
+    if (CY_RSLT_SUCCESS != websocket_server_listen(HTTP_INTERFACE_AP, &http_server_addresses[HTTP_INTERFACE_AP]))
+    {
+        ERR_INFO(("Failed to start the WebSocket listener of the SoftAP.\n"));
+    }
+
+    if (CY_RSLT_SUCCESS != captive_dns_start(&http_server_addresses[HTTP_INTERFACE_AP]))
+    {
+        ERR_INFO(("Failed to start the DNS responder.\n"));
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: softap_restart
+ *******************************************************************************
+ * Summary:
+ *  Starts the SoftAP again on its channel before the teardown, with its HTTP
+ *  server, WebSocket listener, and DNS responder.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the SoftAP is started, otherwise,
+ *  it returns the WCM or HTTP server error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t softap_restart(void)
+{
+    cy_rslt_t result;
+
+    result = softap_bring_up(softap_teardown_channel);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    softap_teardown_channel = 0;
+    softap_restarts++;
+
+    APP_INFO(("SoftAP restarted on channel %u.\n", (unsigned int)softap_channel));
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: softap_provision
+ *******************************************************************************
+ * Summary:
+ *  Starts the SoftAP with the configuration page on the least congested
+ *  channel, for a device that connected with the stored credentials at boot
+ *  and so never started it. Unless the STA is connected, it also starts the
+ *  background scans that keep the scan page up to date.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the SoftAP is started, otherwise,
+ *  it returns the WCM or HTTP server error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t softap_provision(void)
+{
+    cy_rslt_t result;
+
+    device_configured = false;
+
+    result = softap_bring_up(softap_pick_channel());
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    /* While the STA is connected, the scan page is served from the scan of
+     * the channel pick, as the background scans would take the radio off the
+     * channel of the STA.
+     */
+    if ((WIFI_STATE_CONNECTED != wifi_state_get()) && (CY_RSLT_SUCCESS != scan_cache_start_scanner(SCAN_DELAY_MS)))
+    {
+        ERR_INFO(("Failed to start the background scans.\n"));
+    }
+
+    APP_INFO(("SoftAP '%s' started on channel %u to configure the device.\n",
+              SOFTAP_SSID, (unsigned int)softap_channel));
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: softap_button_callback
+ *******************************************************************************
+ * Summary:
+ *  Requests the restart of the SoftAP after an idle teardown, or its start
+ *  with the configuration page if it was never started, when the user
+ *  button is pressed, and wakes the server task, which starts it.
+ *
+ * Parameters:
+ *  arg - Unused.
+ *  event - GPIO event.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void softap_button_callback(void *arg, cyhal_gpio_event_t event)
+{
+    (void)arg;
+    (void)event;
+
+    softap_restart_requested = true;
+    wifi_state_wake();
+}
+
+/*******************************************************************************
+ * Function Name: softap_idle_update
+ *******************************************************************************
+ * Summary:
+ *  Tears the SoftAP down once the STA is connected and no client has been
+ *  associated with the SoftAP for SOFTAP_IDLE_TEARDOWN_MSEC, and starts it
+ *  again when the STA is not connected or the user button was pressed. Once
+ *  the reconnection gives up, the SoftAP serves the configuration page; a
+ *  device that connected with the stored credentials at boot starts it then,
+ *  or when the user button is pressed.
+ *
+ * Parameters:
+ *  now - Current time.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void softap_idle_update(cy_time_t now)
+{
+    wifi_state_t state = wifi_state_get();
+    bool connected = (WIFI_STATE_CONNECTED == state);
+
+    /* The network of the stored credentials is gone: configure another one. */
+    if ((WIFI_STATE_IDLE == state) && device_configured && (0 != softap_channel))
+    {
+        APP_INFO(("Serving the configuration page on the SoftAP.\n"));
+        device_configured = false;
+    }
+
+    if ((0 == softap_channel) && (0 == softap_teardown_channel))
+    {
+        if ((WIFI_STATE_IDLE == state) || softap_restart_requested)
+        {
+            softap_restart_requested = false;
+            softap_idle_since = now;
+            (void)softap_provision();
+        }
+        return;
+    }
+
+    if (0 != softap_teardown_channel)
+    {
+        if (!connected || softap_restart_requested)
+        {
+            softap_restart_requested = false;
+            softap_idle_since = now;
+            (void)softap_restart();
+        }
+        return;
+    }
+
+    softap_restart_requested = false;
+    if ((0 == SOFTAP_IDLE_TEARDOWN_MSEC) || !connected || (0 != softap_clients))
+    {
+        softap_idle_since = now;
+    }
+    else if ((now - softap_idle_since) >= SOFTAP_IDLE_TEARDOWN_MSEC)
+    {
+        softap_teardown();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: get_softap_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the state and the idle teardowns of the SoftAP.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void get_softap_stats(softap_stats_t *stats)
+{
+    stats->running = (0 != softap_channel);
+    stats->clients = softap_clients;
+    stats->teardowns = softap_teardowns;
+    stats->restarts = softap_restarts;
+    stats->byte_pool_used_before = softap_byte_pool_used_before;
+    stats->byte_pool_used_after = softap_byte_pool_used_after;
+    stats->pool_free_before = softap_pool_free_before;
+    stats->pool_free_after = softap_pool_free_after;
+}
+
+/*******************************************************************************
+ * Function Name: get_http_interface_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the requests served by the HTTP server of an interface and the
+ *  time spent in their handlers.
+ *
+ * Parameters:
+ *  interface - Interface of the HTTP server.
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void get_http_interface_stats(http_interface_t interface, http_interface_stats_t *stats)
+{
+    cy_rtos_get_mutex(&http_route_mutex, CY_RTOS_NEVER_TIMEOUT);
+    *stats = http_interface_stats[interface];
+    cy_rtos_set_mutex(&http_route_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: configure_http_server
+ *******************************************************************************
+ * Summary:
+ *  The function initializes the resources shared by the HTTP servers and
+ *  creates the HTTP server of the given interface with the routes of
+ *  http_routes.
+ *
+ * Parameters:
+ *  interface - Interface whose IP address the HTTP server listens on: the
+ *  SoftAP, or the STA when the device connected with the stored credentials
+ *  at boot.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the HTTP server is configured
+ *  successfully, otherwise, it returns CY_RSLT_TYPE_ERROR.
+ *
+ *******************************************************************************/
+cy_rslt_t configure_http_server(cy_wcm_interface_t interface)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    cy_wcm_ip_address_t ip_addr;
+
+    /* IP address of the SoftAP or of the STA. */
+    result = cy_wcm_get_ip_addr(interface, &ip_addr);
+    PRINT_AND_ASSERT(result, "cy_wcm_get_ip_addr failed for creating HTTP server...! \n");
+
+    /* Initialize secure socket library. */
+    result = cy_http_server_network_init();
+
+    /* Serializes the scan page buffer between the HTTP server threads. */
+    result = cy_rtos_init_mutex(&wifi_scan_mutex);
+    PRINT_AND_ASSERT(result, "Failed to initialize the scan page mutex.\n");
+
+    result = cy_rtos_init_mutex(&http_route_mutex);
+    PRINT_AND_ASSERT(result, "Failed to initialize the HTTP route mutex.\n");
+
+    result = metrics_init();
+    PRINT_AND_ASSERT(result, "Failed to initialize the metrics.\n");
+
+    result = profiles_api_init();
+    PRINT_AND_ASSERT(result, "Failed to initialize the profiles API.\n");
+
+    result = http_server_create((CY_WCM_INTERFACE_TYPE_AP == interface) ? HTTP_INTERFACE_AP : HTTP_INTERFACE_STA,
+                                ip_addr.ip.v4);
+    PRINT_AND_ASSERT(result, "Failed to create the HTTP server.\n");
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: url_decode
+ ********************************************************************************
+ *
+ * Summary:
+ * This function is used to decode the url encoded HTTP data received.
+ *
+ * Parameters:
+ * char* dst: Pointer to to whch decoded data should be copied.
+ * const uint8_t* src: Pointer to url encoded data .
+ *
+ * Return:
+ * void: Returns void .
+ *
+ *******************************************************************************/
+void url_decode(char *dst, const uint8_t *src)
+{
+    char current_char, next_char;
+    /* Ensure that the received character is a valid character. */
+    while ((*src) && ((*src) < VALID_CHARACTER_ASCII_VALUE))
+    {
+        /* URL encoding replaces unsafe ASCII characters with a "%" followed
+         * by two hexadecimal digits. Check for character "%" followed by
+         * two hexadecimal digits to decode unsafe ASCII characters.
+         */
+        if ((*src == MODUS_OPERATOR_ASCII_VALUE) && ((current_char = src[1]) && (next_char = src[2])) && (isxdigit(current_char) && isxdigit(next_char)))
+        {
+            if (current_char >= SMALL_LETTER_A_ASCII_VALUE)
+            {
+                current_char -= SMALL_LETTER_A_ASCII_VALUE - CAPITAL_LETTER_A_ASCII_VALUE;
+            }
+            if (current_char >= CAPITAL_LETTER_A_ASCII_VALUE)
+            {
+                current_char -= (CAPITAL_LETTER_A_ASCII_VALUE - LF_OPERATOR_ASCII_VALUE);
+            }
+            else
+            {
+                current_char -= NUMBER_ZERO_ASCII_VALUE;
             }
             if (next_char >= SMALL_LETTER_A_ASCII_VALUE)
             {
@@ -519,7 +2826,8 @@ void url_decode(char *dst, const uint8_t *src)
  * Function Name: server_task
  ********************************************************************************
  * Summary:
- *  Task that initializes the device as SoftAp, and starts the HTTP server
+ *  Task that connects to the AP with the stored credentials or, if that fails,
+ *  initializes the device as SoftAp, and starts the HTTP server
  *
  * Parameters:
  *  arg - Unused.
@@ -531,6 +2839,24 @@ void url_decode(char *dst, const uint8_t *src)
 void server_task(cy_thread_arg_t arg)
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
+    cy_wcm_interface_t server_interface = CY_WCM_INTERFACE_TYPE_AP;
+    http_interface_t http_interface;
+    cy_wcm_event_t event;
+    wifi_state_t state;
+    retry_policy_t reconnect_policy;
+    uint32_t retry_delay_msec = 0;
+    bool reconnecting = false;
+    bool reconnect_due;
+    cy_time_t reconnect_time = 0;
+    bool roam_due;
+    cy_time_t roam_time = 0;
+    uint8_t softap_move_channel = 0;
+    cy_time_t softap_move_time = 0;
+    char softap_notice[EVENT_STREAM_MAX_DATA_LEN];
+    uint32_t length;
+    cy_wcm_ip_address_t sta_ip_address;
+    cy_time_t timeout;
+    cy_time_t now;
     (void)arg;
 
     /* Initialize the Wi-Fi device as a STA.*/
@@ -540,22 +2866,391 @@ void server_task(cy_thread_arg_t arg)
     result = cy_wcm_init(&config);
     PRINT_AND_ASSERT(result, "cy_wcm_init failed...!\n");
 
-    result = start_ap_mode();
-    PRINT_AND_ASSERT(result, "start SoftAP failed...!\n");
+    /* The state machine publishes its transitions to the HTTP event stream
+     * from the first connection on.
+     */
+    result = event_stream_init();
+    PRINT_AND_ASSERT(result, "Failed to initialize the HTTP event stream.\n");
+
+    result = wifi_state_init();
+    PRINT_AND_ASSERT(result, "Failed to initialize the Wi-Fi state machine...!\n");
+
+    result = cy_rtos_init_mutex(&wifi_connect_mutex);
+    PRINT_AND_ASSERT(result, "Failed to initialize the Wi-Fi connect mutex...!\n");
+
+    result = cy_wcm_register_event_callback(wifi_event_callback);
+    PRINT_AND_ASSERT(result, "cy_wcm_register_event_callback failed...!\n");
+
+    result = cred_store_init();
+    if (CY_RSLT_SUCCESS != result)
+    {
+        ERR_INFO(("Failed to initialize the credential store.\n"));
+    }
+
+    result = scan_cache_init();
+    PRINT_AND_ASSERT(result, "Failed to initialize the scan cache...!\n");
+
+    /* Bring up the SoftAP only when the stored credentials do not work. */
+    if (CY_RSLT_SUCCESS == connect_stored_credentials())
+    {
+        server_interface = CY_WCM_INTERFACE_TYPE_STA;
+        device_configured = true;
+    }
+    else
+    {
+        result = start_ap_mode();
+        PRINT_AND_ASSERT(result, "start SoftAP failed...!\n");
+
+        /* Keep the scan page up to date while the device is being configured. */
+        result = scan_cache_start_scanner(SCAN_DELAY_MS);
+        PRINT_AND_ASSERT(result, "Failed to start the background scans...!\n");
+    }
 
-    result = configure_http_server();
+    result = configure_http_server(server_interface);
     PRINT_AND_ASSERT(result, "Failed to configure the HTTP server...!\n");
 
     /* Start the HTTP server. */
-    result = cy_http_server_start(http_ap_server);
+    http_interface = (CY_WCM_INTERFACE_TYPE_AP == server_interface) ? HTTP_INTERFACE_AP : HTTP_INTERFACE_STA;
+    result = cy_http_server_start((HTTP_INTERFACE_AP == http_interface) ? http_ap_server : http_sta_server);
     PRINT_AND_ASSERT(result, "Failed to start the HTTP server.\n");
+    http_interface_stats[http_interface].running = true;
+
+    /* Start the WebSocket endpoint on the same network interface. The
+     * servers started later open their own listeners.
+     */
+    result = websocket_server_start();
+    PRINT_AND_ASSERT(result, "Failed to start the WebSocket server.\n");
+
+    result = websocket_server_listen(http_interface, &http_server_addresses[http_interface]);
+    PRINT_AND_ASSERT(result, "Failed to start the WebSocket listener.\n");
+
+    /* Resolve every name to the SoftAP so that the clients open the
+     * configuration page by themselves.
+     */
+    if (CY_WCM_INTERFACE_TYPE_AP == server_interface)
+    {
+        result = captive_dns_start(&http_server_addresses[HTTP_INTERFACE_AP]);
+        PRINT_AND_ASSERT(result, "Failed to start the DNS responder.\n");
+    }
+
+    display_configuration(server_interface);
+
+    /* The user button starts the SoftAP again after an idle teardown, and
+     * starts it with the configuration page after a boot with the stored
+     * credentials.
+     */
+    result = cyhal_gpio_init(CYBSP_USER_BTN, CYHAL_GPIO_DIR_INPUT, CYHAL_GPIO_DRIVE_PULLUP, CYBSP_BTN_OFF);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        softap_button_callback_data.callback = softap_button_callback;
+        cyhal_gpio_register_callback(CYBSP_USER_BTN, &softap_button_callback_data);
+        cyhal_gpio_enable_event(CYBSP_USER_BTN, CYHAL_GPIO_IRQ_FALL, SOFTAP_BUTTON_INTR_PRIORITY, true);
+    }
+    else
+    {
+        ERR_INFO(("Failed to initialize the user button.\n"));
+    }
+
+    /* Start publishing the device data to the HTTP event stream. */
+    result = cy_rtos_thread_create(&device_data_task_handle,
+                                   &device_data_task,
+                                   "Device data task",
+                                   &device_data_task_stack,
+                                   DEVICE_DATA_TASK_STACK_SIZE,
+                                   DEVICE_DATA_TASK_PRIORITY,
+                                   0);
+    PRINT_AND_ASSERT(result, "Failed to create the device data task.\n");
+
+    /* Run the connection state machine. The task sleeps until a WCM event
+     * arrives or the user button wakes it, until the end of the backoff while
+     * it reconnects after a link loss, or until the next sample of the link
+     * while connected.
+     */
+    while (true)
+    {
+        reconnect_due = false;
+        roam_due = false;
+        timeout = CY_RTOS_NEVER_TIMEOUT;
+        cy_rtos_get_time(&now);
+        if (reconnecting)
+        {
+            timeout = ((int32_t)(reconnect_time - now) > 0) ? (reconnect_time - now) : 0;
+        }
+        else if (WIFI_STATE_CONNECTED == wifi_state_get())
+        {
+            timeout = ((int32_t)(roam_time - now) > 0) ? (roam_time - now) : 0;
+            if ((0 != softap_move_channel) && ((int32_t)(softap_move_time - now) < (int32_t)timeout))
+            {
+                timeout = ((int32_t)(softap_move_time - now) > 0) ? (softap_move_time - now) : 0;
+            }
+        }
+
+        if (CY_RSLT_SUCCESS != wifi_state_wait_event(&event, timeout))
+        {
+            cy_rtos_get_time(&now);
+            reconnect_due = reconnecting;
+            roam_due = !reconnecting && ((int32_t)(now - roam_time) >= 0);
+        }
+        else
+        {
+            state = wifi_state_handle_event(event);
+        }
+
+        if (roam_due)
+        {
+            cy_rtos_get_time(&now);
+            (void)wifi_roam_check();
+            cy_rtos_get_time(&now);
+            roam_time = now + roam_sample_interval();
+        }
+
+        /* Once the STA is connected on another channel, warn the SoftAP
+         * clients and move the SoftAP to the STA channel after the notice.
+         */
+        cy_rtos_get_time(&now);
+        if (WIFI_STATE_CONNECTED != wifi_state_get())
+        {
+            softap_move_channel = 0;
+        }
+        else if (0 == softap_move_channel)
+        {
+            softap_move_channel = softap_move_target();
+            if (0 != softap_move_channel)
+            {
+                length = (uint32_t)snprintf(softap_notice, sizeof(softap_notice), "channel %u",
+                                            (unsigned int)softap_move_channel);
+                event_stream_publish(SOFTAP_EVENT_NAME, softap_notice, length);
+                websocket_send_event(SOFTAP_EVENT_NAME, softap_notice, length);
+                softap_move_time = now + SOFTAP_MOVE_NOTICE_MSEC;
+            }
+        }
+        else if ((int32_t)(now - softap_move_time) >= 0)
+        {
+            cy_rtos_get_mutex(&wifi_connect_mutex, CY_RTOS_NEVER_TIMEOUT);
+            if ((WIFI_STATE_CONNECTED == wifi_state_get()) && (softap_move_target() == softap_move_channel))
+            {
+                (void)softap_move(softap_move_channel);
+            }
+            cy_rtos_set_mutex(&wifi_connect_mutex);
+            softap_move_channel = 0;
+        }
+
+        /* Serve and advertise the device on the network of the STA while it
+         * is connected, at its current IP address.
+         */
+        if (WIFI_STATE_CONNECTED == wifi_state_get())
+        {
+            if (CY_RSLT_SUCCESS == cy_wcm_get_ip_addr(CY_WCM_INTERFACE_TYPE_STA, &sta_ip_address))
+            {
+                http_sta_server_update(sta_ip_address.ip.v4, now);
+                (void)mdns_start(sta_ip_address.ip.v4);
+            }
+        }
+        else
+        {
+            mdns_stop();
+        }
+
+        /* Stop the SoftAP once nobody uses it, and start it again on demand. */
+        cy_rtos_get_mutex(&wifi_connect_mutex, CY_RTOS_NEVER_TIMEOUT);
+        softap_idle_update(now);
+        cy_rtos_set_mutex(&wifi_connect_mutex);
+
+        /* A link loss, reported by WCM or left by a failed roam, starts the
+         * reconnection.
+         */
+        if (!reconnect_due)
+        {
+            state = wifi_state_get();
+            if ((WIFI_STATE_LOST == state) && !reconnecting)
+            {
+                ERR_INFO(("Link to the Wi-Fi network '%s' lost. Reconnecting...\n", (char *)wifi_ssid));
+                retry_policy_start(&reconnect_policy, &wifi_reconnect_config, wifi_retry_seed());
+                reconnecting = true;
+                reconnect_due = true;
+            }
+            else if (WIFI_STATE_CONNECTED == state)
+            {
+                reconnecting = false;
+            }
+        }
+
+        if (!reconnect_due)
+        {
+            continue;
+        }
+
+        /* A connection from the SoftAP page replaces the reconnection. */
+        cy_rtos_get_mutex(&wifi_connect_mutex, CY_RTOS_NEVER_TIMEOUT);
+        state = wifi_state_get();
+        if ((WIFI_STATE_LOST != state) && (WIFI_STATE_BACKOFF != state))
+        {
+            reconnecting = false;
+            cy_rtos_set_mutex(&wifi_connect_mutex);
+            continue;
+        }
+
+        result = wifi_reconnect(0 == reconnect_policy.attempts);
+        if (retry_policy_next(&reconnect_policy, result, &retry_delay_msec))
+        {
+            ERR_INFO(("Reconnection failed with error code 0x%08lx. Retrying in %lu ms...\n",
+                      (unsigned long)result, (unsigned long)retry_delay_msec));
+            wifi_state_enter(WIFI_STATE_BACKOFF);
+            cy_rtos_get_time(&now);
+            reconnect_time = now + retry_delay_msec;
+        }
+        else
+        {
+            reconnecting = false;
+            if (CY_RSLT_SUCCESS == result)
+            {
+                APP_INFO(("Reconnected to Wi-Fi network '%s'.\n", (char *)wifi_ssid));
+            }
+            else
+            {
+                ERR_INFO(("Reconnection failed with error code 0x%08lx. Giving up.\n", (unsigned long)result));
+                wifi_state_enter(WIFI_STATE_IDLE);
+
+                /* The task sleeps until the next event from now on, so offer
+                 * the configuration page on the SoftAP at once.
+                 */
+                cy_rtos_get_time(&now);
+                softap_idle_update(now);
+            }
+        }
+        cy_rtos_set_mutex(&wifi_connect_mutex);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: device_duty_cycle_step
+ ********************************************************************************
+ * Summary:
+ *  Increases or decreases the duty cycle reported in the device data by
+ *  DUTY_CYCLE_STEP_PERCENT, within 0 to DUTY_CYCLE_MAX_PERCENT.
+ *
+ * Parameters:
+ *  increase - true to increase the duty cycle, false to decrease it.
+ *
+ * Return:
+ *  uint32_t - The new duty cycle.
+ *
+ *******************************************************************************/
+uint32_t device_duty_cycle_step(bool increase)
+{
+    uint32_t duty_cycle = device_duty_cycle;
+
+    if (increase)
+    {
+        if (duty_cycle + DUTY_CYCLE_STEP_PERCENT <= DUTY_CYCLE_MAX_PERCENT)
+        {
+            duty_cycle += DUTY_CYCLE_STEP_PERCENT;
+        }
+    }
+    else if (duty_cycle >= DUTY_CYCLE_STEP_PERCENT)
+    {
+        duty_cycle -= DUTY_CYCLE_STEP_PERCENT;
+    }
+
+    device_duty_cycle = duty_cycle;
+    return duty_cycle;
+}
+
+/*******************************************************************************
+ * Function Name: device_data_task
+ ********************************************************************************
+ * Summary:
+ *  Task that publishes the device data to the HTTP event stream and sends the
+ *  heartbeats of the stream. The device data is also sent to the WebSocket
+ *  client, if one is connected; the event stream then carries it only once
+ *  per EVENT_STREAM_DATA_INTERVAL_MSEC. The interval between uploads is adapted by
+ *  the rate controller to the TX packet pool occupancy, the time taken to
+ *  write the upload and the RSSI.
+ *
+ * Parameters:
+ *  arg - Unused.
+ *
+ * Return:
+ *  None.
+ *
+ *******************************************************************************/
+void device_data_task(cy_thread_arg_t arg)
+{
+    char device_data[TELEMETRY_MAX_TEXT_LEN + 1];
+    uint32_t length;
+    telemetry_sample_t sample;
+    cy_wcm_associated_ap_info_t ap_info;
+    cy_time_t now;
+    cy_time_t last_rssi_time = 0;
+    cy_time_t last_event_time = 0;
+    int8_t rssi_dbm = 0;
+    bool rssi_valid = false;
+    rate_control_input_t rate_input;
+    cy_time_t write_start;
+    uint32_t interval_msec;
+    (void)arg;
 
-    display_configuration();
+    rate_control_init(WIFI_DATA_UPLOAD_INTERVAL_MSEC);
 
-    /* Waits for queue message to register a new HTTP page resource.*/
     while (true)
     {
-        cy_rtos_delay_milliseconds(2000);
+        cy_rtos_get_time(&now);
+
+        /* Reading the RSSI is an IOCTL to the Wi-Fi firmware, so it is sampled
+         * less often than the device data is published.
+         */
+        if ((now - last_rssi_time) >= TELEMETRY_RSSI_SAMPLE_INTERVAL_MSEC)
+        {
+            last_rssi_time = now;
+            rssi_valid = (cy_wcm_is_connected_to_ap() &&
+                          (CY_RSLT_SUCCESS == cy_wcm_get_associated_ap_info(&ap_info)));
+            if (rssi_valid)
+            {
+                rssi_dbm = (int8_t)ap_info.signal_strength;
+            }
+        }
+
+        sample.present = TELEMETRY_FIELD_DUTY_CYCLE | TELEMETRY_FIELD_UPTIME;
+        sample.duty_cycle_permille = (uint16_t)(device_duty_cycle * 10u);
+        sample.uptime_centisec = now / 10u;
+        if (rssi_valid)
+        {
+            sample.present |= TELEMETRY_FIELD_RSSI;
+            sample.rssi_dbm = rssi_dbm;
+        }
+
+        cy_rtos_get_time(&write_start);
+
+        /* While a page receives the device data over the WebSocket, the event
+         * stream carries it at a lower rate so that its history ring covers
+         * EVENT_STREAM_HISTORY_SEC. Otherwise the event stream is the only
+         * source of the device data and carries it at the upload rate.
+         */
+        if ((0 == last_event_time) || !websocket_has_clients() ||
+            ((now - last_event_time) >= EVENT_STREAM_DATA_INTERVAL_MSEC))
+        {
+            last_event_time = now;
+            length = telemetry_encode_text(&sample, device_data, sizeof(device_data));
+            if (length > 0)
+            {
+                event_stream_publish(NULL, device_data, length);
+            }
+        }
+        event_stream_send_heartbeat();
+        websocket_send_telemetry(&sample);
+
+        cy_rtos_get_time(&now);
+        rate_input.write_time_msec = now - write_start;
+        rate_input.rssi_valid = rssi_valid;
+        rate_input.rssi_dbm = rssi_dbm;
+        if (!rate_control_get_tx_pool(&rate_input.tx_pool_free, &rate_input.tx_pool_total))
+        {
+            rate_input.tx_pool_free = 0;
+            rate_input.tx_pool_total = 0;
+        }
+        interval_msec = rate_control_update(&rate_input);
+
+        cy_rtos_delay_milliseconds(interval_msec);
     }
 }
 
@@ -566,13 +3261,13 @@ void server_task(cy_thread_arg_t arg)
  *  Displays details 
  *
  * Parameters:
- *  void
+ *  interface - Interface the HTTP server listens on.
  *
  * Return:
  *  void
  *
  *******************************************************************************/
-void display_configuration(void)
+void display_configuration(cy_wcm_interface_t interface)
 {
     cy_wcm_ip_address_t ip_address;
     cy_rslt_t result = CY_RSLT_SUCCESS;
@@ -581,8 +3276,8 @@ void display_configuration(void)
     char display_ip_buffer[DISPLAY_BUFFER_LENGTH];
     char http_url[URL_LENGTH] = {0};
 
-    /* IP address of SoftAp. */
-    result = cy_wcm_get_ip_addr(CY_WCM_INTERFACE_TYPE_AP, &ip_address);
+    /* IP address of SoftAp or of the STA. */
+    result = cy_wcm_get_ip_addr(interface, &ip_address);
     PRINT_AND_ASSERT(result, "Failed to retrieveSoftAP IP address\n");
 
     /*Print message to connect to that ip address*/
@@ -594,6 +3289,16 @@ void display_configuration(void)
 
     sprintf(http_url, "http://%s:%d", display_ip_buffer, HTTP_PORT);
 
+    if (CY_WCM_INTERFACE_TYPE_STA == interface)
+    {
+        APP_INFO(("****************************************************************************\r\n"));
+        APP_INFO(("Connected to the stored Wi-Fi network '%s'.\r\n", (char *)wifi_ssid));
+        APP_INFO(("From a device on the same network, open the URL %s\r\n", http_url));
+        APP_INFO(("or http://%s.%s/ from a device that supports mDNS.\r\n", MDNS_HOSTNAME, MDNS_DOMAIN));
+        APP_INFO(("****************************************************************************\r\n"));
+        return;
+    }
+
     APP_INFO(("****************************************************************************\r\n"));
     APP_INFO(("Using another device, connect to the following Wi-Fi network:\r\n"));
     APP_INFO(("SSID     : %s\r\n", SOFTAP_SSID));
@@ -55,6 +55,23 @@
 #include "cyabs_rtos.h"
 #include "cy_http_server.h"
 #include "html_web_page.h"
+#include "captive_portal.h"
+#include "channel_select.h"
+#include "cred_store.h"
+#include "event_stream.h"
+#include "ip_config.h"
+#include "mdns.h"
+#include "metrics.h"
+#include "pmk_cache.h"
+#include "profile_select.h"
+#include "profiles_api.h"
+#include "rate_control.h"
+#include "retry_policy.h"
+#include "roam.h"
+#include "scan_cache.h"
+#include "telemetry.h"
+#include "websocket.h"
+#include "wifi_state.h"
 
 
 #ifdef ENABLE_TFT
@@ -93,7 +110,37 @@
 #define BUFFER_LENGTH                                (2048)
 #define WIFI_SSID_LEN                                (32u)
 #define WIFI_PWD_LEN                                 (64u)
-#define MAX_WIFI_SCAN_HTTP_RESPONSE_LENGTH           (2048)
+#define MAX_WIFI_SCAN_HTTP_RESPONSE_LENGTH           (SCAN_CACHE_MAX_ENTRIES * SCAN_CACHE_MAX_ROW_LEN)
+
+/* URL of the page listing the APs found by the background scans. With the
+ * WIFI_SCAN_FRESH_PARAM query parameter, a new scan is run and each AP is
+ * sent to the client as soon as it is found.
+ */
+#define WIFI_SCAN_URL                                "/wifi_scan"
+#define WIFI_SCAN_FRESH_PARAM                        "fresh=1"
+
+/* URL posted by the "Display Device Data" button of the connect result page.
+ * While the STA is connected, it answers with a redirect to the device data
+ * page on the IP address of the STA, formatted once when the STA gets its
+ * address, with HTTP_DEVICE_DATA_REDIRECT_WEBPAGE as the body. Otherwise, it
+ * redirects to the home page of the SoftAP.
+ */
+#define DEVICE_DATA_REDIRECT_URL                     "/wifi_scan_form"
+#define DEVICE_DATA_REDIRECT_HEADER \
+    "HTTP/1.1 302 Found\r\n" \
+    "Location: http://%u.%u.%u.%u/\r\n" \
+    "Content-Type: text/html\r\n" \
+    "Content-Length: %u\r\n" \
+    "Connection: close\r\n" \
+    "\r\n"
+#define DEVICE_DATA_REDIRECT_LENGTH                  (sizeof(DEVICE_DATA_REDIRECT_HEADER) + \
+                                                      sizeof(HTTP_DEVICE_DATA_REDIRECT_WEBPAGE) + 16u)
+#define DEVICE_DATA_HOME_REDIRECT \
+    "HTTP/1.1 302 Found\r\n" \
+    "Location: /\r\n" \
+    "Content-Length: 0\r\n" \
+    "Connection: close\r\n" \
+    "\r\n"
 
 #define SENSOR_BUFFER_LENGTH                         (128)
 #define DISPLAY_BUFFER_LENGTH                        (64)
@@ -111,16 +158,85 @@
 #define SOFTAP_NETMASK                               MAKE_IPV4_ADDRESS(255, 255, 255, 0)
 #define SOFTAP_GATEWAY                               MAKE_IPV4_ADDRESS(192, 168, 23,  2)
 
-#define MAX_WIFI_RETRY_COUNT                         (3u)
-#define WIFI_CONN_RETRY_INTERVAL_MSEC                (100u)
+/* Retry policy of the connection to the AP entered in the SoftAP page: the
+ * delay starts at WIFI_CONN_RETRY_INTERVAL_MSEC and doubles up to
+ * WIFI_CONN_RETRY_MAX_INTERVAL_MSEC, with jitter, until MAX_WIFI_RETRY_COUNT
+ * attempts or WIFI_CONN_RETRY_DEADLINE_MSEC.
+ */
+#define MAX_WIFI_RETRY_COUNT                         (10u)
+#define WIFI_CONN_RETRY_INTERVAL_MSEC                (500u)
+#define WIFI_CONN_RETRY_MAX_INTERVAL_MSEC            (8000u)
+#define WIFI_CONN_RETRY_DEADLINE_MSEC                (30000u)
+#define WIFI_CONN_RETRY_JITTER_PERCENT               (25u)
+
+/* A join refused by an AP that the scan found, most often because of a wrong
+ * password, is retried this many times before the connection gives up.
+ */
+#define WIFI_CONN_MAX_REJECTIONS                     (1u)
+
+/* Retry policy of the reconnection after a link loss: the first attempt is
+ * made at once, then the delay doubles from WIFI_CONN_RETRY_INTERVAL_MSEC up
+ * to WIFI_RECONNECT_MAX_INTERVAL_MSEC until WIFI_RECONNECT_DEADLINE_MSEC.
+ */
+#define WIFI_RECONNECT_MAX_ATTEMPTS                  (0xFFFFFFFFu)
+#define WIFI_RECONNECT_MAX_INTERVAL_MSEC             (30000u)
+#define WIFI_RECONNECT_DEADLINE_MSEC                 (10u * 60u * 1000u)
+
+/* Once the STA is connected, the SoftAP is moved to the channel of the STA
+ * so that the radio does not time-share between two channels. The clients
+ * receive a SOFTAP_EVENT_NAME event with the new channel on the HTTP event
+ * stream SOFTAP_MOVE_NOTICE_MSEC before the SoftAP restarts. Set
+ * SOFTAP_FOLLOW_STA_CHANNEL to 0 to keep the SoftAP on its channel, for
+ * example to compare the HTTP latency on the SoftAP in both cases.
+ */
+#define SOFTAP_FOLLOW_STA_CHANNEL                    (1)
+#define SOFTAP_MOVE_NOTICE_MSEC                      (3000u)
+#define SOFTAP_EVENT_NAME                            "softap"
+
+/* Once the STA is connected and no client has been associated with the
+ * SoftAP for SOFTAP_IDLE_TEARDOWN_MSEC, the SoftAP, its HTTP server and its
+ * DNS responder are stopped to free their memory and airtime. They are
+ * started again when the STA loses its link, or when the user button is
+ * pressed. Set to 0 to keep the SoftAP up. On a device that connected with
+ * the stored credentials at boot, the SoftAP is started with the
+ * configuration page when the reconnection gives up or the user button is
+ * pressed.
+ */
+#define SOFTAP_IDLE_TEARDOWN_MSEC                    (120000u)
+#define SOFTAP_BUTTON_INTR_PRIORITY                  (7u)
+
+/* Set to 1 to shut down the HTTP server and the DNS responder of the SoftAP,
+ * to free their sockets and memory, once the HTTP server of the STA is
+ * running. The SoftAP itself stays up.
+ */
+#define HTTP_AP_SERVER_SHUTDOWN                      (0)
+
+/* The HTTP server of the SoftAP is shut down this long after the HTTP server
+ * of the STA starts, so that the SoftAP page receives the result of the
+ * connection and can follow the redirect to the STA.
+ */
+#define HTTP_AP_SERVER_SHUTDOWN_DELAY_MSEC           (5000u)
+
+/* Before an HTTP server is stopped to reconfigure its interface, it drains:
+ * new requests are refused, and the responses in flight are given up to
+ * HTTP_DRAIN_DEADLINE_MSEC to finish. The responses still in flight at the
+ * deadline are cut off and counted as aborted.
+ */
+#define HTTP_DRAIN_DEADLINE_MSEC                     (3000u)
+#define HTTP_DRAIN_POLL_INTERVAL_MSEC                (20u)
+
+/* Number of routes of the HTTP servers, in http_routes. */
+#define HTTP_ROUTE_COUNT                             (6u)
 
 /* HTTP headers used in response to client */
 #define HTTP_HEADER_204                              "HTTP/1.1 204 No Content"
 
-/* The delay in milliseconds between successive scans.*/
+/* The delay in milliseconds between successive background scans.*/
 #define SCAN_DELAY_MS                                (5000u)
 
-/* The delay in milliseconds between successive data upload.*/
+/* The shortest delay in milliseconds between successive data upload. The
+ * delay is widened by the rate controller when the link is congested.
+ */
 #define WIFI_DATA_UPLOAD_INTERVAL_MSEC               (50u)
 
 /* Initial row position on TFT display */
@@ -139,6 +255,136 @@
 #define INCREASE                                     ("Increase")
 #define DECREASE                                     ("Decrease")
 
+/* Duty cycle reported in the device data, changed with the Increase and
+ * Decrease buttons of the device data page.
+ */
+#define DUTY_CYCLE_DEFAULT_PERCENT                   (50u)
+#define DUTY_CYCLE_STEP_PERCENT                      (10u)
+#define DUTY_CYCLE_MAX_PERCENT                       (100u)
+
+/* Interval at which the RSSI reported in the device data is sampled. */
+#define TELEMETRY_RSSI_SAMPLE_INTERVAL_MSEC          (1000u)
+
+/* Task that publishes the device data to the HTTP event stream. */
+#define DEVICE_DATA_TASK_STACK_SIZE                  (2 * 1024)
+#define DEVICE_DATA_TASK_PRIORITY                    (CY_RTOS_PRIORITY_BELOWNORMAL)
+
+/* How the device got connected to an AP after boot and the duration of the
+ * association and addressing phases of the last connection, reported in the
+ * metrics. For the connections from the SoftAP page, also the total duration
+ * and whether the known BSSID was joined directly or a scan was needed. For
+ * the connections with the stored profiles, the number of profiles, the
+ * rank of the profile that connected and the number of profiles tried. The
+ * channel of the SoftAP, and how often and how long it was moved to the
+ * channel of the STA. The number of redirects to the device data page on the
+ * STA.
+ */
+typedef enum
+{
+    BOOT_PATH_NONE = 0,
+    BOOT_PATH_STORED_CREDENTIALS,
+    BOOT_PATH_SOFTAP
+} boot_path_t;
+
+typedef struct
+{
+    boot_path_t path;
+    uint32_t connected_msec;
+    uint32_t association_msec;
+    uint32_t addressing_msec;
+    uint32_t connect_msec;
+    bool connect_directed;
+    uint32_t directed_connects;
+    uint32_t directed_fallbacks;
+    uint32_t profiles;
+    uint32_t profile_rank;
+    uint32_t profile_attempts;
+    uint8_t softap_channel;
+    uint32_t softap_moves;
+    uint32_t softap_move_msec;
+    uint32_t device_data_redirects;
+} boot_stats_t;
+
+/* Idle teardowns and restarts of the SoftAP, and the bytes in use in the
+ * ThreadX byte pools and the free packets of the packet pool before and
+ * after the last teardown, reported in the metrics.
+ */
+typedef struct
+{
+    bool running;
+    uint32_t clients;
+    uint32_t teardowns;
+    uint32_t restarts;
+    uint32_t byte_pool_used_before;
+    uint32_t byte_pool_used_after;
+    uint32_t pool_free_before;
+    uint32_t pool_free_after;
+} softap_stats_t;
+
+/* Interfaces of the HTTP servers. */
+typedef enum
+{
+    HTTP_INTERFACE_AP = 0,
+    HTTP_INTERFACE_STA,
+    HTTP_INTERFACE_COUNT
+} http_interface_t;
+
+/* Route of the HTTP servers. The server of the SoftAP registers every route,
+ * and the server of the STA only the routes with on_sta set, so that the
+ * network of the STA cannot provision the device. Each server registers the
+ * routes through its own bindings so that the requests are counted per
+ * interface.
+ */
+typedef struct
+{
+    const char *url;
+    const char *mime_type;
+    cy_url_resource_type type;
+    url_processor_t handler;
+    bool on_sta;
+} http_route_t;
+
+typedef struct
+{
+    uint32_t route;
+    http_interface_t interface;
+} http_route_binding_t;
+
+/* Requests served by the HTTP server of an interface, the time spent in
+ * their handlers, and the drains before the reconfigurations of the
+ * interface with the streams they closed, reported in the metrics.
+ */
+typedef struct
+{
+    bool running;
+    bool draining;
+    uint32_t requests;
+    uint32_t errors;
+    uint32_t total_msec;
+    uint32_t max_msec;
+    uint32_t inflight;
+    uint32_t reconfigurations;
+    uint32_t drain_rejected;
+    uint32_t aborted;
+    uint32_t closed_event_streams;
+    uint32_t closed_websockets;
+    uint32_t last_drain_msec;
+    uint32_t last_reconfigure_msec;
+} http_interface_stats_t;
+
+/* Latency of the last scan page streamed from a new scan, reported in the
+ * metrics: until the first byte is sent, until the first AP is sent, and
+ * until the page is complete.
+ */
+typedef struct
+{
+    uint32_t fresh_scans;
+    uint32_t ttfb_msec;
+    uint32_t first_ap_msec;
+    uint32_t total_msec;
+    uint32_t ap_count;
+} scan_page_stats_t;
+
 #define MAKE_IP_PARAMETERS(a, b, c, d)               ((((uint32_t) d) << 24) | \
                                                      (((uint32_t) c) << 16) | \
                                                      (((uint32_t) b) << 8) | \
@@ -174,12 +420,34 @@
 
 
 void server_task(cy_thread_arg_t arg);
+int32_t softap_resource_handler(const char *url_path,
+                                const char *url_parameters,
+                                cy_http_response_stream_t *stream,
+                                void *arg,
+                                cy_http_message_body_t *http_message_body);
+int32_t wifi_scan_resource_handler(const char *url_path,
+                                   const char *url_parameters,
+                                   cy_http_response_stream_t *stream,
+                                   void *arg,
+                                   cy_http_message_body_t *http_message_body);
+int32_t device_data_redirect_handler(const char *url_path,
+                                     const char *url_parameters,
+                                     cy_http_response_stream_t *stream,
+                                     void *arg,
+                                     cy_http_message_body_t *http_message_body);
 cy_rslt_t wifi_extract_credentials(const uint8_t *data, uint32_t data_len, cy_http_response_stream_t *stream);
-cy_rslt_t start_sta_mode(void);
+cy_rslt_t start_sta_mode(const uint8_t *ssid, const uint8_t *password);
 cy_rslt_t start_ap_mode(void);
 void url_decode(char *dst, const uint8_t *src);
-void display_configuration(void);
-cy_rslt_t configure_http_server(void);
+void display_configuration(cy_wcm_interface_t interface);
+cy_rslt_t configure_http_server(cy_wcm_interface_t interface);
+cy_rslt_t connect_stored_credentials(void);
+void get_boot_stats(boot_stats_t *stats);
+void get_scan_page_stats(scan_page_stats_t *stats);
+void get_http_interface_stats(http_interface_t interface, http_interface_stats_t *stats);
+void get_softap_stats(softap_stats_t *stats);
+void device_data_task(cy_thread_arg_t arg);
+uint32_t device_duty_cycle_step(bool increase);
 
 
 #endif /* WEB_SERVER_DEMO_H_ */
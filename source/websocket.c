@@ -0,0 +1,1663 @@
+/*******************************************************************************
+ * File Name: websocket.c
+ *
+ * Description: This file contains the WebSocket (RFC 6455) endpoint that
+ *              carries the control commands from the device data page and the
+ *              device data to the page on one long-lived connection, using
+ *              small binary frames.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Secure Sockets header file */
+#include "cy_secure_sockets.h"
+
+/* HTTP server task header file. */
+#include "web_server.h"
+#include "websocket.h"
+#include "sha1.h"
+
+/* Standard C header file */
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+/*******************************************************************************
+ * Macros
+ ********************************************************************************/
+/* Length of the Sec-WebSocket-Accept value: base64 of a SHA-1 digest. */
+#define WEBSOCKET_ACCEPT_KEY_LENGTH                  (28u)
+
+/* Longest Sec-WebSocket-Key accepted; the key is base64 of 16 bytes. */
+#define WEBSOCKET_MAX_KEY_LENGTH                     (32u)
+
+#define WEBSOCKET_KEY_HEADER                         "Sec-WebSocket-Key:"
+#define WEBSOCKET_VERSION_HEADER                     "Sec-WebSocket-Version:"
+#define WEBSOCKET_UPGRADE_HEADER                     "Upgrade:"
+#define WEBSOCKET_CONNECTION_HEADER                  "Connection:"
+#define WEBSOCKET_VERSION                            "13"
+#define WEBSOCKET_HEADER_END                         "\r\n\r\n"
+
+#define WEBSOCKET_HANDSHAKE_RESPONSE \
+    "HTTP/1.1 101 Switching Protocols\r\n" \
+    "Upgrade: websocket\r\n" \
+    "Connection: Upgrade\r\n" \
+    "Sec-WebSocket-Accept: %s\r\n" \
+    "\r\n"
+
+#define WEBSOCKET_BUSY_RESPONSE \
+    "HTTP/1.1 503 Service Unavailable\r\n" \
+    "Retry-After: 5\r\n" \
+    "Content-Length: 0\r\n" \
+    "Connection: close\r\n" \
+    "\r\n"
+
+#define WEBSOCKET_BAD_REQUEST_RESPONSE \
+    "HTTP/1.1 400 Bad Request\r\n" \
+    "Content-Length: 0\r\n" \
+    "Connection: close\r\n" \
+    "\r\n"
+
+/* Sent to a client that requests a version of the protocol other than 13. */
+#define WEBSOCKET_UPGRADE_REQUIRED_RESPONSE \
+    "HTTP/1.1 426 Upgrade Required\r\n" \
+    "Sec-WebSocket-Version: " WEBSOCKET_VERSION "\r\n" \
+    "Content-Length: 0\r\n" \
+    "Connection: close\r\n" \
+    "\r\n"
+
+/* Bits of the first two bytes of a frame. */
+#define WEBSOCKET_FIN_BIT                            (0x80u)
+#define WEBSOCKET_RSV_BITS                           (0x70u)
+#define WEBSOCKET_OPCODE_MASK                        (0x0Fu)
+#define WEBSOCKET_MASK_BIT                           (0x80u)
+#define WEBSOCKET_LENGTH_MASK                        (0x7Fu)
+#define WEBSOCKET_LENGTH_16BIT                       (126u)
+#define WEBSOCKET_LENGTH_64BIT                       (127u)
+#define WEBSOCKET_MASK_KEY_LENGTH                    (4u)
+#define WEBSOCKET_CONTROL_OPCODE_BIT                 (0x8u)
+
+/* Server frames are sent unmasked with a 7-bit length. */
+#define WEBSOCKET_SERVER_HEADER_LENGTH               (2u)
+
+/*******************************************************************************
+ * Structures
+ ********************************************************************************/
+/* States of the frame parser. */
+typedef enum
+{
+    WEBSOCKET_PARSE_OPCODE,
+    WEBSOCKET_PARSE_LENGTH,
+    WEBSOCKET_PARSE_EXTENDED_LENGTH,
+    WEBSOCKET_PARSE_MASK_KEY,
+    WEBSOCKET_PARSE_PAYLOAD
+} websocket_parse_state_t;
+
+/* Result of feeding a byte to the frame parser. */
+typedef enum
+{
+    WEBSOCKET_PARSE_NEED_MORE,
+    WEBSOCKET_PARSE_FRAME_COMPLETE,
+    WEBSOCKET_PARSE_PROTOCOL_ERROR,
+    WEBSOCKET_PARSE_FRAME_TOO_BIG
+} websocket_parse_result_t;
+
+/* Fixed-size frame parser. A frame is parsed one byte at a time, so frames
+ * split across TCP segments need no reassembly buffer beyond the payload.
+ */
+typedef struct
+{
+    websocket_parse_state_t state;
+    bool fin;
+    uint8_t opcode;
+    uint8_t length_bytes_left;
+    uint8_t mask_key_index;
+    uint8_t mask_key[WEBSOCKET_MASK_KEY_LENGTH];
+    uint32_t payload_length;
+    uint32_t payload_index;
+    uint8_t payload[WEBSOCKET_MAX_PAYLOAD_LEN];
+} websocket_parser_t;
+
+/* Events queued for the WebSocket task by the socket callbacks, and the
+ * requests to open and close the listener of an interface. An event is
+ * packed in a uint32_t as <type> <generation of the client> <index>, so that
+ * an event of a closed connection is not applied to the next connection of
+ * the same client entry. The index of the connect, listen and close events
+ * is the interface.
+ */
+typedef enum
+{
+    WEBSOCKET_EVENT_CONNECT = 1,
+    WEBSOCKET_EVENT_RECEIVE,
+    WEBSOCKET_EVENT_DISCONNECT,
+    WEBSOCKET_EVENT_LISTEN,
+    WEBSOCKET_EVENT_CLOSE
+} websocket_event_type_t;
+
+#define WEBSOCKET_EVENT(type, generation, index)     (((uint32_t)(type) << 16) | ((uint32_t)(generation) << 8) | (uint32_t)(index))
+#define WEBSOCKET_EVENT_TYPE(event)                  ((event) >> 16)
+#define WEBSOCKET_EVENT_GENERATION(event)            (((event) >> 8) & 0xFFu)
+#define WEBSOCKET_EVENT_INDEX(event)                 ((event) & 0xFFu)
+
+/* A client of the WebSocket endpoint. The upgrade request is received in
+ * rx_buffer; once connected, the frames are parsed as they are received.
+ */
+typedef struct
+{
+    bool in_use;
+    bool upgraded;
+    volatile bool connected;
+    uint8_t generation;
+    cy_socket_t socket;
+    uint32_t ip_address;
+    uint32_t index;
+    uint32_t interface;
+    cy_time_t last_receive_time;
+    bool ping_sent;
+    uint32_t rx_length;
+    websocket_parser_t parser;
+    char rx_buffer[WEBSOCKET_HANDSHAKE_BUFFER_LENGTH];
+} websocket_client_t;
+
+/* Socket listening for the WebSocket connections on WEBSOCKET_PORT of an
+ * interface. The socket is valid while listening is set.
+ */
+typedef struct
+{
+    bool listening;
+    uint32_t interface;
+    cy_socket_t socket;
+    cy_socket_sockaddr_t address;
+} websocket_listener_t;
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Listener of each interface of the HTTP servers. */
+static websocket_listener_t websocket_listeners[HTTP_INTERFACE_COUNT];
+
+/* Clients of the WebSocket endpoint. The socket of a client is valid while
+ * its in_use flag is set.
+ */
+static websocket_client_t websocket_clients[WEBSOCKET_MAX_CLIENTS];
+
+/* Quota of the connections of each client, checked at accept. */
+static conn_quota_t websocket_quota;
+
+/* Serializes the frames sent by the WebSocket task and the device data task,
+ * and protects the clients and the quota.
+ */
+static cy_mutex_t websocket_mutex;
+
+/* Events of the sockets, handled by the WebSocket task. */
+static cy_queue_t websocket_event_queue;
+
+/* Buffer used to receive the frames of the connected clients. */
+static uint8_t websocket_rx_buffer[WEBSOCKET_MAX_PAYLOAD_LEN];
+
+/* Task that accepts the WebSocket connections and serves the clients. */
+static uint64_t websocket_task_stack[WEBSOCKET_TASK_STACK_SIZE / 8];
+static cy_thread_t websocket_task_handle;
+static bool websocket_started = false;
+
+/* A request to open or close a listener is handled by the WebSocket task,
+ * which owns the sockets. The caller waits for websocket_request_done, and
+ * the requests are serialized by websocket_request_mutex.
+ */
+static cy_mutex_t websocket_request_mutex;
+static cy_semaphore_t websocket_request_done;
+static cy_rslt_t websocket_request_result;
+static uint32_t websocket_request_closed;
+
+/*******************************************************************************
+ * Function Name: websocket_base64_encode
+ *******************************************************************************
+ * Summary:
+ *  Encodes data in base64.
+ *
+ * Parameters:
+ *  src - Pointer to the data.
+ *  src_len - Length of the data.
+ *  dst - Buffer of at least 4 * ((src_len + 2) / 3) + 1 bytes.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void websocket_base64_encode(const uint8_t *src, uint32_t src_len, char *dst)
+{
+    static const char base64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t value;
+
+    for (uint32_t index = 0; index < src_len; index += 3u)
+    {
+        value = (uint32_t)src[index] << 16;
+        if (index + 1u < src_len)
+        {
+            value |= (uint32_t)src[index + 1u] << 8;
+        }
+        if (index + 2u < src_len)
+        {
+            value |= (uint32_t)src[index + 2u];
+        }
+
+        *dst++ = base64_table[(value >> 18) & 0x3Fu];
+        *dst++ = base64_table[(value >> 12) & 0x3Fu];
+        *dst++ = (index + 1u < src_len) ? base64_table[(value >> 6) & 0x3Fu] : '=';
+        *dst++ = (index + 2u < src_len) ? base64_table[value & 0x3Fu] : '=';
+    }
+
+    *dst = NULL_CHARACTER_ASCII_VALUE;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_find_header
+ *******************************************************************************
+ * Summary:
+ *  Finds a header in an HTTP request and returns its value with the leading
+ *  spaces removed. Header names are matched case-insensitively.
+ *
+ * Parameters:
+ *  request - Null-terminated HTTP request.
+ *  name - Header name including the colon.
+ *  value_len - Pointer to store the length of the value.
+ *
+ * Return:
+ *  const char* - Pointer to the value, or NULL if the header is not present.
+ *
+ *******************************************************************************/
+static const char *websocket_find_header(const char *request, const char *name, uint32_t *value_len)
+{
+    const char *line = strstr(request, "\r\n");
+    const char *value;
+    const char *end;
+    size_t name_len = strlen(name);
+
+    while ((NULL != line) && (0 != strncmp(line, WEBSOCKET_HEADER_END, sizeof(WEBSOCKET_HEADER_END) - 1)))
+    {
+        line += 2;
+        if (0 == strncasecmp(line, name, name_len))
+        {
+            value = line + name_len;
+            while (SPACE_CHARACTER_ASCII_VALUE == *value)
+            {
+                value++;
+            }
+
+            end = strstr(value, "\r\n");
+            if (NULL == end)
+            {
+                return NULL;
+            }
+
+            while ((end > value) && (SPACE_CHARACTER_ASCII_VALUE == end[-1]))
+            {
+                end--;
+            }
+
+            *value_len = (uint32_t)(end - value);
+            return value;
+        }
+        line = strstr(line, "\r\n");
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_header_has_token
+ *******************************************************************************
+ * Summary:
+ *  Checks whether the comma-separated list of a header value contains a token.
+ *  Tokens are matched case-insensitively.
+ *
+ * Parameters:
+ *  value - Header value returned by websocket_find_header, or NULL.
+ *  value_len - Length of the value.
+ *  token - Null-terminated token to find.
+ *
+ * Return:
+ *  bool - true if the value contains the token, false otherwise.
+ *
+ *******************************************************************************/
+static bool websocket_header_has_token(const char *value, uint32_t value_len, const char *token)
+{
+    const char *end;
+    const char *item_end;
+    size_t token_len = strlen(token);
+
+    if (NULL == value)
+    {
+        return false;
+    }
+
+    end = value + value_len;
+    while (value < end)
+    {
+        while ((value < end) && ((SPACE_CHARACTER_ASCII_VALUE == *value) || (',' == *value)))
+        {
+            value++;
+        }
+
+        item_end = value;
+        while ((item_end < end) && (',' != *item_end))
+        {
+            item_end++;
+        }
+
+        value_len = (uint32_t)(item_end - value);
+        while ((value_len > 0) && (SPACE_CHARACTER_ASCII_VALUE == value[value_len - 1]))
+        {
+            value_len--;
+        }
+
+        if ((value_len == token_len) && (0 == strncasecmp(value, token, token_len)))
+        {
+            return true;
+        }
+        value = item_end;
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_send_raw
+ *******************************************************************************
+ * Summary:
+ *  Sends data on a socket until all of it is sent or an error occurs.
+ *
+ * Parameters:
+ *  socket - Socket to send on.
+ *  data - Pointer to the data.
+ *  length - Length of the data.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if all the data is sent, otherwise,
+ *  it returns the secure sockets error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_send_raw(cy_socket_t socket, const void *data, uint32_t length)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t bytes_sent = 0;
+    const uint8_t *ptr = (const uint8_t *)data;
+
+    while (length > 0)
+    {
+        result = cy_socket_send(socket, ptr, length, CY_SOCKET_FLAGS_NONE, &bytes_sent);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            break;
+        }
+        ptr += bytes_sent;
+        length -= bytes_sent;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_send_frame
+ *******************************************************************************
+ * Summary:
+ *  Sends an unmasked frame to a connected client. A client whose send fails
+ *  is marked as disconnected and closed by the WebSocket task.
+ *
+ * Parameters:
+ *  client - Pointer to the client.
+ *  opcode - Opcode of the frame.
+ *  payload - Pointer to the payload.
+ *  length - Length of the payload, at most WEBSOCKET_MAX_PAYLOAD_LEN.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the frame is sent, otherwise, it
+ *  returns CY_RSLT_TYPE_ERROR or the secure sockets error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_send_frame(websocket_client_t *client, uint8_t opcode, const uint8_t *payload,
+                                      uint32_t length)
+{
+    cy_rslt_t result = CY_RSLT_TYPE_ERROR;
+    uint8_t frame[WEBSOCKET_SERVER_HEADER_LENGTH + WEBSOCKET_MAX_PAYLOAD_LEN];
+
+    if (length > WEBSOCKET_MAX_PAYLOAD_LEN)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    frame[0] = WEBSOCKET_FIN_BIT | opcode;
+    frame[1] = (uint8_t)length;
+    if (length > 0)
+    {
+        memcpy(&frame[WEBSOCKET_SERVER_HEADER_LENGTH], payload, length);
+    }
+
+    cy_rtos_get_mutex(&websocket_mutex, CY_RTOS_NEVER_TIMEOUT);
+    if (client->connected)
+    {
+        result = websocket_send_raw(client->socket, frame, WEBSOCKET_SERVER_HEADER_LENGTH + length);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            client->connected = false;
+        }
+    }
+    cy_rtos_set_mutex(&websocket_mutex);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_send_close
+ *******************************************************************************
+ * Summary:
+ *  Sends a close frame with a status code to a connected client.
+ *
+ * Parameters:
+ *  client - Pointer to the client.
+ *  status_code - Close status code.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void websocket_send_close(websocket_client_t *client, uint16_t status_code)
+{
+    uint8_t payload[2];
+
+    payload[0] = (uint8_t)(status_code >> 8);
+    payload[1] = (uint8_t)(status_code & 0xFFu);
+    websocket_send_frame(client, WEBSOCKET_OPCODE_CLOSE, payload, sizeof(payload));
+}
+
+/*******************************************************************************
+ * Function Name: websocket_parse_byte
+ *******************************************************************************
+ * Summary:
+ *  Feeds one received byte to the frame parser. Client frames must be masked,
+ *  must not use extensions, and must fit in WEBSOCKET_MAX_PAYLOAD_LEN.
+ *
+ * Parameters:
+ *  parser - Pointer to the frame parser.
+ *  byte - Received byte.
+ *
+ * Return:
+ *  websocket_parse_result_t - WEBSOCKET_PARSE_FRAME_COMPLETE when a whole frame
+ *  has been parsed into parser->payload.
+ *
+ *******************************************************************************/
+static websocket_parse_result_t websocket_parse_byte(websocket_parser_t *parser, uint8_t byte)
+{
+    switch (parser->state)
+    {
+    case WEBSOCKET_PARSE_OPCODE:
+        if (0 != (byte & WEBSOCKET_RSV_BITS))
+        {
+            return WEBSOCKET_PARSE_PROTOCOL_ERROR;
+        }
+        parser->fin = (0 != (byte & WEBSOCKET_FIN_BIT));
+        parser->opcode = byte & WEBSOCKET_OPCODE_MASK;
+        parser->state = WEBSOCKET_PARSE_LENGTH;
+        break;
+
+    case WEBSOCKET_PARSE_LENGTH:
+        if (0 == (byte & WEBSOCKET_MASK_BIT))
+        {
+            return WEBSOCKET_PARSE_PROTOCOL_ERROR;
+        }
+
+        parser->payload_length = byte & WEBSOCKET_LENGTH_MASK;
+        parser->mask_key_index = 0;
+        if (WEBSOCKET_LENGTH_16BIT == parser->payload_length)
+        {
+            parser->payload_length = 0;
+            parser->length_bytes_left = 2;
+            parser->state = WEBSOCKET_PARSE_EXTENDED_LENGTH;
+        }
+        else if (WEBSOCKET_LENGTH_64BIT == parser->payload_length)
+        {
+            parser->payload_length = 0;
+            parser->length_bytes_left = 8;
+            parser->state = WEBSOCKET_PARSE_EXTENDED_LENGTH;
+        }
+        else
+        {
+            parser->state = WEBSOCKET_PARSE_MASK_KEY;
+        }
+        break;
+
+    case WEBSOCKET_PARSE_EXTENDED_LENGTH:
+        /* Anything that does not fit in 16 bits is too big for the payload buffer. */
+        if (parser->payload_length > WEBSOCKET_MAX_PAYLOAD_LEN)
+        {
+            return WEBSOCKET_PARSE_FRAME_TOO_BIG;
+        }
+        parser->payload_length = (parser->payload_length << 8) | byte;
+        if (0 == --parser->length_bytes_left)
+        {
+            parser->state = WEBSOCKET_PARSE_MASK_KEY;
+        }
+        break;
+
+    case WEBSOCKET_PARSE_MASK_KEY:
+        parser->mask_key[parser->mask_key_index++] = byte;
+        if (WEBSOCKET_MASK_KEY_LENGTH == parser->mask_key_index)
+        {
+            if (parser->payload_length > WEBSOCKET_MAX_PAYLOAD_LEN)
+            {
+                return WEBSOCKET_PARSE_FRAME_TOO_BIG;
+            }
+
+            /* Control frames must not be fragmented. */
+            if ((0 != (parser->opcode & WEBSOCKET_CONTROL_OPCODE_BIT)) && (!parser->fin))
+            {
+                return WEBSOCKET_PARSE_PROTOCOL_ERROR;
+            }
+
+            parser->payload_index = 0;
+            if (0 == parser->payload_length)
+            {
+                parser->state = WEBSOCKET_PARSE_OPCODE;
+                return WEBSOCKET_PARSE_FRAME_COMPLETE;
+            }
+            parser->state = WEBSOCKET_PARSE_PAYLOAD;
+        }
+        break;
+
+    case WEBSOCKET_PARSE_PAYLOAD:
+        parser->payload[parser->payload_index] = byte ^ parser->mask_key[parser->payload_index % WEBSOCKET_MASK_KEY_LENGTH];
+        if (++parser->payload_index == parser->payload_length)
+        {
+            parser->state = WEBSOCKET_PARSE_OPCODE;
+            return WEBSOCKET_PARSE_FRAME_COMPLETE;
+        }
+        break;
+
+    default:
+        return WEBSOCKET_PARSE_PROTOCOL_ERROR;
+    }
+
+    return WEBSOCKET_PARSE_NEED_MORE;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_handle_frame
+ *******************************************************************************
+ * Summary:
+ *  Handles a frame received from a client.
+ *
+ * Parameters:
+ *  client - Pointer to the client whose frame parser holds the frame.
+ *
+ * Return:
+ *  bool - false if the connection must be closed.
+ *
+ *******************************************************************************/
+static bool websocket_handle_frame(websocket_client_t *client)
+{
+    websocket_parser_t *parser = &client->parser;
+    uint8_t ack[4];
+    uint32_t duty_cycle;
+
+    switch (parser->opcode)
+    {
+    case WEBSOCKET_OPCODE_BINARY:
+        if ((!parser->fin) || (parser->payload_length < WEBSOCKET_CMD_LENGTH) ||
+            ((WEBSOCKET_CMD_INCREASE != parser->payload[0]) && (WEBSOCKET_CMD_DECREASE != parser->payload[0])))
+        {
+            websocket_send_close(client, WEBSOCKET_CLOSE_UNSUPPORTED_DATA);
+            return false;
+        }
+
+        duty_cycle = device_duty_cycle_step(WEBSOCKET_CMD_INCREASE == parser->payload[0]);
+
+        /* Acknowledge with the sequence number so that the page can measure the
+         * round trip of the command.
+         */
+        ack[0] = WEBSOCKET_MSG_ACK;
+        ack[1] = parser->payload[1];
+        ack[2] = parser->payload[2];
+        ack[3] = (uint8_t)duty_cycle;
+        websocket_send_frame(client, WEBSOCKET_OPCODE_BINARY, ack, sizeof(ack));
+        return true;
+
+    case WEBSOCKET_OPCODE_PING:
+        websocket_send_frame(client, WEBSOCKET_OPCODE_PONG, parser->payload, parser->payload_length);
+        return true;
+
+    case WEBSOCKET_OPCODE_PONG:
+        return true;
+
+    case WEBSOCKET_OPCODE_CLOSE:
+        websocket_send_close(client, WEBSOCKET_CLOSE_NORMAL);
+        return false;
+
+    default:
+        websocket_send_close(client, WEBSOCKET_CLOSE_UNSUPPORTED_DATA);
+        return false;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: websocket_handshake
+ *******************************************************************************
+ * Summary:
+ *  Validates the HTTP upgrade request received in the buffer of a new
+ *  connection and sends the 101 Switching Protocols response. The request must
+ *  carry "Upgrade: websocket", a Connection header that lists "Upgrade" and a
+ *  key; otherwise it is answered with 400 Bad Request. A request for a version
+ *  of the protocol other than 13 is answered with 426 Upgrade Required, which
+ *  lists the supported version.
+ *
+ * Parameters:
+ *  client - Pointer to the client of the new connection.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the handshake is completed, otherwise,
+ *  it returns CY_RSLT_TYPE_ERROR or the secure sockets error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_handshake(websocket_client_t *client)
+{
+    uint32_t key_len = 0;
+    uint32_t upgrade_len = 0;
+    uint32_t connection_len = 0;
+    uint32_t version_len = 0;
+    const char *key;
+    const char *upgrade;
+    const char *connection;
+    const char *version;
+    char accept_key[WEBSOCKET_ACCEPT_KEY_LENGTH + 1];
+    char response[sizeof(WEBSOCKET_HANDSHAKE_RESPONSE) + WEBSOCKET_ACCEPT_KEY_LENGTH];
+    uint8_t digest[SHA1_DIGEST_LENGTH];
+    sha1_context_t sha1_ctx;
+    int response_len;
+
+    key = websocket_find_header(client->rx_buffer, WEBSOCKET_KEY_HEADER, &key_len);
+    upgrade = websocket_find_header(client->rx_buffer, WEBSOCKET_UPGRADE_HEADER, &upgrade_len);
+    connection = websocket_find_header(client->rx_buffer, WEBSOCKET_CONNECTION_HEADER, &connection_len);
+    version = websocket_find_header(client->rx_buffer, WEBSOCKET_VERSION_HEADER, &version_len);
+
+    if ((0 != strncmp(client->rx_buffer, "GET " WEBSOCKET_URL, sizeof("GET " WEBSOCKET_URL) - 1)) ||
+        !websocket_header_has_token(upgrade, upgrade_len, "websocket") ||
+        !websocket_header_has_token(connection, connection_len, "Upgrade") ||
+        (NULL == key) || (0 == key_len) || (key_len > WEBSOCKET_MAX_KEY_LENGTH))
+    {
+        ERR_INFO(("Received an invalid WebSocket upgrade request.\n"));
+        websocket_send_raw(client->socket, WEBSOCKET_BAD_REQUEST_RESPONSE, sizeof(WEBSOCKET_BAD_REQUEST_RESPONSE) - 1);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if ((NULL == version) || (version_len != sizeof(WEBSOCKET_VERSION) - 1) ||
+        (0 != strncmp(version, WEBSOCKET_VERSION, version_len)))
+    {
+        ERR_INFO(("Received a WebSocket upgrade request for an unsupported version.\n"));
+        websocket_send_raw(client->socket, WEBSOCKET_UPGRADE_REQUIRED_RESPONSE,
+                           sizeof(WEBSOCKET_UPGRADE_REQUIRED_RESPONSE) - 1);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    sha1_init(&sha1_ctx);
+    sha1_update(&sha1_ctx, (const uint8_t *)key, key_len);
+    sha1_update(&sha1_ctx, (const uint8_t *)WEBSOCKET_GUID, sizeof(WEBSOCKET_GUID) - 1);
+    sha1_final(&sha1_ctx, digest);
+    websocket_base64_encode(digest, sizeof(digest), accept_key);
+
+    response_len = snprintf(response, sizeof(response), WEBSOCKET_HANDSHAKE_RESPONSE, accept_key);
+
+    return websocket_send_raw(client->socket, response, (uint32_t)response_len);
+}
+
+/*******************************************************************************
+ * Function Name: websocket_socket_callback
+ *******************************************************************************
+ * Summary:
+ *  Callback of the sockets of the clients and of the listening sockets, called
+ *  by the secure sockets library. Queues the event for the WebSocket task
+ *  without blocking; an event lost because the queue is full is made up for
+ *  by the periodic check of the clients.
+ *
+ * Parameters:
+ *  socket_handle - Socket that has the event.
+ *  arg - Pointer to the client, or to the listener for a connect event.
+ *  type - Type of the event.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_socket_callback(cy_socket_t socket_handle, void *arg, websocket_event_type_t type)
+{
+    websocket_client_t *client = (websocket_client_t *)arg;
+    websocket_listener_t *listener = (websocket_listener_t *)arg;
+    uint32_t event;
+    (void)socket_handle;
+
+    if (WEBSOCKET_EVENT_CONNECT == type)
+    {
+        event = WEBSOCKET_EVENT(type, 0, listener->interface);
+    }
+    else
+    {
+        event = WEBSOCKET_EVENT(type, client->generation, client->index);
+    }
+
+    (void)cy_rtos_put_queue(&websocket_event_queue, &event, 0, false);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_connect_callback
+ *******************************************************************************
+ * Summary:
+ *  Queues a new connection on a listening socket.
+ *
+ * Parameters:
+ *  socket_handle - Socket that has the event.
+ *  arg - Pointer to the listener.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_connect_callback(cy_socket_t socket_handle, void *arg)
+{
+    return websocket_socket_callback(socket_handle, arg, WEBSOCKET_EVENT_CONNECT);
+}
+
+/*******************************************************************************
+ * Function Name: websocket_receive_callback
+ *******************************************************************************
+ * Summary:
+ *  Queues the data received on the socket of a client.
+ *
+ * Parameters:
+ *  socket_handle - Socket that has the event.
+ *  arg - Pointer to the client.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_receive_callback(cy_socket_t socket_handle, void *arg)
+{
+    return websocket_socket_callback(socket_handle, arg, WEBSOCKET_EVENT_RECEIVE);
+}
+
+/*******************************************************************************
+ * Function Name: websocket_disconnect_callback
+ *******************************************************************************
+ * Summary:
+ *  Queues the disconnection of the peer of a client.
+ *
+ * Parameters:
+ *  socket_handle - Socket that has the event.
+ *  arg - Pointer to the client.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_disconnect_callback(cy_socket_t socket_handle, void *arg)
+{
+    return websocket_socket_callback(socket_handle, arg, WEBSOCKET_EVENT_DISCONNECT);
+}
+
+/*******************************************************************************
+ * Function Name: websocket_close_client
+ *******************************************************************************
+ * Summary:
+ *  Closes the connection of a client and releases its quota and its entry.
+ *
+ * Parameters:
+ *  client - Pointer to the client.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void websocket_close_client(websocket_client_t *client)
+{
+    /* No frame is sent on the socket once connected is cleared. */
+    cy_rtos_get_mutex(&websocket_mutex, CY_RTOS_NEVER_TIMEOUT);
+    client->connected = false;
+    cy_rtos_set_mutex(&websocket_mutex);
+
+    if (client->upgraded)
+    {
+        APP_INFO(("WebSocket client disconnected.\n"));
+    }
+
+    cy_socket_disconnect(client->socket, 0);
+    cy_socket_delete(client->socket);
+
+    cy_rtos_get_mutex(&websocket_mutex, CY_RTOS_NEVER_TIMEOUT);
+    conn_quota_release(&websocket_quota, client->ip_address);
+    client->upgraded = false;
+    client->generation++;
+    client->in_use = false;
+    cy_rtos_set_mutex(&websocket_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: websocket_receive
+ *******************************************************************************
+ * Summary:
+ *  Reads the data received from a client until none is left. Before the
+ *  handshake, the data is added to the upgrade request; after it, the frames
+ *  are parsed and handled as they are received.
+ *
+ * Parameters:
+ *  client - Pointer to the client.
+ *
+ * Return:
+ *  bool - false if the connection must be closed.
+ *
+ *******************************************************************************/
+static bool websocket_receive(websocket_client_t *client)
+{
+    cy_rslt_t result;
+    uint32_t bytes_received = 0;
+    websocket_parse_result_t parse_result;
+
+    while (true)
+    {
+        if (!client->upgraded)
+        {
+            result = cy_socket_recv(client->socket, &client->rx_buffer[client->rx_length],
+                                    WEBSOCKET_HANDSHAKE_BUFFER_LENGTH - 1 - client->rx_length,
+                                    CY_SOCKET_FLAGS_NONE, &bytes_received);
+        }
+        else
+        {
+            result = cy_socket_recv(client->socket, websocket_rx_buffer, sizeof(websocket_rx_buffer),
+                                    CY_SOCKET_FLAGS_NONE, &bytes_received);
+        }
+
+        if (CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT == result)
+        {
+            return true;
+        }
+
+        if ((CY_RSLT_SUCCESS != result) || (0 == bytes_received))
+        {
+            return false;
+        }
+
+        cy_rtos_get_time(&client->last_receive_time);
+        client->ping_sent = false;
+
+        if (!client->upgraded)
+        {
+            client->rx_length += bytes_received;
+            client->rx_buffer[client->rx_length] = NULL_CHARACTER_ASCII_VALUE;
+
+            if (NULL != strstr(client->rx_buffer, WEBSOCKET_HEADER_END))
+            {
+                if (CY_RSLT_SUCCESS != websocket_handshake(client))
+                {
+                    return false;
+                }
+
+                memset(&client->parser, 0, sizeof(client->parser));
+                cy_rtos_get_mutex(&websocket_mutex, CY_RTOS_NEVER_TIMEOUT);
+                client->upgraded = true;
+                client->connected = true;
+                cy_rtos_set_mutex(&websocket_mutex);
+                APP_INFO(("WebSocket client connected.\n"));
+            }
+            else if (client->rx_length >= WEBSOCKET_HANDSHAKE_BUFFER_LENGTH - 1)
+            {
+                ERR_INFO(("WebSocket upgrade request is too long.\n"));
+                websocket_send_raw(client->socket, WEBSOCKET_BAD_REQUEST_RESPONSE,
+                                   sizeof(WEBSOCKET_BAD_REQUEST_RESPONSE) - 1);
+                return false;
+            }
+            continue;
+        }
+
+        for (uint32_t index = 0; index < bytes_received; index++)
+        {
+            parse_result = websocket_parse_byte(&client->parser, websocket_rx_buffer[index]);
+
+            if (WEBSOCKET_PARSE_FRAME_COMPLETE == parse_result)
+            {
+                if (!websocket_handle_frame(client))
+                {
+                    return false;
+                }
+            }
+            else if (WEBSOCKET_PARSE_FRAME_TOO_BIG == parse_result)
+            {
+                websocket_send_close(client, WEBSOCKET_CLOSE_MESSAGE_TOO_BIG);
+                return false;
+            }
+            else if (WEBSOCKET_PARSE_PROTOCOL_ERROR == parse_result)
+            {
+                websocket_send_close(client, WEBSOCKET_CLOSE_PROTOCOL_ERROR);
+                return false;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: websocket_accept
+ *******************************************************************************
+ * Summary:
+ *  Accepts a pending connection of a listener. A connection within the quota
+ *  of its client is given a free client entry; any other connection gets a
+ *  503 response and is closed at once.
+ *
+ * Parameters:
+ *  listener - Pointer to the listener.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+static void websocket_accept(websocket_listener_t *listener)
+{
+    cy_rslt_t result;
+    cy_socket_t client_socket;
+    cy_socket_sockaddr_t peer_address;
+    uint32_t peer_address_length = sizeof(peer_address);
+    uint32_t poll_timeout = WEBSOCKET_POLL_TIMEOUT_MSEC;
+    uint32_t send_timeout = WEBSOCKET_SEND_TIMEOUT_MSEC;
+    cy_socket_opt_callback_t callback;
+    websocket_client_t *client = NULL;
+    bool accepted;
+
+    /* The event may be left from a listener that is closed since. */
+    if (!listener->listening)
+    {
+        return;
+    }
+
+    result = cy_socket_accept(listener->socket, &peer_address, &peer_address_length, &client_socket);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return;
+    }
+
+    /* A connection is only counted as accepted once it has a client entry. */
+    cy_rtos_get_mutex(&websocket_mutex, CY_RTOS_NEVER_TIMEOUT);
+    for (uint32_t index = 0; index < WEBSOCKET_MAX_CLIENTS; index++)
+    {
+        if (!websocket_clients[index].in_use)
+        {
+            client = &websocket_clients[index];
+            break;
+        }
+    }
+
+    if (NULL == client)
+    {
+        conn_quota_reject(&websocket_quota, peer_address.ip_address.ip.v4);
+        accepted = false;
+    }
+    else
+    {
+        accepted = conn_quota_acquire(&websocket_quota, peer_address.ip_address.ip.v4);
+    }
+
+    if (accepted)
+    {
+        client->in_use = true;
+        client->upgraded = false;
+        client->connected = false;
+        client->socket = client_socket;
+        client->ip_address = peer_address.ip_address.ip.v4;
+        client->interface = listener->interface;
+        client->rx_length = 0;
+        client->ping_sent = false;
+        cy_rtos_get_time(&client->last_receive_time);
+    }
+    cy_rtos_set_mutex(&websocket_mutex);
+
+    cy_socket_setsockopt(client_socket, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_SNDTIMEO,
+                         &send_timeout, sizeof(send_timeout));
+
+    if (!accepted)
+    {
+        ERR_INFO(("WebSocket connection from %u.%u.%u.%u rejected by the connection quota.\n",
+                  (unsigned int)(peer_address.ip_address.ip.v4 & 0xFFu),
+                  (unsigned int)((peer_address.ip_address.ip.v4 >> 8) & 0xFFu),
+                  (unsigned int)((peer_address.ip_address.ip.v4 >> 16) & 0xFFu),
+                  (unsigned int)(peer_address.ip_address.ip.v4 >> 24)));
+        websocket_send_raw(client_socket, WEBSOCKET_BUSY_RESPONSE, sizeof(WEBSOCKET_BUSY_RESPONSE) - 1);
+        cy_socket_disconnect(client_socket, 0);
+        cy_socket_delete(client_socket);
+        return;
+    }
+
+    cy_socket_setsockopt(client_socket, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                         &poll_timeout, sizeof(poll_timeout));
+
+    callback.arg = client;
+    callback.callback = websocket_receive_callback;
+    cy_socket_setsockopt(client_socket, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RECEIVE_CALLBACK,
+                         &callback, sizeof(callback));
+    callback.callback = websocket_disconnect_callback;
+    cy_socket_setsockopt(client_socket, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_DISCONNECT_CALLBACK,
+                         &callback, sizeof(callback));
+
+    /* The upgrade request may have arrived before the callback was set. */
+    if (!websocket_receive(client))
+    {
+        websocket_close_client(client);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: websocket_listen
+ *******************************************************************************
+ * Summary:
+ *  Opens the listening socket of a listener on WEBSOCKET_PORT of its address.
+ *  A socket already open is closed first. Called by the WebSocket task.
+ *
+ * Parameters:
+ *  listener - Pointer to the listener.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the socket listens, otherwise, it
+ *  returns the secure sockets error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_listen(websocket_listener_t *listener)
+{
+    cy_rslt_t result;
+    cy_socket_opt_callback_t callback;
+    uint32_t poll_timeout = WEBSOCKET_POLL_TIMEOUT_MSEC;
+
+    if (listener->listening)
+    {
+        listener->listening = false;
+        cy_socket_delete(listener->socket);
+    }
+
+    result = cy_socket_create(CY_SOCKET_DOMAIN_AF_INET, CY_SOCKET_TYPE_STREAM, CY_SOCKET_IPPROTO_TCP,
+                              &listener->socket);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    /* The task accepts a connection when the listening socket reports it, so
+     * the accept only waits for WEBSOCKET_POLL_TIMEOUT_MSEC if it is gone.
+     */
+    cy_socket_setsockopt(listener->socket, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_RCVTIMEO,
+                         &poll_timeout, sizeof(poll_timeout));
+    callback.callback = websocket_connect_callback;
+    callback.arg = listener;
+    result = cy_socket_setsockopt(listener->socket, CY_SOCKET_SOL_SOCKET, CY_SOCKET_SO_CONNECT_REQUEST_CALLBACK,
+                                  &callback, sizeof(callback));
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_socket_bind(listener->socket, &listener->address, sizeof(listener->address));
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_socket_listen(listener->socket, WEBSOCKET_MAX_CLIENTS);
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        cy_socket_delete(listener->socket);
+        return result;
+    }
+
+    listener->listening = true;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_close_interface
+ *******************************************************************************
+ * Summary:
+ *  Closes the listening socket of an interface and the connections of its
+ *  clients, sending a close frame to the clients that are connected so that
+ *  the page reconnects. Called by the WebSocket task.
+ *
+ * Parameters:
+ *  interface - Interface of the listener.
+ *
+ * Return:
+ *  uint32_t - Number of the connections closed.
+ *
+ *******************************************************************************/
+static uint32_t websocket_close_interface(uint32_t interface)
+{
+    websocket_listener_t *listener = &websocket_listeners[interface];
+    websocket_client_t *client;
+    uint32_t closed = 0;
+
+    if (listener->listening)
+    {
+        listener->listening = false;
+        cy_socket_delete(listener->socket);
+    }
+
+    for (uint32_t index = 0; index < WEBSOCKET_MAX_CLIENTS; index++)
+    {
+        client = &websocket_clients[index];
+        if (!client->in_use || (interface != client->interface))
+        {
+            continue;
+        }
+
+        if (client->connected)
+        {
+            websocket_send_close(client, WEBSOCKET_CLOSE_GOING_AWAY);
+        }
+        websocket_close_client(client);
+        closed++;
+    }
+
+    return closed;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_check_clients
+ *******************************************************************************
+ * Summary:
+ *  Reads the clients whose receive event was lost, pings the clients that
+ *  have been silent for WEBSOCKET_PING_INTERVAL_MSEC, and closes the clients
+ *  that stayed silent for WEBSOCKET_IDLE_TIMEOUT_MSEC or whose send failed.
+ *
+ * Parameters:
+ *  now - Current time in milliseconds.
+ *
+ * Return:
+ *  bool - true if any client is in use.
+ *
+ *******************************************************************************/
+static bool websocket_check_clients(cy_time_t now)
+{
+    websocket_client_t *client;
+    bool in_use = false;
+
+    for (uint32_t index = 0; index < WEBSOCKET_MAX_CLIENTS; index++)
+    {
+        client = &websocket_clients[index];
+        if (!client->in_use)
+        {
+            continue;
+        }
+
+        if ((client->upgraded && !client->connected) || !websocket_receive(client))
+        {
+            websocket_close_client(client);
+            continue;
+        }
+
+        if ((now - client->last_receive_time) >= WEBSOCKET_IDLE_TIMEOUT_MSEC)
+        {
+            APP_INFO(("WebSocket client is not responding, closing the connection.\n"));
+            websocket_close_client(client);
+            continue;
+        }
+
+        if (client->upgraded && !client->ping_sent && ((now - client->last_receive_time) >= WEBSOCKET_PING_INTERVAL_MSEC))
+        {
+            websocket_send_frame(client, WEBSOCKET_OPCODE_PING, NULL, 0);
+            client->ping_sent = true;
+        }
+        in_use = true;
+    }
+
+    return in_use;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_task
+ *******************************************************************************
+ * Summary:
+ *  Task that handles the events of the sockets: it accepts the new
+ *  connections, and reads and closes the connections of the clients. It also
+ *  opens and closes the listeners on request. While a client is in use, it
+ *  checks the clients every WEBSOCKET_CHECK_INTERVAL_MSEC; otherwise it
+ *  sleeps until the next event.
+ *
+ * Parameters:
+ *  arg - Unused.
+ *
+ * Return:
+ *  None.
+ *
+ *******************************************************************************/
+static void websocket_task(cy_thread_arg_t arg)
+{
+    uint32_t event;
+    uint32_t interface;
+    websocket_client_t *client;
+    cy_time_t now;
+    cy_time_t last_check_time;
+    cy_time_t timeout;
+    bool in_use = false;
+    (void)arg;
+
+    cy_rtos_get_time(&last_check_time);
+
+    while (true)
+    {
+        timeout = CY_RTOS_NEVER_TIMEOUT;
+        if (in_use)
+        {
+            cy_rtos_get_time(&now);
+            timeout = ((now - last_check_time) < WEBSOCKET_CHECK_INTERVAL_MSEC) ?
+                      (WEBSOCKET_CHECK_INTERVAL_MSEC - (now - last_check_time)) : 0;
+        }
+
+        if (CY_RSLT_SUCCESS == cy_rtos_get_queue(&websocket_event_queue, &event, timeout, false))
+        {
+            client = &websocket_clients[WEBSOCKET_EVENT_INDEX(event) % WEBSOCKET_MAX_CLIENTS];
+            interface = WEBSOCKET_EVENT_INDEX(event) % HTTP_INTERFACE_COUNT;
+
+            if (WEBSOCKET_EVENT_CONNECT == WEBSOCKET_EVENT_TYPE(event))
+            {
+                websocket_accept(&websocket_listeners[interface]);
+            }
+            else if (WEBSOCKET_EVENT_LISTEN == WEBSOCKET_EVENT_TYPE(event))
+            {
+                websocket_request_result = websocket_listen(&websocket_listeners[interface]);
+                cy_rtos_set_semaphore(&websocket_request_done, false);
+            }
+            else if (WEBSOCKET_EVENT_CLOSE == WEBSOCKET_EVENT_TYPE(event))
+            {
+                websocket_request_closed = websocket_close_interface(interface);
+                cy_rtos_set_semaphore(&websocket_request_done, false);
+            }
+            else if (client->in_use && (client->generation == WEBSOCKET_EVENT_GENERATION(event)))
+            {
+                if ((WEBSOCKET_EVENT_DISCONNECT == WEBSOCKET_EVENT_TYPE(event)) || !websocket_receive(client))
+                {
+                    websocket_close_client(client);
+                }
+            }
+        }
+
+        cy_rtos_get_time(&now);
+        if (!in_use || ((now - last_check_time) >= WEBSOCKET_CHECK_INTERVAL_MSEC))
+        {
+            last_check_time = now;
+            in_use = websocket_check_clients(now);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: websocket_request
+ *******************************************************************************
+ * Summary:
+ *  Queues a request to open or close the listener of an interface for the
+ *  WebSocket task, and waits until the task has handled it.
+ *
+ * Parameters:
+ *  type - WEBSOCKET_EVENT_LISTEN or WEBSOCKET_EVENT_CLOSE.
+ *  interface - Interface of the listener.
+ *  closed - Pointer to store the number of the connections closed, or NULL.
+ *
+ * Return:
+ *  cy_rslt_t: Returns the result of the request, or the RTOS error code.
+ *
+ *******************************************************************************/
+static cy_rslt_t websocket_request(websocket_event_type_t type, uint32_t interface, uint32_t *closed)
+{
+    cy_rslt_t result;
+    uint32_t event = WEBSOCKET_EVENT(type, 0, interface);
+
+    cy_rtos_get_mutex(&websocket_request_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    websocket_request_result = CY_RSLT_SUCCESS;
+    websocket_request_closed = 0;
+
+    /* Unlike the socket events, a request must not be lost. */
+    result = cy_rtos_put_queue(&websocket_event_queue, &event, CY_RTOS_NEVER_TIMEOUT, false);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = cy_rtos_get_semaphore(&websocket_request_done, CY_RTOS_NEVER_TIMEOUT, false);
+    }
+
+    if (CY_RSLT_SUCCESS == result)
+    {
+        result = websocket_request_result;
+    }
+
+    if (NULL != closed)
+    {
+        *closed = websocket_request_closed;
+    }
+
+    cy_rtos_set_mutex(&websocket_request_mutex);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_server_start
+ *******************************************************************************
+ * Summary:
+ *  Starts the task that serves up to WEBSOCKET_MAX_CLIENTS WebSocket clients.
+ *  The task accepts connections once websocket_server_listen() opens the
+ *  listener of an interface.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the WebSocket server is started
+ *  successfully, otherwise, it returns the RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t websocket_server_start(void)
+{
+    cy_rslt_t result;
+
+    result = cy_rtos_init_mutex(&websocket_mutex);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    result = cy_rtos_init_mutex(&websocket_request_mutex);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    result = cy_rtos_init_semaphore(&websocket_request_done, 1, 0);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    result = cy_rtos_init_queue(&websocket_event_queue, WEBSOCKET_EVENT_QUEUE_LENGTH, sizeof(uint32_t));
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    conn_quota_init(&websocket_quota, WEBSOCKET_MAX_CLIENTS, WEBSOCKET_MAX_CONNECTIONS_PER_CLIENT,
+                    WEBSOCKET_RESERVED_CONNECTIONS);
+
+    for (uint32_t index = 0; index < WEBSOCKET_MAX_CLIENTS; index++)
+    {
+        websocket_clients[index].index = index;
+    }
+
+    for (uint32_t interface = 0; interface < HTTP_INTERFACE_COUNT; interface++)
+    {
+        websocket_listeners[interface].interface = interface;
+    }
+
+    result = cy_rtos_thread_create(&websocket_task_handle,
+                                   &websocket_task,
+                                   "WebSocket task",
+                                   &websocket_task_stack,
+                                   WEBSOCKET_TASK_STACK_SIZE,
+                                   WEBSOCKET_TASK_PRIORITY,
+                                   0);
+
+    websocket_started = (CY_RSLT_SUCCESS == result);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_server_listen
+ *******************************************************************************
+ * Summary:
+ *  Listens for WebSocket connections on WEBSOCKET_PORT of the IP address of
+ *  an interface, alongside the HTTP server of the interface. The listener is
+ *  opened again if it already listens, so that it follows a new address.
+ *
+ * Parameters:
+ *  interface - Interface of the HTTP server.
+ *  address - IP address of the interface.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the listener is open, otherwise, it
+ *  returns CY_RSLT_TYPE_ERROR or the secure sockets or RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t websocket_server_listen(uint32_t interface, const cy_socket_sockaddr_t *address)
+{
+    if (!websocket_started || (interface >= HTTP_INTERFACE_COUNT))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    /* The address is only read by the task while the request is handled. */
+    websocket_listeners[interface].address = *address;
+    websocket_listeners[interface].address.port = WEBSOCKET_PORT;
+
+    return websocket_request(WEBSOCKET_EVENT_LISTEN, interface, NULL);
+}
+
+/*******************************************************************************
+ * Function Name: websocket_server_close
+ *******************************************************************************
+ * Summary:
+ *  Closes the listener of an interface and the connections of its clients,
+ *  before the interface is reconfigured or stopped.
+ *
+ * Parameters:
+ *  interface - Interface of the HTTP server.
+ *
+ * Return:
+ *  uint32_t - Number of the connections closed.
+ *
+ *******************************************************************************/
+uint32_t websocket_server_close(uint32_t interface)
+{
+    uint32_t closed = 0;
+
+    if (websocket_started && (interface < HTTP_INTERFACE_COUNT))
+    {
+        (void)websocket_request(WEBSOCKET_EVENT_CLOSE, interface, &closed);
+    }
+
+    return closed;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_send_telemetry
+ *******************************************************************************
+ * Summary:
+ *  Sends the device data to the connected WebSocket clients, if any, as
+ *  binary telemetry or as text depending on WEBSOCKET_BINARY_TELEMETRY.
+ *
+ * Parameters:
+ *  sample - Pointer to the device data sample.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the device data is sent to at least
+ *  one client, otherwise, it returns CY_RSLT_TYPE_ERROR or the secure sockets
+ *  error code.
+ *
+ *******************************************************************************/
+cy_rslt_t websocket_send_telemetry(const telemetry_sample_t *sample)
+{
+#if (WEBSOCKET_BINARY_TELEMETRY)
+    uint8_t telemetry[1 + TELEMETRY_MAX_BINARY_LEN];
+    uint8_t opcode = WEBSOCKET_OPCODE_BINARY;
+#else
+    char telemetry[TELEMETRY_MAX_TEXT_LEN + 1];
+    uint8_t opcode = WEBSOCKET_OPCODE_TEXT;
+#endif
+    cy_rslt_t result = CY_RSLT_TYPE_ERROR;
+    bool sent = false;
+    uint32_t length;
+
+#if (WEBSOCKET_BINARY_TELEMETRY)
+    telemetry[0] = WEBSOCKET_MSG_TELEMETRY;
+    length = telemetry_encode_binary(sample, &telemetry[1], sizeof(telemetry) - 1);
+    if (0 == length)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    length++;
+#else
+    length = telemetry_encode_text(sample, telemetry, sizeof(telemetry));
+    if (0 == length)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
+
+    for (uint32_t index = 0; index < WEBSOCKET_MAX_CLIENTS; index++)
+    {
+        if (websocket_clients[index].connected)
+        {
+            result = websocket_send_frame(&websocket_clients[index], opcode, (const uint8_t *)telemetry, length);
+            sent = sent || (CY_RSLT_SUCCESS == result);
+        }
+    }
+
+    return sent ? CY_RSLT_SUCCESS : result;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_send_event
+ *******************************************************************************
+ * Summary:
+ *  Sends a named event of the HTTP event stream to the connected WebSocket
+ *  clients, if any, so that a page connected by WebSocket does not need to
+ *  keep an event stream open as well.
+ *
+ * Parameters:
+ *  event_name - Name of the event.
+ *  data - Pointer to the data of the event.
+ *  data_len - Length of the data.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the event is sent to at least one
+ *  client, otherwise, it returns CY_RSLT_TYPE_ERROR or the secure sockets
+ *  error code.
+ *
+ *******************************************************************************/
+cy_rslt_t websocket_send_event(const char *event_name, const char *data, uint32_t data_len)
+{
+    uint8_t message[WEBSOCKET_MAX_PAYLOAD_LEN];
+    uint32_t name_len = (uint32_t)strlen(event_name);
+    uint32_t length = 2u + name_len + data_len;
+    cy_rslt_t result = CY_RSLT_TYPE_ERROR;
+    bool sent = false;
+
+    if (length > sizeof(message))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    message[0] = WEBSOCKET_MSG_EVENT;
+    message[1] = (uint8_t)name_len;
+    memcpy(&message[2], event_name, name_len);
+    memcpy(&message[2u + name_len], data, data_len);
+
+    for (uint32_t index = 0; index < WEBSOCKET_MAX_CLIENTS; index++)
+    {
+        if (websocket_clients[index].connected)
+        {
+            result = websocket_send_frame(&websocket_clients[index], WEBSOCKET_OPCODE_BINARY, message, length);
+            sent = sent || (CY_RSLT_SUCCESS == result);
+        }
+    }
+
+    return sent ? CY_RSLT_SUCCESS : result;
+}
+
+/*******************************************************************************
+ * Function Name: websocket_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the connected clients and the connections accepted and rejected
+ *  by the quota, in total and for each recent client.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void websocket_get_stats(websocket_stats_t *stats)
+{
+    stats->connected_clients = 0;
+    for (uint32_t index = 0; index < WEBSOCKET_MAX_CLIENTS; index++)
+    {
+        if (websocket_clients[index].connected)
+        {
+            stats->connected_clients++;
+        }
+    }
+
+    cy_rtos_get_mutex(&websocket_mutex, CY_RTOS_NEVER_TIMEOUT);
+    stats->accepted = websocket_quota.accepted;
+    stats->rejected = websocket_quota.rejected;
+    memcpy(stats->clients, websocket_quota.clients, sizeof(stats->clients));
+    cy_rtos_set_mutex(&websocket_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: websocket_has_clients
+ *******************************************************************************
+ * Summary:
+ *  Checks whether a client is connected to the WebSocket endpoint.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  bool - true if a client is connected, false otherwise.
+ *
+ *******************************************************************************/
+bool websocket_has_clients(void)
+{
+    for (uint32_t index = 0; index < WEBSOCKET_MAX_CLIENTS; index++)
+    {
+        if (websocket_clients[index].connected)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,156 @@
+/******************************************************************************
+* File Name: websocket.h
+*
+* Description: This file contains the configuration parameters and function
+*              prototypes of the WebSocket (RFC 6455) endpoint that carries
+*              the control commands and the device data on one connection.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WEBSOCKET_H_
+#define WEBSOCKET_H_
+
+#include "cy_secure_sockets.h"
+#include "telemetry.h"
+#include "conn_quota.h"
+
+/* The HTTP server library does not hand the request headers or the socket to
+ * the resource handlers, so the WebSocket endpoint is served by its own
+ * listener on WEBSOCKET_PORT of each interface that runs an HTTP server. The
+ * port is also hard-coded in SOFTAP_DEVICE_DATA.
+ */
+#define WEBSOCKET_PORT                               (81u)
+#define WEBSOCKET_URL                                "/ws"
+
+/* Clients served at the same time. A client may hold
+ * WEBSOCKET_MAX_CONNECTIONS_PER_CLIENT of them, and the last
+ * WEBSOCKET_RESERVED_CONNECTIONS are kept for clients that hold none, so that
+ * a station with several open pages cannot lock out the next one.
+ */
+#define WEBSOCKET_MAX_CLIENTS                        (3u)
+#define WEBSOCKET_MAX_CONNECTIONS_PER_CLIENT         (2u)
+#define WEBSOCKET_RESERVED_CONNECTIONS               (1u)
+
+/* Task that accepts the WebSocket connections and serves all the clients.
+ * The sockets report new connections, received data and disconnections
+ * through callbacks that queue an event for the task, so the task only wakes
+ * up when a socket needs it, or every WEBSOCKET_CHECK_INTERVAL_MSEC.
+ */
+#define WEBSOCKET_TASK_STACK_SIZE                    (3 * 1024)
+#define WEBSOCKET_TASK_PRIORITY                      (CY_RTOS_PRIORITY_NORMAL)
+#define WEBSOCKET_EVENT_QUEUE_LENGTH                 (8u)
+
+/* Buffer used to receive the HTTP upgrade request. */
+#define WEBSOCKET_HANDSHAKE_BUFFER_LENGTH            (512u)
+
+/* Largest frame payload accepted from the client. Commands are a few bytes,
+ * so larger frames are rejected and the connection is closed.
+ */
+#define WEBSOCKET_MAX_PAYLOAD_LEN                    (125u)
+
+/* Interval at which the task checks whether the clients are still alive,
+ * and reads the sockets in case an event was lost because the queue was
+ * full. A socket is only read when it has data, so its receive timeout
+ * WEBSOCKET_POLL_TIMEOUT_MSEC only bounds a read that finds none.
+ */
+#define WEBSOCKET_CHECK_INTERVAL_MSEC                (1000u)
+#define WEBSOCKET_POLL_TIMEOUT_MSEC                  (10u)
+#define WEBSOCKET_SEND_TIMEOUT_MSEC                  (1000u)
+
+/* A ping is sent to a client that has been silent for this long, and the
+ * client is closed if it stays silent for WEBSOCKET_IDLE_TIMEOUT_MSEC.
+ */
+#define WEBSOCKET_PING_INTERVAL_MSEC                 (10000u)
+#define WEBSOCKET_IDLE_TIMEOUT_MSEC                  (20000u)
+
+/* GUID appended to Sec-WebSocket-Key to compute Sec-WebSocket-Accept. */
+#define WEBSOCKET_GUID                               "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+/* Frame opcodes. */
+#define WEBSOCKET_OPCODE_CONTINUATION                (0x0u)
+#define WEBSOCKET_OPCODE_TEXT                        (0x1u)
+#define WEBSOCKET_OPCODE_BINARY                      (0x2u)
+#define WEBSOCKET_OPCODE_CLOSE                       (0x8u)
+#define WEBSOCKET_OPCODE_PING                        (0x9u)
+#define WEBSOCKET_OPCODE_PONG                        (0xAu)
+
+/* Close status codes. */
+#define WEBSOCKET_CLOSE_NORMAL                       (1000u)
+#define WEBSOCKET_CLOSE_GOING_AWAY                   (1001u)
+#define WEBSOCKET_CLOSE_PROTOCOL_ERROR               (1002u)
+#define WEBSOCKET_CLOSE_UNSUPPORTED_DATA             (1003u)
+#define WEBSOCKET_CLOSE_MESSAGE_TOO_BIG              (1009u)
+
+/* Binary messages from the client: <command> <sequence number, 2 bytes>. */
+#define WEBSOCKET_CMD_INCREASE                       (0x01u)
+#define WEBSOCKET_CMD_DECREASE                       (0x02u)
+#define WEBSOCKET_CMD_LENGTH                         (3u)
+
+/* Binary messages to the client.
+ * Acknowledgment: <WEBSOCKET_MSG_ACK> <sequence number, 2 bytes> <duty cycle>
+ * Telemetry: <WEBSOCKET_MSG_TELEMETRY> <binary telemetry, see telemetry.h>
+ * Event: <WEBSOCKET_MSG_EVENT> <length of the name> <name> <data>, the named
+ * events of the HTTP event stream, such as the Wi-Fi state.
+ */
+#define WEBSOCKET_MSG_TELEMETRY                      (0x80u)
+#define WEBSOCKET_MSG_ACK                            (0x81u)
+#define WEBSOCKET_MSG_EVENT                          (0x82u)
+
+/* Set to 0 to send the device data as text frames in the same format as the
+ * HTTP event stream instead of the compact binary telemetry.
+ */
+#define WEBSOCKET_BINARY_TELEMETRY                   (1u)
+
+/* Clients and connections of the WebSocket endpoint reported in the metrics. */
+typedef struct
+{
+    uint32_t connected_clients;
+    uint32_t accepted;
+    uint32_t rejected;
+    conn_quota_client_t clients[CONN_QUOTA_MAX_CLIENTS];
+} websocket_stats_t;
+
+
+cy_rslt_t websocket_server_start(void);
+cy_rslt_t websocket_server_listen(uint32_t interface, const cy_socket_sockaddr_t *address);
+uint32_t websocket_server_close(uint32_t interface);
+cy_rslt_t websocket_send_telemetry(const telemetry_sample_t *sample);
+cy_rslt_t websocket_send_event(const char *event_name, const char *data, uint32_t data_len);
+void websocket_get_stats(websocket_stats_t *stats);
+bool websocket_has_clients(void);
+
+
+#endif /* WEBSOCKET_H_ */
+
+/* [] END OF FILE */
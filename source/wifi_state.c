@@ -0,0 +1,350 @@
+/*******************************************************************************
+ * File Name: wifi_state.c
+ *
+ * Description: This file contains the state machine of the connection to the
+ *              AP. The WCM events are queued by the WCM event callback and
+ *              handled by the server task, and each transition is published
+ *              to the HTTP event stream.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* Header file includes */
+#include "wifi_state.h"
+#include "event_stream.h"
+#include "websocket.h"
+
+/* Standard C header file */
+#include <string.h>
+
+/*******************************************************************************
+ * Global Variables
+ ********************************************************************************/
+/* Names of the states, published to the HTTP event stream. */
+static const char *wifi_state_names[WIFI_STATE_COUNT] =
+{
+    "idle",
+    "scanning",
+    "connecting",
+    "dhcp",
+    "connected",
+    "lost",
+    "backoff"
+};
+
+/* Current state. Changed by the server task on WCM events and by the connect
+ * path as it goes through the phases of a connection.
+ */
+static volatile wifi_state_t wifi_state = WIFI_STATE_IDLE;
+static cy_mutex_t wifi_state_mutex;
+
+/* WCM events waiting to be handled by the server task. */
+static cy_queue_t wifi_state_event_queue;
+
+/* Time the link went down, while it is down. */
+static cy_time_t wifi_state_lost_time = 0;
+static bool wifi_state_link_down = false;
+
+/* Statistics of the state machine. */
+static volatile uint32_t wifi_state_transitions = 0;
+static volatile uint32_t wifi_state_link_losses = 0;
+static volatile uint32_t wifi_state_reconnects = 0;
+static volatile uint32_t wifi_state_last_outage_msec = 0;
+static volatile uint32_t wifi_state_dropped_events = 0;
+
+/*******************************************************************************
+ * Function Name: wifi_state_init
+ *******************************************************************************
+ * Summary:
+ *  Initializes the state machine in the IDLE state.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if the state machine is initialized
+ *  successfully, otherwise, it returns the RTOS error code.
+ *
+ *******************************************************************************/
+cy_rslt_t wifi_state_init(void)
+{
+    cy_rslt_t result;
+
+    wifi_state = WIFI_STATE_IDLE;
+
+    result = cy_rtos_init_mutex(&wifi_state_mutex);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    return cy_rtos_init_queue(&wifi_state_event_queue, WIFI_STATE_EVENT_QUEUE_LENGTH, sizeof(cy_wcm_event_t));
+}
+
+/*******************************************************************************
+ * Function Name: wifi_state_post_event
+ *******************************************************************************
+ * Summary:
+ *  Queues a WCM event for the server task. Called from the WCM event
+ *  callback, so it never blocks; the event is dropped if the queue is full.
+ *
+ * Parameters:
+ *  event - WCM event.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void wifi_state_post_event(cy_wcm_event_t event)
+{
+    if (CY_RSLT_SUCCESS != cy_rtos_put_queue(&wifi_state_event_queue, &event, 0, false))
+    {
+        wifi_state_dropped_events++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: wifi_state_wake
+ *******************************************************************************
+ * Summary:
+ *  Queues WIFI_STATE_EVENT_WAKE for the server task. Called from an interrupt
+ *  handler, so it never blocks; the event is dropped if the queue is full,
+ *  as the server task is then awake already.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void wifi_state_wake(void)
+{
+    cy_wcm_event_t event = WIFI_STATE_EVENT_WAKE;
+
+    (void)cy_rtos_put_queue(&wifi_state_event_queue, &event, 0, true);
+}
+
+/*******************************************************************************
+ * Function Name: wifi_state_wait_event
+ *******************************************************************************
+ * Summary:
+ *  Waits for the next WCM event.
+ *
+ * Parameters:
+ *  event - Pointer to store the event.
+ *  timeout_msec - Time to wait, or CY_RTOS_NEVER_TIMEOUT.
+ *
+ * Return:
+ *  cy_rslt_t: Returns CY_RSLT_SUCCESS if an event is returned, otherwise, the
+ *  RTOS error code when the timeout expires.
+ *
+ *******************************************************************************/
+cy_rslt_t wifi_state_wait_event(cy_wcm_event_t *event, cy_time_t timeout_msec)
+{
+    return cy_rtos_get_queue(&wifi_state_event_queue, event, timeout_msec, false);
+}
+
+/*******************************************************************************
+ * Function Name: wifi_state_handle_event
+ *******************************************************************************
+ * Summary:
+ *  Applies a WCM event to the state machine. Events that do not apply to the
+ *  current state, such as the disconnection caused by a new connection from
+ *  the SoftAP page or by a roam, are ignored.
+ *
+ * Parameters:
+ *  event - WCM event.
+ *
+ * Return:
+ *  wifi_state_t - State after the event.
+ *
+ *******************************************************************************/
+wifi_state_t wifi_state_handle_event(cy_wcm_event_t event)
+{
+    wifi_state_t state = wifi_state;
+
+    switch (event)
+    {
+    case CY_WCM_EVENT_CONNECTED:
+        if (WIFI_STATE_CONNECTING == state)
+        {
+            wifi_state_enter(WIFI_STATE_DHCP);
+        }
+        break;
+
+    case CY_WCM_EVENT_IP_CHANGED:
+        if (WIFI_STATE_DHCP == state)
+        {
+            wifi_state_enter(WIFI_STATE_CONNECTED);
+        }
+        break;
+
+    case CY_WCM_EVENT_RECONNECTED:
+        if ((WIFI_STATE_LOST == state) || (WIFI_STATE_BACKOFF == state) || (WIFI_STATE_DHCP == state))
+        {
+            wifi_state_enter(WIFI_STATE_CONNECTED);
+        }
+        break;
+
+    case CY_WCM_EVENT_DISCONNECTED:
+        /* The event of a disconnection made on purpose, before a roam or a
+         * new connection, may be handled after the new link is up.
+         */
+        if (((WIFI_STATE_CONNECTED == state) || (WIFI_STATE_DHCP == state)) && !cy_wcm_is_connected_to_ap())
+        {
+            wifi_state_enter(WIFI_STATE_LOST);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return wifi_state;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_state_enter
+ *******************************************************************************
+ * Summary:
+ *  Moves the state machine to a new state and publishes the transition to
+ *  the HTTP event stream. Entering IDLE forgets a lost link, as the
+ *  connection was given up or replaced.
+ *
+ * Parameters:
+ *  state - New state.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void wifi_state_enter(wifi_state_t state)
+{
+    cy_time_t now;
+
+    cy_rtos_get_mutex(&wifi_state_mutex, CY_RTOS_NEVER_TIMEOUT);
+
+    if (wifi_state == state)
+    {
+        cy_rtos_set_mutex(&wifi_state_mutex);
+        return;
+    }
+
+    wifi_state = state;
+    wifi_state_transitions++;
+    cy_rtos_get_time(&now);
+
+    if (WIFI_STATE_LOST == state)
+    {
+        wifi_state_link_losses++;
+        wifi_state_lost_time = now;
+        wifi_state_link_down = true;
+    }
+    else if ((WIFI_STATE_CONNECTED == state) && wifi_state_link_down)
+    {
+        wifi_state_reconnects++;
+        wifi_state_last_outage_msec = now - wifi_state_lost_time;
+        wifi_state_link_down = false;
+    }
+    else if (WIFI_STATE_IDLE == state)
+    {
+        wifi_state_link_down = false;
+    }
+
+    cy_rtos_set_mutex(&wifi_state_mutex);
+
+    event_stream_publish(WIFI_STATE_EVENT_NAME, wifi_state_names[state], strlen(wifi_state_names[state]));
+    websocket_send_event(WIFI_STATE_EVENT_NAME, wifi_state_names[state], strlen(wifi_state_names[state]));
+}
+
+/*******************************************************************************
+ * Function Name: wifi_state_get
+ *******************************************************************************
+ * Summary:
+ *  Returns the current state.
+ *
+ * Parameters:
+ *  void
+ *
+ * Return:
+ *  wifi_state_t - Current state.
+ *
+ *******************************************************************************/
+wifi_state_t wifi_state_get(void)
+{
+    return wifi_state;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_state_name
+ *******************************************************************************
+ * Summary:
+ *  Returns the name of a state for the logs and the metrics.
+ *
+ * Parameters:
+ *  state - State.
+ *
+ * Return:
+ *  const char * - Name of the state.
+ *
+ *******************************************************************************/
+const char *wifi_state_name(wifi_state_t state)
+{
+    return (state < WIFI_STATE_COUNT) ? wifi_state_names[state] : "unknown";
+}
+
+/*******************************************************************************
+ * Function Name: wifi_state_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Returns the statistics of the state machine.
+ *
+ * Parameters:
+ *  stats - Pointer to store the statistics.
+ *
+ * Return:
+ *  void
+ *
+ *******************************************************************************/
+void wifi_state_get_stats(wifi_state_stats_t *stats)
+{
+    stats->state = wifi_state;
+    stats->transitions = wifi_state_transitions;
+    stats->link_losses = wifi_state_link_losses;
+    stats->reconnects = wifi_state_reconnects;
+    stats->last_outage_msec = wifi_state_last_outage_msec;
+    stats->dropped_events = wifi_state_dropped_events;
+}
+
+/* [] END OF FILE */
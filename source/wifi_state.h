@@ -0,0 +1,108 @@
+/******************************************************************************
+* File Name: wifi_state.h
+*
+* Description: This file contains the states, structures and function
+*              prototypes of the state machine of the connection to the AP.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef WIFI_STATE_H_
+#define WIFI_STATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cyabs_rtos.h"
+#include "cy_wcm.h"
+
+/* Number of WCM events that can wait to be handled by the state machine. */
+#define WIFI_STATE_EVENT_QUEUE_LENGTH                (8u)
+
+/* Event queued by wifi_state_wake() to wake the server task for a request
+ * other than a WCM event, such as the press of the user button. It is not a
+ * WCM event, so the state machine ignores it.
+ */
+#define WIFI_STATE_EVENT_WAKE                        ((cy_wcm_event_t)0xFF)
+
+/* Name of the event published to the HTTP event stream on each transition.
+ * Its data is the name of the new state.
+ */
+#define WIFI_STATE_EVENT_NAME                        "wifi"
+
+/* States of the connection to the AP.
+ *  IDLE        not connected and not trying to connect
+ *  SCANNING    scanning for the AP to connect to
+ *  CONNECTING  joining the AP
+ *  DHCP        associated, waiting for an IP address
+ *  CONNECTED   associated with an IP address
+ *  LOST        the link to the AP went down
+ *  BACKOFF     waiting before the next connection attempt
+ */
+typedef enum
+{
+    WIFI_STATE_IDLE = 0,
+    WIFI_STATE_SCANNING,
+    WIFI_STATE_CONNECTING,
+    WIFI_STATE_DHCP,
+    WIFI_STATE_CONNECTED,
+    WIFI_STATE_LOST,
+    WIFI_STATE_BACKOFF,
+    WIFI_STATE_COUNT
+} wifi_state_t;
+
+/* Statistics of the state machine reported in the metrics. */
+typedef struct
+{
+    wifi_state_t state;
+    uint32_t transitions;
+    uint32_t link_losses;
+    uint32_t reconnects;
+    uint32_t last_outage_msec;
+    uint32_t dropped_events;
+} wifi_state_stats_t;
+
+
+cy_rslt_t wifi_state_init(void);
+void wifi_state_post_event(cy_wcm_event_t event);
+void wifi_state_wake(void);
+cy_rslt_t wifi_state_wait_event(cy_wcm_event_t *event, cy_time_t timeout_msec);
+wifi_state_t wifi_state_handle_event(cy_wcm_event_t event);
+void wifi_state_enter(wifi_state_t state);
+wifi_state_t wifi_state_get(void);
+const char *wifi_state_name(wifi_state_t state);
+void wifi_state_get_stats(wifi_state_stats_t *stats);
+
+
+#endif /* WIFI_STATE_H_ */
+
+/* [] END OF FILE */
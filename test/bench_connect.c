@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * File Name: bench_connect.c
+ *
+ * Description: Host benchmark of the connect latency with a simulated WCM
+ *              that dwells on each channel: a connection that scans all the
+ *              channels first, against the direct join of a known BSSID on
+ *              its channel, with and without stale channel information.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "web_server.h"
+#include "cy_wcm_error.h"
+#include "test_common.h"
+
+/* Connections simulated on each path, and the share of the direct joins on
+ * a channel that the AP has left since it was cached, in percent.
+ */
+#define SIM_CONNECTIONS                              (2000u)
+#define SIM_STALE_PERCENT                            (10u)
+
+/* Dwell times of a scan: active on the 2.4 GHz channels and on the 5 GHz
+ * channels without radar detection, passive on the DFS channels, plus the
+ * channel switch.
+ */
+#define SIM_ACTIVE_DWELL_MSEC                        (40u)
+#define SIM_PASSIVE_DWELL_MSEC                       (110u)
+#define SIM_SWITCH_MSEC                              (3u)
+#define SIM_DWELL_JITTER_PERCENT                     (20u)
+
+/* A direct join on a channel the AP has left gives up after this many
+ * unanswered probes.
+ */
+#define SIM_DIRECT_JOIN_PROBES                       (3u)
+
+/* Authentication, association and 4-way handshake, then DHCP. */
+#define SIM_JOIN_MIN_MSEC                            (60u)
+#define SIM_JOIN_MAX_MSEC                            (150u)
+#define SIM_DHCP_MIN_MSEC                            (150u)
+#define SIM_DHCP_MAX_MSEC                            (600u)
+
+/* Channels of the simulated regulatory domain. */
+static const uint8_t sim_channels[] =
+{
+    1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+    36, 40, 44, 48, 52, 56, 60, 64, 100, 104, 108, 112, 116, 120, 124, 128, 132, 136, 140, 144,
+    149, 153, 157, 161, 165
+};
+
+static uint32_t sim_samples[SIM_CONNECTIONS];
+
+static uint32_t sim_random(uint32_t min, uint32_t max)
+{
+    return min + test_random(max - min + 1u);
+}
+
+static cy_wcm_wifi_band_t sim_band(uint8_t channel)
+{
+    return (channel > 14u) ? CY_WCM_WIFI_BAND_5GHZ : CY_WCM_WIFI_BAND_2_4GHZ;
+}
+
+/* Time spent on a channel by a scan. */
+static uint32_t sim_dwell(uint8_t channel)
+{
+    uint32_t dwell = ((channel >= 52u) && (channel <= 144u)) ? SIM_PASSIVE_DWELL_MSEC : SIM_ACTIVE_DWELL_MSEC;
+    uint32_t jitter = (dwell * SIM_DWELL_JITTER_PERCENT) / 100u;
+
+    return SIM_SWITCH_MSEC + sim_random(dwell - jitter, dwell + jitter);
+}
+
+/* Time of a scan of all the channels of a band. */
+static uint32_t sim_scan(cy_wcm_wifi_band_t band)
+{
+    uint32_t total = 0;
+
+    for (uint32_t index = 0; index < sizeof(sim_channels); index++)
+    {
+        if ((CY_WCM_WIFI_BAND_ANY == band) || (band == sim_band(sim_channels[index])))
+        {
+            total += sim_dwell(sim_channels[index]);
+        }
+    }
+    return total;
+}
+
+static uint32_t sim_join(void)
+{
+    return sim_random(SIM_JOIN_MIN_MSEC, SIM_JOIN_MAX_MSEC) + sim_random(SIM_DHCP_MIN_MSEC, SIM_DHCP_MAX_MSEC);
+}
+
+/* The AP is not known: wifi_scan_for_ap() scans all the channels for the
+ * SSID, then cy_wcm_connect_ap() scans the band of the AP to join it.
+ */
+static uint32_t sim_connect_scan(uint8_t channel)
+{
+    return sim_scan(CY_WCM_WIFI_BAND_ANY) + sim_scan(sim_band(channel)) + sim_join();
+}
+
+/* The AP is known from the scan cache or the credential store: the BSSID is
+ * joined on its channel. If the AP has left the channel, the join fails and
+ * start_sta_mode() widens to the scan after the delay of its retry policy.
+ */
+static uint32_t sim_connect_direct(uint8_t channel, bool stale)
+{
+    static const retry_policy_config_t config =
+    {
+        .max_attempts = MAX_WIFI_RETRY_COUNT,
+        .max_rejections = WIFI_CONN_MAX_REJECTIONS,
+        .initial_delay_msec = WIFI_CONN_RETRY_INTERVAL_MSEC,
+        .max_delay_msec = WIFI_CONN_RETRY_MAX_INTERVAL_MSEC,
+        .deadline_msec = WIFI_CONN_RETRY_DEADLINE_MSEC,
+        .jitter_percent = WIFI_CONN_RETRY_JITTER_PERCENT,
+        .classify = retry_policy_classify_wcm
+    };
+    retry_policy_t policy;
+    uint32_t total = 0;
+    uint32_t delay_msec = 0;
+
+    if (!stale)
+    {
+        return sim_dwell(channel) + sim_join();
+    }
+
+    retry_policy_start(&policy, &config, sim_random(1u, UINT32_MAX - 1u));
+    for (uint32_t probe = 0; probe < SIM_DIRECT_JOIN_PROBES; probe++)
+    {
+        total += sim_dwell(channel);
+    }
+    TEST_CHECK(retry_policy_next(&policy, CY_RSLT_WCM_WAIT_TIMEOUT, &delay_msec));
+
+    return total + delay_msec + sim_connect_scan(channel);
+}
+
+static void sim_report(const char *name)
+{
+    printf("%-32s p50 %5lu ms  p95 %5lu ms  p99 %5lu ms\n", name,
+           (unsigned long)test_percentile(sim_samples, SIM_CONNECTIONS, 50),
+           (unsigned long)test_percentile(sim_samples, SIM_CONNECTIONS, 95),
+           (unsigned long)test_percentile(sim_samples, SIM_CONNECTIONS, 99));
+}
+
+int main(void)
+{
+    uint32_t scan_p50;
+    uint32_t direct_p95;
+    uint8_t channel;
+
+    test_random_seed(0x2545F491u);
+
+    for (uint32_t index = 0; index < SIM_CONNECTIONS; index++)
+    {
+        channel = sim_channels[sim_random(0, sizeof(sim_channels) - 1u)];
+        sim_samples[index] = sim_connect_scan(channel);
+    }
+    sim_report("Scan of all the channels");
+    scan_p50 = test_percentile(sim_samples, SIM_CONNECTIONS, 50);
+
+    for (uint32_t index = 0; index < SIM_CONNECTIONS; index++)
+    {
+        channel = sim_channels[sim_random(0, sizeof(sim_channels) - 1u)];
+        sim_samples[index] = sim_connect_direct(channel, false);
+    }
+    sim_report("Direct join");
+    direct_p95 = test_percentile(sim_samples, SIM_CONNECTIONS, 95);
+
+    for (uint32_t index = 0; index < SIM_CONNECTIONS; index++)
+    {
+        channel = sim_channels[sim_random(0, sizeof(sim_channels) - 1u)];
+        sim_samples[index] = sim_connect_direct(channel, sim_random(1u, 100u) <= SIM_STALE_PERCENT);
+    }
+    sim_report("Direct join, 10% stale channels");
+
+    TEST_CHECK(direct_p95 < scan_p50);
+
+    return TEST_RESULT("connect latency");
+}
+
+/* [] END OF FILE */
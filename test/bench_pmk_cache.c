@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * File Name: bench_pmk_cache.c
+ *
+ * Description: Host microbenchmark of the PMK cache: times the PBKDF2
+ *              derivation that a connect without a cached PMK pays, against
+ *              the lookups in RAM and in the credential store.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "pmk_cache.h"
+#include "cred_store.h"
+#include "test_common.h"
+
+#include <string.h>
+
+/* Derivations and lookups timed. */
+#define BENCH_DERIVATIONS                            (50u)
+#define BENCH_LOOKUPS                                (2000u)
+
+static uint32_t bench_samples[BENCH_LOOKUPS];
+
+static void bench_report(const char *name, uint32_t count)
+{
+    printf("%-28s p50 %7lu us  p95 %7lu us\n", name,
+           (unsigned long)test_percentile(bench_samples, count, 50),
+           (unsigned long)test_percentile(bench_samples, count, 95));
+}
+
+/* Stores a profile of the SSID with its PMK. */
+static void bench_store(const char *ssid, const char *passphrase)
+{
+    cred_store_entry_t entry;
+
+    memset(&entry, 0, sizeof(entry));
+    strcpy((char *)entry.ssid, ssid);
+    strcpy((char *)entry.password, passphrase);
+    entry.security = CY_WCM_SECURITY_WPA2_AES_PSK;
+    pmk_cache_derive(entry.ssid, entry.password, entry.pmk);
+    entry.pmk_valid = true;
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, true));
+}
+
+int main(void)
+{
+    uint8_t pmk[PMK_LENGTH];
+    uint64_t start;
+    const uint8_t *ssid;
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_init());
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_erase());
+
+    for (uint32_t index = 0; index < BENCH_DERIVATIONS; index++)
+    {
+        start = test_time_usec();
+        pmk_cache_derive((const uint8_t *)"line-1", (const uint8_t *)"password", pmk);
+        bench_samples[index] = (uint32_t)(test_time_usec() - start);
+    }
+    bench_report("PBKDF2 derivation", BENCH_DERIVATIONS);
+
+    for (uint32_t index = 0; index < BENCH_LOOKUPS; index++)
+    {
+        start = test_time_usec();
+        TEST_CHECK(pmk_cache_lookup((const uint8_t *)"line-1", (const uint8_t *)"password", pmk));
+        bench_samples[index] = (uint32_t)(test_time_usec() - start);
+    }
+    bench_report("Lookup in RAM", BENCH_LOOKUPS);
+
+    /* Alternating between two stored profiles reads the store every time. */
+    bench_store("line-1", "password");
+    bench_store("line-2", "password");
+    for (uint32_t index = 0; index < BENCH_LOOKUPS; index++)
+    {
+        ssid = (const uint8_t *)((0 == (index & 1u)) ? "line-1" : "line-2");
+        start = test_time_usec();
+        TEST_CHECK(pmk_cache_lookup(ssid, (const uint8_t *)"password", pmk));
+        bench_samples[index] = (uint32_t)(test_time_usec() - start);
+    }
+    bench_report("Lookup in the store file", BENCH_LOOKUPS);
+
+    (void)cred_store_erase();
+
+    return TEST_RESULT("pmk_cache");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * File Name: bench_telemetry.c
+ *
+ * Description: Host benchmark of the telemetry encoders: times the text and
+ *              the binary encoding of a device data sample and compares their
+ *              payload sizes.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "telemetry.h"
+#include "test_common.h"
+
+#include <string.h>
+
+/* Samples encoded in each format. */
+#define BENCH_SAMPLES                                (200000u)
+
+/* Samples of the device data as the page receives them, with the uptime and
+ * the duty cycle moving from one sample to the next.
+ */
+static void bench_sample(uint32_t index, telemetry_sample_t *sample)
+{
+    sample->present = TELEMETRY_FIELD_DUTY_CYCLE | TELEMETRY_FIELD_UPTIME | TELEMETRY_FIELD_RSSI;
+    sample->duty_cycle_permille = (uint16_t)((index * 10u) % 1001u);
+    sample->uptime_centisec = 360000u + (index * 5u);
+    sample->rssi_dbm = (int8_t)(-40 - (int32_t)(index % 50u));
+}
+
+/* The binary frame decodes to the sample, as the decoder of the page reads it. */
+static void test_binary_layout(void)
+{
+    telemetry_sample_t sample = { 0 };
+    uint8_t frame[TELEMETRY_MAX_BINARY_LEN];
+    uint8_t expected[] = { TELEMETRY_SCHEMA_VERSION, 0x07u, 0x2Au, 0x02u, 0x78u, 0x56u, 0x34u, 0x12u, 0xC4u };
+    telemetry_stats_t stats;
+
+    sample.present = TELEMETRY_FIELD_DUTY_CYCLE | TELEMETRY_FIELD_UPTIME | TELEMETRY_FIELD_RSSI;
+    sample.duty_cycle_permille = 554u;
+    sample.uptime_centisec = 0x12345678u;
+    sample.rssi_dbm = -60;
+
+    TEST_CHECK(sizeof(expected) == telemetry_encode_binary(&sample, frame, sizeof(frame)));
+    TEST_CHECK(0 == memcmp(expected, frame, sizeof(expected)));
+
+    /* Absent fields take no space. */
+    sample.present = TELEMETRY_FIELD_RSSI;
+    TEST_CHECK(3u == telemetry_encode_binary(&sample, frame, sizeof(frame)));
+    TEST_CHECK((0x04u == frame[1]) && (0xC4u == frame[2]));
+
+    TEST_CHECK(0 == telemetry_encode_binary(&sample, frame, TELEMETRY_MAX_BINARY_LEN - 1u));
+
+    telemetry_get_stats(&stats);
+    TEST_CHECK(3u == stats.binary_len);
+}
+
+/* The text format fits in TELEMETRY_MAX_TEXT_LEN with the widest fields. */
+static void test_text_length(void)
+{
+    telemetry_sample_t sample = { 0 };
+    char text[TELEMETRY_MAX_TEXT_LEN];
+
+    sample.present = TELEMETRY_FIELD_DUTY_CYCLE | TELEMETRY_FIELD_UPTIME | TELEMETRY_FIELD_RSSI;
+    sample.duty_cycle_permille = 1000u;
+    sample.uptime_centisec = UINT32_MAX;
+    sample.rssi_dbm = INT8_MIN;
+
+    TEST_CHECK(0 != telemetry_encode_text(&sample, text, sizeof(text)));
+    TEST_CHECK(0 == strcmp("Duty cycle: 100%, RSSI: -128 dBm, Uptime: 42949672.95 s", text));
+    TEST_CHECK(0 == telemetry_encode_text(&sample, text, 16u));
+}
+
+static void bench_report(const char *name, uint64_t elapsed_usec, uint64_t total_bytes)
+{
+    printf("%-20s %6lu ns per sample  %5.1f bytes per sample\n", name,
+           (unsigned long)((elapsed_usec * 1000u) / BENCH_SAMPLES), (double)total_bytes / BENCH_SAMPLES);
+}
+
+static void bench_encode(void)
+{
+    telemetry_sample_t sample;
+    char text[TELEMETRY_MAX_TEXT_LEN];
+    uint8_t frame[TELEMETRY_MAX_BINARY_LEN];
+    uint64_t text_bytes = 0;
+    uint64_t binary_bytes = 0;
+    uint64_t start;
+    uint64_t text_usec;
+    uint64_t binary_usec;
+
+    start = test_time_usec();
+    for (uint32_t index = 0; index < BENCH_SAMPLES; index++)
+    {
+        bench_sample(index, &sample);
+        text_bytes += telemetry_encode_text(&sample, text, sizeof(text));
+    }
+    text_usec = test_time_usec() - start;
+
+    start = test_time_usec();
+    for (uint32_t index = 0; index < BENCH_SAMPLES; index++)
+    {
+        bench_sample(index, &sample);
+        binary_bytes += telemetry_encode_binary(&sample, frame, sizeof(frame));
+    }
+    binary_usec = test_time_usec() - start;
+
+    bench_report("Text encoding", text_usec, text_bytes);
+    bench_report("Binary encoding", binary_usec, binary_bytes);
+
+    TEST_CHECK(binary_bytes < text_bytes);
+}
+
+int main(void)
+{
+    test_binary_layout();
+    test_text_length();
+    bench_encode();
+
+    return TEST_RESULT("telemetry encoding");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,395 @@
+/*******************************************************************************
+ * File Name: bench_websocket.c
+ *
+ * Description: Host benchmark of the round trip of a device data page
+ *              command: a binary frame on the WebSocket endpoint against an
+ *              XHR POST to the HTTP server, on loopback TCP.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* The endpoint is built in, so that the benchmark drives its task through the
+ * same events as the socket callbacks do on the device.
+ */
+#include "../source/websocket.c"
+#include "test_common.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* Commands timed on each path. */
+#define BENCH_COMMANDS                               (2000u)
+
+/* Sample key and accept value of RFC 6455, section 1.3. */
+#define BENCH_WEBSOCKET_KEY                          "dGhlIHNhbXBsZSBub25jZQ=="
+#define BENCH_WEBSOCKET_ACCEPT                       "s3pPLMBiTxaQ9kYGzzhZRbK+xOo="
+
+#define BENCH_UPGRADE_REQUEST \
+    "GET /ws HTTP/1.1\r\n" \
+    "Host: 192.168.0.2:81\r\n" \
+    "Upgrade: websocket\r\n" \
+    "Connection: Upgrade\r\n" \
+    "Sec-WebSocket-Key: " BENCH_WEBSOCKET_KEY "\r\n" \
+    "Sec-WebSocket-Version: 13\r\n" \
+    "\r\n"
+
+/* XHR of send_command() in SOFTAP_DEVICE_DATA, with the headers a browser adds. */
+#define BENCH_XHR_REQUEST \
+    "POST / HTTP/1.1\r\n" \
+    "Host: 192.168.0.2\r\n" \
+    "Connection: keep-alive\r\n" \
+    "Content-Length: 8\r\n" \
+    "Content-type: application/x-www-form-urlencoded\r\n" \
+    "Accept: */*\r\n" \
+    "Origin: http://192.168.0.2\r\n" \
+    "Referer: http://192.168.0.2/\r\n" \
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n" \
+    "Accept-Encoding: gzip, deflate\r\n" \
+    "Accept-Language: en-US,en;q=0.9\r\n" \
+    "\r\n" \
+    "Increase"
+
+#define BENCH_XHR_RESPONSE                           HTTP_HEADER_204 "\r\nContent-Length: 0\r\n\r\n"
+
+/* Masked command frame: header, mask key and WEBSOCKET_CMD_LENGTH bytes. */
+#define BENCH_COMMAND_FRAME_LENGTH                   (2u + WEBSOCKET_MASK_KEY_LENGTH + WEBSOCKET_CMD_LENGTH)
+
+/* Acknowledgment frame: header and 4 bytes. */
+#define BENCH_ACK_FRAME_LENGTH                       (2u + 4u)
+
+static uint32_t bench_duty_cycle = 0;
+static int bench_http_listen_fd = -1;
+static bool bench_http_keep_alive = false;
+static uint32_t bench_samples[BENCH_COMMANDS];
+
+/* Stand-in for the handler in web_server.c. */
+uint32_t device_duty_cycle_step(bool increase)
+{
+    bench_duty_cycle = increase ? ((bench_duty_cycle + 1u) % 101u) : ((bench_duty_cycle + 100u) % 101u);
+    return bench_duty_cycle;
+}
+
+static bool bench_read(int fd, void *buffer, size_t length)
+{
+    uint8_t *ptr = (uint8_t *)buffer;
+    ssize_t received;
+
+    while (length > 0)
+    {
+        received = recv(fd, ptr, length, 0);
+        if (received <= 0)
+        {
+            return false;
+        }
+        ptr += received;
+        length -= (size_t)received;
+    }
+    return true;
+}
+
+/* Reads an HTTP message into buffer until its header is complete, in as
+ * few reads as the data arrives in, as the HTTP server does. Returns the
+ * length read, the header included, or 0 on error.
+ */
+static size_t bench_read_header(int fd, char *buffer, size_t size, size_t *header_length)
+{
+    size_t length = 0;
+    ssize_t received;
+    char *end;
+
+    while (length < size - 1)
+    {
+        received = recv(fd, &buffer[length], size - 1 - length, 0);
+        if (received <= 0)
+        {
+            return 0;
+        }
+        length += (size_t)received;
+        buffer[length] = '\0';
+
+        end = strstr(buffer, "\r\n\r\n");
+        if (NULL != end)
+        {
+            *header_length = (size_t)(end - buffer) + 4u;
+            return length;
+        }
+    }
+    return 0;
+}
+
+static int bench_connect(uint16_t port)
+{
+    struct sockaddr_in addr = { 0 };
+    int enable = 1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    if (0 != connect(fd, (struct sockaddr *)&addr, sizeof(addr)))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static uint16_t bench_port(int fd)
+{
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+
+    getsockname(fd, (struct sockaddr *)&addr, &length);
+    return ntohs(addr.sin_port);
+}
+
+static void bench_report(const char *name, uint32_t count, uint32_t wire_bytes)
+{
+    uint64_t total = 0;
+
+    for (uint32_t index = 0; index < count; index++)
+    {
+        total += bench_samples[index];
+    }
+    printf("%-28s p50 %5lu us  p95 %5lu us  mean %5lu us  %4lu bytes per command\n", name,
+           (unsigned long)test_percentile(bench_samples, count, 50),
+           (unsigned long)test_percentile(bench_samples, count, 95),
+           (unsigned long)((0 == count) ? 0 : (total / count)), (unsigned long)wire_bytes);
+}
+
+/* Sends the commands as masked binary frames and times each acknowledgment.
+ * The receive event that the socket callback queues on the device is queued
+ * here after each frame, so that the WebSocket task reads it.
+ */
+static void bench_websocket(void)
+{
+    websocket_listener_t *listener = &websocket_listeners[HTTP_INTERFACE_AP];
+    websocket_client_t *client = &websocket_clients[0];
+    char header[WEBSOCKET_HANDSHAKE_BUFFER_LENGTH];
+    size_t header_length;
+    uint8_t frame[BENCH_COMMAND_FRAME_LENGTH];
+    uint8_t ack[BENCH_ACK_FRAME_LENGTH];
+    uint8_t close_frame[4];
+    uint64_t start;
+    uint32_t count = 0;
+    int fd;
+
+    TEST_CHECK(CY_RSLT_SUCCESS == websocket_server_start());
+
+    /* Listen on an ephemeral port of the loopback address through the
+     * request path of websocket_server_listen(), which uses WEBSOCKET_PORT.
+     */
+    listener->address.ip_address.version = CY_SOCKET_IP_VER_V4;
+    listener->address.ip_address.ip.v4 = htonl(INADDR_LOOPBACK);
+    listener->address.port = 0;
+    TEST_CHECK(CY_RSLT_SUCCESS == websocket_request(WEBSOCKET_EVENT_LISTEN, HTTP_INTERFACE_AP, NULL));
+    TEST_CHECK(listener->listening);
+
+    fd = bench_connect(bench_port(host_socket_fd(listener->socket)));
+    TEST_CHECK(fd >= 0);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    send(fd, BENCH_UPGRADE_REQUEST, sizeof(BENCH_UPGRADE_REQUEST) - 1, 0);
+    websocket_connect_callback(listener->socket, listener);
+    TEST_CHECK(0 != bench_read_header(fd, header, sizeof(header), &header_length));
+    TEST_CHECK(NULL != strstr(header, "HTTP/1.1 101 "));
+    TEST_CHECK(NULL != strstr(header, "Sec-WebSocket-Accept: " BENCH_WEBSOCKET_ACCEPT "\r\n"));
+
+    for (uint32_t command = 0; command < BENCH_COMMANDS; command++)
+    {
+        frame[0] = WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_BINARY;
+        frame[1] = WEBSOCKET_MASK_BIT | WEBSOCKET_CMD_LENGTH;
+        frame[2] = 0x12;
+        frame[3] = 0x34;
+        frame[4] = 0x56;
+        frame[5] = (uint8_t)command;
+        frame[6] = WEBSOCKET_CMD_INCREASE ^ frame[2];
+        frame[7] = (uint8_t)(command >> 8) ^ frame[3];
+        frame[8] = (uint8_t)command ^ frame[4];
+
+        start = test_time_usec();
+        send(fd, frame, sizeof(frame), 0);
+        websocket_receive_callback(client->socket, client);
+        if (!bench_read(fd, ack, sizeof(ack)))
+        {
+            TEST_CHECK(false);
+            break;
+        }
+        bench_samples[count++] = (uint32_t)(test_time_usec() - start);
+
+        TEST_CHECK((WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_BINARY) == ack[0]);
+        TEST_CHECK(4u == ack[1]);
+        TEST_CHECK(WEBSOCKET_MSG_ACK == ack[2]);
+        TEST_CHECK(((uint8_t)(command >> 8) == ack[3]) && ((uint8_t)command == ack[4]));
+        TEST_CHECK(bench_duty_cycle == ack[5]);
+    }
+
+    bench_report("WebSocket binary frame", count, sizeof(frame) + sizeof(ack));
+
+    /* Closing the interface closes the client with 1001 Going Away. */
+    TEST_CHECK(1u == websocket_server_close(HTTP_INTERFACE_AP));
+    TEST_CHECK(!listener->listening);
+    TEST_CHECK(bench_read(fd, close_frame, sizeof(close_frame)));
+    TEST_CHECK((WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_CLOSE) == close_frame[0]);
+    TEST_CHECK((WEBSOCKET_CLOSE_GOING_AWAY >> 8) == close_frame[2]);
+    TEST_CHECK((WEBSOCKET_CLOSE_GOING_AWAY & 0xFFu) == close_frame[3]);
+    TEST_CHECK(0u == websocket_server_close(HTTP_INTERFACE_AP));
+    close(fd);
+}
+
+/* Serves the XHR requests as the POST branch of softap_resource_handler()
+ * does for the device data page.
+ */
+static void *bench_http_server(void *arg)
+{
+    char request[1024];
+    size_t length;
+    size_t header_length;
+    const char *body;
+    const char *length_header;
+    uint32_t content_length;
+    int fd;
+    (void)arg;
+
+    while ((fd = accept(bench_http_listen_fd, NULL, NULL)) >= 0)
+    {
+        while (0 != (length = bench_read_header(fd, request, sizeof(request), &header_length)))
+        {
+            length_header = strstr(request, "Content-Length: ");
+            content_length = (NULL == length_header) ? 0 : (uint32_t)atoi(length_header + sizeof("Content-Length: ") - 1);
+            if ((header_length + content_length > sizeof(request) - 1) ||
+                ((length < header_length + content_length) &&
+                 !bench_read(fd, &request[length], header_length + content_length - length)))
+            {
+                break;
+            }
+            body = &request[header_length];
+
+            if ((content_length >= sizeof(INCREASE) - 1) && (0 == strncmp(INCREASE, body, sizeof(INCREASE) - 1)))
+            {
+                device_duty_cycle_step(true);
+            }
+            else if ((content_length >= sizeof(DECREASE) - 1) && (0 == strncmp(DECREASE, body, sizeof(DECREASE) - 1)))
+            {
+                device_duty_cycle_step(false);
+            }
+
+            send(fd, BENCH_XHR_RESPONSE, sizeof(BENCH_XHR_RESPONSE) - 1, MSG_NOSIGNAL);
+            if (!bench_http_keep_alive)
+            {
+                break;
+            }
+        }
+        close(fd);
+    }
+    return NULL;
+}
+
+/* Sends the commands as XHR POSTs and times each response, on a new
+ * connection per command or on one kept-alive connection.
+ */
+static void bench_xhr(bool keep_alive)
+{
+    char header[1024];
+    size_t header_length;
+    uint64_t start;
+    uint32_t count = 0;
+    uint32_t duty_cycle;
+    uint16_t port = bench_port(bench_http_listen_fd);
+    int fd = -1;
+
+    bench_http_keep_alive = keep_alive;
+
+    for (uint32_t command = 0; command < BENCH_COMMANDS; command++)
+    {
+        duty_cycle = bench_duty_cycle;
+        start = test_time_usec();
+        if (fd < 0)
+        {
+            fd = bench_connect(port);
+        }
+        send(fd, BENCH_XHR_REQUEST, sizeof(BENCH_XHR_REQUEST) - 1, 0);
+        if (0 == bench_read_header(fd, header, sizeof(header), &header_length))
+        {
+            TEST_CHECK(false);
+            break;
+        }
+        bench_samples[count++] = (uint32_t)(test_time_usec() - start);
+
+        TEST_CHECK(0 == strncmp(header, HTTP_HEADER_204, sizeof(HTTP_HEADER_204) - 1));
+        TEST_CHECK(((duty_cycle + 1u) % 101u) == bench_duty_cycle);
+        if (!keep_alive)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    bench_report(keep_alive ? "XHR POST, kept-alive" : "XHR POST, new connection", count,
+                 sizeof(BENCH_XHR_REQUEST) - 1 + sizeof(BENCH_XHR_RESPONSE) - 1);
+}
+
+int main(void)
+{
+    struct sockaddr_in addr = { 0 };
+    pthread_t http_thread;
+    int enable = 1;
+
+    bench_websocket();
+
+    bench_http_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    setsockopt(bench_http_listen_fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    TEST_CHECK(0 == bind(bench_http_listen_fd, (struct sockaddr *)&addr, sizeof(addr)));
+    TEST_CHECK(0 == listen(bench_http_listen_fd, 4));
+    pthread_create(&http_thread, NULL, bench_http_server, NULL);
+
+    bench_xhr(false);
+    bench_xhr(true);
+
+    return TEST_RESULT("websocket round trip");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,36 @@
+/* Host stub of cy_http_server.h: only the declarations used by the modules in source. */
+#ifndef STUB_CY_HTTP_SERVER_H
+#define STUB_CY_HTTP_SERVER_H
+
+#include "cy_result.h"
+#include "cy_secure_sockets.h"
+typedef void* cy_http_server_t;
+typedef struct { int dummy; } cy_http_response_stream_t;
+typedef enum { CY_HTTP_REQUEST_GET, CY_HTTP_REQUEST_POST, CY_HTTP_REQUEST_PUT, CY_HTTP_REQUEST_UNDEFINED } cy_http_request_type_t;
+typedef enum { CY_HTTP_MIME_TYPE_HTML, CY_HTTP_MIME_TYPE_JSON, CY_HTTP_MIME_TYPE_TEXT_PLAIN, CY_HTTP_MIME_TYPE_TEXT_EVENT_STREAM, CY_HTTP_MIME_TYPE_APPLICATION_OCTET_STREAM, CY_HTTP_MIME_TYPE_ALL } cy_http_mime_type_t;
+typedef enum { CY_HTTP_200_TYPE, CY_HTTP_204_TYPE, CY_HTTP_207_TYPE, CY_HTTP_301_TYPE, CY_HTTP_400_TYPE, CY_HTTP_403_TYPE, CY_HTTP_404_TYPE, CY_HTTP_405_TYPE, CY_HTTP_406_TYPE, CY_HTTP_412_TYPE, CY_HTTP_415_TYPE, CY_HTTP_429_TYPE, CY_HTTP_444_TYPE, CY_HTTP_470_TYPE, CY_HTTP_500_TYPE, CY_HTTP_504_TYPE } cy_http_status_codes_t;
+typedef enum { CY_HTTP_CACHE_DISABLED, CY_HTTP_CACHE_ENABLED } cy_http_cache_t;
+typedef enum { CY_STATIC_URL_CONTENT, CY_DYNAMIC_URL_CONTENT, CY_RESOURCE_URL_CONTENT, CY_RAW_STATIC_URL_CONTENT, CY_RAW_DYNAMIC_URL_CONTENT, CY_RAW_RESOURCE_URL_CONTENT } cy_url_resource_type;
+typedef struct { uint8_t *data; uint16_t data_length; uint32_t data_remaining; bool is_chunked_transfer; cy_http_mime_type_t mime_type; cy_http_request_type_t request_type; } cy_http_message_body_t;
+typedef int32_t (*url_processor_t)(const char *url_path, const char *url_query_string, cy_http_response_stream_t *stream, void *arg, cy_http_message_body_t *http_message_body);
+typedef struct { url_processor_t resource_handler; void *arg; } cy_resource_dynamic_data_t;
+typedef struct { const void *data; uint32_t length; } cy_resource_static_data_t;
+typedef enum { CY_NW_INF_TYPE_WIFI, CY_NW_INF_TYPE_ETH } cy_network_interface_type_t;
+typedef struct { cy_network_interface_type_t type; void *object; } cy_network_interface_t;
+cy_rslt_t cy_http_server_network_init(void);
+cy_rslt_t cy_http_server_network_deinit(void);
+cy_rslt_t cy_http_server_create(cy_network_interface_t *interface, uint16_t port, uint16_t max_connection, void *security_info, cy_http_server_t *server_handle);
+cy_rslt_t cy_http_server_delete(cy_http_server_t server_handle);
+cy_rslt_t cy_http_server_start(cy_http_server_t server_handle);
+cy_rslt_t cy_http_server_stop(cy_http_server_t server_handle);
+cy_rslt_t cy_http_server_register_resource(cy_http_server_t server_handle, uint8_t *url, uint8_t *mime_type, cy_url_resource_type url_resource_type, void *resource_data);
+cy_rslt_t cy_http_server_response_stream_enable_chunked_transfer(cy_http_response_stream_t *stream);
+cy_rslt_t cy_http_server_response_stream_disable_chunked_transfer(cy_http_response_stream_t *stream);
+cy_rslt_t cy_http_server_response_stream_write_header(cy_http_response_stream_t *stream, cy_http_status_codes_t status_code, uint32_t content_length, cy_http_cache_t cache_type, cy_http_mime_type_t mime_type);
+cy_rslt_t cy_http_server_response_stream_write_payload(cy_http_response_stream_t *stream, const void *data, uint32_t length);
+cy_rslt_t cy_http_server_response_stream_flush(cy_http_response_stream_t *stream);
+cy_rslt_t cy_http_server_response_stream_disconnect(cy_http_response_stream_t *stream);
+cy_rslt_t cy_http_server_response_stream_disconnect_all(cy_http_server_t server);
+cy_rslt_t cy_http_server_get_query_parameter_value(const char *url_query, const char *parameter_key, char **parameter_value, uint32_t *value_length);
+
+#endif /* STUB_CY_HTTP_SERVER_H */
@@ -0,0 +1,9 @@
+/* Host stub of cy_network_mw_core.h: only the declarations used by the modules in source. */
+#ifndef STUB_CY_NETWORK_MW_CORE_H
+#define STUB_CY_NETWORK_MW_CORE_H
+
+#include <stdint.h>
+typedef enum { CY_NETWORK_WIFI_STA_INTERFACE, CY_NETWORK_WIFI_AP_INTERFACE } cy_network_hw_interface_type_t;
+void *cy_network_get_nw_interface(cy_network_hw_interface_type_t iface_type, uint8_t iface_idx);
+
+#endif /* STUB_CY_NETWORK_MW_CORE_H */
@@ -0,0 +1,9 @@
+/* Host stub of cy_pdl.h: only the declarations used by the modules in source. */
+#ifndef STUB_CY_PDL_H
+#define STUB_CY_PDL_H
+
+#include "cy_result.h"
+#define __enable_irq()
+#define __WEAK __attribute__((weak))
+
+#endif /* STUB_CY_PDL_H */
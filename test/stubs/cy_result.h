@@ -0,0 +1,18 @@
+/* Host stub of cy_result.h: only the declarations used by the modules in source. */
+#ifndef STUB_CY_RESULT_H
+#define STUB_CY_RESULT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+typedef uint32_t cy_rslt_t;
+#define CY_RSLT_SUCCESS ((cy_rslt_t)0)
+#define CY_RSLT_TYPE_ERROR 2
+#define CY_RSLT_MODULE_ABSTRACTION_OS 0x100
+#define CY_RSLT_CREATE(t,m,c) ((cy_rslt_t)(((t)<<16)|((m)<<18)|(c)))
+#define CY_RSLT_GET_CODE(r) ((r)&0xffff)
+#define CY_ASSERT(x) do{ if(!(x)){} }while(0)
+#define CY_UNUSED_PARAMETER(x) (void)(x)
+#define CY_RSLT_MODULE_APP_BASE 0x1000
+
+#endif /* STUB_CY_RESULT_H */
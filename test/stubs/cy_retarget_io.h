@@ -0,0 +1,10 @@
+/* Host stub of cy_retarget_io.h: only the declarations used by the modules in source. */
+#ifndef STUB_CY_RETARGET_IO_H
+#define STUB_CY_RETARGET_IO_H
+
+#include <stdio.h>
+#include "cy_result.h"
+#define CY_RETARGET_IO_BAUDRATE 115200
+cy_rslt_t cy_retarget_io_init(int tx, int rx, int baud);
+
+#endif /* STUB_CY_RETARGET_IO_H */
@@ -0,0 +1,51 @@
+/* Host stub of cy_secure_sockets.h: only the declarations used by the modules in source. */
+#ifndef STUB_CY_SECURE_SOCKETS_H
+#define STUB_CY_SECURE_SOCKETS_H
+
+#include "cy_result.h"
+typedef void* cy_socket_t;
+#define CY_SOCKET_INVALID_HANDLE ((cy_socket_t)0)
+typedef enum { CY_SOCKET_IP_VER_V4 = 4, CY_SOCKET_IP_VER_V6 = 6 } cy_socket_ip_version_t;
+typedef struct { cy_socket_ip_version_t version; union { uint32_t v4; uint32_t v6[4]; } ip; } cy_socket_ip_address_t;
+typedef struct { uint16_t port; cy_socket_ip_address_t ip_address; } cy_socket_sockaddr_t;
+typedef struct { cy_socket_ip_address_t multi_addr; cy_socket_ip_address_t if_addr; } cy_socket_ip_mreq_t;
+typedef cy_rslt_t (*cy_socket_callback_t)(cy_socket_t socket_handle, void *arg);
+typedef struct { cy_socket_callback_t callback; void *arg; } cy_socket_opt_callback_t;
+#define CY_SOCKET_DOMAIN_AF_INET 1
+#define CY_SOCKET_TYPE_STREAM 1
+#define CY_SOCKET_TYPE_DGRAM 2
+#define CY_SOCKET_IPPROTO_TCP 1
+#define CY_SOCKET_IPPROTO_UDP 2
+#define CY_SOCKET_SOL_SOCKET 1
+#define CY_SOCKET_SOL_TCP 2
+#define CY_SOCKET_SOL_IP 3
+#define CY_SOCKET_SO_RCVTIMEO 1
+#define CY_SOCKET_SO_SNDTIMEO 2
+#define CY_SOCKET_SO_RECEIVE_CALLBACK 3
+#define CY_SOCKET_SO_CONNECT_REQUEST_CALLBACK 4
+#define CY_SOCKET_SO_DISCONNECT_CALLBACK 5
+#define CY_SOCKET_SO_JOIN_MULTICAST_GROUP 6
+#define CY_SOCKET_SO_IP_MULTICAST_TTL 7
+#define CY_SOCKET_SO_TCP_NODELAY 8
+#define CY_SOCKET_FLAGS_NONE 0
+#define CY_SOCKET_NEVER_TIMEOUT 0xFFFFFFFFUL
+#define CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT CY_RSLT_CREATE(2, 0x900, 1)
+#define CY_RSLT_MODULE_SECURE_SOCKETS_CLOSED CY_RSLT_CREATE(2, 0x900, 2)
+#define CY_RSLT_MODULE_SECURE_SOCKETS_WOULDBLOCK CY_RSLT_CREATE(2, 0x900, 3)
+cy_rslt_t cy_socket_init(void);
+cy_rslt_t cy_socket_create(int domain, int type, int protocol, cy_socket_t *handle);
+cy_rslt_t cy_socket_setsockopt(cy_socket_t handle, int level, int optname, const void *optval, uint32_t optlen);
+cy_rslt_t cy_socket_bind(cy_socket_t handle, cy_socket_sockaddr_t *address, uint32_t address_length);
+cy_rslt_t cy_socket_listen(cy_socket_t handle, int backlog);
+cy_rslt_t cy_socket_accept(cy_socket_t handle, cy_socket_sockaddr_t *address, uint32_t *address_length, cy_socket_t *socket);
+cy_rslt_t cy_socket_send(cy_socket_t handle, const void *buffer, uint32_t length, int flags, uint32_t *bytes_sent);
+cy_rslt_t cy_socket_recv(cy_socket_t handle, void *buffer, uint32_t length, int flags, uint32_t *bytes_received);
+cy_rslt_t cy_socket_sendto(cy_socket_t handle, const void *buffer, uint32_t length, int flags, const cy_socket_sockaddr_t *dest_addr, uint32_t address_length, uint32_t *bytes_sent);
+cy_rslt_t cy_socket_recvfrom(cy_socket_t handle, void *buffer, uint32_t length, int flags, cy_socket_sockaddr_t *src_addr, uint32_t *src_addr_length, uint32_t *bytes_received);
+cy_rslt_t cy_socket_disconnect(cy_socket_t handle, uint32_t timeout);
+cy_rslt_t cy_socket_delete(cy_socket_t handle);
+
+/* Host only: POSIX socket of a handle, see host_sockets.c. */
+int host_socket_fd(cy_socket_t handle);
+
+#endif /* STUB_CY_SECURE_SOCKETS_H */
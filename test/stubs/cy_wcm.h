@@ -0,0 +1,55 @@
+/* Host stub of cy_wcm.h: only the declarations used by the modules in source. */
+#ifndef STUB_CY_WCM_H
+#define STUB_CY_WCM_H
+
+#include "cy_result.h"
+#include "cyabs_rtos.h"
+#define CY_WCM_MAX_SSID_LEN 32
+#define CY_WCM_MAX_PASSPHRASE_LEN 64
+#define CY_WCM_MAC_ADDR_LEN 6
+typedef uint8_t cy_wcm_mac_t[CY_WCM_MAC_ADDR_LEN];
+typedef uint8_t cy_wcm_ssid_t[CY_WCM_MAX_SSID_LEN + 1];
+typedef uint8_t cy_wcm_passphrase_t[CY_WCM_MAX_PASSPHRASE_LEN + 1];
+typedef enum { CY_WCM_INTERFACE_TYPE_STA = 0, CY_WCM_INTERFACE_TYPE_AP, CY_WCM_INTERFACE_TYPE_AP_STA } cy_wcm_interface_t;
+typedef enum { CY_WCM_SECURITY_OPEN = 0, CY_WCM_SECURITY_WEP_PSK, CY_WCM_SECURITY_WPA_AES_PSK, CY_WCM_SECURITY_WPA2_AES_PSK, CY_WCM_SECURITY_WPA2_MIXED_PSK, CY_WCM_SECURITY_WPA2_TKIP_PSK, CY_WCM_SECURITY_WPA3_SAE, CY_WCM_SECURITY_WPA3_WPA2_PSK, CY_WCM_SECURITY_WPA_MIXED_PSK, CY_WCM_SECURITY_WPA_TKIP_PSK, CY_WCM_SECURITY_UNKNOWN = -1 } cy_wcm_security_t;
+typedef enum { CY_WCM_WIFI_BAND_ANY = 0, CY_WCM_WIFI_BAND_2_4GHZ, CY_WCM_WIFI_BAND_5GHZ, CY_WCM_WIFI_BAND_6GHZ } cy_wcm_wifi_band_t;
+typedef enum { CY_WCM_IP_VER_V4 = 4, CY_WCM_IP_VER_V6 = 6 } cy_wcm_ip_version_t;
+typedef struct { cy_wcm_ip_version_t version; union { uint32_t v4; uint32_t v6[4]; } ip; } cy_wcm_ip_address_t;
+typedef struct { cy_wcm_ip_address_t ip_address; cy_wcm_ip_address_t gateway; cy_wcm_ip_address_t netmask; } cy_wcm_ip_setting_t;
+typedef struct { cy_wcm_ssid_t SSID; cy_wcm_passphrase_t password; cy_wcm_security_t security; } cy_wcm_ap_credentials_t;
+typedef struct { cy_wcm_ap_credentials_t ap_credentials; cy_wcm_mac_t BSSID; cy_wcm_ip_setting_t *static_ip_settings; cy_wcm_wifi_band_t band; } cy_wcm_connect_params_t;
+typedef struct { uint8_t data_length; uint8_t *data; } cy_wcm_custom_ie_info_t;
+typedef struct { cy_wcm_ap_credentials_t ap_credentials; cy_wcm_ip_setting_t ip_settings; uint8_t channel; cy_wcm_custom_ie_info_t *ie_info; cy_wcm_wifi_band_t band; } cy_wcm_ap_config_t;
+typedef struct { cy_wcm_interface_t interface; } cy_wcm_config_t;
+typedef enum { CY_WCM_SCAN_INCOMPLETE, CY_WCM_SCAN_COMPLETE } cy_wcm_scan_status_t;
+typedef enum { CY_WCM_BSS_TYPE_INFRASTRUCTURE, CY_WCM_BSS_TYPE_ADHOC, CY_WCM_BSS_TYPE_ANY, CY_WCM_BSS_TYPE_MESH, CY_WCM_BSS_TYPE_UNKNOWN } cy_wcm_bss_type_t;
+typedef struct { cy_wcm_ssid_t SSID; cy_wcm_mac_t BSSID; int16_t signal_strength; uint32_t max_data_rate; cy_wcm_bss_type_t bss_type; cy_wcm_security_t security; uint8_t channel; cy_wcm_wifi_band_t band; uint8_t ccode[2]; uint8_t flags; uint8_t *ie_ptr; uint32_t ie_len; } cy_wcm_scan_result_t;
+typedef void (*cy_wcm_scan_result_callback_t)(cy_wcm_scan_result_t *result_ptr, void *user_data, cy_wcm_scan_status_t status);
+typedef enum { CY_WCM_SCAN_FILTER_TYPE_SSID = 0, CY_WCM_SCAN_FILTER_TYPE_MAC, CY_WCM_SCAN_FILTER_TYPE_BAND, CY_WCM_SCAN_FILTER_TYPE_RSSI } cy_wcm_scan_filter_type_t;
+typedef enum { CY_WCM_SCAN_RSSI_FAIR = -90, CY_WCM_SCAN_RSSI_GOOD = -60, CY_WCM_SCAN_RSSI_EXCELLENT = -50 } cy_wcm_scan_rssi_range_t;
+typedef struct { cy_wcm_scan_filter_type_t mode; union { cy_wcm_ssid_t SSID; cy_wcm_mac_t BSSID; cy_wcm_wifi_band_t band; cy_wcm_scan_rssi_range_t rssi_range; } param; } cy_wcm_scan_filter_t;
+typedef struct { cy_wcm_ssid_t SSID; cy_wcm_mac_t BSSID; int16_t signal_strength; uint8_t channel; uint8_t channel_width; cy_wcm_security_t security; uint32_t max_data_rate; } cy_wcm_associated_ap_info_t;
+typedef struct { uint32_t rx_bytes; uint32_t tx_bytes; uint32_t rx_packets; uint32_t tx_packets; uint32_t tx_failed; uint32_t tx_retries; uint32_t tx_bitrate; uint32_t rx_bitrate; } cy_wcm_wlan_statistics_t;
+typedef enum { CY_WCM_EVENT_CONNECTING = 0, CY_WCM_EVENT_CONNECTED, CY_WCM_EVENT_CONNECT_FAILED, CY_WCM_EVENT_RECONNECTED, CY_WCM_EVENT_DISCONNECTED, CY_WCM_EVENT_IP_CHANGED, CY_WCM_EVENT_INITIATED_RETRY, CY_WCM_EVENT_STA_JOINED_SOFTAP, CY_WCM_EVENT_STA_LEFT_SOFTAP } cy_wcm_event_t;
+typedef enum { CY_WCM_REASON_UNKNOWN = 0, CY_WCM_REASON_AUTH_FAILED, CY_WCM_REASON_NETWORK_NOT_FOUND } cy_wcm_reason_code;
+typedef union { cy_wcm_reason_code reason; cy_wcm_ip_address_t ip_addr; struct { cy_wcm_mac_t sta_mac; } sta; } cy_wcm_event_data_t;
+typedef void (*cy_wcm_event_callback_t)(cy_wcm_event_t event, cy_wcm_event_data_t *event_data);
+cy_rslt_t cy_wcm_init(cy_wcm_config_t *config);
+cy_rslt_t cy_wcm_start_ap(const cy_wcm_ap_config_t *ap_config);
+cy_rslt_t cy_wcm_stop_ap(void);
+cy_rslt_t cy_wcm_get_ip_addr(cy_wcm_interface_t interface_type, cy_wcm_ip_address_t *ip_addr);
+cy_rslt_t cy_wcm_get_gateway_ip_address(cy_wcm_interface_t interface_type, cy_wcm_ip_address_t *gateway_addr);
+cy_rslt_t cy_wcm_get_ip_netmask(cy_wcm_interface_t interface_type, cy_wcm_ip_address_t *net_mask_addr);
+cy_rslt_t cy_wcm_connect_ap(cy_wcm_connect_params_t *connect_params, cy_wcm_ip_address_t *ip_addr);
+cy_rslt_t cy_wcm_disconnect_ap(void);
+uint8_t cy_wcm_is_connected_to_ap(void);
+cy_rslt_t cy_wcm_start_scan(cy_wcm_scan_result_callback_t scan_callback, void *user_data, cy_wcm_scan_filter_t *scan_filter);
+cy_rslt_t cy_wcm_stop_scan(void);
+cy_rslt_t cy_wcm_get_associated_ap_info(cy_wcm_associated_ap_info_t *ap_info);
+cy_rslt_t cy_wcm_get_wlan_statistics(cy_wcm_interface_t interface, cy_wcm_wlan_statistics_t *stat);
+cy_rslt_t cy_wcm_register_event_callback(cy_wcm_event_callback_t event_callback);
+cy_rslt_t cy_wcm_deregister_event_callback(cy_wcm_event_callback_t event_callback);
+cy_rslt_t cy_wcm_get_associated_client_list(cy_wcm_mac_t *client_mac_list, uint8_t num_clients);
+cy_rslt_t cy_wcm_get_mac_addr(cy_wcm_interface_t interface_type, cy_wcm_mac_t *mac_addr);
+
+#endif /* STUB_CY_WCM_H */
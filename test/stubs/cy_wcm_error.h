@@ -0,0 +1,24 @@
+/* Host stub of cy_wcm_error.h: only the declarations used by the modules in source. */
+#ifndef STUB_CY_WCM_ERROR_H
+#define STUB_CY_WCM_ERROR_H
+
+#include "cy_result.h"
+#define CY_RSLT_MODULE_WCM_BASE 0x800
+#define CY_RSLT_WCM_WAIT_TIMEOUT CY_RSLT_CREATE(2, 0x800, 1)
+#define CY_RSLT_WCM_BAD_NETWORK_PARAM CY_RSLT_CREATE(2, 0x800, 2)
+#define CY_RSLT_WCM_BAD_SSID_LEN CY_RSLT_CREATE(2, 0x800, 3)
+#define CY_RSLT_WCM_SECURITY_NOT_SUPPORTED CY_RSLT_CREATE(2, 0x800, 4)
+#define CY_RSLT_WCM_BAD_PASSPHRASE_LEN CY_RSLT_CREATE(2, 0x800, 5)
+#define CY_RSLT_WCM_BSP_INIT_ERROR CY_RSLT_CREATE(2, 0x800, 6)
+#define CY_RSLT_WCM_NETWORK_DOWN CY_RSLT_CREATE(2, 0x800, 7)
+#define CY_RSLT_WCM_SCAN_IN_PROGRESS CY_RSLT_CREATE(2, 0x800, 8)
+#define CY_RSLT_WCM_SCAN_ERROR CY_RSLT_CREATE(2, 0x800, 9)
+#define CY_RSLT_WCM_STA_DISCONNECT_ERROR CY_RSLT_CREATE(2, 0x800, 10)
+#define CY_RSLT_WCM_STA_CONNECT_ERROR CY_RSLT_CREATE(2, 0x800, 11)
+#define CY_RSLT_WCM_BAD_ARG CY_RSLT_CREATE(2, 0x800, 12)
+#define CY_RSLT_WCM_INTERFACE_NOT_SUPPORTED CY_RSLT_CREATE(2, 0x800, 13)
+#define CY_RSLT_WCM_OUT_OF_MEMORY CY_RSLT_CREATE(2, 0x800, 16)
+#define CY_RSLT_WCM_NOT_INITIALIZED CY_RSLT_CREATE(2, 0x800, 17)
+#define CY_RSLT_WCM_DHCP_TIMEOUT CY_RSLT_CREATE(2, 0x800, 20)
+
+#endif /* STUB_CY_WCM_ERROR_H */
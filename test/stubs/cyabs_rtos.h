@@ -0,0 +1,38 @@
+/* Host stub of cyabs_rtos.h: the RTOS abstraction on POSIX threads, see
+ * host_rtos.c.
+ */
+#ifndef STUB_CYABS_RTOS_H
+#define STUB_CYABS_RTOS_H
+
+#include <pthread.h>
+#include "cy_result.h"
+
+typedef void* cy_thread_arg_t;
+typedef void (*cy_thread_entry_fn_t)(cy_thread_arg_t arg);
+typedef pthread_t cy_thread_t;
+typedef pthread_mutex_t cy_mutex_t;
+typedef struct { pthread_mutex_t lock; pthread_cond_t cond; uint32_t count; uint32_t maxcount; } cy_semaphore_t;
+typedef struct { pthread_mutex_t lock; pthread_cond_t cond; uint8_t *items; size_t length; size_t itemsize; size_t head; size_t count; } cy_queue_t;
+typedef uint32_t cy_time_t;
+typedef enum { CY_RTOS_PRIORITY_MIN, CY_RTOS_PRIORITY_LOW, CY_RTOS_PRIORITY_BELOWNORMAL, CY_RTOS_PRIORITY_NORMAL, CY_RTOS_PRIORITY_ABOVENORMAL, CY_RTOS_PRIORITY_HIGH } cy_thread_priority_t;
+#define CY_RTOS_NEVER_TIMEOUT (0xFFFFFFFFUL)
+#define CY_RTOS_TIMEOUT CY_RSLT_CREATE(2, 0x100, 0)
+cy_rslt_t cy_rtos_thread_create(cy_thread_t *thread, cy_thread_entry_fn_t entry_function, const char *name, void *stack, uint32_t stack_size, cy_thread_priority_t priority, cy_thread_arg_t arg);
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms);
+cy_rslt_t cy_rtos_get_time(cy_time_t *tval);
+cy_rslt_t cy_rtos_init_mutex(cy_mutex_t *mutex);
+cy_rslt_t cy_rtos_get_mutex(cy_mutex_t *mutex, cy_time_t timeout_ms);
+cy_rslt_t cy_rtos_set_mutex(cy_mutex_t *mutex);
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t *sem, uint32_t maxcount, uint32_t initcount);
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t *sem, cy_time_t timeout_ms, bool in_isr);
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t *sem, bool in_isr);
+cy_rslt_t cy_rtos_init_queue(cy_queue_t *queue, size_t length, size_t itemsize);
+cy_rslt_t cy_rtos_put_queue(cy_queue_t *queue, const void *item_ptr, cy_time_t timeout_ms, bool in_isr);
+cy_rslt_t cy_rtos_get_queue(cy_queue_t *queue, void *item_ptr, cy_time_t timeout_ms, bool in_isr);
+
+/* Offset added to the time of cy_rtos_get_time(), so that a test can
+ * advance the clock without waiting.
+ */
+extern cy_time_t host_rtos_time_offset;
+
+#endif /* STUB_CYABS_RTOS_H */
@@ -0,0 +1,14 @@
+/* Host stub of cybsp.h: only the declarations used by the modules in source. */
+#ifndef STUB_CYBSP_H
+#define STUB_CYBSP_H
+
+#include "cy_result.h"
+#define CYBSP_USER_LED 1
+#define CYBSP_USER_BTN 2
+#define CYBSP_LED_STATE_OFF 0
+#define CYBSP_BTN_OFF 1
+#define CYBSP_DEBUG_UART_TX 3
+#define CYBSP_DEBUG_UART_RX 4
+cy_rslt_t cybsp_init(void);
+
+#endif /* STUB_CYBSP_H */
@@ -0,0 +1,19 @@
+/* Host stub of cyhal.h: only the declarations used by the modules in source. */
+#ifndef STUB_CYHAL_H
+#define STUB_CYHAL_H
+
+#include "cy_result.h"
+#include "cyhal_gpio.h"
+typedef struct { int x; } cyhal_flash_t;
+typedef struct { uint32_t start_address; uint32_t size; uint32_t sector_size; uint32_t page_size; uint8_t erase_value; } cyhal_flash_block_info_t;
+typedef struct { uint8_t block_count; const cyhal_flash_block_info_t *blocks; } cyhal_flash_info_t;
+cy_rslt_t cyhal_flash_init(cyhal_flash_t *obj);
+void cyhal_flash_free(cyhal_flash_t *obj);
+void cyhal_flash_get_info(const cyhal_flash_t *obj, cyhal_flash_info_t *info);
+cy_rslt_t cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size);
+cy_rslt_t cyhal_flash_erase(cyhal_flash_t *obj, uint32_t address);
+cy_rslt_t cyhal_flash_write(cyhal_flash_t *obj, uint32_t address, const uint32_t *data);
+cy_rslt_t cyhal_flash_program(cyhal_flash_t *obj, uint32_t address, const uint32_t *data);
+uint32_t cyhal_trng_generate(void *obj);
+
+#endif /* STUB_CYHAL_H */
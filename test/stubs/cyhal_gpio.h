@@ -0,0 +1,17 @@
+/* Host stub of cyhal_gpio.h: only the declarations used by the modules in source. */
+#ifndef STUB_CYHAL_GPIO_H
+#define STUB_CYHAL_GPIO_H
+
+#include "cy_result.h"
+typedef int cyhal_gpio_t;
+typedef enum { CYHAL_GPIO_IRQ_NONE, CYHAL_GPIO_IRQ_RISE, CYHAL_GPIO_IRQ_FALL } cyhal_gpio_event_t;
+typedef enum { CYHAL_GPIO_DIR_INPUT, CYHAL_GPIO_DIR_OUTPUT } cyhal_gpio_direction_t;
+typedef enum { CYHAL_GPIO_DRIVE_NONE, CYHAL_GPIO_DRIVE_PULLUP, CYHAL_GPIO_DRIVE_STRONG } cyhal_gpio_drive_mode_t;
+typedef void (*cyhal_gpio_event_callback_t)(void *arg, cyhal_gpio_event_t event);
+typedef struct { cyhal_gpio_event_callback_t callback; void *callback_arg; void *next; cyhal_gpio_t pin; } cyhal_gpio_callback_data_t;
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction, cyhal_gpio_drive_mode_t drive_mode, bool init_val);
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data);
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority, bool enable);
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value);
+
+#endif /* STUB_CYHAL_GPIO_H */
@@ -0,0 +1,225 @@
+/* Host implementation of the RTOS abstraction used by the modules in source,
+ * on POSIX threads. Mutexes are recursive, as with the RTOS.
+ */
+#include "cyabs_rtos.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+cy_time_t host_rtos_time_offset = 0;
+
+typedef struct
+{
+    cy_thread_entry_fn_t entry_function;
+    cy_thread_arg_t arg;
+} host_thread_start_t;
+
+static void *host_thread_entry(void *arg)
+{
+    host_thread_start_t start = *(host_thread_start_t *)arg;
+
+    free(arg);
+    start.entry_function(start.arg);
+    return NULL;
+}
+
+/* Converts a timeout from now to the absolute time of pthread_cond_timedwait. */
+static struct timespec host_deadline(cy_time_t timeout_ms)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000u;
+    deadline.tv_nsec += (long)(timeout_ms % 1000u) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+/* Waits on a condition until signaled, or until the deadline unless the
+ * timeout is CY_RTOS_NEVER_TIMEOUT. Returns false on timeout.
+ */
+static bool host_wait(pthread_cond_t *cond, pthread_mutex_t *lock, cy_time_t timeout_ms,
+                      const struct timespec *deadline)
+{
+    if (CY_RTOS_NEVER_TIMEOUT == timeout_ms)
+    {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return ETIMEDOUT != pthread_cond_timedwait(cond, lock, deadline);
+}
+
+cy_rslt_t cy_rtos_thread_create(cy_thread_t *thread, cy_thread_entry_fn_t entry_function, const char *name,
+                                void *stack, uint32_t stack_size, cy_thread_priority_t priority, cy_thread_arg_t arg)
+{
+    host_thread_start_t *start = malloc(sizeof(*start));
+    (void)name;
+    (void)stack;
+    (void)stack_size;
+    (void)priority;
+
+    start->entry_function = entry_function;
+    start->arg = arg;
+    if (0 != pthread_create(thread, NULL, host_thread_entry, start))
+    {
+        free(start);
+        return CY_RSLT_TYPE_ERROR;
+    }
+    pthread_detach(*thread);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms)
+{
+    struct timespec delay = { (time_t)(num_ms / 1000u), (long)(num_ms % 1000u) * 1000000L };
+
+    nanosleep(&delay, NULL);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_get_time(cy_time_t *tval)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    *tval = (cy_time_t)((uint64_t)now.tv_sec * 1000u + (uint64_t)now.tv_nsec / 1000000u) + host_rtos_time_offset;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_init_mutex(cy_mutex_t *mutex)
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_get_mutex(cy_mutex_t *mutex, cy_time_t timeout_ms)
+{
+    (void)timeout_ms;
+
+    pthread_mutex_lock(mutex);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_set_mutex(cy_mutex_t *mutex)
+{
+    pthread_mutex_unlock(mutex);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t *sem, uint32_t maxcount, uint32_t initcount)
+{
+    pthread_mutex_init(&sem->lock, NULL);
+    pthread_cond_init(&sem->cond, NULL);
+    sem->count = initcount;
+    sem->maxcount = maxcount;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t *sem, cy_time_t timeout_ms, bool in_isr)
+{
+    struct timespec deadline = host_deadline(timeout_ms);
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    (void)in_isr;
+
+    pthread_mutex_lock(&sem->lock);
+    while ((0 == sem->count) && (CY_RSLT_SUCCESS == result))
+    {
+        if (!host_wait(&sem->cond, &sem->lock, timeout_ms, &deadline))
+        {
+            result = CY_RTOS_TIMEOUT;
+        }
+    }
+    if (CY_RSLT_SUCCESS == result)
+    {
+        sem->count--;
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return result;
+}
+
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t *sem, bool in_isr)
+{
+    (void)in_isr;
+
+    pthread_mutex_lock(&sem->lock);
+    if (sem->count < sem->maxcount)
+    {
+        sem->count++;
+    }
+    pthread_cond_broadcast(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_init_queue(cy_queue_t *queue, size_t length, size_t itemsize)
+{
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->cond, NULL);
+    queue->items = calloc(length, itemsize);
+    queue->length = length;
+    queue->itemsize = itemsize;
+    queue->head = 0;
+    queue->count = 0;
+    return (NULL == queue->items) ? CY_RSLT_TYPE_ERROR : CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_rtos_put_queue(cy_queue_t *queue, const void *item_ptr, cy_time_t timeout_ms, bool in_isr)
+{
+    struct timespec deadline = host_deadline(timeout_ms);
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    (void)in_isr;
+
+    pthread_mutex_lock(&queue->lock);
+    while ((queue->count == queue->length) && (CY_RSLT_SUCCESS == result))
+    {
+        if ((0 == timeout_ms) || !host_wait(&queue->cond, &queue->lock, timeout_ms, &deadline))
+        {
+            result = CY_RTOS_TIMEOUT;
+        }
+    }
+    if (CY_RSLT_SUCCESS == result)
+    {
+        memcpy(&queue->items[((queue->head + queue->count) % queue->length) * queue->itemsize], item_ptr,
+               queue->itemsize);
+        queue->count++;
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
+
+cy_rslt_t cy_rtos_get_queue(cy_queue_t *queue, void *item_ptr, cy_time_t timeout_ms, bool in_isr)
+{
+    struct timespec deadline = host_deadline(timeout_ms);
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    (void)in_isr;
+
+    pthread_mutex_lock(&queue->lock);
+    while ((0 == queue->count) && (CY_RSLT_SUCCESS == result))
+    {
+        if ((0 == timeout_ms) || !host_wait(&queue->cond, &queue->lock, timeout_ms, &deadline))
+        {
+            result = CY_RTOS_TIMEOUT;
+        }
+    }
+    if (CY_RSLT_SUCCESS == result)
+    {
+        memcpy(item_ptr, &queue->items[queue->head * queue->itemsize], queue->itemsize);
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->cond);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return result;
+}
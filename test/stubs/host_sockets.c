@@ -0,0 +1,154 @@
+/* Host implementation of the secure sockets calls used by the modules in
+ * source, on POSIX TCP sockets. The socket callbacks are accepted but never
+ * called; the tests call the receive paths themselves.
+ */
+#include "cy_secure_sockets.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define HOST_SOCKET(handle)                          ((int)(intptr_t)(handle) - 1)
+#define HOST_HANDLE(fd)                              ((cy_socket_t)(intptr_t)((fd) + 1))
+
+static cy_rslt_t host_socket_error(void)
+{
+    if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+    {
+        return CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT;
+    }
+    return CY_RSLT_MODULE_SECURE_SOCKETS_CLOSED;
+}
+
+int host_socket_fd(cy_socket_t handle)
+{
+    return HOST_SOCKET(handle);
+}
+
+cy_rslt_t cy_socket_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_create(int domain, int type, int protocol, cy_socket_t *handle)
+{
+    int fd = socket(AF_INET, (CY_SOCKET_TYPE_DGRAM == type) ? SOCK_DGRAM : SOCK_STREAM, 0);
+    int enable = 1;
+    (void)domain;
+    (void)protocol;
+
+    if (fd < 0)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    *handle = HOST_HANDLE(fd);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_setsockopt(cy_socket_t handle, int level, int optname, const void *optval, uint32_t optlen)
+{
+    struct timeval timeout;
+    int enable = 1;
+    (void)level;
+    (void)optlen;
+
+    switch (optname)
+    {
+    case CY_SOCKET_SO_RCVTIMEO:
+    case CY_SOCKET_SO_SNDTIMEO:
+        timeout.tv_sec = *(const uint32_t *)optval / 1000u;
+        timeout.tv_usec = (*(const uint32_t *)optval % 1000u) * 1000u;
+        setsockopt(HOST_SOCKET(handle), SOL_SOCKET, (CY_SOCKET_SO_RCVTIMEO == optname) ? SO_RCVTIMEO : SO_SNDTIMEO,
+                   &timeout, sizeof(timeout));
+        break;
+
+    case CY_SOCKET_SO_TCP_NODELAY:
+        setsockopt(HOST_SOCKET(handle), IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        break;
+
+    default:
+        break;
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_bind(cy_socket_t handle, cy_socket_sockaddr_t *address, uint32_t address_length)
+{
+    struct sockaddr_in addr = { 0 };
+    (void)address_length;
+
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(address->port);
+    addr.sin_addr.s_addr = address->ip_address.ip.v4;
+    return (0 == bind(HOST_SOCKET(handle), (struct sockaddr *)&addr, sizeof(addr))) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
+
+cy_rslt_t cy_socket_listen(cy_socket_t handle, int backlog)
+{
+    return (0 == listen(HOST_SOCKET(handle), backlog)) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
+
+cy_rslt_t cy_socket_accept(cy_socket_t handle, cy_socket_sockaddr_t *address, uint32_t *address_length,
+                           cy_socket_t *socket)
+{
+    struct sockaddr_in addr;
+    socklen_t addr_length = sizeof(addr);
+    int fd = accept(HOST_SOCKET(handle), (struct sockaddr *)&addr, &addr_length);
+
+    if (fd < 0)
+    {
+        return host_socket_error();
+    }
+    address->port = ntohs(addr.sin_port);
+    address->ip_address.version = CY_SOCKET_IP_VER_V4;
+    address->ip_address.ip.v4 = addr.sin_addr.s_addr;
+    *address_length = sizeof(*address);
+    *socket = HOST_HANDLE(fd);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_send(cy_socket_t handle, const void *buffer, uint32_t length, int flags, uint32_t *bytes_sent)
+{
+    ssize_t sent = send(HOST_SOCKET(handle), buffer, length, MSG_NOSIGNAL);
+    (void)flags;
+
+    if (sent < 0)
+    {
+        return host_socket_error();
+    }
+    *bytes_sent = (uint32_t)sent;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_recv(cy_socket_t handle, void *buffer, uint32_t length, int flags, uint32_t *bytes_received)
+{
+    ssize_t received = recv(HOST_SOCKET(handle), buffer, length, 0);
+    (void)flags;
+
+    if (received < 0)
+    {
+        return host_socket_error();
+    }
+    *bytes_received = (uint32_t)received;
+    return (0 == received) ? CY_RSLT_MODULE_SECURE_SOCKETS_CLOSED : CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_disconnect(cy_socket_t handle, uint32_t timeout)
+{
+    (void)timeout;
+
+    shutdown(HOST_SOCKET(handle), SHUT_RDWR);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_delete(cy_socket_t handle)
+{
+    close(HOST_SOCKET(handle));
+    return CY_RSLT_SUCCESS;
+}
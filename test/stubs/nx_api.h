@@ -0,0 +1,12 @@
+/* Host stub of nx_api.h: only the declarations used by the modules in source. */
+#ifndef STUB_NX_API_H
+#define STUB_NX_API_H
+
+typedef unsigned long ULONG; typedef unsigned int UINT;
+typedef struct NX_PACKET_POOL_STRUCT { int x; } NX_PACKET_POOL;
+typedef struct NX_IP_STRUCT { NX_PACKET_POOL *nx_ip_default_packet_pool; } NX_IP;
+#define NX_SUCCESS 0
+#define NX_NULL 0
+UINT nx_packet_pool_info_get(NX_PACKET_POOL *pool_ptr, ULONG *total_packets, ULONG *free_packets, ULONG *empty_pool_requests, ULONG *empty_pool_suspensions, ULONG *invalid_packet_releases);
+
+#endif /* STUB_NX_API_H */
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * File Name: test_channel_select.c
+ *
+ * Description: Host test and benchmark of the SoftAP channel selection
+ *              against synthetic scan results: the congestion scores, the
+ *              channel picked, and the time to score a full scan cache.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "channel_select.h"
+#include "test_common.h"
+
+#include <string.h>
+
+/* Synthetic scans scored by the benchmark. */
+#define SYNTHETIC_SCANS                              (100000u)
+
+static void make_ap(scan_cache_entry_t *ap, uint8_t channel, int16_t rssi)
+{
+    memset(ap, 0, sizeof(*ap));
+    ap->channel = channel;
+    ap->rssi = rssi;
+    ap->band = (channel > 14u) ? CY_WCM_WIFI_BAND_5GHZ : CY_WCM_WIFI_BAND_2_4GHZ;
+}
+
+/* An AP weighs its level above the floor, less the further its channel. */
+static void test_score(void)
+{
+    scan_cache_entry_t aps[4];
+
+    make_ap(&aps[0], 6, -56);
+    TEST_CHECK(40u * 5u == channel_select_score(aps, 1, 6));
+    TEST_CHECK(40u * 4u == channel_select_score(aps, 1, 7));
+    TEST_CHECK(40u * 1u == channel_select_score(aps, 1, 2));
+    TEST_CHECK(0u == channel_select_score(aps, 1, 1));
+    TEST_CHECK(0u == channel_select_score(aps, 1, 11));
+
+    /* An AP below the floor still counts, and 5 GHz APs and APs without a
+     * channel do not.
+     */
+    make_ap(&aps[1], 6, -100);
+    make_ap(&aps[2], 36, -30);
+    make_ap(&aps[3], 0, -30);
+    TEST_CHECK((40u * 5u) + 5u == channel_select_score(aps, 4, 6));
+}
+
+/* The least congested of channels 1, 6 and 11 is picked; the first one on
+ * a tie, and channel 1 without any AP.
+ */
+static void test_pick(void)
+{
+    scan_cache_entry_t aps[6];
+    channel_select_stats_t stats;
+    uint32_t score;
+
+    TEST_CHECK(CHANNEL_SELECT_DEFAULT_CHANNEL == channel_select_pick(NULL, 0, &score));
+    TEST_CHECK(0u == score);
+
+    /* Channel 1 is crowded, and a strong AP on channel 10 overlaps 11. */
+    make_ap(&aps[0], 1, -40);
+    make_ap(&aps[1], 1, -70);
+    make_ap(&aps[2], 2, -60);
+    make_ap(&aps[3], 10, -45);
+    make_ap(&aps[4], 6, -85);
+    make_ap(&aps[5], 40, -20);
+    TEST_CHECK(6u == channel_select_pick(aps, 6, &score));
+    TEST_CHECK(channel_select_score(aps, 6, 6) == score);
+
+    channel_select_get_stats(&stats);
+    TEST_CHECK((6u == stats.channel) && (6u == stats.ap_count));
+    TEST_CHECK((1u == stats.channels[0]) && (6u == stats.channels[1]) && (11u == stats.channels[2]));
+    TEST_CHECK(score == stats.scores[1]);
+    TEST_CHECK((stats.scores[0] > score) && (stats.scores[2] > score));
+
+    /* The same AP on channels 1 and 11 leaves 6 free. */
+    make_ap(&aps[0], 1, -50);
+    make_ap(&aps[1], 11, -50);
+    TEST_CHECK(6u == channel_select_pick(aps, 2, &score));
+
+    make_ap(&aps[0], 6, -50);
+    TEST_CHECK(1u == channel_select_pick(aps, 2, &score));
+}
+
+/* The channel picked from random scans never scores above another
+ * candidate. Also times the selection over a full scan cache.
+ */
+static void test_synthetic_scans(void)
+{
+    static const uint8_t candidates[CHANNEL_SELECT_CANDIDATE_COUNT] = CHANNEL_SELECT_CANDIDATES;
+    scan_cache_entry_t aps[SCAN_CACHE_MAX_ENTRIES];
+    uint32_t score;
+    uint8_t channel;
+    uint64_t elapsed = 0;
+    uint64_t start;
+
+    for (uint32_t scan = 0; scan < SYNTHETIC_SCANS; scan++)
+    {
+        for (uint32_t index = 0; index < SCAN_CACHE_MAX_ENTRIES; index++)
+        {
+            make_ap(&aps[index], (uint8_t)((0 == test_random(4)) ? 36 : 1 + test_random(13)),
+                    (int16_t)(-30 - (int16_t)test_random(70)));
+        }
+
+        start = test_time_usec();
+        channel = channel_select_pick(aps, SCAN_CACHE_MAX_ENTRIES, &score);
+        elapsed += test_time_usec() - start;
+
+        for (uint32_t index = 0; index < CHANNEL_SELECT_CANDIDATE_COUNT; index++)
+        {
+            TEST_CHECK(score <= channel_select_score(aps, SCAN_CACHE_MAX_ENTRIES, candidates[index]));
+        }
+        TEST_CHECK(score == channel_select_score(aps, SCAN_CACHE_MAX_ENTRIES, channel));
+    }
+
+    printf("Picked a channel from %u APs in %.3f us on average\n", (unsigned int)SCAN_CACHE_MAX_ENTRIES,
+           (double)elapsed / SYNTHETIC_SCANS);
+}
+
+int main(void)
+{
+    test_random_seed(0xBB67AE85u);
+
+    test_score();
+    test_pick();
+    test_synthetic_scans();
+
+    return TEST_RESULT("channel_select");
+}
+
+/* [] END OF FILE */
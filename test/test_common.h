@@ -0,0 +1,115 @@
+/******************************************************************************
+* File Name: test_common.h
+*
+* Description: Minimal assertion helpers shared by the host tests of the
+*              modules in source.
+*
+********************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef TEST_COMMON_H_
+#define TEST_COMMON_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Number of failed checks of the test program. */
+static int test_failures = 0;
+
+/* Records a failed check with its location and continues. */
+#define TEST_CHECK(cond) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+/* Prints the result of the test program and returns its exit code. */
+#define TEST_RESULT(name) \
+    ((0 == test_failures) ? (printf("PASS %s\n", (name)), 0) : (printf("FAIL %s (%d)\n", (name), test_failures), 1))
+
+/* State of the pseudo-random generator of the randomized tests. Each program
+ * seeds it, so that its runs are repeatable.
+ */
+static uint32_t test_random_state = 1u;
+
+static inline void test_random_seed(uint32_t seed)
+{
+    test_random_state = (0u != seed) ? seed : 1u;
+}
+
+/* Returns a pseudo-random number below range, from a xorshift generator. */
+static inline uint32_t test_random(uint32_t range)
+{
+    test_random_state ^= test_random_state << 13;
+    test_random_state ^= test_random_state >> 17;
+    test_random_state ^= test_random_state << 5;
+    return test_random_state % range;
+}
+
+/* Monotonic time in microseconds, for the benchmarks. */
+static inline uint64_t test_time_usec(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000u) + ((uint64_t)now.tv_nsec / 1000u);
+}
+
+static inline int test_compare_u32(const void *a, const void *b)
+{
+    uint32_t value_a = *(const uint32_t *)a;
+    uint32_t value_b = *(const uint32_t *)b;
+
+    return (value_a > value_b) - (value_a < value_b);
+}
+
+/* Returns the given percentile of the values, which are sorted in place. */
+static inline uint32_t test_percentile(uint32_t *values, uint32_t count, uint32_t percent)
+{
+    if (0 == count)
+    {
+        return 0;
+    }
+    qsort(values, count, sizeof(values[0]), test_compare_u32);
+    return values[((count - 1) * percent) / 100u];
+}
+
+#endif /* TEST_COMMON_H_ */
+
+/* [] END OF FILE */
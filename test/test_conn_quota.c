@@ -0,0 +1,213 @@
+/*******************************************************************************
+ * File Name: test_conn_quota.c
+ *
+ * Description: Host test of the per-client connection quota: simulates
+ *              several client IPs opening and closing connections against one
+ *              listener.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "conn_quota.h"
+#include "test_common.h"
+
+/* Client IP addresses, in network byte order. */
+#define CLIENT_A                                     (0x0A01A8C0u)
+#define CLIENT_B                                     (0x0B01A8C0u)
+#define CLIENT_C                                     (0x0C01A8C0u)
+
+/* Limits of the WebSocket listener: 3 connections, 2 per client, 1 reserved. */
+#define MAX_CONNECTIONS                              (3u)
+#define MAX_PER_CLIENT                               (2u)
+#define RESERVED                                     (1u)
+
+static const conn_quota_client_t *find_client(const conn_quota_t *quota, uint32_t key)
+{
+    for (uint32_t index = 0; index < CONN_QUOTA_MAX_CLIENTS; index++)
+    {
+        if (key == quota->clients[index].key)
+        {
+            return &quota->clients[index];
+        }
+    }
+    return NULL;
+}
+
+/* A station with several pages cannot take the connection kept for the next one. */
+static void test_reserved_connection(void)
+{
+    conn_quota_t quota;
+
+    conn_quota_init(&quota, MAX_CONNECTIONS, MAX_PER_CLIENT, RESERVED);
+
+    TEST_CHECK(conn_quota_acquire(&quota, CLIENT_A));
+    TEST_CHECK(conn_quota_acquire(&quota, CLIENT_A));
+    TEST_CHECK(!conn_quota_acquire(&quota, CLIENT_A));
+    TEST_CHECK(conn_quota_acquire(&quota, CLIENT_B));
+    TEST_CHECK(!conn_quota_acquire(&quota, CLIENT_C));
+
+    conn_quota_release(&quota, CLIENT_B);
+    TEST_CHECK(!conn_quota_acquire(&quota, CLIENT_A));
+    conn_quota_release(&quota, CLIENT_A);
+    TEST_CHECK(conn_quota_acquire(&quota, CLIENT_B));
+    TEST_CHECK(!conn_quota_acquire(&quota, CLIENT_A));
+    TEST_CHECK(!conn_quota_acquire(&quota, CLIENT_B));
+    TEST_CHECK(conn_quota_acquire(&quota, CLIENT_C));
+
+    TEST_CHECK(3u == find_client(&quota, CLIENT_A)->rejected);
+    TEST_CHECK(1u == find_client(&quota, CLIENT_B)->rejected);
+    TEST_CHECK(1u == find_client(&quota, CLIENT_C)->rejected);
+    TEST_CHECK(5u == quota.rejected);
+    TEST_CHECK(3u == quota.connections);
+}
+
+/* The last free connection only goes to a client that holds none. */
+static void test_reserve_refused_to_holder(void)
+{
+    conn_quota_t quota;
+
+    conn_quota_init(&quota, MAX_CONNECTIONS, MAX_PER_CLIENT, RESERVED);
+
+    TEST_CHECK(conn_quota_acquire(&quota, CLIENT_A));
+    TEST_CHECK(conn_quota_acquire(&quota, CLIENT_B));
+    TEST_CHECK(!conn_quota_acquire(&quota, CLIENT_A));
+    TEST_CHECK(!conn_quota_acquire(&quota, CLIENT_B));
+    TEST_CHECK(conn_quota_acquire(&quota, CLIENT_C));
+
+    TEST_CHECK(3u == quota.connections);
+    TEST_CHECK(3u == quota.accepted);
+    TEST_CHECK(2u == quota.rejected);
+    TEST_CHECK(1u == find_client(&quota, CLIENT_A)->rejected);
+    TEST_CHECK(1u == find_client(&quota, CLIENT_B)->rejected);
+    TEST_CHECK(0u == find_client(&quota, CLIENT_C)->rejected);
+}
+
+/* A rejection counted before the quota is checked does not count as accepted. */
+static void test_reject_counts(void)
+{
+    conn_quota_t quota;
+
+    conn_quota_init(&quota, MAX_CONNECTIONS, MAX_PER_CLIENT, RESERVED);
+
+    conn_quota_reject(&quota, CLIENT_A);
+    conn_quota_reject(&quota, CLIENT_A);
+
+    TEST_CHECK(0u == quota.accepted);
+    TEST_CHECK(0u == quota.connections);
+    TEST_CHECK(2u == quota.rejected);
+    TEST_CHECK(2u == find_client(&quota, CLIENT_A)->rejected);
+}
+
+/* Clients without connections are forgotten when the table is full, and a
+ * release of an unknown client changes nothing.
+ */
+static void test_client_table(void)
+{
+    conn_quota_t quota;
+
+    conn_quota_init(&quota, MAX_CONNECTIONS, MAX_PER_CLIENT, RESERVED);
+
+    for (uint32_t key = 1; key <= 4u * CONN_QUOTA_MAX_CLIENTS; key++)
+    {
+        TEST_CHECK(conn_quota_acquire(&quota, key));
+        conn_quota_release(&quota, key);
+    }
+    TEST_CHECK(0u == quota.connections);
+    TEST_CHECK(4u * CONN_QUOTA_MAX_CLIENTS == quota.accepted);
+
+    conn_quota_release(&quota, CLIENT_C);
+    TEST_CHECK(0u == quota.connections);
+
+    /* With every entry holding a connection, a new client cannot be tracked. */
+    conn_quota_init(&quota, CONN_QUOTA_MAX_CLIENTS + 1u, 1u, 0u);
+    for (uint32_t key = 1; key <= CONN_QUOTA_MAX_CLIENTS; key++)
+    {
+        TEST_CHECK(conn_quota_acquire(&quota, key));
+    }
+    TEST_CHECK(!conn_quota_acquire(&quota, CLIENT_A));
+}
+
+/* Simulation: several client IPs open and close connections in turn, and
+ * the quota never exceeds its limits and always lets a new client in.
+ */
+static void test_simulated_clients(void)
+{
+    conn_quota_t quota;
+    uint32_t held[4] = {0, 0, 0, 0};
+    uint32_t seed = 12345u;
+    uint32_t client;
+    uint32_t total;
+
+    conn_quota_init(&quota, MAX_CONNECTIONS, MAX_PER_CLIENT, RESERVED);
+
+    for (uint32_t step = 0; step < 10000u; step++)
+    {
+        seed = (seed * 1103515245u) + 12345u;
+        client = (seed >> 16) % 4u;
+
+        if ((0 != held[client]) && (0 != ((seed >> 8) & 1u)))
+        {
+            conn_quota_release(&quota, 0x0101A8C0u + (client << 24));
+            held[client]--;
+        }
+        else if (conn_quota_acquire(&quota, 0x0101A8C0u + (client << 24)))
+        {
+            held[client]++;
+        }
+        else
+        {
+            /* A rejected client either holds its share, or the listener is
+             * full, or it holds one and only the reserve is left.
+             */
+            total = held[0] + held[1] + held[2] + held[3];
+            TEST_CHECK((held[client] >= MAX_PER_CLIENT) || (total >= MAX_CONNECTIONS) ||
+                       ((0 != held[client]) && ((MAX_CONNECTIONS - total) <= RESERVED)));
+        }
+
+        TEST_CHECK(quota.connections == held[0] + held[1] + held[2] + held[3]);
+        TEST_CHECK(quota.connections <= MAX_CONNECTIONS);
+    }
+}
+
+int main(void)
+{
+    test_reserved_connection();
+    test_reserve_refused_to_holder();
+    test_reject_counts();
+    test_client_table();
+    test_simulated_clients();
+
+    return TEST_RESULT("conn_quota");
+}
+
+/* [] END OF FILE */
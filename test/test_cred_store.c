@@ -0,0 +1,221 @@
+/*******************************************************************************
+ * File Name: test_cred_store.c
+ *
+ * Description: Host test of the credential store against the file that
+ *              emulates the flash: stores, ranks, replaces and removes
+ *              profiles, and rejects a corrupted record.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "cred_store.h"
+#include "test_common.h"
+
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Builds a profile of an SSID with the given priority. */
+static void make_profile(cred_store_entry_t *entry, const char *ssid, uint8_t priority)
+{
+    memset(entry, 0, sizeof(*entry));
+    strncpy((char *)entry->ssid, ssid, CY_WCM_MAX_SSID_LEN);
+    strncpy((char *)entry->password, "password", CY_WCM_MAX_PASSPHRASE_LEN);
+    entry->security = CY_WCM_SECURITY_WPA2_AES_PSK;
+    entry->priority = priority;
+    entry->channel = 6;
+    entry->bssid[5] = priority;
+}
+
+/* Modification time of the emulated flash, in nanoseconds. */
+static uint64_t flash_mtime(void)
+{
+    struct stat info;
+
+    if (0 != stat(CRED_STORE_HOST_FILE, &info))
+    {
+        return 0;
+    }
+    return ((uint64_t)info.st_mtim.tv_sec * 1000000000u) + (uint64_t)info.st_mtim.tv_nsec;
+}
+
+/* A profile is read back as it was saved, also after a reboot. */
+static void test_save_and_find(void)
+{
+    cred_store_entry_t entry;
+    cred_store_entry_t found;
+    cred_store_entry_t profiles[CRED_STORE_MAX_PROFILES];
+    uint32_t count;
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_erase());
+    TEST_CHECK(CY_RSLT_SUCCESS != cred_store_load(profiles, &count));
+    TEST_CHECK(0 == count);
+
+    make_profile(&entry, "line-1", 3);
+    entry.pmk_valid = true;
+    memset(entry.pmk, 0xA5, sizeof(entry.pmk));
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, false));
+
+    /* The store keeps nothing in RAM between calls. */
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_find((const uint8_t *)"line-1", &found));
+    TEST_CHECK(found.valid);
+    TEST_CHECK(0 == found.last_success);
+    TEST_CHECK(0 == strcmp("password", (const char *)found.password));
+    TEST_CHECK(CY_WCM_SECURITY_WPA2_AES_PSK == found.security);
+    TEST_CHECK((6 == found.channel) && (3 == found.bssid[5]));
+    TEST_CHECK(found.pmk_valid && (0xA5 == found.pmk[PMK_LENGTH - 1]));
+
+    TEST_CHECK(CY_RSLT_SUCCESS != cred_store_find((const uint8_t *)"line-2", &found));
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_load(profiles, &count));
+    TEST_CHECK(1 == count);
+}
+
+/* Each successful connection becomes the most recent one, and a reconnection
+ * to the most recent AP does not write the flash again.
+ */
+static void test_last_success(void)
+{
+    cred_store_entry_t entry;
+    cred_store_entry_t found;
+    uint64_t mtime;
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_erase());
+
+    make_profile(&entry, "line-1", 1);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, true));
+    make_profile(&entry, "line-2", 1);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, true));
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_find((const uint8_t *)"line-1", &found));
+    TEST_CHECK(1 == found.last_success);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_find((const uint8_t *)"line-2", &found));
+    TEST_CHECK(2 == found.last_success);
+
+    mtime = flash_mtime();
+    usleep(10000);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, true));
+    TEST_CHECK(mtime == flash_mtime());
+
+    /* A connection keeps the priority stored through the profiles API. */
+    make_profile(&entry, "line-1", 9);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, false));
+    make_profile(&entry, "line-1", 0);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, true));
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_find((const uint8_t *)"line-1", &found));
+    TEST_CHECK((3 == found.last_success) && (9 == found.priority));
+}
+
+/* A new profile in a full record replaces the oldest success, and then the
+ * lowest priority.
+ */
+static void test_full_record(void)
+{
+    static const char *ssids[CRED_STORE_MAX_PROFILES] = { "line-1", "line-2", "line-3", "line-4" };
+    cred_store_entry_t entry;
+    cred_store_entry_t found;
+    cred_store_entry_t profiles[CRED_STORE_MAX_PROFILES];
+    uint32_t count;
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_erase());
+
+    for (uint32_t index = 0; index < CRED_STORE_MAX_PROFILES; index++)
+    {
+        make_profile(&entry, ssids[index], (uint8_t)(index + 1u));
+        TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, 0 == index));
+    }
+
+    /* line-2 never connected and has the lowest priority of the others. */
+    make_profile(&entry, "line-5", 1);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, false));
+    TEST_CHECK(CY_RSLT_SUCCESS != cred_store_find((const uint8_t *)"line-2", &found));
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_find((const uint8_t *)"line-1", &found));
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_find((const uint8_t *)"line-5", &found));
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_load(profiles, &count));
+    TEST_CHECK(CRED_STORE_MAX_PROFILES == count);
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_remove((const uint8_t *)"line-5"));
+    TEST_CHECK(CY_RSLT_SUCCESS != cred_store_remove((const uint8_t *)"line-5"));
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_load(profiles, &count));
+    TEST_CHECK(CRED_STORE_MAX_PROFILES - 1u == count);
+}
+
+/* A corrupted or truncated record is reported as missing and is replaced by
+ * the next save.
+ */
+static void test_corrupted_record(void)
+{
+    cred_store_entry_t entry;
+    cred_store_entry_t found;
+    cred_store_record_t record;
+    FILE *file;
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_erase());
+    make_profile(&entry, "line-1", 1);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, true));
+
+    file = fopen(CRED_STORE_HOST_FILE, "r+b");
+    TEST_CHECK(NULL != file);
+    TEST_CHECK(sizeof(record) == fread(&record, 1, sizeof(record), file));
+    record.profiles[0].password[0] ^= 0x01u;
+    rewind(file);
+    TEST_CHECK(sizeof(record) == fwrite(&record, 1, sizeof(record), file));
+    fclose(file);
+    TEST_CHECK(CY_RSLT_SUCCESS != cred_store_find((const uint8_t *)"line-1", &found));
+
+    TEST_CHECK(0 == truncate(CRED_STORE_HOST_FILE, sizeof(record) / 2u));
+    TEST_CHECK(CY_RSLT_SUCCESS != cred_store_find((const uint8_t *)"line-1", &found));
+
+    make_profile(&entry, "line-2", 1);
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, true));
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_find((const uint8_t *)"line-2", &found));
+    TEST_CHECK(1 == found.last_success);
+    TEST_CHECK(CY_RSLT_SUCCESS != cred_store_find((const uint8_t *)"line-1", &found));
+}
+
+int main(void)
+{
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_init());
+
+    test_save_and_find();
+    test_last_success();
+    test_full_record();
+    test_corrupted_record();
+
+    (void)cred_store_erase();
+
+    return TEST_RESULT("cred_store");
+}
+
+/* [] END OF FILE */
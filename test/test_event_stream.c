@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * File Name: test_event_stream.c
+ *
+ * Description: Host test of the HTTP event stream: the replay of the missed
+ *              events to a stream that resumes from the last event ID, the
+ *              reset event once the gap has left the history, and the 503
+ *              response over the quota.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "web_server.h"
+#include "event_stream.h"
+#include "test_common.h"
+
+#include <string.h>
+
+/* Bytes written to a response stream that the test keeps. */
+#define SIM_STREAM_BUFFER_LENGTH                     (4096u)
+
+/* Response stream of the simulated HTTP server, with what was written to it. */
+typedef struct
+{
+    cy_http_response_stream_t stream;
+    bool header_written;
+    cy_http_status_codes_t status;
+    bool disconnected;
+    uint32_t length;
+    char data[SIM_STREAM_BUFFER_LENGTH];
+} sim_stream_t;
+
+static sim_stream_t sim_streams[4];
+
+/* Simulated HTTP server: the writes to a response stream are appended to it. */
+cy_rslt_t cy_http_server_response_stream_enable_chunked_transfer(cy_http_response_stream_t *stream)
+{
+    (void)stream;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_response_stream_write_header(cy_http_response_stream_t *stream, cy_http_status_codes_t status_code, uint32_t content_length, cy_http_cache_t cache_type, cy_http_mime_type_t mime_type)
+{
+    sim_stream_t *sim = (sim_stream_t *)stream;
+    (void)content_length;
+    (void)cache_type;
+    (void)mime_type;
+
+    sim->header_written = true;
+    sim->status = status_code;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_response_stream_write_payload(cy_http_response_stream_t *stream, const void *data, uint32_t length)
+{
+    sim_stream_t *sim = (sim_stream_t *)stream;
+
+    if (sim->disconnected || (sim->length + length >= sizeof(sim->data)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memcpy(&sim->data[sim->length], data, length);
+    sim->length += length;
+    sim->data[sim->length] = '\0';
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_response_stream_disconnect(cy_http_response_stream_t *stream)
+{
+    ((sim_stream_t *)stream)->disconnected = true;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_get_query_parameter_value(const char *url_query, const char *parameter_key, char **parameter_value, uint32_t *value_length)
+{
+    size_t key_len = strlen(parameter_key);
+    const char *param = url_query;
+
+    while (NULL != param)
+    {
+        if ((0 == strncmp(param, parameter_key, key_len)) && ('=' == param[key_len]))
+        {
+            *parameter_value = (char *)&param[key_len + 1];
+            *value_length = (uint32_t)strcspn(*parameter_value, "&");
+            return CY_RSLT_SUCCESS;
+        }
+        param = strchr(param, '&');
+        param = (NULL != param) ? param + 1 : NULL;
+    }
+
+    return CY_RSLT_TYPE_ERROR;
+}
+
+/* Opens an event stream with the query string of the page. */
+static int32_t sim_open(uint32_t index, const char *query)
+{
+    cy_http_message_body_t body;
+
+    memset(&sim_streams[index], 0, sizeof(sim_streams[index]));
+    memset(&body, 0, sizeof(body));
+    body.request_type = CY_HTTP_REQUEST_GET;
+    return event_stream_resource_handler(EVENT_STREAM_URL, query, &sim_streams[index].stream, NULL, &body);
+}
+
+/* Closes the streams and starts a new window of accepted streams. */
+static void sim_close_all(void)
+{
+    (void)event_stream_close_interface((uint32_t)HTTP_INTERFACE_AP);
+    host_rtos_time_offset += EVENT_STREAM_ACCEPT_WINDOW_MSEC;
+}
+
+/* Publishes device data events up to the given ID. */
+static void sim_publish_until(uint32_t last_id)
+{
+    event_stream_stats_t stats;
+    char data[16];
+    uint32_t length;
+
+    event_stream_get_stats(&stats);
+    for (uint32_t id = stats.last_event_id + 1u; id <= last_id; id++)
+    {
+        length = (uint32_t)snprintf(data, sizeof(data), "d%lu", (unsigned long)id);
+        TEST_CHECK(CY_RSLT_SUCCESS == event_stream_publish(NULL, data, length));
+    }
+}
+
+static void test_replay(void)
+{
+    sim_publish_until(3u);
+    TEST_CHECK(CY_RSLT_SUCCESS == event_stream_publish(WIFI_STATE_EVENT_NAME, "connected", 9u));
+    sim_publish_until(5u);
+
+    /* The events after the last one received are replayed in order. */
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(0u, "last_event_id=2&client=a"));
+    TEST_CHECK(sim_streams[0].header_written && (CY_HTTP_200_TYPE == sim_streams[0].status));
+    TEST_CHECK(0 == strcmp(sim_streams[0].data,
+                           "id: 3\ndata: d3\n\n"
+                           "id: 4\nevent: wifi\ndata: connected\n\n"
+                           "id: 5\ndata: d5\n\n"));
+
+    /* The live events follow the replayed ones. */
+    sim_publish_until(6u);
+    TEST_CHECK(NULL != strstr(sim_streams[0].data, "data: d5\n\nid: 6\ndata: d6\n\n"));
+
+    /* A client that is up to date gets no replay, nor does a new one. */
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(1u, "last_event_id=6&client=b"));
+    TEST_CHECK(0u == sim_streams[1].length);
+    sim_close_all();
+    TEST_CHECK(sim_streams[0].disconnected && sim_streams[1].disconnected);
+
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(0u, "client=a"));
+    TEST_CHECK(0u == sim_streams[0].length);
+    sim_close_all();
+}
+
+static void test_replay_batches(void)
+{
+    event_stream_stats_t stats;
+    char expected[32];
+
+    /* A replay longer than a batch is written in several batches. */
+    event_stream_get_stats(&stats);
+    sim_publish_until(stats.last_event_id + (3u * EVENT_STREAM_REPLAY_BATCH));
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(0u, "last_event_id=7&client=a"));
+    snprintf(expected, sizeof(expected), "id: %lu\n", (unsigned long)(stats.last_event_id + (3u * EVENT_STREAM_REPLAY_BATCH)));
+    TEST_CHECK(0 == strncmp(sim_streams[0].data, "id: 8\ndata: d8\n\n", 16));
+    TEST_CHECK(NULL != strstr(sim_streams[0].data, expected));
+    sim_close_all();
+}
+
+static void test_reset(void)
+{
+    event_stream_stats_t stats;
+    char expected[64];
+
+    /* Once the gap has left the history ring, the client gets a reset. */
+    sim_publish_until(20u + EVENT_STREAM_HISTORY_DEPTH);
+    event_stream_get_stats(&stats);
+    snprintf(expected, sizeof(expected), "id: %lu\nevent: reset\ndata: %lu\n\n",
+             (unsigned long)stats.last_event_id, (unsigned long)stats.last_event_id);
+
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(0u, "last_event_id=2&client=a"));
+    TEST_CHECK(0 == strcmp(sim_streams[0].data, expected));
+
+    /* An ID from before a reboot of the device also gets a reset. */
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(1u, "last_event_id=100000&client=b"));
+    TEST_CHECK(0 == strcmp(sim_streams[1].data, expected));
+    sim_close_all();
+
+    /* The oldest event still in the ring is replayed without a reset. */
+    snprintf(expected, sizeof(expected), "last_event_id=%lu&client=a",
+             (unsigned long)(stats.last_event_id - EVENT_STREAM_HISTORY_DEPTH));
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(0u, expected));
+    TEST_CHECK(NULL == strstr(sim_streams[0].data, "event: reset"));
+    snprintf(expected, sizeof(expected), "id: %lu\n",
+             (unsigned long)(stats.last_event_id - EVENT_STREAM_HISTORY_DEPTH + 1u));
+    TEST_CHECK(0 == strncmp(sim_streams[0].data, expected, strlen(expected)));
+    sim_close_all();
+}
+
+static void test_quota(void)
+{
+    event_stream_stats_t stats;
+    uint32_t rate_limited;
+
+    /* A client over its quota, or over the streams, gets 503. */
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(0u, "client=a"));
+    TEST_CHECK(HTTP_REQUEST_HANDLE_ERROR == sim_open(1u, "client=a"));
+    TEST_CHECK(!sim_streams[1].header_written);
+    TEST_CHECK(0 == strncmp(sim_streams[1].data, "HTTP/1.1 503 ", 13));
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(1u, "client=b"));
+    TEST_CHECK(HTTP_REQUEST_HANDLE_ERROR == sim_open(2u, "client=c"));
+    TEST_CHECK(0 == strncmp(sim_streams[2].data, "HTTP/1.1 503 ", 13));
+    sim_close_all();
+
+    /* A client that changes its ID is limited by the streams accepted in
+     * the window.
+     */
+    event_stream_get_stats(&stats);
+    rate_limited = stats.rate_limited;
+    for (uint32_t index = 0; index < EVENT_STREAM_MAX_ACCEPTS; index++)
+    {
+        TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(0u, (0u == (index % 2u)) ? "client=x" : "client=y"));
+        (void)event_stream_close_interface((uint32_t)HTTP_INTERFACE_AP);
+    }
+    TEST_CHECK(HTTP_REQUEST_HANDLE_ERROR == sim_open(0u, "client=z"));
+    TEST_CHECK(0 == strncmp(sim_streams[0].data, "HTTP/1.1 503 ", 13));
+    event_stream_get_stats(&stats);
+    TEST_CHECK(rate_limited + 1u == stats.rate_limited);
+
+    sim_close_all();
+    TEST_CHECK(HTTP_REQUEST_HANDLE_SUCCESS == sim_open(0u, "client=z"));
+    sim_close_all();
+}
+
+int main(void)
+{
+    TEST_CHECK(CY_RSLT_SUCCESS == event_stream_init());
+
+    test_replay();
+    test_replay_batches();
+    test_reset();
+    test_quota();
+
+    return TEST_RESULT("event_stream");
+}
+
+/* [] END OF FILE */
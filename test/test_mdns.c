@@ -0,0 +1,528 @@
+/*******************************************************************************
+ * File Name: test_mdns.c
+ *
+ * Description: Host test of the mDNS responder: the records of the response,
+ *              the matching of the queries, and the announcements, the rate
+ *              limited responses and the goodbye of the responder task over a
+ *              local multicast stand-in.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "mdns.h"
+#include "web_server.h"
+#include "test_common.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+
+/* IPv4 address of the STA, 192.168.0.10 in network byte order. */
+#define SIM_IP_ADDRESS                               (0x0A00A8C0u)
+
+/* Datagrams queued to the responder, and multicast by it, in the stand-in. */
+#define SIM_MAX_QUERIES                              (16u)
+#define SIM_MAX_SENT                                 (16u)
+
+/* Time for the responder task to handle a query, on top of its intervals. */
+#define SIM_MARGIN_MSEC                              (200u)
+
+/* Local multicast stand-in of the secure sockets used by the responder. The
+ * datagrams of the querier are queued to the socket of the responder while
+ * it is a member of the group, and the datagrams it multicasts are logged
+ * with their time for the checks.
+ */
+typedef struct
+{
+    uint8_t data[MDNS_MAX_MESSAGE_LEN];
+    uint32_t length;
+    cy_time_t time;
+} sim_datagram_t;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int socket;
+    uint32_t open_sockets;
+    uint32_t created_sockets;
+    bool joined;
+    cy_socket_ip_mreq_t membership;
+    cy_socket_sockaddr_t bound;
+    uint8_t ttl;
+    uint32_t receive_timeout;
+    sim_datagram_t queries[SIM_MAX_QUERIES];
+    uint32_t query_head;
+    uint32_t query_count;
+    sim_datagram_t sent[SIM_MAX_SENT];
+    uint32_t sent_count;
+    uint32_t bad_sends;
+} sim_group_t;
+
+static sim_group_t sim_group = { .lock = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER };
+
+cy_rslt_t cy_socket_create(int domain, int type, int protocol, cy_socket_t *handle)
+{
+    (void)domain;
+    (void)protocol;
+
+    if (CY_SOCKET_TYPE_DGRAM != type)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    pthread_mutex_lock(&sim_group.lock);
+    sim_group.open_sockets++;
+    sim_group.created_sockets++;
+    sim_group.joined = false;
+    pthread_mutex_unlock(&sim_group.lock);
+    *handle = &sim_group.socket;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_setsockopt(cy_socket_t handle, int level, int optname, const void *optval, uint32_t optlen)
+{
+    (void)handle;
+    (void)level;
+
+    pthread_mutex_lock(&sim_group.lock);
+    if ((CY_SOCKET_SO_RCVTIMEO == optname) && (sizeof(uint32_t) == optlen))
+    {
+        memcpy(&sim_group.receive_timeout, optval, optlen);
+    }
+    else if ((CY_SOCKET_SO_IP_MULTICAST_TTL == optname) && (sizeof(uint8_t) == optlen))
+    {
+        memcpy(&sim_group.ttl, optval, optlen);
+    }
+    else if ((CY_SOCKET_SO_JOIN_MULTICAST_GROUP == optname) && (sizeof(cy_socket_ip_mreq_t) == optlen))
+    {
+        memcpy(&sim_group.membership, optval, optlen);
+        sim_group.joined = (MDNS_MULTICAST_ADDRESS == sim_group.membership.multi_addr.ip.v4);
+    }
+    pthread_mutex_unlock(&sim_group.lock);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_bind(cy_socket_t handle, cy_socket_sockaddr_t *address, uint32_t address_length)
+{
+    (void)handle;
+    (void)address_length;
+
+    pthread_mutex_lock(&sim_group.lock);
+    sim_group.bound = *address;
+    pthread_mutex_unlock(&sim_group.lock);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_sendto(cy_socket_t handle, const void *buffer, uint32_t length, int flags,
+                           const cy_socket_sockaddr_t *dest_addr, uint32_t address_length, uint32_t *bytes_sent)
+{
+    sim_datagram_t *datagram;
+
+    (void)handle;
+    (void)flags;
+    (void)address_length;
+
+    pthread_mutex_lock(&sim_group.lock);
+    if ((MDNS_MULTICAST_ADDRESS != dest_addr->ip_address.ip.v4) || (MDNS_PORT != dest_addr->port) ||
+        (0 == sim_group.open_sockets) || (SIM_MAX_SENT == sim_group.sent_count) || (length > MDNS_MAX_MESSAGE_LEN))
+    {
+        sim_group.bad_sends++;
+    }
+    else
+    {
+        datagram = &sim_group.sent[sim_group.sent_count++];
+        memcpy(datagram->data, buffer, length);
+        datagram->length = length;
+        cy_rtos_get_time(&datagram->time);
+    }
+    pthread_cond_broadcast(&sim_group.cond);
+    pthread_mutex_unlock(&sim_group.lock);
+    *bytes_sent = length;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_recvfrom(cy_socket_t handle, void *buffer, uint32_t length, int flags,
+                             cy_socket_sockaddr_t *src_addr, uint32_t *src_addr_length, uint32_t *bytes_received)
+{
+    struct timespec deadline;
+    sim_datagram_t *datagram;
+    int status = 0;
+
+    (void)handle;
+    (void)flags;
+    (void)src_addr_length;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    pthread_mutex_lock(&sim_group.lock);
+    deadline.tv_sec += sim_group.receive_timeout / 1000u;
+    deadline.tv_nsec += (long)(sim_group.receive_timeout % 1000u) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    while ((0 == sim_group.query_count) && (ETIMEDOUT != status))
+    {
+        status = pthread_cond_timedwait(&sim_group.cond, &sim_group.lock, &deadline);
+    }
+
+    *bytes_received = 0;
+    if (0 == sim_group.query_count)
+    {
+        pthread_mutex_unlock(&sim_group.lock);
+        return CY_RSLT_MODULE_SECURE_SOCKETS_TIMEOUT;
+    }
+
+    datagram = &sim_group.queries[sim_group.query_head];
+    sim_group.query_head = (sim_group.query_head + 1u) % SIM_MAX_QUERIES;
+    sim_group.query_count--;
+    *bytes_received = (datagram->length < length) ? datagram->length : length;
+    memcpy(buffer, datagram->data, *bytes_received);
+    memset(src_addr, 0, sizeof(*src_addr));
+    src_addr->port = MDNS_PORT;
+    src_addr->ip_address.version = CY_SOCKET_IP_VER_V4;
+    pthread_mutex_unlock(&sim_group.lock);
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_socket_delete(cy_socket_t handle)
+{
+    (void)handle;
+
+    pthread_mutex_lock(&sim_group.lock);
+    sim_group.open_sockets--;
+    sim_group.joined = false;
+    sim_group.query_count = 0;
+    pthread_mutex_unlock(&sim_group.lock);
+    return CY_RSLT_SUCCESS;
+}
+
+/* Multicasts a query of the querier to the group. The responder receives it
+ * only while its socket is a member.
+ */
+static void sim_query(const uint8_t *query, uint32_t length)
+{
+    sim_datagram_t *datagram;
+
+    pthread_mutex_lock(&sim_group.lock);
+    if (sim_group.joined && (sim_group.query_count < SIM_MAX_QUERIES))
+    {
+        datagram = &sim_group.queries[(sim_group.query_head + sim_group.query_count) % SIM_MAX_QUERIES];
+        memcpy(datagram->data, query, length);
+        datagram->length = length;
+        sim_group.query_count++;
+        pthread_cond_broadcast(&sim_group.cond);
+    }
+    pthread_mutex_unlock(&sim_group.lock);
+}
+
+/* Waits until the responder multicast the given number of datagrams, at most
+ * timeout_msec. Returns the number multicast.
+ */
+static uint32_t sim_wait_sent(uint32_t count, uint32_t timeout_msec)
+{
+    uint64_t deadline = test_time_usec() + (uint64_t)timeout_msec * 1000u;
+    uint32_t sent;
+
+    while (true)
+    {
+        pthread_mutex_lock(&sim_group.lock);
+        sent = sim_group.sent_count;
+        pthread_mutex_unlock(&sim_group.lock);
+        if ((sent >= count) || (test_time_usec() >= deadline))
+        {
+            return sent;
+        }
+        cy_rtos_delay_milliseconds(10);
+    }
+}
+
+/* Builds a query with one question. Returns its length. */
+static uint32_t make_query(uint8_t *buf, const char *name, uint16_t type, uint16_t class)
+{
+    uint32_t offset = MDNS_HEADER_LEN;
+    const char *label = name;
+    const char *dot;
+    uint32_t length;
+
+    memset(buf, 0, MDNS_HEADER_LEN);
+    buf[5] = 1u;
+    while ('\0' != *label)
+    {
+        dot = strchr(label, '.');
+        length = (NULL != dot) ? (uint32_t)(dot - label) : (uint32_t)strlen(label);
+        buf[offset++] = (uint8_t)length;
+        memcpy(&buf[offset], label, length);
+        offset += length;
+        label += length + ((NULL != dot) ? 1u : 0u);
+    }
+    buf[offset++] = 0;
+    buf[offset++] = (uint8_t)(type >> 8);
+    buf[offset++] = (uint8_t)(type & 0xFFu);
+    buf[offset++] = (uint8_t)(class >> 8);
+    buf[offset++] = (uint8_t)(class & 0xFFu);
+    return offset;
+}
+
+/* A record of a response, as read by read_record. */
+typedef struct
+{
+    uint16_t type;
+    uint16_t class;
+    uint32_t ttl;
+    uint16_t length;
+    const uint8_t *data;
+} record_t;
+
+/* Reads the record at the offset, and moves the offset to the next one.
+ * Returns false if the record does not fit in the message.
+ */
+static bool read_record(const uint8_t *msg, uint32_t msg_len, uint32_t *offset, record_t *record)
+{
+    uint32_t at = *offset;
+
+    while ((at < msg_len) && (0 != msg[at]))
+    {
+        if (MDNS_NAME_POINTER == (msg[at] & MDNS_NAME_POINTER))
+        {
+            at++;
+            break;
+        }
+        at += 1u + msg[at];
+    }
+    at++;
+    if (at + 10u > msg_len)
+    {
+        return false;
+    }
+
+    record->type = (uint16_t)((msg[at] << 8) | msg[at + 1u]);
+    record->class = (uint16_t)((msg[at + 2u] << 8) | msg[at + 3u]);
+    record->ttl = ((uint32_t)msg[at + 4u] << 24) | ((uint32_t)msg[at + 5u] << 16) |
+                  ((uint32_t)msg[at + 6u] << 8) | msg[at + 7u];
+    record->length = (uint16_t)((msg[at + 8u] << 8) | msg[at + 9u]);
+    record->data = &msg[at + 10u];
+    *offset = at + 10u + record->length;
+    return *offset <= msg_len;
+}
+
+/* Checks the records of a response, and returns the sum of their TTLs. */
+static uint32_t check_response(const uint8_t *msg, uint32_t msg_len, uint32_t ip_address)
+{
+    static const uint16_t types[] = { MDNS_TYPE_PTR, MDNS_TYPE_SRV, MDNS_TYPE_TXT, MDNS_TYPE_A, MDNS_TYPE_PTR };
+    uint32_t offset = MDNS_HEADER_LEN;
+    uint32_t ttl_sum = 0;
+    record_t record;
+
+    TEST_CHECK(msg_len > MDNS_HEADER_LEN);
+    if (msg_len <= MDNS_HEADER_LEN)
+    {
+        return 0;
+    }
+    TEST_CHECK((MDNS_FLAG_QR | MDNS_FLAG_AA) == msg[2]);
+    TEST_CHECK((0 == msg[4]) && (0 == msg[5]));
+    TEST_CHECK((0 == msg[6]) && (5u == msg[7]));
+
+    for (uint32_t index = 0; index < sizeof(types) / sizeof(types[0]); index++)
+    {
+        if (!read_record(msg, msg_len, &offset, &record))
+        {
+            TEST_CHECK(false);
+            return ttl_sum;
+        }
+        TEST_CHECK(types[index] == record.type);
+        TEST_CHECK(MDNS_CLASS_IN == (record.class & MDNS_CLASS_MASK));
+        ttl_sum += record.ttl;
+
+        if (MDNS_TYPE_SRV == record.type)
+        {
+            TEST_CHECK(MDNS_HOST_TTL_SEC >= record.ttl);
+            TEST_CHECK(HTTP_PORT == (uint16_t)((record.data[4] << 8) | record.data[5]));
+        }
+        else if (MDNS_TYPE_A == record.type)
+        {
+            TEST_CHECK(4u == record.length);
+            TEST_CHECK(0 == memcmp(record.data, &ip_address, 4u));
+        }
+        else if (MDNS_TYPE_TXT == record.type)
+        {
+            TEST_CHECK((sizeof(MDNS_TXT_PATH) - 1u) == record.data[0]);
+            TEST_CHECK(0 == memcmp(&record.data[1], MDNS_TXT_PATH, record.data[0]));
+        }
+    }
+    TEST_CHECK(msg_len == offset);
+    return ttl_sum;
+}
+
+/* The response carries the five records with the address and the port, the
+ * goodbye carries them with a zero TTL, and a short buffer is refused.
+ */
+static void test_response(void)
+{
+    uint8_t buf[MDNS_MAX_MESSAGE_LEN];
+    uint32_t length;
+
+    length = mdns_build_response(SIM_IP_ADDRESS, false, buf, sizeof(buf));
+    TEST_CHECK(0 != check_response(buf, length, SIM_IP_ADDRESS));
+
+    length = mdns_build_response(SIM_IP_ADDRESS, true, buf, sizeof(buf));
+    TEST_CHECK(0 == check_response(buf, length, SIM_IP_ADDRESS));
+
+    TEST_CHECK(0 == mdns_build_response(SIM_IP_ADDRESS, false, buf, MDNS_HEADER_LEN - 1u));
+    TEST_CHECK(0 == mdns_build_response(SIM_IP_ADDRESS, false, buf, length - 1u));
+}
+
+/* Only the questions about the records of the device match, whatever the
+ * case of their names, and malformed queries do not.
+ */
+static void test_queries(void)
+{
+    uint8_t query[MDNS_MAX_MESSAGE_LEN];
+    uint32_t length;
+
+    length = make_query(query, MDNS_HOSTNAME "." MDNS_DOMAIN, MDNS_TYPE_A, MDNS_CLASS_IN);
+    TEST_CHECK(mdns_query_matches(query, length));
+    length = make_query(query, "CY-Web-Server.LOCAL", MDNS_TYPE_ANY, MDNS_CLASS_IN | MDNS_CACHE_FLUSH);
+    TEST_CHECK(mdns_query_matches(query, length));
+    length = make_query(query, MDNS_SERVICE_TYPE, MDNS_TYPE_PTR, MDNS_CLASS_IN);
+    TEST_CHECK(mdns_query_matches(query, length));
+    length = make_query(query, MDNS_SERVICE_ENUMERATION, MDNS_TYPE_PTR, MDNS_CLASS_IN);
+    TEST_CHECK(mdns_query_matches(query, length));
+    length = make_query(query, MDNS_SERVICE_INSTANCE "." MDNS_SERVICE_TYPE, MDNS_TYPE_SRV, MDNS_CLASS_IN);
+    TEST_CHECK(mdns_query_matches(query, length));
+
+    /* AAAA record, another host, another class. */
+    length = make_query(query, MDNS_HOSTNAME "." MDNS_DOMAIN, 28u, MDNS_CLASS_IN);
+    TEST_CHECK(!mdns_query_matches(query, length));
+    length = make_query(query, "printer.local", MDNS_TYPE_A, MDNS_CLASS_IN);
+    TEST_CHECK(!mdns_query_matches(query, length));
+    length = make_query(query, MDNS_HOSTNAME "." MDNS_DOMAIN, MDNS_TYPE_A, 3u);
+    TEST_CHECK(!mdns_query_matches(query, length));
+
+    /* A response, a truncated question, and a name that points to itself. */
+    length = make_query(query, MDNS_HOSTNAME "." MDNS_DOMAIN, MDNS_TYPE_A, MDNS_CLASS_IN);
+    query[2] = MDNS_FLAG_QR;
+    TEST_CHECK(!mdns_query_matches(query, length));
+    query[2] = 0;
+    TEST_CHECK(!mdns_query_matches(query, length - 1u));
+    query[MDNS_HEADER_LEN] = MDNS_NAME_POINTER;
+    query[MDNS_HEADER_LEN + 1u] = MDNS_HEADER_LEN;
+    TEST_CHECK(!mdns_query_matches(query, length));
+}
+
+/* The responder joins the group on the address of the STA, announces itself
+ * twice, answers a burst of queries with one response per interval, ignores
+ * the other queries, and says goodbye when it stops.
+ */
+static void test_responder(void)
+{
+    uint8_t query[MDNS_MAX_MESSAGE_LEN];
+    uint32_t length;
+    mdns_stats_t stats;
+    sim_datagram_t *sent = sim_group.sent;
+    cy_time_t gap;
+
+    TEST_CHECK(CY_RSLT_SUCCESS == mdns_start(SIM_IP_ADDRESS));
+    TEST_CHECK(sim_group.joined);
+    TEST_CHECK(SIM_IP_ADDRESS == sim_group.membership.if_addr.ip.v4);
+    TEST_CHECK(SIM_IP_ADDRESS == sim_group.bound.ip_address.ip.v4);
+    TEST_CHECK(MDNS_PORT == sim_group.bound.port);
+    TEST_CHECK(MDNS_MULTICAST_TTL == sim_group.ttl);
+    TEST_CHECK(MDNS_RECEIVE_TIMEOUT_MSEC == sim_group.receive_timeout);
+
+    /* Announcements. */
+    TEST_CHECK(MDNS_ANNOUNCE_COUNT == sim_wait_sent(MDNS_ANNOUNCE_COUNT,
+                                                    MDNS_ANNOUNCE_COUNT * MDNS_ANNOUNCE_INTERVAL_MSEC));
+    gap = sent[1].time - sent[0].time;
+    TEST_CHECK(gap >= MDNS_ANNOUNCE_INTERVAL_MSEC);
+    TEST_CHECK(gap <= MDNS_ANNOUNCE_INTERVAL_MSEC + MDNS_RECEIVE_TIMEOUT_MSEC + SIM_MARGIN_MSEC);
+    TEST_CHECK(0 != check_response(sent[0].data, sent[0].length, SIM_IP_ADDRESS));
+
+    /* The same address again: nothing to restart. */
+    TEST_CHECK(CY_RSLT_SUCCESS == mdns_start(SIM_IP_ADDRESS));
+    TEST_CHECK(1u == sim_group.created_sockets);
+
+    /* A query for another host is not answered. */
+    length = make_query(query, "printer.local", MDNS_TYPE_A, MDNS_CLASS_IN);
+    sim_query(query, length);
+    TEST_CHECK(MDNS_ANNOUNCE_COUNT == sim_wait_sent(MDNS_ANNOUNCE_COUNT + 1u,
+                                                    MDNS_MIN_RESPONSE_INTERVAL_MSEC + SIM_MARGIN_MSEC));
+
+    /* A burst of five queries: the first is answered at once, the others
+     * share the response at the end of the interval.
+     */
+    length = make_query(query, MDNS_HOSTNAME "." MDNS_DOMAIN, MDNS_TYPE_A, MDNS_CLASS_IN);
+    for (uint32_t index = 0; index < 5u; index++)
+    {
+        sim_query(query, length);
+    }
+    TEST_CHECK(MDNS_ANNOUNCE_COUNT + 2u ==
+               sim_wait_sent(MDNS_ANNOUNCE_COUNT + 3u,
+                             2u * MDNS_MIN_RESPONSE_INTERVAL_MSEC + MDNS_RECEIVE_TIMEOUT_MSEC + SIM_MARGIN_MSEC));
+    gap = sent[3].time - sent[2].time;
+    TEST_CHECK(gap >= MDNS_MIN_RESPONSE_INTERVAL_MSEC);
+    TEST_CHECK(gap <= MDNS_MIN_RESPONSE_INTERVAL_MSEC + MDNS_RECEIVE_TIMEOUT_MSEC + SIM_MARGIN_MSEC);
+
+    mdns_get_stats(&stats);
+    TEST_CHECK(stats.running);
+    TEST_CHECK(6u == stats.queries);
+    TEST_CHECK(5u == stats.matched_queries);
+    TEST_CHECK(4u == stats.deferred_queries);
+    TEST_CHECK(2u == stats.responses);
+    TEST_CHECK(MDNS_ANNOUNCE_COUNT == stats.announcements);
+
+    /* Goodbye, and no answer once stopped. */
+    mdns_stop();
+    TEST_CHECK(MDNS_ANNOUNCE_COUNT + 3u == sim_group.sent_count);
+    TEST_CHECK(0 == check_response(sent[4].data, sent[4].length, SIM_IP_ADDRESS));
+    TEST_CHECK(0 == sim_group.open_sockets);
+    TEST_CHECK(!sim_group.joined);
+
+    sim_query(query, length);
+    TEST_CHECK(MDNS_ANNOUNCE_COUNT + 3u == sim_wait_sent(MDNS_ANNOUNCE_COUNT + 4u, MDNS_MIN_RESPONSE_INTERVAL_MSEC));
+    mdns_get_stats(&stats);
+    TEST_CHECK(!stats.running);
+    TEST_CHECK(0 == sim_group.bad_sends);
+}
+
+int main(void)
+{
+    test_response();
+    test_queries();
+    test_responder();
+
+    return TEST_RESULT("mdns");
+}
+
+/* [] END OF FILE */
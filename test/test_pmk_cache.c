@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * File Name: test_pmk_cache.c
+ *
+ * Description: Host test of SHA-1 and of the PMK cache: checks the digests
+ *              and the PBKDF2 derivation against published test vectors, and
+ *              the lookups in RAM and in the credential store.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "pmk_cache.h"
+#include "cred_store.h"
+#include "sha1.h"
+#include "test_common.h"
+
+#include <string.h>
+
+/* FIPS 180-2 examples. */
+#define SHA1_ONE_BLOCK_MESSAGE                       "abc"
+#define SHA1_ONE_BLOCK_DIGEST                        "a9993e364706816aba3e25717850c26c9cd0d89d"
+#define SHA1_TWO_BLOCK_MESSAGE                       "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"
+#define SHA1_TWO_BLOCK_DIGEST                        "84983e441c3bd26ebaae4aa1f95129e5e54670f1"
+#define SHA1_MILLION_A_DIGEST                        "34aa973cd4c4daa4f61eeb2bdbad27316534016f"
+#define SHA1_EMPTY_DIGEST                            "da39a3ee5e6b4b0d3255bfef95601890afd80709"
+
+/* IEEE 802.11i-2004, annex H.4.3. */
+#define PMK_IEEE_SSID                                "IEEE"
+#define PMK_IEEE_PASSPHRASE                          "password"
+#define PMK_IEEE                                     "f42c6fc52df0ebef9ebb4b90b38a5f902e83fe1b135a70e23aed762e9710a12e"
+#define PMK_LONG_SSID                                "ThisIsASSID"
+#define PMK_LONG_PASSPHRASE                          "ThisIsAPassword"
+#define PMK_LONG                                     "0dc0d6eb90555ed6419756b9a15ec3e3209b63df707dd508d14581f8982721af"
+
+static void digest_to_hex(const uint8_t digest[SHA1_DIGEST_LENGTH], char *hex)
+{
+    for (uint32_t index = 0; index < SHA1_DIGEST_LENGTH; index++)
+    {
+        sprintf(&hex[index * 2u], "%02x", digest[index]);
+    }
+}
+
+/* Hashes a message fed in pieces of the given size. */
+static void sha1_check(const char *message, uint32_t piece, const char *expected)
+{
+    sha1_context_t ctx;
+    uint8_t digest[SHA1_DIGEST_LENGTH];
+    char hex[(SHA1_DIGEST_LENGTH * 2u) + 1u];
+    uint32_t length = strlen(message);
+
+    sha1_init(&ctx);
+    for (uint32_t offset = 0; offset < length; offset += piece)
+    {
+        sha1_update(&ctx, (const uint8_t *)&message[offset], ((length - offset) < piece) ? (length - offset) : piece);
+    }
+    sha1_final(&ctx, digest);
+    digest_to_hex(digest, hex);
+
+    TEST_CHECK(0 == strcmp(expected, hex));
+}
+
+static void test_sha1(void)
+{
+    static char million_a[1000001];
+    sha1_context_t ctx;
+    uint8_t digest[SHA1_DIGEST_LENGTH];
+    char hex[(SHA1_DIGEST_LENGTH * 2u) + 1u];
+
+    sha1_check("", 1, SHA1_EMPTY_DIGEST);
+    sha1_check(SHA1_ONE_BLOCK_MESSAGE, 64, SHA1_ONE_BLOCK_DIGEST);
+    sha1_check(SHA1_TWO_BLOCK_MESSAGE, 64, SHA1_TWO_BLOCK_DIGEST);
+    sha1_check(SHA1_TWO_BLOCK_MESSAGE, 1, SHA1_TWO_BLOCK_DIGEST);
+    sha1_check(SHA1_TWO_BLOCK_MESSAGE, 7, SHA1_TWO_BLOCK_DIGEST);
+
+    memset(million_a, 'a', sizeof(million_a) - 1u);
+    sha1_check(million_a, 1000, SHA1_MILLION_A_DIGEST);
+    sha1_check(million_a, 4093, SHA1_MILLION_A_DIGEST);
+
+    /* The WebSocket handshake hashes the key and the GUID in two updates. */
+    sha1_init(&ctx);
+    sha1_update(&ctx, (const uint8_t *)"dGhlIHNhbXBsZSBub25jZQ==", 24);
+    sha1_update(&ctx, (const uint8_t *)"258EAFA5-E914-47DA-95CA-C5AB0DC85B11", 36);
+    sha1_final(&ctx, digest);
+    digest_to_hex(digest, hex);
+    TEST_CHECK(0 == strcmp("b37a4f2cc0624f1690f64606cf385945b2bec4ea", hex));
+}
+
+static void pmk_check(const char *ssid, const char *passphrase, const char *expected)
+{
+    uint8_t pmk[PMK_LENGTH];
+    char hex[PMK_HEX_LENGTH + 1u];
+
+    pmk_cache_derive((const uint8_t *)ssid, (const uint8_t *)passphrase, pmk);
+    pmk_to_hex(pmk, hex, sizeof(hex));
+    TEST_CHECK(0 == strcmp(expected, hex));
+}
+
+static void test_derive(void)
+{
+    pmk_check(PMK_IEEE_SSID, PMK_IEEE_PASSPHRASE, PMK_IEEE);
+    pmk_check(PMK_LONG_SSID, PMK_LONG_PASSPHRASE, PMK_LONG);
+
+    TEST_CHECK(pmk_cache_security_supported(CY_WCM_SECURITY_WPA2_AES_PSK));
+    TEST_CHECK(!pmk_cache_security_supported(CY_WCM_SECURITY_WPA3_SAE));
+    TEST_CHECK(!pmk_cache_security_supported(CY_WCM_SECURITY_OPEN));
+}
+
+/* The last derived PMK is served from RAM, and a stored one from the
+ * credential store, but only for the same passphrase.
+ */
+static void test_lookup(void)
+{
+    cred_store_entry_t entry;
+    pmk_cache_stats_t before;
+    pmk_cache_stats_t after;
+    uint8_t pmk[PMK_LENGTH];
+    char hex[PMK_HEX_LENGTH + 1u];
+
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_init());
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_erase());
+    pmk_cache_get_stats(&before);
+
+    memset(&entry, 0, sizeof(entry));
+    strcpy((char *)entry.ssid, PMK_IEEE_SSID);
+    strcpy((char *)entry.password, PMK_IEEE_PASSPHRASE);
+    entry.security = CY_WCM_SECURITY_WPA2_AES_PSK;
+    pmk_cache_derive(entry.ssid, entry.password, entry.pmk);
+    entry.pmk_valid = true;
+    TEST_CHECK(CY_RSLT_SUCCESS == cred_store_save(&entry, true));
+
+    TEST_CHECK(pmk_cache_lookup((const uint8_t *)PMK_IEEE_SSID, (const uint8_t *)PMK_IEEE_PASSPHRASE, pmk));
+    TEST_CHECK(!pmk_cache_lookup((const uint8_t *)PMK_IEEE_SSID, (const uint8_t *)"passwore", pmk));
+
+    /* Another derivation replaces the PMK in RAM; the first one is read back
+     * from the store.
+     */
+    pmk_check(PMK_LONG_SSID, PMK_LONG_PASSPHRASE, PMK_LONG);
+    memset(pmk, 0, sizeof(pmk));
+    TEST_CHECK(pmk_cache_lookup((const uint8_t *)PMK_IEEE_SSID, (const uint8_t *)PMK_IEEE_PASSPHRASE, pmk));
+    pmk_to_hex(pmk, hex, sizeof(hex));
+    TEST_CHECK(0 == strcmp(PMK_IEEE, hex));
+
+    TEST_CHECK(!pmk_cache_lookup((const uint8_t *)PMK_LONG_SSID, (const uint8_t *)PMK_LONG_PASSPHRASE, pmk));
+
+    pmk_cache_get_stats(&after);
+    TEST_CHECK(2u == after.hits - before.hits);
+    TEST_CHECK(2u == after.misses - before.misses);
+    TEST_CHECK(2u == after.derivations - before.derivations);
+
+    (void)cred_store_erase();
+}
+
+int main(void)
+{
+    test_sha1();
+    test_derive();
+    test_lookup();
+
+    return TEST_RESULT("sha1 and pmk_cache");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,190 @@
+/*******************************************************************************
+ * File Name: test_profile_select.c
+ *
+ * Description: Host test of the ranking of the Wi-Fi profiles against
+ *              synthetic scan tables: visible profiles first, then the most
+ *              recent success, the strongest signal and the priority.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "profile_select.h"
+#include "test_common.h"
+
+#include <string.h>
+
+/* Synthetic scan tables ranked by the randomized test. */
+#define SYNTHETIC_TABLES                             (20000u)
+
+static void make_profile(cred_store_entry_t *profile, const char *ssid, uint32_t last_success, uint8_t priority)
+{
+    memset(profile, 0, sizeof(*profile));
+    profile->valid = true;
+    strncpy((char *)profile->ssid, ssid, CY_WCM_MAX_SSID_LEN);
+    profile->last_success = last_success;
+    profile->priority = priority;
+    profile->channel = 36;
+    profile->security = CY_WCM_SECURITY_WPA2_AES_PSK;
+}
+
+static void make_ap(scan_cache_entry_t *ap, const char *ssid, int16_t rssi, uint8_t channel)
+{
+    memset(ap, 0, sizeof(*ap));
+    strncpy((char *)ap->ssid, ssid, CY_WCM_MAX_SSID_LEN);
+    ap->rssi = rssi;
+    ap->channel = channel;
+    ap->bssid[5] = channel;
+    ap->security = CY_WCM_SECURITY_WPA3_WPA2_PSK;
+}
+
+/* The order of the request: visible profiles first, then recent success,
+ * RSSI and priority; each profile is matched with its strongest AP.
+ */
+static void test_ranking(void)
+{
+    cred_store_entry_t profiles[CRED_STORE_MAX_PROFILES];
+    scan_cache_entry_t aps[5];
+    profile_candidate_t candidates[CRED_STORE_MAX_PROFILES];
+
+    make_profile(&profiles[0], "line-1", 0, 9);
+    make_profile(&profiles[1], "line-2", 5, 1);
+    make_profile(&profiles[2], "line-3", 5, 2);
+    make_profile(&profiles[3], "line-4", 7, 1);
+
+    make_ap(&aps[0], "line-2", -70, 1);
+    make_ap(&aps[1], "line-3", -60, 6);
+    make_ap(&aps[2], "line-2", -50, 11);
+    make_ap(&aps[3], "other", -30, 6);
+    make_ap(&aps[4], "line-1", -40, 1);
+
+    TEST_CHECK(4u == profile_select_rank(profiles, 4, aps, 5, candidates));
+
+    /* line-2 and line-3 share the last success; line-2 has the stronger AP. */
+    TEST_CHECK((1u == candidates[0].profile) && candidates[0].visible);
+    TEST_CHECK((-50 == candidates[0].ap.rssi) && (11 == candidates[0].ap.channel));
+    TEST_CHECK(2u == candidates[1].profile);
+    TEST_CHECK(0u == candidates[2].profile);
+
+    /* line-4 was not found: it comes last, with the AP stored in its profile. */
+    TEST_CHECK((3u == candidates[3].profile) && !candidates[3].visible);
+    TEST_CHECK((36 == candidates[3].ap.channel) && (CY_WCM_WIFI_BAND_5GHZ == candidates[3].ap.band));
+    TEST_CHECK(CY_WCM_SECURITY_WPA2_AES_PSK == candidates[3].ap.security);
+
+    /* Without a scan, the profiles are ranked by success and then priority. */
+    TEST_CHECK(4u == profile_select_rank(profiles, 4, aps, 0, candidates));
+    TEST_CHECK(3u == candidates[0].profile);
+    TEST_CHECK(2u == candidates[1].profile);
+    TEST_CHECK(1u == candidates[2].profile);
+    TEST_CHECK(0u == candidates[3].profile);
+
+    /* Removed profiles are skipped. */
+    profiles[3].valid = false;
+    TEST_CHECK(3u == profile_select_rank(profiles, 4, aps, 0, candidates));
+}
+
+/* Every adjacent pair of the ranking of random tables is in order, and each
+ * visible candidate has the strongest AP of its SSID. Also times the ranking.
+ */
+static void test_synthetic_tables(void)
+{
+    static const char *ssids[] = { "line-1", "line-2", "line-3", "line-4", "guest", "lab" };
+    cred_store_entry_t profiles[CRED_STORE_MAX_PROFILES];
+    scan_cache_entry_t aps[SCAN_CACHE_MAX_ENTRIES];
+    profile_candidate_t candidates[CRED_STORE_MAX_PROFILES];
+    const cred_store_entry_t *a;
+    const cred_store_entry_t *b;
+    uint32_t count;
+    uint64_t elapsed = 0;
+    uint64_t start;
+
+    for (uint32_t table = 0; table < SYNTHETIC_TABLES; table++)
+    {
+        for (uint32_t index = 0; index < CRED_STORE_MAX_PROFILES; index++)
+        {
+            make_profile(&profiles[index], ssids[index], test_random(3), (uint8_t)test_random(3));
+        }
+        for (uint32_t index = 0; index < SCAN_CACHE_MAX_ENTRIES; index++)
+        {
+            make_ap(&aps[index], ssids[test_random(6)], (int16_t)(-30 - (int16_t)test_random(60)),
+                    (uint8_t)(1 + test_random(13)));
+        }
+
+        start = test_time_usec();
+        count = profile_select_rank(profiles, CRED_STORE_MAX_PROFILES, aps, SCAN_CACHE_MAX_ENTRIES, candidates);
+        elapsed += test_time_usec() - start;
+
+        TEST_CHECK(CRED_STORE_MAX_PROFILES == count);
+        for (uint32_t index = 0; index < count; index++)
+        {
+            for (uint32_t ap = 0; candidates[index].visible && (ap < SCAN_CACHE_MAX_ENTRIES); ap++)
+            {
+                if (0 == strcmp((const char *)aps[ap].ssid, (const char *)candidates[index].ap.ssid))
+                {
+                    TEST_CHECK(aps[ap].rssi <= candidates[index].ap.rssi);
+                }
+            }
+
+            if (0 == index)
+            {
+                continue;
+            }
+
+            a = &profiles[candidates[index - 1].profile];
+            b = &profiles[candidates[index].profile];
+            TEST_CHECK(candidates[index - 1].visible >= candidates[index].visible);
+            if (candidates[index - 1].visible == candidates[index].visible)
+            {
+                TEST_CHECK(a->last_success >= b->last_success);
+                if (candidates[index].visible && (a->last_success == b->last_success))
+                {
+                    TEST_CHECK(candidates[index - 1].ap.rssi >= candidates[index].ap.rssi);
+                }
+            }
+        }
+    }
+
+    printf("Ranked %u profiles against %u APs in %.2f us on average\n", (unsigned int)CRED_STORE_MAX_PROFILES,
+           (unsigned int)SCAN_CACHE_MAX_ENTRIES, (double)elapsed / SYNTHETIC_TABLES);
+}
+
+int main(void)
+{
+    test_random_seed(0x6A09E667u);
+
+    test_ranking();
+    test_synthetic_tables();
+
+    return TEST_RESULT("profile_select");
+}
+
+/* [] END OF FILE */
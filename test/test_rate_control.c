@@ -0,0 +1,281 @@
+/*******************************************************************************
+ * File Name: test_rate_control.c
+ *
+ * Description: Host simulation of the adaptive telemetry rate: the uploads of
+ *              the device data task share a TX packet pool with an emulated
+ *              link, and the pool must never run out when the link slows
+ *              down.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "rate_control.h"
+#include "test_common.h"
+
+#include "nx_api.h"
+#include "cy_network_mw_core.h"
+
+/* Settings of the device: TX_PACKET_POOL_SIZE in the Makefile,
+ * WIFI_DATA_UPLOAD_INTERVAL_MSEC, EVENT_STREAM_DATA_INTERVAL_MSEC and
+ * EVENT_STREAM_MAX_SUBSCRIBERS.
+ */
+#define SIM_TX_POOL_SIZE                             (10u)
+#define SIM_MIN_INTERVAL_MSEC                        (50u)
+#define SIM_EVENT_INTERVAL_MSEC                      (1000u)
+#define SIM_EVENT_SUBSCRIBERS                        (2u)
+
+/* Airtime of a packet on a good link and on an emulated slow link, which
+ * carries fewer packets per second than the uploads need at the shortest
+ * interval.
+ */
+#define SIM_FAST_PACKET_MSEC                         (2u)
+#define SIM_SLOW_PACKET_MSEC                         (120u)
+
+/* TX packet pool shared with the emulated link. Packets are queued to the
+ * link and released one airtime after the other.
+ */
+typedef struct
+{
+    uint32_t queued;
+    uint32_t next_done_msec;
+    uint32_t packet_msec;
+    uint32_t now_msec;
+    uint32_t exhausted;
+    uint32_t free_min;
+} sim_link_t;
+
+static sim_link_t sim_link;
+static NX_PACKET_POOL sim_pool;
+static NX_IP sim_ap_ip = { &sim_pool };
+static NX_IP sim_sta_ip = { &sim_pool };
+
+/* Interfaces that exist; the simulation runs with the SoftAP only. */
+static bool sim_ap_up = true;
+static bool sim_sta_up = false;
+
+/* The interfaces and their shared packet pool, read by
+ * rate_control_get_tx_pool().
+ */
+void *cy_network_get_nw_interface(cy_network_hw_interface_type_t iface_type, uint8_t iface_idx)
+{
+    (void)iface_idx;
+
+    if (CY_NETWORK_WIFI_AP_INTERFACE == iface_type)
+    {
+        return sim_ap_up ? &sim_ap_ip : NULL;
+    }
+    return sim_sta_up ? &sim_sta_ip : NULL;
+}
+
+UINT nx_packet_pool_info_get(NX_PACKET_POOL *pool_ptr, ULONG *total_packets, ULONG *free_packets,
+                             ULONG *empty_pool_requests, ULONG *empty_pool_suspensions,
+                             ULONG *invalid_packet_releases)
+{
+    (void)pool_ptr;
+    (void)empty_pool_requests;
+    (void)empty_pool_suspensions;
+    (void)invalid_packet_releases;
+
+    *total_packets = SIM_TX_POOL_SIZE;
+    *free_packets = SIM_TX_POOL_SIZE - sim_link.queued;
+    return NX_SUCCESS;
+}
+
+/* Moves the time forward, releasing the packets sent in the meantime. */
+static void sim_advance(uint32_t to_msec)
+{
+    while ((0 != sim_link.queued) && (sim_link.next_done_msec <= to_msec))
+    {
+        sim_link.queued--;
+        sim_link.next_done_msec += sim_link.packet_msec;
+    }
+    sim_link.now_msec = to_msec;
+}
+
+/* Allocates a packet and queues it to the link. An allocation from an empty
+ * pool waits, as NX_WAIT does on the device, and counts as an exhaustion.
+ */
+static void sim_send_packet(void)
+{
+    if (SIM_TX_POOL_SIZE == sim_link.queued)
+    {
+        sim_link.exhausted++;
+        sim_advance(sim_link.next_done_msec);
+    }
+
+    if (0 == sim_link.queued)
+    {
+        sim_link.next_done_msec = sim_link.now_msec + sim_link.packet_msec;
+    }
+    sim_link.queued++;
+
+    if (SIM_TX_POOL_SIZE - sim_link.queued < sim_link.free_min)
+    {
+        sim_link.free_min = SIM_TX_POOL_SIZE - sim_link.queued;
+    }
+}
+
+/* Runs the upload loop of device_data_task for a while. With adaptive set to
+ * false, the interval stays at SIM_MIN_INTERVAL_MSEC as before the rate
+ * control. Returns the interval of the last upload.
+ */
+static uint32_t sim_run(uint32_t duration_msec, uint32_t packet_msec, int8_t rssi_dbm, bool adaptive)
+{
+    static uint32_t last_event_msec = 0;
+    rate_control_input_t input;
+    uint32_t end_msec = sim_link.now_msec + duration_msec;
+    uint32_t interval_msec = SIM_MIN_INTERVAL_MSEC;
+    uint32_t write_start;
+
+    sim_link.packet_msec = packet_msec;
+
+    while (sim_link.now_msec < end_msec)
+    {
+        write_start = sim_link.now_msec;
+
+        /* The event stream subscribers get the data once per interval of the
+         * event stream, and the WebSocket client gets every upload.
+         */
+        if ((sim_link.now_msec - last_event_msec) >= SIM_EVENT_INTERVAL_MSEC)
+        {
+            last_event_msec = sim_link.now_msec;
+            for (uint32_t index = 0; index < SIM_EVENT_SUBSCRIBERS; index++)
+            {
+                sim_send_packet();
+            }
+        }
+        sim_send_packet();
+
+        input.write_time_msec = sim_link.now_msec - write_start;
+        input.rssi_valid = true;
+        input.rssi_dbm = rssi_dbm;
+        TEST_CHECK(rate_control_get_tx_pool(&input.tx_pool_free, &input.tx_pool_total));
+
+        if (adaptive)
+        {
+            interval_msec = rate_control_update(&input);
+        }
+        sim_advance(sim_link.now_msec + interval_msec);
+    }
+
+    return interval_msec;
+}
+
+static void sim_reset(void)
+{
+    sim_link.queued = 0;
+    sim_link.exhausted = 0;
+    sim_link.free_min = SIM_TX_POOL_SIZE;
+    rate_control_init(SIM_MIN_INTERVAL_MSEC);
+}
+
+/* The fixed interval runs the pool out as soon as the link slows down. */
+static void test_fixed_interval(void)
+{
+    sim_reset();
+    (void)sim_run(10000u, SIM_FAST_PACKET_MSEC, -50, false);
+    TEST_CHECK(0 == sim_link.exhausted);
+    (void)sim_run(60000u, SIM_SLOW_PACKET_MSEC, -60, false);
+    printf("Fixed interval:    %4lu exhaustions, %lu free packets at least\n",
+           (unsigned long)sim_link.exhausted, (unsigned long)sim_link.free_min);
+    TEST_CHECK(0 != sim_link.exhausted);
+}
+
+/* The adaptive interval keeps free packets through a slow link and a weak
+ * link, and comes back to the shortest interval once the link recovers.
+ */
+static void test_adaptive_interval(void)
+{
+    rate_control_stats_t stats;
+    uint32_t interval_msec;
+
+    sim_reset();
+    interval_msec = sim_run(10000u, SIM_FAST_PACKET_MSEC, -50, true);
+    TEST_CHECK(SIM_MIN_INTERVAL_MSEC == interval_msec);
+
+    interval_msec = sim_run(60000u, SIM_SLOW_PACKET_MSEC, -60, true);
+    TEST_CHECK(interval_msec > SIM_MIN_INTERVAL_MSEC);
+
+    interval_msec = sim_run(30000u, SIM_SLOW_PACKET_MSEC, -80, true);
+    TEST_CHECK(interval_msec >= RATE_CONTROL_WEAK_LINK_MIN_INTERVAL_MSEC);
+
+    rate_control_get_stats(&stats);
+    printf("Adaptive interval: %4lu exhaustions, %lu free packets at least, %lu ms on the slow link\n",
+           (unsigned long)sim_link.exhausted, (unsigned long)sim_link.free_min, (unsigned long)interval_msec);
+    TEST_CHECK(0 == sim_link.exhausted);
+    TEST_CHECK(stats.tx_pool_free_min == sim_link.free_min);
+    TEST_CHECK(0 != stats.decisions[RATE_CONTROL_REASON_TX_POOL] + stats.decisions[RATE_CONTROL_REASON_SLOW_WRITE]);
+
+    interval_msec = sim_run(60000u, SIM_FAST_PACKET_MSEC, -50, true);
+    TEST_CHECK(SIM_MIN_INTERVAL_MSEC == interval_msec);
+    TEST_CHECK(0 == sim_link.exhausted);
+
+    rate_control_get_stats(&stats);
+    TEST_CHECK(0 != stats.decisions[RATE_CONTROL_REASON_HEADROOM]);
+}
+
+/* The pool is read through whichever interface exists, so rate control
+ * keeps its input after the SoftAP is torn down.
+ */
+static void test_pool_interfaces(void)
+{
+    uint32_t pool_free = 0;
+    uint32_t pool_total = 0;
+
+    sim_reset();
+    sim_ap_up = false;
+    sim_sta_up = true;
+    TEST_CHECK(rate_control_get_tx_pool(&pool_free, &pool_total));
+    TEST_CHECK(SIM_TX_POOL_SIZE == pool_total);
+    TEST_CHECK(SIM_TX_POOL_SIZE == pool_free);
+
+    sim_ap_up = true;
+    TEST_CHECK(rate_control_get_tx_pool(&pool_free, &pool_total));
+
+    sim_ap_up = false;
+    sim_sta_up = false;
+    TEST_CHECK(!rate_control_get_tx_pool(&pool_free, &pool_total));
+
+    sim_ap_up = true;
+}
+
+int main(void)
+{
+    test_fixed_interval();
+    test_adaptive_interval();
+    test_pool_interfaces();
+
+    return TEST_RESULT("rate_control");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,297 @@
+/*******************************************************************************
+ * File Name: test_retry_policy.c
+ *
+ * Description: Host test of the retry policy driven by a simulated WCM: an AP
+ *              with a wrong password, an AP that reboots, an AP that never
+ *              comes back, and invalid parameters, with the policies of the
+ *              connection from the SoftAP page and of the reconnection.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "web_server.h"
+#include "cy_wcm_error.h"
+#include "test_common.h"
+
+/* Time the simulated WCM takes for a join, and for a connect attempt that
+ * does not find the AP.
+ */
+#define SIM_JOIN_MSEC                                (400u)
+#define SIM_NOT_FOUND_MSEC                           (2500u)
+
+/* Most delays recorded for a sequence of attempts. */
+#define SIM_MAX_DELAYS                               (64u)
+
+/* An AP as seen by the simulated WCM. It answers from up_at_msec, in the
+ * time of the simulation, and accepts the join if the password is right.
+ */
+typedef struct
+{
+    uint32_t up_at_msec;
+    bool password_ok;
+} sim_ap_t;
+
+static const sim_ap_t *sim_ap;
+static bool sim_target_found;
+
+/* Time of the simulation: cy_rtos_get_time() is moved forward instead of
+ * sleeping.
+ */
+static uint32_t sim_now(void)
+{
+    cy_time_t now;
+
+    cy_rtos_get_time(&now);
+    return now;
+}
+
+static void sim_sleep(uint32_t msec)
+{
+    host_rtos_time_offset += msec;
+}
+
+/* cy_wcm_connect_ap() of the CYW955913: a missing AP and a refused join both
+ * return CY_RSLT_WCM_STA_CONNECT_ERROR.
+ */
+static cy_rslt_t sim_wcm_connect(uint32_t start_msec)
+{
+    if ((sim_now() - start_msec) < sim_ap->up_at_msec)
+    {
+        sim_target_found = false;
+        sim_sleep(SIM_NOT_FOUND_MSEC);
+        return CY_RSLT_WCM_STA_CONNECT_ERROR;
+    }
+
+    sim_target_found = true;
+    sim_sleep(SIM_JOIN_MSEC);
+    return sim_ap->password_ok ? CY_RSLT_SUCCESS : CY_RSLT_WCM_STA_CONNECT_ERROR;
+}
+
+/* As wifi_classify_connect(): a join error is a rejection only when the scan
+ * found the AP.
+ */
+static retry_class_t sim_classify(cy_rslt_t result)
+{
+    retry_class_t retry_class = retry_policy_classify_wcm(result);
+
+    return ((RETRY_CLASS_REJECTED == retry_class) && !sim_target_found) ? RETRY_CLASS_RETRYABLE : retry_class;
+}
+
+/* The policies of web_server.c, with the classification of the simulation. */
+static const retry_policy_config_t sim_connect_config =
+{
+    .max_attempts = MAX_WIFI_RETRY_COUNT,
+    .max_rejections = WIFI_CONN_MAX_REJECTIONS,
+    .initial_delay_msec = WIFI_CONN_RETRY_INTERVAL_MSEC,
+    .max_delay_msec = WIFI_CONN_RETRY_MAX_INTERVAL_MSEC,
+    .deadline_msec = WIFI_CONN_RETRY_DEADLINE_MSEC,
+    .jitter_percent = WIFI_CONN_RETRY_JITTER_PERCENT,
+    .classify = sim_classify
+};
+
+static const retry_policy_config_t sim_reconnect_config =
+{
+    .max_attempts = WIFI_RECONNECT_MAX_ATTEMPTS,
+    .max_rejections = WIFI_RECONNECT_MAX_ATTEMPTS,
+    .initial_delay_msec = WIFI_CONN_RETRY_INTERVAL_MSEC,
+    .max_delay_msec = WIFI_RECONNECT_MAX_INTERVAL_MSEC,
+    .deadline_msec = WIFI_RECONNECT_DEADLINE_MSEC,
+    .jitter_percent = WIFI_CONN_RETRY_JITTER_PERCENT,
+    .classify = sim_classify
+};
+
+/* Result of a sequence of attempts. */
+typedef struct
+{
+    retry_outcome_t outcome;
+    uint32_t attempts;
+    uint32_t total_msec;
+    uint32_t delay_count;
+    uint32_t delays[SIM_MAX_DELAYS];
+} sim_run_t;
+
+/* Runs the connect loop of start_sta_mode() against an AP. */
+static void sim_connect(const retry_policy_config_t *config, const sim_ap_t *ap, uint32_t seed, sim_run_t *run)
+{
+    retry_policy_t policy;
+    retry_policy_stats_t stats;
+    uint32_t start_msec = sim_now();
+    uint32_t delay_msec;
+    cy_rslt_t result;
+
+    sim_ap = ap;
+    run->delay_count = 0;
+    retry_policy_start(&policy, config, seed);
+
+    while (true)
+    {
+        result = sim_wcm_connect(start_msec);
+        if (!retry_policy_next(&policy, result, &delay_msec))
+        {
+            break;
+        }
+
+        if (run->delay_count < SIM_MAX_DELAYS)
+        {
+            run->delays[run->delay_count++] = delay_msec;
+        }
+        sim_sleep(delay_msec);
+    }
+
+    retry_policy_get_stats(&stats);
+    run->outcome = stats.last_outcome;
+    run->attempts = stats.last_attempts;
+    run->total_msec = sim_now() - start_msec;
+}
+
+/* Each delay is the doubled base, capped, within the jitter. */
+static void check_backoff(const retry_policy_config_t *config, const sim_run_t *run)
+{
+    uint32_t base = config->initial_delay_msec;
+    uint32_t jitter;
+
+    for (uint32_t index = 0; index < run->delay_count; index++)
+    {
+        jitter = (base * config->jitter_percent) / 100u;
+        TEST_CHECK(run->delays[index] >= base - jitter);
+        TEST_CHECK(run->delays[index] <= base + jitter);
+        base = (base < (config->max_delay_msec / 2u)) ? (base * 2u) : config->max_delay_msec;
+    }
+}
+
+/* A wrong password gives up after WIFI_CONN_MAX_REJECTIONS retries instead
+ * of holding the HTTP thread until the deadline.
+ */
+static void test_wrong_password(void)
+{
+    static const sim_ap_t ap = { 0, false };
+    sim_run_t run;
+
+    sim_connect(&sim_connect_config, &ap, 1, &run);
+
+    TEST_CHECK(RETRY_OUTCOME_REJECTED == run.outcome);
+    TEST_CHECK(WIFI_CONN_MAX_REJECTIONS + 1u == run.attempts);
+    TEST_CHECK(run.total_msec < 2000u);
+}
+
+/* An AP that reboots is joined on the first attempt after it is back. */
+static void test_rebooting_ap(void)
+{
+    static const sim_ap_t ap = { 12000u, true };
+    sim_run_t run;
+
+    sim_connect(&sim_connect_config, &ap, 2, &run);
+
+    TEST_CHECK(RETRY_OUTCOME_SUCCESS == run.outcome);
+    TEST_CHECK(run.attempts > 1u);
+    TEST_CHECK(run.total_msec >= ap.up_at_msec);
+    TEST_CHECK(run.total_msec < WIFI_CONN_RETRY_DEADLINE_MSEC);
+    check_backoff(&sim_connect_config, &run);
+}
+
+/* An AP that never comes back ends at the deadline: the last attempt starts
+ * before it.
+ */
+static void test_missing_ap(void)
+{
+    static const sim_ap_t ap = { UINT32_MAX, true };
+    sim_run_t run;
+
+    sim_connect(&sim_connect_config, &ap, 3, &run);
+
+    TEST_CHECK(RETRY_OUTCOME_DEADLINE == run.outcome);
+    TEST_CHECK(run.attempts <= MAX_WIFI_RETRY_COUNT);
+    TEST_CHECK(run.total_msec <= WIFI_CONN_RETRY_DEADLINE_MSEC + SIM_NOT_FOUND_MSEC);
+    check_backoff(&sim_connect_config, &run);
+}
+
+/* The reconnection retries a rejection, because a known AP that refuses the
+ * join is usually rebooting, and backs off up to its own maximum.
+ */
+static void test_reconnect(void)
+{
+    static const sim_ap_t ap = { UINT32_MAX, false };
+    sim_run_t run;
+
+    sim_connect(&sim_reconnect_config, &ap, 4, &run);
+
+    TEST_CHECK(RETRY_OUTCOME_DEADLINE == run.outcome);
+    TEST_CHECK(run.total_msec <= WIFI_RECONNECT_DEADLINE_MSEC + SIM_NOT_FOUND_MSEC);
+    TEST_CHECK(run.delays[run.delay_count - 1u] >=
+               WIFI_RECONNECT_MAX_INTERVAL_MSEC * (100u - WIFI_CONN_RETRY_JITTER_PERCENT) / 100u);
+    check_backoff(&sim_reconnect_config, &run);
+}
+
+/* Invalid parameters are not retried, and devices with different seeds do
+ * not retry in lockstep.
+ */
+static void test_classification(void)
+{
+    retry_policy_t policy;
+    uint32_t delay_a;
+    uint32_t delay_b;
+    bool differs = false;
+
+    TEST_CHECK(RETRY_CLASS_FATAL == retry_policy_classify_wcm(CY_RSLT_WCM_BAD_PASSPHRASE_LEN));
+    TEST_CHECK(RETRY_CLASS_FATAL == retry_policy_classify_wcm(CY_RSLT_WCM_SECURITY_NOT_SUPPORTED));
+    TEST_CHECK(RETRY_CLASS_REJECTED == retry_policy_classify_wcm(CY_RSLT_WCM_STA_CONNECT_ERROR));
+    TEST_CHECK(RETRY_CLASS_RETRYABLE == retry_policy_classify_wcm(CY_RSLT_WCM_DHCP_TIMEOUT));
+    TEST_CHECK(RETRY_CLASS_RETRYABLE == retry_policy_classify_wcm(CY_RSLT_WCM_WAIT_TIMEOUT));
+
+    retry_policy_start(&policy, &sim_connect_config, 5);
+    TEST_CHECK(!retry_policy_next(&policy, CY_RSLT_WCM_BAD_SSID_LEN, &delay_a));
+    TEST_CHECK(1u == policy.attempts);
+
+    for (uint32_t seed = 1; seed < 32u; seed++)
+    {
+        retry_policy_start(&policy, &sim_connect_config, seed);
+        TEST_CHECK(retry_policy_next(&policy, CY_RSLT_WCM_DHCP_TIMEOUT, &delay_a));
+        retry_policy_start(&policy, &sim_connect_config, seed + 1000u);
+        TEST_CHECK(retry_policy_next(&policy, CY_RSLT_WCM_DHCP_TIMEOUT, &delay_b));
+        differs = differs || (delay_a != delay_b);
+    }
+    TEST_CHECK(differs);
+}
+
+int main(void)
+{
+    test_wrong_password();
+    test_rebooting_ap();
+    test_missing_ap();
+    test_reconnect();
+    test_classification();
+
+    return TEST_RESULT("retry_policy");
+}
+
+/* [] END OF FILE */
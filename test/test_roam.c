@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * File Name: test_roam.c
+ *
+ * Description: Host test of the link monitor that triggers roaming: the
+ *              degraded samples, the hysteresis and hold-off, and the
+ *              sampling rate on a good and a weak link.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "roam.h"
+#include "test_common.h"
+
+/* Feeds a sample with the RSSI and the cumulative TX counters. */
+static bool sample(int8_t rssi_dbm, uint32_t tx_packets, uint32_t tx_failed, uint32_t now_msec)
+{
+    roam_input_t input = { rssi_dbm, true, tx_packets, tx_failed };
+
+    return roam_update(&input, now_msec);
+}
+
+/* A search is requested after ROAM_TRIGGER_SAMPLES weak samples in a row,
+ * not during the hold-off, and a good sample starts the count again.
+ */
+static void test_trigger(void)
+{
+    uint32_t now = 0;
+    uint32_t index;
+
+    roam_reset(now);
+
+    /* Weak from the start of the connection: held off. */
+    for (index = 0; index < ROAM_TRIGGER_SAMPLES; index++)
+    {
+        now += ROAM_SAMPLE_INTERVAL_MSEC;
+        TEST_CHECK(!sample(-80, 0, 0, now));
+    }
+
+    /* Still weak at the end of the hold-off: searched at once. */
+    now = ROAM_HOLDOFF_MSEC + ROAM_SAMPLE_INTERVAL_MSEC;
+    TEST_CHECK(sample(-80, 0, 0, now));
+
+    now += ROAM_HOLDOFF_MSEC;
+    for (index = 0; index < ROAM_TRIGGER_SAMPLES - 1u; index++)
+    {
+        now += ROAM_SAMPLE_INTERVAL_MSEC;
+        TEST_CHECK(!sample(-80, 0, 0, now));
+    }
+    now += ROAM_SAMPLE_INTERVAL_MSEC;
+    TEST_CHECK(!sample(-60, 0, 0, now));
+
+    for (index = 0; index < ROAM_TRIGGER_SAMPLES - 1u; index++)
+    {
+        now += ROAM_SAMPLE_INTERVAL_MSEC;
+        TEST_CHECK(!sample(-80, 0, 0, now));
+    }
+    now += ROAM_SAMPLE_INTERVAL_MSEC;
+    TEST_CHECK(sample(-80, 0, 0, now));
+
+    /* A search that found no better AP is not repeated before the hold-off. */
+    for (index = 0; index < ROAM_TRIGGER_SAMPLES; index++)
+    {
+        now += ROAM_SAMPLE_INTERVAL_MSEC;
+        TEST_CHECK(!sample(-80, 0, 0, now));
+    }
+    now += ROAM_HOLDOFF_MSEC;
+    TEST_CHECK(sample(-80, 0, 0, now));
+}
+
+/* TX failures degrade a link with a good RSSI, once enough frames were sent
+ * since the previous sample.
+ */
+static void test_tx_failures(void)
+{
+    roam_stats_t stats;
+    uint32_t now = ROAM_HOLDOFF_MSEC;
+    uint32_t packets = 1000;
+    uint32_t failed = 10;
+    bool search = false;
+
+    roam_reset(0);
+    TEST_CHECK(!sample(-50, packets, failed, now));
+
+    /* 5 of 9 frames failed: too few frames to judge. */
+    for (uint32_t index = 0; index < ROAM_TRIGGER_SAMPLES; index++)
+    {
+        packets += ROAM_MIN_TX_PACKETS - 1u;
+        failed += 5;
+        now += ROAM_SAMPLE_INTERVAL_MSEC;
+        TEST_CHECK(!sample(-50, packets, failed, now));
+    }
+
+    /* 25 % of the frames failed. */
+    for (uint32_t index = 0; index < ROAM_TRIGGER_SAMPLES; index++)
+    {
+        packets += 100;
+        failed += 25;
+        now += ROAM_SAMPLE_INTERVAL_MSEC;
+        search = sample(-50, packets, failed, now);
+    }
+    TEST_CHECK(search);
+
+    roam_get_stats(&stats);
+    TEST_CHECK(25u == stats.tx_failed_percent);
+
+    /* The counters wrap around. */
+    roam_reset(0);
+    TEST_CHECK(!sample(-50, UINT32_MAX - 49u, UINT32_MAX - 4u, now));
+    TEST_CHECK(!sample(-50, 50u, 5u, now + ROAM_SAMPLE_INTERVAL_MSEC));
+    roam_get_stats(&stats);
+    TEST_CHECK(10u == stats.tx_failed_percent);
+}
+
+/* The link is sampled every ROAM_IDLE_SAMPLE_INTERVAL_MSEC while the RSSI is
+ * well above the trigger, and every ROAM_SAMPLE_INTERVAL_MSEC near it.
+ */
+static void test_sample_interval(void)
+{
+    uint32_t now = 0;
+    uint32_t wakeups = 0;
+    int8_t rssi;
+
+    roam_reset(now);
+    TEST_CHECK(!sample(-50, 0, 0, now));
+    TEST_CHECK(ROAM_IDLE_SAMPLE_INTERVAL_MSEC == roam_sample_interval());
+    TEST_CHECK(!sample(ROAM_TRIGGER_RSSI_DBM + ROAM_NEAR_MARGIN_DB, 0, 0, now));
+    TEST_CHECK(ROAM_IDLE_SAMPLE_INTERVAL_MSEC == roam_sample_interval());
+    TEST_CHECK(!sample(ROAM_TRIGGER_RSSI_DBM + ROAM_NEAR_MARGIN_DB - 1, 0, 0, now));
+    TEST_CHECK(ROAM_SAMPLE_INTERVAL_MSEC == roam_sample_interval());
+
+    /* An hour on a good link wakes the server task once per idle interval. */
+    for (now = 0; now < 3600000u; now += roam_sample_interval())
+    {
+        rssi = (int8_t)(-55 - (int8_t)((now / 60000u) % 5u));
+        (void)sample(rssi, 0, 0, now);
+        wakeups++;
+    }
+    TEST_CHECK(3600000u / ROAM_IDLE_SAMPLE_INTERVAL_MSEC == wakeups);
+}
+
+/* Roaming needs an AP at least ROAM_MIN_RSSI_GAIN_DB stronger, and the
+ * roams are recorded.
+ */
+static void test_better_ap(void)
+{
+    roam_stats_t before;
+    roam_stats_t after;
+
+    TEST_CHECK(roam_is_better(-80, -80 + ROAM_MIN_RSSI_GAIN_DB));
+    TEST_CHECK(!roam_is_better(-80, -80 + ROAM_MIN_RSSI_GAIN_DB - 1));
+    TEST_CHECK(!roam_is_better(-60, -80));
+
+    roam_get_stats(&before);
+    roam_record(true, 850u, 15);
+    roam_record(false, 0, 0);
+    roam_get_stats(&after);
+    TEST_CHECK(1u == after.roams - before.roams);
+    TEST_CHECK(1u == after.failed_roams - before.failed_roams);
+    TEST_CHECK((850u == after.last_roam_msec) && (15 == after.last_roam_gain_db));
+}
+
+int main(void)
+{
+    test_trigger();
+    test_tx_failures();
+    test_sample_interval();
+    test_better_ap();
+
+    return TEST_RESULT("roam");
+}
+
+/* [] END OF FILE */
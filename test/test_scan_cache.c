@@ -0,0 +1,258 @@
+/*******************************************************************************
+ * File Name: test_scan_cache.c
+ *
+ * Description: Host test of the scan cache: one entry per BSSID, the order by
+ *              signal strength, the replacement of the weakest AP when the
+ *              table is full, the aging of the APs not seen, and the APs
+ *              reported by a streamed scan.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+#include "scan_cache.h"
+#include "test_common.h"
+
+#include <string.h>
+
+/* APs reported by the simulated WCM for the next scan. */
+#define SIM_MAX_RESULTS                              (SCAN_CACHE_MAX_ENTRIES + 2u)
+
+static cy_wcm_scan_result_t sim_results[SIM_MAX_RESULTS];
+static uint32_t sim_result_count;
+static uint32_t sim_scans;
+static uint32_t sim_stops;
+
+/* Simulated WCM: reports the APs of sim_results and completes the scan from
+ * the calling thread, as the WCM worker thread would once the scan is done.
+ */
+cy_rslt_t cy_wcm_start_scan(cy_wcm_scan_result_callback_t scan_callback, void *user_data, cy_wcm_scan_filter_t *scan_filter)
+{
+    (void)scan_filter;
+
+    sim_scans++;
+    for (uint32_t index = 0; index < sim_result_count; index++)
+    {
+        scan_callback(&sim_results[index], user_data, CY_WCM_SCAN_INCOMPLETE);
+    }
+    scan_callback(NULL, user_data, CY_WCM_SCAN_COMPLETE);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_wcm_stop_scan(void)
+{
+    sim_stops++;
+    return CY_RSLT_SUCCESS;
+}
+
+/* Builds a scan result of an AP whose BSSID ends with id. */
+static cy_wcm_scan_result_t sim_result(const char *ssid, uint8_t id, int16_t rssi)
+{
+    cy_wcm_scan_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    strncpy((char *)result.SSID, ssid, CY_WCM_MAX_SSID_LEN);
+    result.BSSID[0] = 0x02u;
+    result.BSSID[5] = id;
+    result.signal_strength = rssi;
+    result.security = CY_WCM_SECURITY_WPA2_AES_PSK;
+    result.channel = 6u;
+    result.band = CY_WCM_WIFI_BAND_2_4GHZ;
+    return result;
+}
+
+static void sim_add(const char *ssid, uint8_t id, int16_t rssi)
+{
+    cy_wcm_scan_result_t result = sim_result(ssid, id, rssi);
+
+    scan_cache_add(&result);
+}
+
+/* Checks that the entries are sorted by signal strength, strongest first. */
+static bool sorted(const scan_cache_entry_t *entries, uint32_t count)
+{
+    for (uint32_t index = 1; index < count; index++)
+    {
+        if (entries[index - 1].rssi < entries[index].rssi)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Time of the simulation: cy_rtos_get_time() is moved forward instead of
+ * sleeping.
+ */
+static void sim_sleep(uint32_t msec)
+{
+    host_rtos_time_offset += msec;
+}
+
+static void test_dedupe_and_order(void)
+{
+    scan_cache_entry_t entries[SCAN_CACHE_MAX_ENTRIES];
+    scan_cache_entry_t entry;
+    uint32_t count;
+
+    sim_add("office", 1u, -70);
+    sim_add("office", 2u, -50);
+    sim_add("lab", 3u, -60);
+    sim_add("", 4u, -40);
+
+    count = scan_cache_snapshot(entries, SCAN_CACHE_MAX_ENTRIES);
+    TEST_CHECK(3u == count);
+    TEST_CHECK(sorted(entries, count));
+    TEST_CHECK(2u == entries[0].bssid[5]);
+
+    /* A BSSID seen again is refreshed in place and moved to its new rank. */
+    sim_add("office", 1u, -45);
+    sim_add("office", 2u, -80);
+    count = scan_cache_snapshot(entries, SCAN_CACHE_MAX_ENTRIES);
+    TEST_CHECK(3u == count);
+    TEST_CHECK(sorted(entries, count));
+    TEST_CHECK((1u == entries[0].bssid[5]) && (-45 == entries[0].rssi));
+    TEST_CHECK((2u == entries[2].bssid[5]) && (-80 == entries[2].rssi));
+
+    /* The lookup returns the strongest AP of the SSID. */
+    TEST_CHECK(scan_cache_lookup((const uint8_t *)"office", &entry));
+    TEST_CHECK(1u == entry.bssid[5]);
+    TEST_CHECK(!scan_cache_lookup((const uint8_t *)"garage", &entry));
+}
+
+static void test_full_table(void)
+{
+    scan_cache_entry_t entries[SCAN_CACHE_MAX_ENTRIES];
+    scan_cache_stats_t before;
+    scan_cache_stats_t after;
+    uint32_t count;
+    uint8_t id;
+
+    for (id = 10u; id < 10u + SCAN_CACHE_MAX_ENTRIES; id++)
+    {
+        sim_add("crowd", id, (int16_t)(-90 + id));
+    }
+    count = scan_cache_snapshot(entries, SCAN_CACHE_MAX_ENTRIES);
+    TEST_CHECK(SCAN_CACHE_MAX_ENTRIES == count);
+    TEST_CHECK(sorted(entries, count));
+
+    /* A weaker AP is dropped, a stronger one replaces the weakest. */
+    scan_cache_get_stats(&before);
+    sim_add("weak", 100u, -95);
+    sim_add("strong", 101u, -30);
+    count = scan_cache_snapshot(entries, SCAN_CACHE_MAX_ENTRIES);
+    TEST_CHECK(SCAN_CACHE_MAX_ENTRIES == count);
+    TEST_CHECK(sorted(entries, count));
+    TEST_CHECK(101u == entries[0].bssid[5]);
+    for (uint32_t index = 0; index < count; index++)
+    {
+        TEST_CHECK(100u != entries[index].bssid[5]);
+    }
+    scan_cache_get_stats(&after);
+    TEST_CHECK(before.dropped + 1u == after.dropped);
+}
+
+static void test_aging(void)
+{
+    scan_cache_entry_t entries[SCAN_CACHE_MAX_ENTRIES];
+    scan_cache_stats_t before;
+    scan_cache_stats_t after;
+    uint32_t count;
+
+    count = scan_cache_snapshot(entries, SCAN_CACHE_MAX_ENTRIES);
+    TEST_CHECK(0u != count);
+    scan_cache_get_stats(&before);
+
+    /* An AP seen again is kept, the others age out. */
+    sim_sleep(SCAN_CACHE_MAX_AGE_MSEC / 2u);
+    sim_add("fresh", 200u, -65);
+    sim_sleep((SCAN_CACHE_MAX_AGE_MSEC / 2u) + 1u);
+
+    count = scan_cache_snapshot(entries, SCAN_CACHE_MAX_ENTRIES);
+    TEST_CHECK(1u == count);
+    TEST_CHECK(200u == entries[0].bssid[5]);
+    scan_cache_get_stats(&after);
+    TEST_CHECK(before.aged_out + before.entries - 1u == after.aged_out);
+
+    sim_sleep(SCAN_CACHE_MAX_AGE_MSEC);
+    TEST_CHECK(0u == scan_cache_snapshot(entries, SCAN_CACHE_MAX_ENTRIES));
+}
+
+static void test_scans(void)
+{
+    scan_cache_entry_t entries[SCAN_CACHE_MAX_ENTRIES];
+    scan_cache_entry_t entry;
+    char text[4u * SCAN_CACHE_MAX_ROW_LEN];
+    uint32_t reported = 0;
+    uint32_t length;
+    bool complete = false;
+
+    sim_results[0] = sim_result("a<b&c", 1u, -55);
+    sim_results[1] = sim_result("lab", 2u, -40);
+    sim_results[2] = sim_result("", 3u, -30);
+    sim_result_count = 3u;
+
+    /* A full scan fills the table, without the hidden SSID. */
+    TEST_CHECK(CY_RSLT_SUCCESS == scan_cache_scan_all());
+    TEST_CHECK(2u == scan_cache_snapshot(entries, SCAN_CACHE_MAX_ENTRIES));
+
+    length = scan_cache_format(text, sizeof(text));
+    text[length] = '\0';
+    TEST_CHECK(0 == strcmp(text, "lab  -40 dBm  ch 6  WPA2\na&lt;b&amp;c  -55 dBm  ch 6  WPA2\n"));
+
+    /* A streamed scan reports the APs as found, then its end. */
+    TEST_CHECK(CY_RSLT_SUCCESS == scan_cache_stream_start());
+    while (!complete && (CY_RSLT_SUCCESS == scan_cache_stream_next(&entry, &complete)))
+    {
+        reported += complete ? 0u : 1u;
+    }
+    scan_cache_stream_end();
+    TEST_CHECK(complete);
+    TEST_CHECK(2u == reported);
+    TEST_CHECK(2u == sim_scans);
+    TEST_CHECK(0u == sim_stops);
+}
+
+int main(void)
+{
+    TEST_CHECK(CY_RSLT_SUCCESS == scan_cache_init());
+
+    test_dedupe_and_order();
+    test_full_table();
+    test_aging();
+    test_scans();
+
+    return TEST_RESULT("scan_cache");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,273 @@
+/*******************************************************************************
+ * File Name: test_websocket.c
+ *
+ * Description: Host test of the frame parser of the WebSocket endpoint:
+ *              masked frames of each length encoding, frames split at every
+ *              byte, and the frames that are refused; and of the header
+ *              checks of the upgrade request.
+ *
+ ********************************************************************************
+ * Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ *******************************************************************************/
+
+/* The parser is static in the endpoint, so the endpoint is built in. */
+#include "../source/websocket.c"
+#include "test_common.h"
+
+#include <string.h>
+
+/* Stand-in for the handler in web_server.c. */
+uint32_t device_duty_cycle_step(bool increase)
+{
+    return increase ? 1u : 0u;
+}
+
+/* Builds a masked client frame. Returns its length. */
+static uint32_t sim_frame(uint8_t *frame, uint8_t first_byte, const uint8_t *payload, uint32_t length,
+                          uint32_t length_encoding)
+{
+    static const uint8_t mask_key[WEBSOCKET_MASK_KEY_LENGTH] = { 0x37u, 0xFAu, 0x21u, 0x3Du };
+    uint32_t offset = 0;
+
+    frame[offset++] = first_byte;
+    if (WEBSOCKET_LENGTH_16BIT == length_encoding)
+    {
+        frame[offset++] = WEBSOCKET_MASK_BIT | WEBSOCKET_LENGTH_16BIT;
+        frame[offset++] = (uint8_t)(length >> 8);
+        frame[offset++] = (uint8_t)length;
+    }
+    else if (WEBSOCKET_LENGTH_64BIT == length_encoding)
+    {
+        frame[offset++] = WEBSOCKET_MASK_BIT | WEBSOCKET_LENGTH_64BIT;
+        for (uint32_t shift = 56u; shift > 0u; shift -= 8u)
+        {
+            frame[offset++] = (shift >= 32u) ? 0u : (uint8_t)(length >> shift);
+        }
+        frame[offset++] = (uint8_t)length;
+    }
+    else
+    {
+        frame[offset++] = WEBSOCKET_MASK_BIT | (uint8_t)length;
+    }
+
+    memcpy(&frame[offset], mask_key, sizeof(mask_key));
+    offset += sizeof(mask_key);
+    for (uint32_t index = 0; index < length; index++)
+    {
+        frame[offset++] = payload[index] ^ mask_key[index % WEBSOCKET_MASK_KEY_LENGTH];
+    }
+
+    return offset;
+}
+
+/* Feeds bytes to the parser. Returns the result of the last byte, or of the
+ * first byte that does not need more.
+ */
+static websocket_parse_result_t sim_parse(websocket_parser_t *parser, const uint8_t *data, uint32_t length,
+                                          uint32_t *consumed)
+{
+    websocket_parse_result_t result = WEBSOCKET_PARSE_NEED_MORE;
+    uint32_t index;
+
+    for (index = 0; (index < length) && (WEBSOCKET_PARSE_NEED_MORE == result); index++)
+    {
+        result = websocket_parse_byte(parser, data[index]);
+    }
+
+    *consumed = index;
+    return result;
+}
+
+static void test_lengths(void)
+{
+    static websocket_parser_t parser;
+    uint8_t payload[WEBSOCKET_MAX_PAYLOAD_LEN];
+    uint8_t frame[16u + WEBSOCKET_MAX_PAYLOAD_LEN];
+    const uint32_t encodings[] = { 0u, WEBSOCKET_LENGTH_16BIT, WEBSOCKET_LENGTH_64BIT };
+    uint32_t frame_len;
+    uint32_t consumed;
+
+    for (uint32_t index = 0; index < sizeof(payload); index++)
+    {
+        payload[index] = (uint8_t)(index * 7u);
+    }
+
+    /* Every length encoding of the same payload gives the same frame. */
+    for (uint32_t encoding = 0; encoding < sizeof(encodings) / sizeof(encodings[0]); encoding++)
+    {
+        memset(&parser, 0, sizeof(parser));
+        frame_len = sim_frame(frame, WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_BINARY, payload, sizeof(payload),
+                              encodings[encoding]);
+        TEST_CHECK(WEBSOCKET_PARSE_FRAME_COMPLETE == sim_parse(&parser, frame, frame_len, &consumed));
+        TEST_CHECK(frame_len == consumed);
+        TEST_CHECK(parser.fin && (WEBSOCKET_OPCODE_BINARY == parser.opcode));
+        TEST_CHECK(sizeof(payload) == parser.payload_length);
+        TEST_CHECK(0 == memcmp(parser.payload, payload, sizeof(payload)));
+    }
+
+    /* An empty frame completes on its mask key. */
+    memset(&parser, 0, sizeof(parser));
+    frame_len = sim_frame(frame, WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_PING, NULL, 0u, 0u);
+    TEST_CHECK(WEBSOCKET_PARSE_FRAME_COMPLETE == sim_parse(&parser, frame, frame_len, &consumed));
+    TEST_CHECK((frame_len == consumed) && (0u == parser.payload_length));
+}
+
+static void test_split_frames(void)
+{
+    static websocket_parser_t parser;
+    const uint8_t command[WEBSOCKET_CMD_LENGTH] = { WEBSOCKET_CMD_INCREASE, 0x12u, 0x34u };
+    const uint8_t text[] = "duty";
+    uint8_t stream[64];
+    uint32_t first_len;
+    uint32_t stream_len;
+    uint32_t consumed;
+    uint32_t frames = 0;
+
+    /* Two frames back to back, as one TCP segment may carry them, are parsed
+     * whatever the split of the bytes.
+     */
+    first_len = sim_frame(stream, WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_BINARY, command, sizeof(command), 0u);
+    stream_len = first_len + sim_frame(&stream[first_len], WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_TEXT, text,
+                                       sizeof(text) - 1u, WEBSOCKET_LENGTH_16BIT);
+
+    memset(&parser, 0, sizeof(parser));
+    for (uint32_t index = 0; index < stream_len; index++)
+    {
+        if (WEBSOCKET_PARSE_FRAME_COMPLETE != websocket_parse_byte(&parser, stream[index]))
+        {
+            continue;
+        }
+
+        frames++;
+        if (1u == frames)
+        {
+            TEST_CHECK(first_len - 1u == index);
+            TEST_CHECK(WEBSOCKET_OPCODE_BINARY == parser.opcode);
+            TEST_CHECK(0 == memcmp(parser.payload, command, sizeof(command)));
+        }
+        else
+        {
+            TEST_CHECK(stream_len - 1u == index);
+            TEST_CHECK(WEBSOCKET_OPCODE_TEXT == parser.opcode);
+            TEST_CHECK(0 == memcmp(parser.payload, text, sizeof(text) - 1u));
+        }
+    }
+    TEST_CHECK(2u == frames);
+
+    /* A fragment is reported with fin cleared. */
+    memset(&parser, 0, sizeof(parser));
+    stream_len = sim_frame(stream, WEBSOCKET_OPCODE_TEXT, text, sizeof(text) - 1u, 0u);
+    TEST_CHECK(WEBSOCKET_PARSE_FRAME_COMPLETE == sim_parse(&parser, stream, stream_len, &consumed));
+    TEST_CHECK(!parser.fin);
+}
+
+static void test_refused_frames(void)
+{
+    static websocket_parser_t parser;
+    uint8_t payload[WEBSOCKET_MAX_PAYLOAD_LEN + 1u];
+    uint8_t frame[16u + sizeof(payload)];
+    uint32_t frame_len;
+    uint32_t consumed;
+
+    memset(payload, 0x55, sizeof(payload));
+
+    /* An unmasked frame. */
+    memset(&parser, 0, sizeof(parser));
+    frame[0] = WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_BINARY;
+    frame[1] = 3u;
+    TEST_CHECK(WEBSOCKET_PARSE_PROTOCOL_ERROR == sim_parse(&parser, frame, 2u, &consumed));
+
+    /* A frame that uses an extension. */
+    memset(&parser, 0, sizeof(parser));
+    frame_len = sim_frame(frame, WEBSOCKET_FIN_BIT | 0x40u | WEBSOCKET_OPCODE_BINARY, payload, 3u, 0u);
+    TEST_CHECK(WEBSOCKET_PARSE_PROTOCOL_ERROR == sim_parse(&parser, frame, frame_len, &consumed));
+    TEST_CHECK(1u == consumed);
+
+    /* A fragmented control frame. */
+    memset(&parser, 0, sizeof(parser));
+    frame_len = sim_frame(frame, WEBSOCKET_OPCODE_PING, payload, 3u, 0u);
+    TEST_CHECK(WEBSOCKET_PARSE_PROTOCOL_ERROR == sim_parse(&parser, frame, frame_len, &consumed));
+
+    /* Frames larger than the payload buffer, before any payload is stored. */
+    memset(&parser, 0, sizeof(parser));
+    frame_len = sim_frame(frame, WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_BINARY, payload, sizeof(payload),
+                          WEBSOCKET_LENGTH_16BIT);
+    TEST_CHECK(WEBSOCKET_PARSE_FRAME_TOO_BIG == sim_parse(&parser, frame, frame_len, &consumed));
+    TEST_CHECK(4u + WEBSOCKET_MASK_KEY_LENGTH == consumed);
+
+    memset(&parser, 0, sizeof(parser));
+    frame[0] = WEBSOCKET_FIN_BIT | WEBSOCKET_OPCODE_BINARY;
+    frame[1] = WEBSOCKET_MASK_BIT | WEBSOCKET_LENGTH_64BIT;
+    memset(&frame[2], 0xFF, 8u);
+    TEST_CHECK(WEBSOCKET_PARSE_FRAME_TOO_BIG == sim_parse(&parser, frame, 10u, &consumed));
+}
+
+static void test_upgrade_headers(void)
+{
+    const char *request =
+        "GET /ws HTTP/1.1\r\n"
+        "Host: 192.168.0.2:81\r\n"
+        "upgrade: WebSocket\r\n"
+        "Connection: keep-alive, Upgrade\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Sec-WebSocket-Version:  13  \r\n"
+        "\r\n";
+    const char *value;
+    uint32_t value_len = 0;
+
+    /* Header names are matched case-insensitively and whole. */
+    value = websocket_find_header(request, WEBSOCKET_UPGRADE_HEADER, &value_len);
+    TEST_CHECK(websocket_header_has_token(value, value_len, "websocket"));
+    value = websocket_find_header(request, WEBSOCKET_VERSION_HEADER, &value_len);
+    TEST_CHECK((NULL != value) && (2u == value_len) && (0 == strncmp(value, WEBSOCKET_VERSION, 2u)));
+    TEST_CHECK(NULL == websocket_find_header(request, WEBSOCKET_KEY_HEADER, &value_len));
+
+    /* The Connection header is a list of tokens. */
+    value = websocket_find_header(request, WEBSOCKET_CONNECTION_HEADER, &value_len);
+    TEST_CHECK(websocket_header_has_token(value, value_len, "Upgrade"));
+    TEST_CHECK(websocket_header_has_token(value, value_len, "keep-alive"));
+    TEST_CHECK(!websocket_header_has_token(value, value_len, "close"));
+    TEST_CHECK(!websocket_header_has_token("Upgraded", 8u, "Upgrade"));
+    TEST_CHECK(!websocket_header_has_token(NULL, 0u, "Upgrade"));
+}
+
+int main(void)
+{
+    test_lengths();
+    test_split_frames();
+    test_refused_frames();
+    test_upgrade_headers();
+
+    return TEST_RESULT("websocket");
+}
+
+/* [] END OF FILE */